@@ -7,6 +7,11 @@
 # ============================================================================
 find_package(BZip2 REQUIRED)
 
+# ============================================================================
+# Threads - for parallel compression
+# ============================================================================
+find_package(Threads REQUIRED)
+
 # ============================================================================
 # pugixml - for XML parsing
 # ============================================================================
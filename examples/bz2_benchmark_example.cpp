@@ -0,0 +1,89 @@
+/**
+ * @file bz2_benchmark_example.cpp
+ * @brief Example: Comparing the libbz2 and native bzip2 decoders
+ *
+ * This example demonstrates:
+ * - Selecting the decompression backend at runtime
+ * - Decoding the blocks of one stream on a thread pool
+ * - Checking that both decoders produce identical output
+ *
+ * Without a file argument, a synthetic multi-block stream is generated.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "wikilib/core/thread_pool.h"
+#include "wikilib/dump/bz2_decoder.h"
+#include "wikilib/dump/bz2_stream.h"
+
+using namespace wikilib;
+using namespace wikilib::dump;
+
+std::string sample_data() {
+    std::string data;
+    for (int i = 0; data.size() < 20 * 1024 * 1024; ++i) {
+        data += "== Section " + std::to_string(i) + " ==\n";
+        data += "'''Example''' article text with a [[Link|link]] and {{cite web|url=https://example.org/";
+        data += std::to_string(i * 7919 % 10007) + "}}.\n";
+    }
+    return data;
+}
+
+double time_run(const char *label, size_t compressed_size, const std::function<Result<std::string>()> &run,
+                std::string &output) {
+    auto start = std::chrono::steady_clock::now();
+    auto result = run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!result) {
+        std::cerr << label << ": " << result.error().message << std::endl;
+        return 0;
+    }
+    output = std::move(*result);
+    std::cout << std::left << std::setw(20) << label << std::right << std::fixed << std::setprecision(3)
+              << seconds << " s  " << std::setprecision(1)
+              << static_cast<double>(compressed_size) / seconds / 1e6 << " MB/s compressed, "
+              << static_cast<double>(output.size()) / seconds / 1e6 << " MB/s output" << std::endl;
+    return seconds;
+}
+
+int main(int argc, char *argv[]) {
+    std::string compressed;
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (!file) {
+            std::cerr << "Cannot open " << argv[1] << std::endl;
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        compressed = contents.str();
+    } else {
+        auto sample = compress_bz2(sample_data());
+        if (!sample) {
+            std::cerr << sample.error().message << std::endl;
+            return 1;
+        }
+        compressed = std::move(*sample);
+    }
+    std::cout << "Compressed input: " << compressed.size() << " bytes" << std::endl;
+
+    std::string reference, native, parallel;
+    set_bz2_backend(Bz2Backend::Libbz2);
+    time_run("libbz2", compressed.size(), [&] { return decompress_bz2(compressed); }, reference);
+    time_run("native", compressed.size(), [&] { return native_decompress_bz2(compressed); }, native);
+
+    ThreadPool pool;
+    Bz2DecodeConfig config{.pool = &pool, .min_parallel_size = 0};
+    time_run("native (parallel)", compressed.size(), [&] { return native_decompress_bz2(compressed, config); },
+             parallel);
+
+    // libbz2's buffer API stops after the first stream of a multistream file
+    bool same = native.starts_with(reference) && parallel == native;
+    std::cout << (same ? "Outputs match" : "OUTPUTS DIFFER") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+/**
+ * @file arena.h
+ * @brief Bump arenas backed by mmap'd (huge page) blocks
+ *
+ * Scratch memory of a worker (decompressed chunks, page buffers) is
+ * allocated by bumping a pointer through large blocks that are mapped
+ * once and reused after reset(). Blocks are 2 MiB aligned so that they
+ * can be backed by huge pages, and on Linux they are bound to the NUMA
+ * node of the thread that maps them.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace wikilib {
+
+/**
+ * @brief Huge page use of arena blocks
+ */
+enum class HugePages : uint8_t {
+    Off, // Regular pages
+    Transparent, // madvise(MADV_HUGEPAGE) on aligned blocks
+    Explicit // MAP_HUGETLB, falling back to Transparent when none are reserved
+};
+
+/**
+ * @brief Configuration for Arena
+ */
+struct ArenaConfig {
+    size_t block_size = 8ull << 20; // Rounded up to the huge page size
+    HugePages huge_pages = HugePages::Transparent;
+    bool node_local = true; // Bind blocks to the NUMA node of the mapping thread (Linux)
+};
+
+/**
+ * @brief Arena memory statistics
+ */
+struct ArenaStats {
+    uint64_t bytes_used = 0; // Allocated since the last reset
+    uint64_t peak_bytes_used = 0;
+    uint64_t bytes_mapped = 0; // Reserved in blocks
+    uint64_t hugetlb_bytes = 0; // Mapped with MAP_HUGETLB
+    uint64_t thp_bytes = 0; // Advised for transparent huge pages
+    uint64_t node_bound_bytes = 0; // Bound to the local NUMA node
+    uint32_t blocks = 0;
+    uint64_t resets = 0;
+
+    /**
+     * @brief Share of mapped bytes eligible for huge pages (fewer TLB entries)
+     */
+    [[nodiscard]] double huge_page_fraction() const noexcept {
+        return bytes_mapped == 0 ? 0.0 : static_cast<double>(hugetlb_bytes + thp_bytes) / static_cast<double>(bytes_mapped);
+    }
+};
+
+/**
+ * @brief Bump allocator over mmap'd blocks
+ *
+ * Memory is released all at once by reset() (blocks stay mapped for
+ * reuse) or release(). Not thread-safe; use one arena per thread.
+ *
+ * Example usage:
+ * @code
+ *   Arena arena;
+ *   for (...) {
+ *       arena.reset();
+ *       auto xml = decompress_bz2(compressed, arena);
+ *       ...
+ *   }
+ * @endcode
+ */
+class Arena {
+public:
+    explicit Arena(ArenaConfig config = {});
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * @brief Allocate uninitialized memory
+     */
+    [[nodiscard]] void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Allocate an uninitialized array of trivial T
+     */
+    template<typename T>
+    [[nodiscard]] T *allocate_array(size_t count) {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief Copy a string into the arena
+     */
+    [[nodiscard]] std::string_view copy(std::string_view text);
+
+    /**
+     * @brief Give back the tail of the most recent allocation
+     *
+     * Has no effect unless ptr is the latest allocation.
+     */
+    void shrink(void *ptr, size_t old_size, size_t new_size) noexcept;
+
+    /**
+     * @brief Free all allocations, keeping the blocks mapped
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Free all allocations and unmap the blocks
+     */
+    void release() noexcept;
+
+    [[nodiscard]] const ArenaStats &stats() const noexcept {
+        return stats_;
+    }
+
+    [[nodiscard]] const ArenaConfig &config() const noexcept {
+        return config_;
+    }
+private:
+    struct Block {
+        char *data = nullptr; // Huge page aligned
+        size_t size = 0;
+    };
+
+    bool map_block(size_t min_size);
+
+    ArenaConfig config_;
+    std::vector<Block> blocks_;
+    size_t current_ = 0; // Block being filled
+    size_t offset_ = 0; // Fill position in current block
+    ArenaStats stats_;
+};
+
+/**
+ * @brief std::pmr adapter, so that pmr containers can use an arena
+ *
+ * Deallocation is a no-op; memory returns on Arena::reset().
+ */
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(Arena &arena) noexcept : arena_(&arena) {
+    }
+
+    [[nodiscard]] Arena &arena() const noexcept {
+        return *arena_;
+    }
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        return arena_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *, size_t, size_t) override {
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        const auto *resource = dynamic_cast<const ArenaResource *>(&other);
+        return resource && resource->arena_ == arena_;
+    }
+
+    Arena *arena_;
+};
+
+} // namespace wikilib
@@ -0,0 +1,88 @@
+#pragma once
+
+/**
+ * @file bloom_filter.h
+ * @brief Blocked Bloom filter for fast negative membership checks
+ *
+ * Each key maps to one 32-byte block and sets one bit in each of the
+ * block's eight 32-bit words, so a lookup touches a single cache line.
+ * At the default 10 bits per key the false positive rate is about 1%,
+ * and a filter over several million titles stays small enough to live
+ * in L2/L3 while the exact hash map it guards does not.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "wikilib/core/types.h"
+
+namespace wikilib {
+
+/**
+ * @brief Split-block Bloom filter over strings
+ *
+ * Example usage:
+ * @code
+ *   BloomFilter filter(titles.size());
+ *   for (const auto &title: titles) {
+ *       filter.insert(title);
+ *   }
+ *   if (filter.may_contain(link_target) && exact_index.contains(link_target)) {
+ *       ...
+ *   }
+ * @endcode
+ */
+class BloomFilter {
+public:
+    /**
+     * @brief Empty filter; may_contain() is true for every key
+     */
+    BloomFilter() = default;
+
+    /**
+     * @brief Filter sized for expected_items keys
+     */
+    explicit BloomFilter(size_t expected_items, double bits_per_item = 10.0);
+
+    void insert(std::string_view key) noexcept;
+
+    /**
+     * @brief False only if key was never inserted
+     */
+    [[nodiscard]] bool may_contain(std::string_view key) const noexcept;
+
+    /**
+     * @brief True for a default-constructed filter (no information)
+     */
+    [[nodiscard]] bool empty() const noexcept {
+        return blocks_.empty();
+    }
+
+    [[nodiscard]] size_t size_bytes() const noexcept {
+        return blocks_.size() * sizeof(Block);
+    }
+
+    /**
+     * @brief Serialized form for storing next to an index
+     *
+     * The hash is fixed, so a filter saved by one build can be loaded by
+     * another on a machine of the same byte order.
+     */
+    [[nodiscard]] std::string serialize() const;
+
+    [[nodiscard]] static Result<BloomFilter> deserialize(std::string_view data);
+private:
+    struct alignas(32) Block {
+        uint32_t words[8];
+    };
+
+    [[nodiscard]] size_t block_index(uint64_t hash) const noexcept {
+        return static_cast<size_t>(((hash >> 32) * blocks_.size()) >> 32);
+    }
+
+    std::vector<Block> blocks_;
+};
+
+} // namespace wikilib
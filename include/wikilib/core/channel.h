@@ -0,0 +1,153 @@
+#pragma once
+
+/**
+ * @file channel.h
+ * @brief Bounded multi-producer multi-consumer queue
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace wikilib {
+
+/**
+ * @brief Bounded MPMC channel
+ *
+ * push() blocks while the channel is full, pop() while it is empty, which
+ * keeps a fast producer from running ahead of its consumers. After
+ * close(), pushes fail and pops drain the remaining items.
+ *
+ * Example usage:
+ * @code
+ *   Channel<std::string> pages(64);
+ *   // Producer: pages.push(std::move(xml)); ... pages.close();
+ *   while (auto xml = pages.pop()) {
+ *       process(*xml);
+ *   }
+ * @endcode
+ */
+template<typename T>
+class Channel {
+public:
+    explicit Channel(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {
+    }
+
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+    /**
+     * @brief Add an item, waiting for space
+     * @return false if the channel is closed (item is dropped)
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Add an item if there is space
+     * @return false if the channel is full or closed; item is then not moved from
+     */
+    bool try_push(T &&item) {
+        return try_emplace(std::move(item));
+    }
+
+    /**
+     * @brief Add a copy of an item if there is space
+     * @return false if the channel is full or closed
+     */
+    bool try_push(const T &item) {
+        return try_emplace(item);
+    }
+
+    /**
+     * @brief Take the oldest item, waiting for one
+     * @return nullopt once the channel is closed and empty
+     */
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        return take(lock);
+    }
+
+    /**
+     * @brief Take the oldest item if there is one
+     */
+    std::optional<T> try_pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        return take(lock);
+    }
+
+    /**
+     * @brief Stop accepting items and wake all waiters
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    [[nodiscard]] bool closed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    [[nodiscard]] size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return capacity_;
+    }
+private:
+    template<typename U>
+    bool try_emplace(U &&item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_ || items_.size() >= capacity_) {
+                return false;
+            }
+            items_.push_back(std::forward<U>(item));
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    T take(std::unique_lock<std::mutex> &lock) {
+        T item = std::move(items_.front());
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return item;
+    }
+
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> items_;
+    bool closed_ = false;
+};
+
+} // namespace wikilib
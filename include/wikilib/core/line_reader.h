@@ -5,10 +5,12 @@
  * @brief Buffered line reader with support for various input sources
  */
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace wikilib::core {
 
@@ -126,4 +128,82 @@ private:
     bool eof_ = false;
 };
 
+// ============================================================================
+// Memory-mapped line reader
+// ============================================================================
+
+/**
+ * @brief Zero-copy line reader over a memory-mapped file
+ *
+ * Lines end at \n; a \r before it is dropped. Lines are found with
+ * memchr, which glibc vectorises, and returned as views into the
+ * mapping. For multi-threaded consumers, split() divides the remaining
+ * input at line boundaries into readers that share the mapping.
+ *
+ * Example usage:
+ * @code
+ *   MmapLineReader reader("index.txt");
+ *   while (auto line = reader.read_line_view()) {
+ *       process(*line);
+ *   }
+ * @endcode
+ */
+class MmapLineReader : public LineReader {
+public:
+    /**
+     * @brief Map a file; check is_open() afterwards
+     */
+    explicit MmapLineReader(const std::string& path);
+
+    /**
+     * @brief Read lines from caller-owned memory
+     */
+    static MmapLineReader from_string(std::string_view data);
+
+    /**
+     * @brief Next line without its terminator, nullopt at end of input
+     *
+     * The view stays valid as long as this reader or any reader split
+     * from it exists.
+     */
+    [[nodiscard]] std::optional<std::string_view> read_line_view();
+
+    bool read_line(std::string& line) override;
+    [[nodiscard]] bool eof() const noexcept override;
+
+    /**
+     * @brief Divide the unread input into up to parts readers
+     *
+     * Every part except the last ends just after a newline, so each line
+     * belongs to exactly one part. Empty parts are omitted. This reader
+     * is left unchanged.
+     */
+    [[nodiscard]] std::vector<MmapLineReader> split(size_t parts) const;
+
+    [[nodiscard]] bool is_open() const noexcept {
+        return error_.empty();
+    }
+
+    [[nodiscard]] std::string_view error() const noexcept {
+        return error_;
+    }
+
+    /**
+     * @brief Unread input
+     */
+    [[nodiscard]] std::string_view remaining() const noexcept {
+        return data_.substr(position_);
+    }
+
+private:
+    struct Mapping;
+
+    MmapLineReader() = default;
+
+    std::shared_ptr<const Mapping> mapping_;
+    std::string_view data_;
+    size_t position_ = 0;
+    std::string error_;
+};
+
 } // namespace wikilib::core
@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * @file namespace_resolver.h
+ * @brief Namespace classification of page titles and link targets
+ *
+ * Names are matched case-insensitively (ASCII letters fold, '_' equals
+ * ' ') through a perfect hash built once per site, so classifying a title
+ * costs one hash of the text before the first colon and one comparison.
+ */
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "wikilib/core/types.h"
+
+namespace wikilib {
+
+/**
+ * @brief Canonical (English) name of a built-in namespace
+ * @return Empty for the main namespace and unknown ids
+ */
+[[nodiscard]] std::string_view canonical_namespace_name(NamespaceId id) noexcept;
+
+/**
+ * @brief Title split into namespace and local part
+ */
+struct ResolvedTitle {
+    NamespaceId namespace_id = NS_MAIN;
+    std::string_view prefix; // Namespace text as written (empty for main)
+    std::string_view local; // Text after the namespace colon
+};
+
+/**
+ * @brief Maps namespace names and aliases to namespace ids
+ *
+ * Canonical English names (and the "Image" alias) are always known, as in
+ * MediaWiki; localized names come from the dump's siteinfo. Non-ASCII
+ * names match as written or fully lower-cased.
+ */
+class NamespaceResolver {
+public:
+    using Alias = std::pair<std::string_view, NamespaceId>;
+
+    /**
+     * @brief Resolver for canonical names only
+     */
+    NamespaceResolver();
+
+    /**
+     * @brief Resolver for a site's namespaces plus extra aliases
+     */
+    explicit NamespaceResolver(std::span<const Namespace> namespaces, std::span<const Alias> aliases = {});
+
+    /**
+     * @brief Shared resolver used when no site is configured
+     *
+     * Canonical names plus the "Kategoria" alias the tokenizer has always
+     * accepted.
+     */
+    [[nodiscard]] static const NamespaceResolver &builtin();
+
+    /**
+     * @brief Look up a namespace name (surrounding spaces are ignored)
+     */
+    [[nodiscard]] std::optional<NamespaceId> find(std::string_view name) const noexcept;
+
+    /**
+     * @brief Classify a title by the text before its first colon
+     *
+     * Titles without a known namespace prefix are in the main namespace.
+     */
+    [[nodiscard]] ResolvedTitle resolve(std::string_view title) const noexcept;
+
+    /**
+     * @brief Namespace id of a title or link target
+     */
+    [[nodiscard]] NamespaceId namespace_of(std::string_view title) const noexcept {
+        return resolve(title).namespace_id;
+    }
+
+    /**
+     * @brief Number of distinct names
+     */
+    [[nodiscard]] size_t size() const noexcept {
+        return names_;
+    }
+
+    /**
+     * @brief Length of the longest name (bounds the search for a colon)
+     */
+    [[nodiscard]] size_t max_length() const noexcept {
+        return max_length_;
+    }
+private:
+    struct Slot {
+        uint32_t offset = 0; // Folded key in keys_
+        uint32_t length = 0; // 0 = empty slot
+        NamespaceId id = NS_MAIN;
+    };
+
+    void build(std::vector<std::pair<std::string, NamespaceId>> names);
+
+    std::string keys_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> seeds_; // Displacement per bucket
+    uint32_t slot_mask_ = 0;
+    uint32_t bucket_mask_ = 0;
+    size_t max_length_ = 0;
+    size_t names_ = 0;
+};
+
+} // namespace wikilib
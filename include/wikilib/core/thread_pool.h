@@ -0,0 +1,381 @@
+#pragma once
+
+/**
+ * @file thread_pool.h
+ * @brief Work-stealing task pool, futures and parallel loops
+ *
+ * One pool is meant to be shared by every parallel part of the library so
+ * that nested or concurrent jobs do not oversubscribe the cores. Each
+ * worker owns a deque: it pushes and pops its own tasks at the back, idle
+ * workers steal from the front of the others. Tasks submitted from
+ * outside the pool go to a shared injection queue.
+ */
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace wikilib {
+
+class ThreadPool;
+
+template<typename T>
+class Future;
+
+template<typename T>
+class Promise;
+
+// ============================================================================
+// Futures
+// ============================================================================
+
+namespace detail {
+
+/**
+ * @brief State shared by a promise and its future
+ */
+template<typename T>
+struct FutureState {
+    using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    std::mutex mutex;
+    std::condition_variable ready_cv;
+    std::optional<Value> value;
+    std::exception_ptr error;
+    bool ready = false;
+    std::vector<std::move_only_function<void()>> continuations; // Run once ready
+    ThreadPool *pool = nullptr; // Runs continuations, helped while waiting
+
+    void complete() {
+        std::vector<std::move_only_function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready = true;
+            pending.swap(continuations);
+        }
+        ready_cv.notify_all();
+        for (auto &continuation: pending) {
+            continuation();
+        }
+    }
+};
+
+/**
+ * @brief Result of a continuation taking T (nothing for void)
+ */
+template<typename F, typename T>
+struct ContinuationResult {
+    using type = std::invoke_result_t<F, T>;
+};
+
+template<typename F>
+struct ContinuationResult<F, void> {
+    using type = std::invoke_result_t<F>;
+};
+
+template<typename F, typename T>
+using continuation_result_t = typename ContinuationResult<F, T>::type;
+
+/**
+ * @brief Wait for a state, running pool tasks meanwhile on pool threads
+ */
+template<typename T>
+void wait_ready(FutureState<T> &state);
+
+} // namespace detail
+
+/**
+ * @brief Producer side of a Future
+ */
+template<typename T>
+class Promise {
+public:
+    explicit Promise(ThreadPool *pool = nullptr) : state_(std::make_shared<detail::FutureState<T>>()) {
+        state_->pool = pool;
+    }
+
+    [[nodiscard]] Future<T> get_future() const {
+        return Future<T>(state_);
+    }
+
+    template<typename... Args>
+    void set_value(Args &&...args) {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->value.emplace(std::forward<Args>(args)...);
+        }
+        state_->complete();
+    }
+
+    void set_exception(std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->error = std::move(error);
+        }
+        state_->complete();
+    }
+private:
+    std::shared_ptr<detail::FutureState<T>> state_;
+};
+
+/**
+ * @brief Result of a task submitted to a ThreadPool
+ *
+ * Like std::future the result is consumed once: get() and then() leave
+ * the future invalid. get() rethrows an exception thrown by the task.
+ * Waiting on a pool thread runs other pool tasks instead of blocking the
+ * worker.
+ */
+template<typename T>
+class Future {
+public:
+    Future() = default;
+
+    [[nodiscard]] bool valid() const noexcept {
+        return state_ != nullptr;
+    }
+
+    [[nodiscard]] bool ready() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->ready;
+    }
+
+    void wait() const {
+        detail::wait_ready(*state_);
+    }
+
+    /**
+     * @brief Wait and return the value (moved out for non-void T)
+     *
+     * The future is invalid afterwards.
+     */
+    T get() {
+        assert(valid());
+        std::shared_ptr<detail::FutureState<T>> state = std::move(state_);
+        detail::wait_ready(*state);
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*state->value);
+        }
+    }
+
+    /**
+     * @brief Run f with the value once it is available
+     *
+     * The continuation runs as a pool task and takes over the value, so
+     * this future is invalid afterwards. An exception of this future is
+     * passed on to the returned one without calling f.
+     */
+    template<typename F>
+    auto then(F &&f) -> Future<detail::continuation_result_t<F, T>>;
+private:
+    template<typename>
+    friend class Promise;
+
+    template<typename>
+    friend class Future;
+
+    explicit Future(std::shared_ptr<detail::FutureState<T>> state) : state_(std::move(state)) {
+    }
+
+    std::shared_ptr<detail::FutureState<T>> state_;
+};
+
+// ============================================================================
+// Thread pool
+// ============================================================================
+
+/**
+ * @brief Configuration for ThreadPool
+ */
+struct ThreadPoolConfig {
+    size_t threads = 0; // Worker threads (0 = hardware concurrency)
+    bool pin_workers = false; // Pin workers to CPUs, filling one NUMA node before the next (Linux)
+};
+
+/**
+ * @brief Work-stealing task pool
+ *
+ * Example usage:
+ * @code
+ *   ThreadPool pool;
+ *   auto size = pool.submit([] { return count_pages(); });
+ *   auto text = size.then([](size_t n) { return std::to_string(n); });
+ *   std::cout << text.get() << '\n';
+ * @endcode
+ */
+class ThreadPool {
+public:
+    using Task = std::move_only_function<void()>;
+
+    explicit ThreadPool(ThreadPoolConfig config = {});
+
+    /**
+     * @brief Run all queued tasks, then stop the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Process-wide pool with one worker per hardware thread
+     */
+    [[nodiscard]] static ThreadPool &shared();
+
+    /**
+     * @brief Number of worker threads
+     */
+    [[nodiscard]] size_t size() const noexcept;
+
+    /**
+     * @brief Index of the calling worker of this pool, or -1
+     */
+    [[nodiscard]] int current_worker() const noexcept;
+
+    /**
+     * @brief Queue a task without a result
+     *
+     * From a worker of this pool the task goes to that worker's own deque.
+     */
+    void post(Task task);
+
+    /**
+     * @brief Queue a callable and get a future of its result
+     */
+    template<typename F>
+    auto submit(F &&f) -> Future<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        Promise<R> promise(this);
+        Future<R> future = promise.get_future();
+        post([promise = std::move(promise), f = std::forward<F>(f)]() mutable {
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    f();
+                    promise.set_value();
+                } else {
+                    promise.set_value(f());
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
+        return future;
+    }
+
+    /**
+     * @brief Run one queued task on the calling thread
+     * @return false if no task was available
+     */
+    bool run_pending_task();
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Run body over [begin, end) split into chunks on the pool
+ *
+ * body receives half-open sub-ranges of at least grain indices
+ * (0 = picked from the pool size). The calling thread works on chunks
+ * too and returns once all are done; the first exception thrown by body
+ * is rethrown.
+ */
+void parallel_for(ThreadPool &pool, size_t begin, size_t end, const std::function<void(size_t, size_t)> &body,
+                  size_t grain = 0);
+
+/**
+ * @brief parallel_for on the shared pool
+ */
+inline void parallel_for(size_t begin, size_t end, const std::function<void(size_t, size_t)> &body,
+                         size_t grain = 0) {
+    parallel_for(ThreadPool::shared(), begin, end, body, grain);
+}
+
+// ============================================================================
+// Template implementation
+// ============================================================================
+
+namespace detail {
+
+template<typename T>
+void wait_ready(FutureState<T> &state) {
+    ThreadPool *pool = state.pool;
+    bool on_pool = pool && pool->current_worker() >= 0;
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.ready) {
+        if (!on_pool) {
+            state.ready_cv.wait(lock);
+            continue;
+        }
+        // A blocked worker could hold up the task it waits for
+        lock.unlock();
+        bool ran = pool->run_pending_task();
+        lock.lock();
+        if (!ran && !state.ready) {
+            state.ready_cv.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+template<typename F>
+auto Future<T>::then(F &&f)
+        -> Future<detail::continuation_result_t<F, T>> {
+    assert(valid());
+    using R = detail::continuation_result_t<F, T>;
+    std::shared_ptr<detail::FutureState<T>> state = std::move(state_);
+    ThreadPool *pool = state->pool ? state->pool : &ThreadPool::shared();
+    Promise<R> promise(pool);
+    Future<R> next = promise.get_future();
+
+    auto run = [state, promise = std::move(promise), f = std::forward<F>(f)]() mutable {
+        if (state->error) {
+            promise.set_exception(state->error);
+            return;
+        }
+        try {
+            if constexpr (std::is_void_v<R>) {
+                if constexpr (std::is_void_v<T>) {
+                    f();
+                } else {
+                    f(std::move(*state->value));
+                }
+                promise.set_value();
+            } else if constexpr (std::is_void_v<T>) {
+                promise.set_value(f());
+            } else {
+                promise.set_value(f(std::move(*state->value)));
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    };
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (state->ready) {
+        lock.unlock();
+        pool->post(std::move(run));
+    } else {
+        state->continuations.emplace_back([pool, run = std::move(run)]() mutable { pool->post(std::move(run)); });
+    }
+    return next;
+}
+
+} // namespace wikilib
@@ -5,6 +5,7 @@
  * @brief Fundamental type definitions for wikilib
  */
 
+#include <array>
 #include <cstdint>
 #include <expected>
 #include <memory>
@@ -74,16 +75,86 @@ enum class ErrorSeverity {
     Fatal // Unrecoverable error, parsing stops
 };
 
+/**
+ * @brief Codes of errors raised by the tokenizer and parser
+ *
+ * Coded errors carry no message; the text comes from error_code_message()
+ * when the error is formatted.
+ */
+enum class ErrorCode : uint8_t {
+    None, // Free-form error, see message
+    MaxDepthExceeded
+};
+
+inline constexpr size_t ERROR_CODE_COUNT = static_cast<size_t>(ErrorCode::MaxDepthExceeded) + 1;
+
+/**
+ * @brief Message text for an error code
+ */
+[[nodiscard]] std::string_view error_code_message(ErrorCode code) noexcept;
+
+/**
+ * @brief How the tokenizer and parser record errors
+ */
+enum class ErrorReporting : uint8_t {
+    Off, // Errors are dropped
+    Counters, // Only ErrorCounts are updated
+    Compact // Counters plus a ParseError with code and location per error
+};
+
+/**
+ * @brief Error tallies by code and severity
+ */
+struct ErrorCounts {
+    std::array<uint32_t, ERROR_CODE_COUNT> by_code{};
+    std::array<uint32_t, 3> by_severity{};
+
+    void add(ErrorCode code, ErrorSeverity severity) noexcept {
+        by_code[static_cast<size_t>(code)]++;
+        by_severity[static_cast<size_t>(severity)]++;
+    }
+
+    void merge(const ErrorCounts &other) noexcept {
+        for (size_t i = 0; i < by_code.size(); ++i) {
+            by_code[i] += other.by_code[i];
+        }
+        for (size_t i = 0; i < by_severity.size(); ++i) {
+            by_severity[i] += other.by_severity[i];
+        }
+    }
+
+    [[nodiscard]] uint32_t count(ErrorCode code) const noexcept {
+        return by_code[static_cast<size_t>(code)];
+    }
+
+    [[nodiscard]] uint32_t count(ErrorSeverity severity) const noexcept {
+        return by_severity[static_cast<size_t>(severity)];
+    }
+
+    [[nodiscard]] uint32_t total() const noexcept {
+        return by_severity[0] + by_severity[1] + by_severity[2];
+    }
+};
+
 /**
  * @brief Parse error information
  */
 struct ParseError {
-    std::string message;
+    std::string message; // Empty for coded errors
     SourceRange location;
     ErrorSeverity severity = ErrorSeverity::Error;
     std::string context; // Surrounding text for error messages
+    ErrorCode code = ErrorCode::None;
 
     [[nodiscard]] std::string format() const;
+
+    /**
+     * @brief Format with context taken from the parsed source
+     *
+     * Coded errors store only offsets; the source supplies the surrounding
+     * text when context is empty.
+     */
+    [[nodiscard]] std::string format(std::string_view source) const;
 };
 
 /**
@@ -108,9 +179,25 @@ struct Namespace {
     bool allow_subpages = false;
 };
 
+// Ids of the built-in namespaces (the same on every wiki)
+inline constexpr NamespaceId NS_MEDIA = -2;
+inline constexpr NamespaceId NS_SPECIAL = -1;
+inline constexpr NamespaceId NS_MAIN = 0;
+inline constexpr NamespaceId NS_TALK = 1;
+inline constexpr NamespaceId NS_USER = 2;
+inline constexpr NamespaceId NS_PROJECT = 4;
+inline constexpr NamespaceId NS_FILE = 6;
+inline constexpr NamespaceId NS_MEDIAWIKI = 8;
+inline constexpr NamespaceId NS_TEMPLATE = 10;
+inline constexpr NamespaceId NS_HELP = 12;
+inline constexpr NamespaceId NS_CATEGORY = 14;
+inline constexpr NamespaceId NS_MODULE = 828;
+
 /**
  * @brief Page metadata
  */
+class NamespaceResolver;
+
 struct PageInfo {
     PageId id = 0;
     std::string title;
@@ -123,7 +210,16 @@ struct PageInfo {
         return redirect_target.has_value();
     }
 
+    /**
+     * @brief Title with its namespace prefix
+     *
+     * A title whose text before the first colon resolves to namespace_id
+     * already carries its prefix and is returned as is; any other title
+     * outside the main namespace gets the canonical prefix. Pass the site's
+     * resolver so localized dump prefixes ("Szablon:Kot") are recognized.
+     */
     [[nodiscard]] std::string full_title() const;
+    [[nodiscard]] std::string full_title(const NamespaceResolver &resolver) const;
 };
 
 // ============================================================================
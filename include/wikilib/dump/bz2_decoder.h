@@ -0,0 +1,140 @@
+#pragma once
+
+/**
+ * @file bz2_decoder.h
+ * @brief In-tree bzip2 decoder and runtime backend selection
+ *
+ * The native decoder decodes Huffman symbols through per-table lookups of
+ * the next 10 bits, resolving two short codes at once where they fit,
+ * undoes the BWT over a packed index/byte vector and verifies block and
+ * stream CRCs, producing the same bytes as libbz2.
+ * Blocks of one stream are independent once their start bit is known, so
+ * with a thread pool the decoder locates block headers by bit pattern and
+ * decodes them in parallel, falling back to sequential decoding for any
+ * block whose boundaries do not chain up.
+ *
+ * Output is written straight into the caller's string or arena block;
+ * Bz2FileDecoder decodes a file block by block for Bz2Stream.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "wikilib/core/arena.h"
+#include "wikilib/core/types.h"
+
+namespace wikilib {
+class ThreadPool;
+}
+
+namespace wikilib::dump {
+
+/**
+ * @brief Decoder used for in-memory BZ2 decompression
+ */
+enum class Bz2Backend : uint8_t {
+    Libbz2,
+    Native
+};
+
+/**
+ * @brief Select the decoder for decompress_bz2(), decompress_bz2_blocks(),
+ *        DumpReader chunks and page lookups, and Bz2Stream
+ *
+ * The initial backend is Native if WIKILIB_BZ2_BACKEND=native is set in
+ * the environment, libbz2 otherwise. A Bz2Stream keeps the backend that
+ * was selected when it was opened. The native backend reports its own
+ * errors; data it cannot decode (randomised blocks) needs libbz2.
+ */
+void set_bz2_backend(Bz2Backend backend) noexcept;
+
+[[nodiscard]] Bz2Backend bz2_backend() noexcept;
+
+/**
+ * @brief Options for native_decompress_bz2
+ */
+struct Bz2DecodeConfig {
+    ThreadPool *pool = nullptr; // Decode the blocks of a stream in parallel
+    size_t min_parallel_size = 1 << 20; // Smaller inputs are decoded on the calling thread
+};
+
+/**
+ * @brief Decompress BZ2 data (one or more concatenated streams) in-tree
+ *
+ * Randomised blocks (written only by bzip2 0.9.0 and older) are
+ * rejected.
+ */
+[[nodiscard]] Result<std::string> native_decompress_bz2(std::string_view compressed,
+                                                        const Bz2DecodeConfig &config = {});
+
+/**
+ * @brief Decompress BZ2 data into one arena block
+ *
+ * The block starts at an estimate of the output size and is moved to a
+ * larger one if needed; the unused tail goes back to the arena.
+ *
+ * @return Decompressed data, valid until the arena is reset
+ */
+[[nodiscard]] Result<std::string_view> native_decompress_bz2(std::string_view compressed, Arena &arena,
+                                                             const Bz2DecodeConfig &config = {});
+
+/**
+ * @brief Decompress one BZ2 stream in-tree, handing out each block as it is
+ *        decoded
+ *
+ * Native counterpart of decompress_bz2_blocks(): every bzip2 block (up to
+ * 900 kB of output) is decoded and CRC-checked whole, then passed to
+ * on_output in pieces of at most block_size bytes until it returns false.
+ *
+ * @return Decompressed bytes handed out (up to the stop)
+ */
+[[nodiscard]] Result<uint64_t> native_decompress_bz2_blocks(std::string_view compressed,
+                                                            const std::function<bool(std::string_view)> &on_output,
+                                                            size_t block_size = 64 * 1024);
+
+/**
+ * @brief Incremental native decoder over a BZ2 file
+ *
+ * Reads compressed data ahead of the current block (about 1.5 block sizes,
+ * more if a block does not fit) and hands out one decoded block at a time.
+ * Concatenated streams are decoded in sequence; bytes after the last
+ * stream are ignored.
+ */
+class Bz2FileDecoder {
+public:
+    /**
+     * @brief Decode from the current position of file (not owned)
+     */
+    explicit Bz2FileDecoder(FILE *file);
+
+    ~Bz2FileDecoder();
+
+    Bz2FileDecoder(const Bz2FileDecoder &) = delete;
+    Bz2FileDecoder &operator=(const Bz2FileDecoder &) = delete;
+
+    /**
+     * @brief Read up to n decompressed bytes
+     * @return Number of bytes read; 0 at the end or after an error
+     */
+    size_t read(char *buffer, size_t n);
+
+    [[nodiscard]] bool eof() const noexcept;
+
+    /**
+     * @brief Error message, empty if none
+     */
+    [[nodiscard]] std::string_view error() const noexcept;
+
+    /**
+     * @brief Drop buffered data and restart at the file's current position
+     */
+    void reset();
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace wikilib::dump
@@ -10,6 +10,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include "wikilib/core/arena.h"
 #include "wikilib/core/types.h"
 
 namespace wikilib::dump {
@@ -68,6 +69,17 @@ public:
      */
     [[nodiscard]] std::optional<std::string> read_line();
 
+    /**
+     * @brief Read line without copying it out of the decompression buffer
+     *
+     * Lines are located with memchr in the internal buffer. Only a line that
+     * straddles a buffer refill is assembled in a separate carry buffer.
+     *
+     * @return View of line content (without newline) or nullopt at EOF.
+     *         The view is valid until the next call to any read method.
+     */
+    [[nodiscard]] std::optional<std::string_view> read_line_view();
+
     /**
      * @brief Read all remaining content
      */
@@ -112,6 +124,31 @@ private:
  */
 [[nodiscard]] Result<std::string> decompress_bz2(std::string_view compressed);
 
+/**
+ * @brief Decompress BZ2 data into arena memory
+ *
+ * Avoids a heap allocation per chunk for workers that reset their arena
+ * between chunks.
+ *
+ * @return Decompressed data, valid until the arena is reset
+ */
+[[nodiscard]] Result<std::string_view> decompress_bz2(std::string_view compressed, Arena &arena);
+
+/**
+ * @brief Decompress one BZ2 stream piece by piece
+ *
+ * on_output receives each block of output as soon as it is produced and
+ * returns false to stop decompressing, so a caller looking for something
+ * near the start of a chunk does not pay for the rest of it. The native
+ * backend decodes a whole bzip2 block before handing out its pieces.
+ *
+ * @param block_size Output block size
+ * @return Decompressed bytes produced (up to the stop)
+ */
+[[nodiscard]] Result<uint64_t> decompress_bz2_blocks(std::string_view compressed,
+                                                     const std::function<bool(std::string_view)> &on_output,
+                                                     size_t block_size = 64 * 1024);
+
 /**
  * @brief Compress data to BZ2
  */
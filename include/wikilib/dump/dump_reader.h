@@ -10,8 +10,11 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
+#include "wikilib/core/bloom_filter.h"
+#include "wikilib/core/types.h"
 #include "wikilib/dump/dump_path.h"
 #include "wikilib/dump/index_chunker.h"
 
@@ -109,6 +112,15 @@ public:
      */
     [[nodiscard]] bool has_page(const std::string& title) const;
 
+    /**
+     * @brief Bloom filter over all indexed titles
+     *
+     * Built by load_index(); has_page() and get_page_info() consult it
+     * before the exact index. It can be shared with a TemplateExpander
+     * (ExpanderConfig::existing_titles) or saved with serialize().
+     */
+    [[nodiscard]] const BloomFilter& title_filter() const noexcept;
+
     /**
      * @brief Get indexed page info
      */
@@ -116,6 +128,8 @@ public:
 
     /**
      * @brief Extract a single page by title
+     *
+     * Decompresses its chunk only up to the end of the page.
      */
     [[nodiscard]] ExtractedPage extract_page(const std::string& title);
 
@@ -201,6 +215,21 @@ private:
     const std::string& xml_chunk
 );
 
+/**
+ * @brief Extract a page from a compressed chunk, decompressing only up to it
+ *
+ * Output is scanned for the title block by block and decompression stops
+ * right after the matching </page>.
+ *
+ * @param title Page title to find
+ * @param compressed_chunk One BZ2 stream of a multistream dump
+ * @return Page content, empty if the chunk has no such page
+ */
+[[nodiscard]] Result<std::string> extract_page_from_bz2(
+    const std::string& title,
+    std::string_view compressed_chunk
+);
+
 /**
  * @brief Extract all pages from XML chunk
  * @param xml_chunk Decompressed XML content
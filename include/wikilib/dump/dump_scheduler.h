@@ -0,0 +1,163 @@
+#pragma once
+
+/**
+ * @file dump_scheduler.h
+ * @brief Concurrent processing of many dumps (languages, projects) at once
+ *
+ * Dumps are cut into tasks of compressed byte ranges: small dumps are a
+ * single task covering the whole file, dumps above a size threshold are
+ * split at stream boundaries taken from their index. All tasks share one
+ * pool of workers and are started largest first; idle workers steal the
+ * largest pending task of another worker, so small dumps fill the cores
+ * while the large ones are still running.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "wikilib/core/thread_pool.h"
+#include "wikilib/dump/dump_path.h"
+#include "wikilib/dump/page_handler.h"
+
+namespace wikilib::dump {
+
+/**
+ * @brief Configuration for dump scheduler
+ */
+struct DumpSchedulerConfig {
+    size_t threads = 0; // Worker threads (0 = hardware concurrency)
+    ThreadPool *pool = nullptr; // If non-null, process dumps on this pool and ignore threads
+    uint64_t split_threshold = 256ull << 20; // Dumps larger than this are split using the index
+    uint64_t task_bytes = 64ull << 20; // Target compressed bytes per split task
+    size_t sink_flush_bytes = 4ull << 20; // Task output buffered before writing to the sink
+};
+
+/**
+ * @brief Progress of one dump
+ */
+struct DumpProgress {
+    std::string name; // Symbolic name, e.g. "plwiktionary-20260101"
+    uint64_t bytes_total = 0; // Compressed size
+    uint64_t bytes_done = 0; // Compressed bytes of finished tasks
+    uint64_t pages = 0;
+    size_t tasks_total = 0;
+    size_t tasks_done = 0;
+    bool finished = false;
+    std::string error; // First error of this dump, empty on success
+};
+
+/**
+ * @brief Output destination of one dump
+ *
+ * Calls for the same dump are serialized by the scheduler. Output of split
+ * dumps arrives per task, so records are not necessarily in dump order.
+ */
+class DumpSink {
+public:
+    virtual ~DumpSink() = default;
+
+    virtual void write(std::string_view data) = 0;
+
+    /**
+     * @brief Called once when all tasks of the dump are done
+     */
+    virtual void close() {
+    }
+};
+
+/**
+ * @brief Sink appending to a file (truncated on creation)
+ */
+[[nodiscard]] std::unique_ptr<DumpSink> make_file_sink(const std::filesystem::path &path);
+
+/**
+ * @brief Multi-dump job scheduler
+ *
+ * Example usage:
+ * @code
+ *   DumpPath base("/path/to/wikimedia-dump-fetcher");
+ *   base.set_project(WikiProject::Wiktionary);
+ *
+ *   DumpScheduler scheduler;
+ *   scheduler.add_project(base);
+ *   scheduler.set_sink_factory([](const DumpPath& dump) {
+ *       return make_file_sink("out/" + dump.symbolic_name() + ".tsv");
+ *   });
+ *   scheduler.run([](const DumpPath&, const Page& page, std::string& out) {
+ *       out += page.info.title;
+ *       out += '\n';
+ *   });
+ * @endcode
+ */
+class DumpScheduler {
+public:
+    /**
+     * @brief Called for every page; append output records to out
+     *
+     * Runs concurrently on worker threads, also for pages of the same dump.
+     */
+    using PageProcessor = std::function<void(const DumpPath &dump, const Page &page, std::string &out)>;
+    using SinkFactory = std::function<std::unique_ptr<DumpSink>(const DumpPath &dump)>;
+    using ProgressCallback = std::function<void(const DumpProgress &progress)>;
+
+    explicit DumpScheduler(DumpSchedulerConfig config = {});
+    ~DumpScheduler();
+
+    DumpScheduler(const DumpScheduler &) = delete;
+    DumpScheduler &operator=(const DumpScheduler &) = delete;
+
+    /**
+     * @brief Add a single dump
+     */
+    void add_dump(const DumpPath &dump);
+
+    /**
+     * @brief Add every language of the project and date of base
+     *
+     * Languages come from DumpPath::available_languages(); those without
+     * an index file are skipped.
+     *
+     * @return Number of dumps added
+     */
+    size_t add_project(const DumpPath &base);
+
+    /**
+     * @brief Create an output sink per dump (default: output is discarded)
+     */
+    void set_sink_factory(SinkFactory factory);
+
+    /**
+     * @brief Called after each finished task with that dump's progress
+     *
+     * Calls are serialized.
+     */
+    void set_progress_callback(ProgressCallback callback);
+
+    /**
+     * @brief Process all added dumps
+     *
+     * A failing dump does not stop the others.
+     *
+     * @return true if every dump was processed without error
+     */
+    bool run(const PageProcessor &processor);
+
+    /**
+     * @brief Progress of each dump, in the order they were added
+     */
+    [[nodiscard]] const std::vector<DumpProgress> &progress() const noexcept;
+
+    /**
+     * @brief Number of tasks planned by the last run()
+     */
+    [[nodiscard]] size_t task_count() const noexcept;
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace wikilib::dump
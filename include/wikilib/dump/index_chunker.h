@@ -6,6 +6,7 @@
  */
 
 #include <cstdint>
+#include <cstdio>
 #include <memory>
 #include <vector>
 #include "wikilib/core/line_reader.h"
@@ -124,6 +125,12 @@ private:
 // Utility functions
 // ============================================================================
 
+/**
+ * @brief Read compressed dump bytes [start, end) into out
+ * @return false on a seek error or short read
+ */
+bool read_dump_range(FILE* file, uint64_t start, uint64_t end, std::string& out);
+
 /**
  * @brief Load all chunks from index file
  * @param index_path Path to index file
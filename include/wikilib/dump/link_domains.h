@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * @file link_domains.h
+ * @brief Parallel per-domain external link statistics over a multistream dump
+ *
+ * Chunks from the index are handed out to workers on a ThreadPool, each
+ * of which reads and decompresses its chunks independently and counts
+ * links into its own DomainCounter. Counters are merged once all workers
+ * finish.
+ */
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "wikilib/core/thread_pool.h"
+#include "wikilib/core/types.h"
+#include "wikilib/markup/external_links.h"
+
+namespace wikilib::dump {
+
+/**
+ * @brief Configuration for link domain counting
+ */
+struct LinkDomainConfig {
+    size_t threads = 0; // Worker threads (0 = hardware concurrency)
+    ThreadPool *pool = nullptr; // If non-null, scan chunks on this pool and ignore threads
+    markup::UrlNormalizeOptions normalize;
+    std::optional<std::vector<NamespaceId>> namespaces; // Pages to scan (nullopt = all)
+};
+
+/**
+ * @brief Result of link domain counting
+ */
+struct LinkDomainResult {
+    bool success = false;
+    std::string error;
+
+    markup::DomainCounter domains;
+    uint64_t pages_scanned = 0;
+    uint64_t chunks_read = 0;
+};
+
+/**
+ * @brief Count external link domains of every page in a multistream dump
+ * @param dump_path Multistream dump (.xml.bz2)
+ * @param index_path Index (.txt or .txt.bz2)
+ * @param config Thread count, URL normalization and namespace filter
+ */
+[[nodiscard]] LinkDomainResult count_link_domains(const std::string &dump_path, const std::string &index_path,
+                                                  const LinkDomainConfig &config = {});
+
+} // namespace wikilib::dump
@@ -0,0 +1,134 @@
+#pragma once
+
+/**
+ * @file multistream_writer.h
+ * @brief Parallel writer for multistream BZ2 dumps with index
+ *
+ * Produces the same layout as Wikimedia "pages-articles-multistream" dumps:
+ *   stream 0:    <mediawiki ...><siteinfo>...</siteinfo>
+ *   stream 1..N: groups of pages (100 by default), one BZ2 stream each
+ *   last stream: </mediawiki>
+ *
+ * and a matching "-index.txt.bz2" with offset:page_id:title lines, so the
+ * output can be read back with DumpReader, IndexChunker and Bz2Stream.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "wikilib/core/thread_pool.h"
+#include "wikilib/core/types.h"
+
+namespace wikilib::dump {
+
+/**
+ * @brief Configuration for multistream writer
+ */
+struct MultistreamConfig {
+    size_t pages_per_stream = 100; // Pages per BZ2 stream (Wikimedia uses 100)
+    int compression_level = 9; // BZ2 block size 1-9
+    size_t threads = 0; // Compression threads (0 = hardware concurrency)
+    ThreadPool *pool = nullptr; // If non-null, compress streams on this pool and ignore threads
+    size_t max_pending_streams = 0; // Streams in flight before add_page blocks (0 = 4 per pool thread)
+};
+
+/**
+ * @brief Writes multistream BZ2 dump and index, compressing streams in parallel
+ *
+ * Page groups are compressed concurrently into independent BZ2 streams
+ * (pbzip2-style) as ThreadPool tasks and written to the dump file in
+ * submission order.
+ *
+ * Example usage:
+ * @code
+ *   MultistreamWriter writer("out-multistream.xml.bz2", "out-multistream-index.txt.bz2");
+ *   writer.write_header(header_xml);
+ *   writer.add_page(id, title, page_xml);  // <page>...</page>
+ *   writer.finish();
+ * @endcode
+ */
+class MultistreamWriter {
+public:
+    /**
+     * @brief Create writer for dump and index files
+     * @param dump_path Output path for multistream dump (.xml.bz2)
+     * @param index_path Output path for index (.txt.bz2)
+     */
+    MultistreamWriter(const std::string &dump_path, const std::string &index_path, MultistreamConfig config = {});
+
+    /**
+     * @brief Finishes writing if finish() was not called
+     */
+    ~MultistreamWriter();
+
+    // Non-copyable, non-movable (owns compression jobs in flight)
+    MultistreamWriter(const MultistreamWriter &) = delete;
+    MultistreamWriter &operator=(const MultistreamWriter &) = delete;
+
+    /**
+     * @brief Check if output files were opened successfully
+     */
+    [[nodiscard]] bool is_open() const noexcept;
+
+    /**
+     * @brief Write dump header (<mediawiki> and <siteinfo>) as its own stream
+     *
+     * Must be called before the first page, if at all.
+     */
+    void write_header(std::string_view header_xml);
+
+    /**
+     * @brief Add page to current stream
+     * @param id Page ID for the index
+     * @param title Page title for the index (unescaped)
+     * @param page_xml Complete <page>...</page> element
+     */
+    void add_page(PageId id, std::string_view title, std::string_view page_xml);
+
+    /**
+     * @brief Append an already compressed BZ2 stream verbatim
+     *
+     * Pending pages are flushed first so output order is preserved.
+     * Used to copy whole chunks from another multistream dump.
+     *
+     * @param compressed Complete BZ2 stream
+     * @param entries Index entries (page id, title) for pages in the stream
+     */
+    void add_compressed_stream(std::string_view compressed,
+                               const std::vector<std::pair<PageId, std::string>> &entries);
+
+    /**
+     * @brief Flush pending pages, write footer stream and close files
+     * @param footer_xml Content of the final stream
+     * @return true if everything was written successfully
+     */
+    bool finish(std::string_view footer_xml = "</mediawiki>\n");
+
+    /**
+     * @brief Writer statistics
+     */
+    struct Stats {
+        uint64_t pages_written = 0;
+        uint64_t streams_written = 0;
+        uint64_t bytes_uncompressed = 0;
+        uint64_t bytes_compressed = 0;
+    };
+
+    [[nodiscard]] const Stats &stats() const noexcept;
+
+    /**
+     * @brief Get the first error message
+     *
+     * After an error no further streams are written, so the dump and index
+     * on disk hold a consistent prefix of the pages added.
+     */
+    [[nodiscard]] std::string_view error() const noexcept;
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace wikilib::dump
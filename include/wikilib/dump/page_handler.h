@@ -11,6 +11,7 @@
 #include <string>
 #include <string_view>
 #include <vector>
+#include "wikilib/core/namespace_resolver.h"
 #include "wikilib/core/types.h"
 #include "wikilib/dump/xml_reader.h"
 
@@ -65,21 +66,21 @@ struct Page {
      * @brief Check if page is in main namespace
      */
     [[nodiscard]] bool is_main_namespace() const {
-        return info.namespace_id == 0;
+        return info.namespace_id == NS_MAIN;
     }
 
     /**
      * @brief Check if page is a template
      */
     [[nodiscard]] bool is_template() const {
-        return info.namespace_id == 10; // Template namespace
+        return info.namespace_id == NS_TEMPLATE;
     }
 
     /**
      * @brief Check if page is a module (Lua)
      */
     [[nodiscard]] bool is_module() const {
-        return info.namespace_id == 828; // Module namespace
+        return info.namespace_id == NS_MODULE;
     }
 };
 
@@ -101,7 +102,7 @@ struct PageFilter {
     std::optional<std::string> title_prefix;
     std::optional<std::string> title_contains;
     bool include_redirects = true;
-    bool only_latest_revision = true;
+    bool only_latest_revision = false; // Drop all but the last revision (makes write_subdump decompress kept chunks)
     std::optional<size_t> max_pages;
 
     [[nodiscard]] bool matches(const Page &page) const;
@@ -136,6 +137,9 @@ public:
 
     /**
      * @brief Process all pages with callback
+     *
+     * One Page is refilled for every page, so the reference passed to the
+     * callback is only valid until the callback returns.
      */
     void process(PageCallback callback);
 
@@ -154,6 +158,22 @@ public:
      */
     [[nodiscard]] std::optional<Page> next_page(const PageFilter &filter);
 
+    /**
+     * @brief Read the next page into an existing Page
+     *
+     * All fields are overwritten, but strings and the revisions vector
+     * keep their capacity, so a loop reusing one Page allocates almost
+     * nothing once buffers have grown to the largest page seen.
+     *
+     * @return false at end of dump (reuse is then unspecified)
+     */
+    bool next_page(Page &reuse);
+
+    /**
+     * @brief Read the next page matching filter into an existing Page
+     */
+    bool next_page(Page &reuse, const PageFilter &filter);
+
     /**
      * @brief Get site info from dump header
      */
@@ -162,7 +182,15 @@ public:
         std::string db_name;
         std::string base_url;
         std::string generator;
+        bool capital_links = false; // <case>first-letter</case>
         std::vector<Namespace> namespaces;
+
+        /**
+         * @brief Resolver for this site's namespace names
+         */
+        [[nodiscard]] NamespaceResolver namespace_resolver() const {
+            return NamespaceResolver(namespaces);
+        }
     };
 
     [[nodiscard]] const SiteInfo &site_info() const;
@@ -194,6 +222,47 @@ private:
     std::unique_ptr<Impl> impl_;
 };
 
+// ============================================================================
+// Page scanner
+// ============================================================================
+
+/**
+ * @brief Splits decompressed dump XML into pages
+ *
+ * Multistream chunks hold a run of <page> elements without the enclosing
+ * <mediawiki> document. scan() parses every complete page of a buffer with
+ * a single PageHandler and refills one Page owned by the scanner, handing
+ * each page to the callback together with its original XML.
+ *
+ * Example usage:
+ * @code
+ *   PageScanner scanner;
+ *   scanner.scan(xml, true, [&](std::string_view page_xml, const Page &page) {
+ *       writer.add_page(page.info.id, page.info.title, page_xml);
+ *       return true;
+ *   });
+ * @endcode
+ */
+class PageScanner {
+public:
+    /**
+     * @brief Called for each page; return false to stop scanning
+     *
+     * Both arguments are only valid until the callback returns.
+     */
+    using Callback = std::function<bool(std::string_view page_xml, const Page &page)>;
+
+    /**
+     * @brief Hand the complete pages of xml to callback
+     * @param final False if more XML follows; an unfinished trailing page
+     *              is then left unconsumed
+     * @return Number of leading bytes of xml that were consumed
+     */
+    size_t scan(std::string_view xml, bool final, const Callback &callback);
+private:
+    Page page_;
+};
+
 // ============================================================================
 // Convenience functions
 // ============================================================================
@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * @file subdump_writer.h
+ * @brief Build filtered multistream sub-dumps from an indexed dump
+ *
+ * Most chunks of a multistream dump are either entirely kept or entirely
+ * dropped by a namespace or title filter. Such chunks are decided from the
+ * index alone: kept chunks have their compressed bytes copied verbatim and
+ * dropped chunks are never read. Only chunks with mixed (or undecidable)
+ * pages are decompressed, filtered page by page and re-encoded. Trimming
+ * pages to their latest revision (PageFilter::only_latest_revision, off by
+ * default) makes every kept chunk decompress.
+ */
+
+#include <cstdint>
+#include <string>
+#include "wikilib/dump/multistream_writer.h"
+#include "wikilib/dump/page_handler.h"
+
+namespace wikilib::dump {
+
+/**
+ * @brief Result of building a sub-dump
+ */
+struct SubdumpResult {
+    bool success = false;
+    std::string error;
+
+    uint64_t pages_written = 0;
+    uint64_t chunks_copied = 0; // Copied verbatim, not recompressed
+    uint64_t chunks_reencoded = 0; // Decompressed, filtered and recompressed
+    uint64_t chunks_skipped = 0; // Dropped using the index alone
+};
+
+/**
+ * @brief Write pages matching filter to a new multistream dump and index
+ *
+ * Namespace and title criteria are evaluated on index titles, using the
+ * namespace names from the dump's <siteinfo>. Criteria the index cannot
+ * answer (include_redirects = false) force the chunk through the
+ * decompress-and-filter path. With only_latest_revision, kept chunks are
+ * decompressed to look for older revisions, copied only if they have none
+ * and otherwise re-encoded with just the last revision of each page.
+ *
+ * @param dump_path Source multistream dump (.xml.bz2)
+ * @param index_path Source index (.txt or .txt.bz2)
+ * @param out_dump_path Output multistream dump
+ * @param out_index_path Output index (.txt.bz2)
+ * @param filter Pages to keep
+ * @param config Writer configuration for re-encoded chunks
+ */
+[[nodiscard]] SubdumpResult write_subdump(const std::string &dump_path, const std::string &index_path,
+                                          const std::string &out_dump_path, const std::string &out_index_path,
+                                          const PageFilter &filter, MultistreamConfig config = {});
+
+} // namespace wikilib::dump
@@ -5,9 +5,11 @@
  * @brief Streaming XML reader for MediaWiki dump files
  */
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include "wikilib/core/types.h"
@@ -95,6 +97,13 @@ public:
      */
     [[nodiscard]] std::string read_text();
 
+    /**
+     * @brief Read text content of current element into out
+     *
+     * Replaces the contents of out, reusing its capacity.
+     */
+    void read_text(std::string &out);
+
     /**
      * @brief Check if at end of document
      */
@@ -110,6 +119,23 @@ public:
      */
     [[nodiscard]] std::string current_path() const;
 
+    /**
+     * @brief Intern element name to a small integer id
+     *
+     * The same name always maps to the same id for the lifetime of the reader.
+     */
+    [[nodiscard]] uint32_t intern_name(std::string_view name);
+
+    /**
+     * @brief Get current element path as interned name ids (root first)
+     */
+    [[nodiscard]] std::span<const uint32_t> path_ids() const noexcept;
+
+    /**
+     * @brief Get interned id of the most recent StartElement name
+     */
+    [[nodiscard]] uint32_t current_element_id() const noexcept;
+
     /**
      * @brief Get bytes processed (for progress)
      */
@@ -188,7 +214,9 @@ public:
 private:
     XmlReader &reader_;
     std::string path_;
-    std::vector<std::string> path_parts_;
+    std::vector<uint32_t> path_ids_; // Path compiled to interned name ids
+
+    [[nodiscard]] bool matches_current() const noexcept;
 };
 
 } // namespace wikilib::dump
@@ -5,6 +5,8 @@
  * @brief Abstract Syntax Tree nodes for parsed MediaWiki wikitext
  */
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -12,6 +14,8 @@
 #include <variant>
 #include <vector>
 #include "wikilib/core/types.h"
+#include "wikilib/markup/html_tags.h"
+#include "wikilib/markup/magic_words.h"
 
 namespace wikilib::markup {
 
@@ -224,6 +228,7 @@ private:
  */
 struct MagicWordNode : Node {
     std::string word;
+    std::optional<BehaviorSwitch> behavior; // Set for known behavior switches
 
     MagicWordNode() : Node(NodeType::MagicWord) {
     }
@@ -549,10 +554,14 @@ struct TableNode : Node {
  */
 struct HtmlTagNode : Node {
     std::string tag_name;
+    HtmlTagId tag_id = HtmlTagId::Unknown;
     std::vector<std::pair<std::string, std::string>> attributes;
     NodeList content;
     bool self_closing = false;
 
+    // Index + 1 into attributes for known attribute names (0 = absent)
+    std::array<uint8_t, HTML_ATTR_COUNT> attribute_slots{};
+
     HtmlTagNode() : Node(NodeType::HtmlTag) {
     }
 
@@ -566,7 +575,17 @@ struct HtmlTagNode : Node {
 
     [[nodiscard]] std::string to_wikitext() const override;
 
+    /**
+     * @brief Append attribute, indexing it when its name is a known attribute
+     */
+    void add_attribute(std::string name, std::string value);
+
     [[nodiscard]] std::optional<std::string_view> get_attribute(std::string_view name) const;
+
+    /**
+     * @brief O(1) lookup of an attribute added through add_attribute()
+     */
+    [[nodiscard]] std::optional<std::string_view> get_attribute(HtmlAttrId id) const;
 };
 
 /**
@@ -653,6 +672,7 @@ struct DocumentNode : Node {
     NodeList content;
     std::vector<CategoryNode *> categories; // Non-owning pointers
     RedirectNode *redirect = nullptr; // Non-owning pointer
+    BehaviorSwitches behavior_switches; // Switches found anywhere in the page
 
     DocumentNode() : Node(NodeType::Document) {
     }
@@ -670,6 +690,10 @@ struct DocumentNode : Node {
     [[nodiscard]] bool is_redirect() const {
         return redirect != nullptr;
     }
+
+    [[nodiscard]] bool has_switch(BehaviorSwitch id) const {
+        return behavior_switches.test(static_cast<size_t>(id));
+    }
 };
 
 // ============================================================================
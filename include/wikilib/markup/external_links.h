@@ -0,0 +1,172 @@
+#pragma once
+
+/**
+ * @file external_links.h
+ * @brief External link scanning, URL normalization and per-domain counting
+ *
+ * Works on raw wikitext and finds both bracketed links ([http://x label])
+ * and bare URLs, which the tokenizer passes through as plain text.
+ * Candidates are located by searching for ':' with memchr and confirmed
+ * by "://" and a scheme from MediaWiki's protocol list.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wikilib::markup {
+
+// ============================================================================
+// Link scanner
+// ============================================================================
+
+/**
+ * @brief External URL found in wikitext
+ */
+struct ExternalUrl {
+    std::string_view url; // Points into the scanned text
+    size_t offset = 0; // Byte offset of url
+    bool bracketed = false; // [url label] form
+};
+
+/**
+ * @brief Check scheme against the protocol list (case-insensitive)
+ */
+[[nodiscard]] bool is_url_scheme(std::string_view scheme) noexcept;
+
+/**
+ * @brief Streaming scanner over external URLs in raw wikitext
+ *
+ * URL ends follow the parser: whitespace, '<', '>', '"', '[' and ']' stop
+ * a URL, and trailing ",;.:!?" (and ')' without a matching '(') is not
+ * part of a free link. Since the text is unexpanded, '|', "{{", "}}" and
+ * "''" also stop a URL. URLs inside comments are skipped.
+ */
+class ExternalLinkScanner {
+public:
+    explicit ExternalLinkScanner(std::string_view input) noexcept : input_(input) {}
+
+    /**
+     * @brief Find next URL
+     * @return false when input is exhausted
+     */
+    bool next(ExternalUrl &link);
+private:
+    bool skip_comment(size_t colon);
+
+    std::string_view input_;
+    size_t pos_ = 0;
+    size_t comment_ = 0; // Next "<!--" at or after pos_ (npos if none)
+    bool comment_known_ = false;
+};
+
+/**
+ * @brief Collect all external URLs of a page
+ * @param wikitext Page text (results point into it)
+ * @param out Output URLs in source order (cleared first)
+ */
+void collect_external_urls(std::string_view wikitext, std::vector<ExternalUrl> &out);
+
+// ============================================================================
+// URL normalization
+// ============================================================================
+
+/**
+ * @brief URL normalization options
+ */
+struct UrlNormalizeOptions {
+    bool decode_idn = false; // Convert xn-- host labels to UTF-8
+    bool strip_fragment = true; // Drop #fragment
+    bool strip_www = false; // Drop a leading "www." from the host
+};
+
+/**
+ * @brief Normalize URL into out
+ *
+ * Lower-cases scheme and host, drops userinfo, the default port of the
+ * scheme and (optionally) the fragment, decodes percent-escapes of
+ * unreserved characters, upper-cases the remaining escapes and turns an
+ * empty path into "/". out is cleared first; its capacity is reused, so
+ * one buffer can serve a whole dump.
+ *
+ * @return false if url has no scheme or host (out is left empty)
+ */
+bool normalize_url(std::string_view url, std::string &out, const UrlNormalizeOptions &options = {});
+
+/**
+ * @brief Host part of a URL, as written (empty if none)
+ */
+[[nodiscard]] std::string_view url_host(std::string_view url) noexcept;
+
+/**
+ * @brief Decode a punycode label (without "xn--"), appending UTF-8 to out
+ * @return false on malformed input (out is unchanged)
+ */
+bool decode_punycode(std::string_view label, std::string &out);
+
+// ============================================================================
+// Per-domain counting
+// ============================================================================
+
+/**
+ * @brief Link counts per normalized host
+ *
+ * Not thread-safe: in a parallel dump pipeline each worker fills its own
+ * counter and the results are combined with merge().
+ */
+class DomainCounter {
+public:
+    explicit DomainCounter(UrlNormalizeOptions options = {}) : options_(options) {}
+
+    /**
+     * @brief Count every external URL in wikitext
+     */
+    void add_text(std::string_view wikitext);
+
+    /**
+     * @brief Count one URL (e.g. ExternalLinkNode::url)
+     */
+    void add_url(std::string_view url);
+
+    /**
+     * @brief Add counts of another counter
+     */
+    void merge(const DomainCounter &other);
+
+    /**
+     * @brief Domains sorted by descending count (ties by name)
+     * @param limit Maximum entries (0 = all)
+     */
+    [[nodiscard]] std::vector<std::pair<std::string, uint64_t>> top(size_t limit = 0) const;
+
+    [[nodiscard]] uint64_t count(std::string_view host) const;
+
+    [[nodiscard]] const auto &counts() const noexcept {
+        return counts_;
+    }
+
+    [[nodiscard]] uint64_t total() const noexcept {
+        return total_;
+    }
+private:
+    struct HostHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view sv) const noexcept {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+
+    UrlNormalizeOptions options_;
+    std::unordered_map<std::string, uint64_t, HostHash, std::equal_to<>> counts_;
+    uint64_t total_ = 0;
+    std::string buffer_;
+    std::vector<ExternalUrl> urls_;
+};
+
+} // namespace wikilib::markup
@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file html_tags.h
+ * @brief Interned HTML tag and attribute names
+ *
+ * Maps the HTML tags MediaWiki allows in wikitext, and the attributes most
+ * often queried on them, to small enum ids through compile-time sorted
+ * tables, so the tokenizer and AST compare integers instead of strings.
+ */
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace wikilib::markup {
+
+// ============================================================================
+// Tag ids
+// ============================================================================
+
+/**
+ * @brief Known HTML tag (MediaWiki Sanitizer allow-list), alphabetical
+ */
+enum class HtmlTagId : uint8_t {
+    Unknown,
+    Abbr, B, Bdi, Bdo, Big, Blockquote, Br, Caption, Center,
+    Cite, Code, Col, Colgroup, Data, Dd, Del, Dfn, Div, Dl,
+    Dt, Em, Font, H1, H2, H3, H4, H5, H6, Hr, I, Ins,
+    Kbd, Li, Link, Mark, Meta, Ol, P, Pre, Q, Rb, Rp,
+    Rt, Ruby, S, Samp, Small, Span, Strike, Strong, Sub,
+    Sup, Table, Td, Th, Time, Tr, Tt, U, Ul, Var, Wbr
+};
+
+/**
+ * @brief Look up tag id by name (exact, lower-case)
+ * @return HtmlTagId::Unknown for tags outside the allow-list
+ */
+[[nodiscard]] HtmlTagId lookup_html_tag(std::string_view name) noexcept;
+
+/**
+ * @brief Get tag name for id ("" for Unknown)
+ */
+[[nodiscard]] std::string_view html_tag_name(HtmlTagId id) noexcept;
+
+// ============================================================================
+// Attribute ids
+// ============================================================================
+
+/**
+ * @brief Frequently queried attribute names, alphabetical
+ */
+enum class HtmlAttrId : uint8_t {
+    Unknown,
+    Align, Alt, Bgcolor, Border, Cellpadding, Cellspacing, Class, Colspan,
+    Dir, Group, Height, Id, Lang, Name, Rowspan, Scope, Style, Title,
+    Valign, Width
+};
+
+inline constexpr size_t HTML_ATTR_COUNT = static_cast<size_t>(HtmlAttrId::Width) + 1;
+
+/**
+ * @brief Look up attribute id by name (ASCII case-insensitive)
+ */
+[[nodiscard]] HtmlAttrId lookup_html_attribute(std::string_view name) noexcept;
+
+/**
+ * @brief Attribute as views into the source tag
+ */
+struct HtmlAttribute {
+    std::string_view name;
+    std::string_view value; // Unquoted; empty for valueless attributes
+    HtmlAttrId id = HtmlAttrId::Unknown;
+};
+
+/**
+ * @brief Split attribute text of a tag into name/value views
+ * @param text Text between the tag name and '>' or '/>'
+ * @param out Attributes are appended here
+ * @return Number of attributes appended
+ */
+size_t split_html_attributes(std::string_view text, std::vector<HtmlAttribute> &out);
+
+} // namespace wikilib::markup
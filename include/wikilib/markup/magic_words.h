@@ -0,0 +1,63 @@
+#pragma once
+
+/**
+ * @file magic_words.h
+ * @brief Behavior switches (__NOTOC__, __NOINDEX__, ...) and their lookup
+ *
+ * Switch names are resolved with a compile-time perfect hash, so the
+ * tokenizer pays one table probe per "__X" candidate.
+ */
+
+#include <bitset>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace wikilib::markup {
+
+/**
+ * @brief Behavior switches of MediaWiki core and common extensions
+ */
+enum class BehaviorSwitch : uint8_t {
+    Toc,
+    NoToc,
+    ForceToc,
+    NoEditSection,
+    NewSectionLink,
+    NoNewSectionLink,
+    NoGallery,
+    HiddenCat,
+    ExpectUnusedCategory,
+    ExpectUnusedTemplate,
+    NoContentConvert, // Also __NOCC__
+    NoTitleConvert, // Also __NOTC__
+    Index,
+    NoIndex,
+    StaticRedirect,
+    Disambig, // Disambiguator
+    NoGlobal, // GlobalUserPage
+    ArchivedTalk, // DiscussionTools
+    NoTalk // DiscussionTools
+};
+
+inline constexpr size_t BEHAVIOR_SWITCH_COUNT = static_cast<size_t>(BehaviorSwitch::NoTalk) + 1;
+
+/**
+ * @brief Set of behavior switches present on a page
+ */
+using BehaviorSwitches = std::bitset<BEHAVIOR_SWITCH_COUNT>;
+
+/**
+ * @brief Look up a switch by its name without underscores ("NOTOC")
+ *
+ * Names are matched exactly; MediaWiki also accepts lower-case spellings,
+ * but those are not recognized here.
+ */
+[[nodiscard]] std::optional<BehaviorSwitch> lookup_behavior_switch(std::string_view word) noexcept;
+
+/**
+ * @brief Canonical name of a switch, without underscores
+ */
+[[nodiscard]] std::string_view behavior_switch_name(BehaviorSwitch id) noexcept;
+
+} // namespace wikilib::markup
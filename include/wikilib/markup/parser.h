@@ -5,8 +5,12 @@
  * @brief Parser for MediaWiki wikitext markup
  */
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
 #include "wikilib/core/types.h"
 #include "wikilib/markup/ast.h"
 #include "wikilib/markup/tokenizer.h"
@@ -27,9 +31,10 @@ struct ParserConfig {
     bool preserve_whitespace = false; // Keep exact whitespace
     bool parse_tables = true; // Parse table markup
     bool parse_lists = true; // Parse list markup
-    int max_depth = 100; // Maximum nesting depth
+    int max_depth = 100; // Maximum nesting depth (AST teardown and visitors still recurse per level)
     int max_template_depth = 40; // Maximum template recursion
     bool lenient = true; // Continue on errors
+    ErrorReporting error_reporting = ErrorReporting::Compact; // Also applied to the tokenizer
 };
 
 // ============================================================================
@@ -41,17 +46,21 @@ struct ParserConfig {
  */
 struct ParseResult {
     std::unique_ptr<DocumentNode> document;
-    std::vector<ParseError> errors;
+    std::vector<ParseError> errors; // Empty unless error reporting is Compact
+    ErrorCounts error_counts; // Coded errors of tokenizer and parser
 
     [[nodiscard]] bool success() const {
         return document != nullptr;
     }
 
     [[nodiscard]] bool has_errors() const {
-        return !errors.empty();
+        return !errors.empty() || error_counts.total() > 0;
     }
 
     [[nodiscard]] bool has_fatal_errors() const {
+        if (error_counts.count(ErrorSeverity::Fatal) > 0) {
+            return true;
+        }
         for (const auto &e: errors) {
             if (e.severity == ErrorSeverity::Fatal)
                 return true;
@@ -76,6 +85,7 @@ public:
 
     /**
      * @brief Parse wikitext into AST
+     * @throws std::length_error if input is too large to tokenize (4 GiB)
      */
     [[nodiscard]] ParseResult parse(std::string_view input);
 
@@ -111,16 +121,101 @@ private:
     ParserConfig config_;
     std::unique_ptr<Tokenizer> tokenizer_;
     std::vector<ParseError> errors_;
-    int depth_ = 0;
+    ErrorCounts error_counts_;
+    BehaviorSwitches switches_; // Collected while parsing, copied to DocumentNode
+    int depth_ = 0; // Open frames of nested constructs (rows, cells, items excluded)
+    std::string_view input_;
+
+    // Apostrophe runs of one line, resolved up front like MediaWiki's
+    // doQuotes. Each run maps to a short list of events that always nest,
+    // so formatting nodes are built without backtracking.
+    enum class QuoteEvent : uint8_t {
+        Apostrophe, // Literal ' (bold run read as italic)
+        OpenBold,
+        OpenItalic,
+        OpenBoldItalic,
+        CloseBold,
+        CloseItalic,
+        CloseBoldItalic
+    };
+
+    struct QuoteRun {
+        size_t offset = 0; // Token offset in input
+        uint32_t first_event = 0; // Range in quote_events_
+        uint8_t event_count = 0;
+        uint8_t length = 0; // 2, 3 or 5 apostrophes
+        bool demoted = false; // Bold run read as apostrophe + italic
+    };
+
+    std::vector<QuoteRun> quote_runs_;
+    std::vector<QuoteEvent> quote_events_;
+    size_t quote_run_ = 0; // Run of the current formatting token
+    uint8_t quote_consumed_ = 0; // Events of that run already consumed
+    size_t quote_line_end_ = 0; // Offset of the newline ending the resolved line
+
+    // Spans cut off by the end of a link, template or tag they were opened
+    // in; they continue after it, as their close is still to come
+    struct ReopenSpan {
+        QuoteEvent close;
+        uint32_t span = 0; // Opening order: outer spans first
+    };
+
+    std::vector<ReopenSpan> reopen_;
+    size_t reopen_line_end_ = 0;
+    uint32_t next_span_ = 0;
+
+    // Constructs with child nodes are parsed on an explicit stack: each open
+    // construct is a Frame on the heap rather than a C++ call frame, so
+    // nesting depth costs no native stack.
+    enum class FrameKind : uint8_t {
+        Formatting,
+        List,
+        ListItem,
+        Table,
+        TableRow,
+        ImplicitRow, // Cells before the first |-
+        TableCell,
+        Template,
+        Parameter,
+        Link,
+        ExternalLink,
+        HtmlTag
+    };
+
+    enum class Step : uint8_t {
+        Child, // Parse one child node at the current token
+        Pushed, // A row, cell or list item frame was pushed
+        Done // Construct is complete
+    };
+
+    struct Frame {
+        FrameKind kind = FrameKind::Formatting;
+        NodePtr node; // Node under construction
+        TemplateParameter param; // Template: parameter being parsed
+        size_t line_end = 0; // Formatting: end of the line it was opened on
+        QuoteEvent close = QuoteEvent::CloseBold; // Formatting: event that closes it
+        uint32_t span = 0; // Formatting: opening order on the line
+        bool closed = false; // Formatting: its close event was consumed
+        bool nested = false; // Counts toward depth_
+        bool stop = false; // A child ended the content
+        bool open = false; // Parameters, default value or link text follow
+        bool in_param = false; // Template: inside a parameter
+        bool split = false; // Template parameter '=' or table cell '|' seen
+    };
+
+    std::vector<Frame> frames_;
 
     // Parsing methods
     NodeList parse_content();
     NodeList parse_block_content();
     NodeList parse_inline_content();
 
-    NodePtr parse_node();
+    NodePtr parse_node(); // Runs frames until the node starting here is complete
     NodePtr parse_paragraph();
     NodePtr parse_heading();
+
+    // Construct starters: return a leaf node, or push a frame and return nullptr
+    NodePtr start_node();
     NodePtr parse_list();
     NodePtr parse_table();
     NodePtr parse_template();
@@ -129,41 +224,35 @@ private:
     NodePtr parse_external_link();
     NodePtr parse_formatting();
     NodePtr parse_html_tag();
-
-    // Table parsing
-    NodePtr parse_table_row();
-    NodePtr parse_table_cell();
-
-    // List parsing
-    NodePtr parse_list_item();
+    void resolve_quotes();
+    [[nodiscard]] std::optional<QuoteEvent> peek_quote_event();
+    void consume_quote_event();
+    void push_formatting(QuoteEvent close);
+    bool reopen_formatting();
+
+    // Frame engine
+    void push_frame(FrameKind kind, NodePtr node);
+    Step step_frame(Frame &frame);
+    Step step_table(Frame &frame);
+    Step step_table_row();
+    Step step_table_cell(Frame &frame);
+    Step step_template(Frame &frame);
+    void add_child(Frame &frame, NodePtr child);
+    NodePtr finish_frame(Frame &frame);
 
     // Helper methods
+    NodePtr token_as_text(); // Current token as a TextNode (consumed)
     void advance();
     [[nodiscard]] const Token &current() const;
+    [[nodiscard]] std::string_view token_text(const Token &token) const; // View into the input
+    [[nodiscard]] SourceRange token_location(const Token &token) const;
     [[nodiscard]] bool check(TokenType type) const;
     [[nodiscard]] bool match(TokenType type);
     [[nodiscard]] bool at_end() const;
 
-    void add_error(std::string message, ErrorSeverity severity = ErrorSeverity::Warning);
+    void add_error(ErrorCode code, ErrorSeverity severity = ErrorSeverity::Warning);
+    void start(std::string_view input);
     void synchronize(); // Error recovery
-
-    // Depth tracking
-    class DepthGuard {
-    public:
-        explicit DepthGuard(Parser &p) : parser_(p) {
-            ++parser_.depth_;
-        }
-
-        ~DepthGuard() {
-            --parser_.depth_;
-        }
-
-        [[nodiscard]] bool exceeded() const {
-            return parser_.depth_ > parser_.config_.max_depth;
-        }
-    private:
-        Parser &parser_;
-    };
 };
 
 // ============================================================================
@@ -0,0 +1,75 @@
+#pragma once
+
+/**
+ * @file ref_scanner.h
+ * @brief Fast scanner for <ref> and <references> elements in raw wikitext
+ *
+ * Finds reference spans without tokenizing or building HtmlTagNodes:
+ * candidate tags are located with memchr and only "<ref" / "<references"
+ * openings are examined further. Comments and <nowiki>/<pre> blocks are
+ * skipped, so commented-out references are not reported.
+ */
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "wikilib/core/types.h"
+
+namespace wikilib::markup {
+
+// ============================================================================
+// Reference span
+// ============================================================================
+
+/**
+ * @brief Single <ref> or <references> element, as views into the source
+ */
+struct RefSpan {
+    std::string_view body; // Content between open and close tag (empty if self-closing)
+    std::string_view name; // name="..." attribute, unquoted
+    std::string_view group; // group="..." attribute, unquoted
+    SourceRange location; // Whole element (offsets only)
+    bool self_closing = false; // <ref name="x" /> reuse or <references/>
+    bool is_references = false; // <references> list element
+    uint32_t uses = 1; // Occurrences merged into this entry by collect_refs()
+};
+
+// ============================================================================
+// Reference scanner
+// ============================================================================
+
+/**
+ * @brief Streaming scanner over <ref> and <references> elements
+ *
+ * Refs defined inside <references>...</references> (list-defined refs)
+ * are reported after the enclosing <references> span.
+ */
+class RefScanner {
+public:
+    explicit RefScanner(std::string_view input) noexcept : input_(input) {}
+
+    /**
+     * @brief Find next element
+     * @return false when input is exhausted
+     */
+    bool next(RefSpan &ref);
+private:
+    bool parse_tag(size_t open, bool references, RefSpan &ref);
+
+    std::string_view input_;
+    size_t pos_ = 0;
+};
+
+/**
+ * @brief Collect refs of a page, merging repeated named refs
+ *
+ * Each (group, name) pair appears once, at its first occurrence, with the
+ * body of whichever occurrence defined it and uses counting occurrences.
+ * Unnamed refs are kept as they are; <references> elements are dropped.
+ *
+ * @param wikitext Page text (results point into it)
+ * @param out Output refs (cleared first)
+ */
+void collect_refs(std::string_view wikitext, std::vector<RefSpan> &out);
+
+} // namespace wikilib::markup
@@ -5,47 +5,190 @@
  * @brief Section tree builder for document hierarchy
  */
 
+#include <cstdint>
 #include <functional>
-#include <memory>
+#include <iosfwd>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "wikilib/markup/ast.h"
 
 namespace wikilib::markup {
 
 // ============================================================================
-// Section tree node
+// Section table
 // ============================================================================
 
 /**
- * @brief Node in section tree representing document hierarchy
+ * @brief One section of a document
+ *
+ * Sections are stored flat in document (depth-first) order, so the
+ * subsections of section i are exactly the entries [i + 1, end).
  */
-struct SectionNode {
-    std::string title;      // Section title (empty for root)
-    int level = 0;          // Heading level (0 for root, 1-6 for sections)
+struct Section {
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
 
-    std::vector<Node*> content;  // Content of this section (before subsections)
-    std::vector<std::shared_ptr<SectionNode>> children;  // Subsections
+    std::string_view title;             // Trimmed heading text (empty for root)
+    int level = 0;                      // Heading level (0 for root, 1-6 for sections)
+    uint32_t parent = NO_PARENT;        // Index of the parent section
+    uint32_t end = 0;                   // One past the last subsection
+    uint32_t child_count = 0;           // Direct subsections
+    std::span<const NodePtr> content;   // Content of this section (before subsections)
 
     /**
      * @brief Check if this is the root node
      */
     [[nodiscard]] bool is_root() const noexcept {
-        return level == 0 && title.empty();
+        return parent == NO_PARENT;
+    }
+};
+
+/**
+ * @brief Flat section hierarchy of a document
+ *
+ * Built in one pass over the top-level nodes without per-section
+ * allocations. Titles and content are views into the document (titles
+ * spread over several text nodes are joined into a buffer owned by the
+ * tree), so the document must outlive the tree.
+ */
+class SectionTree {
+public:
+    /**
+     * @brief Direct subsections of a section, in document order
+     */
+    class Children {
+    public:
+        class iterator {
+        public:
+            using value_type = Section;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            iterator(const Section* sections, uint32_t index) noexcept : sections_(sections), index_(index) {}
+
+            const Section& operator*() const noexcept {
+                return sections_[index_];
+            }
+
+            const Section* operator->() const noexcept {
+                return &sections_[index_];
+            }
+
+            iterator& operator++() noexcept {
+                index_ = sections_[index_].end;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const iterator& other) const noexcept {
+                return index_ == other.index_;
+            }
+        private:
+            const Section* sections_ = nullptr;
+            uint32_t index_ = 0;
+        };
+
+        Children(const Section* sections, uint32_t parent) noexcept
+            : sections_(sections), first_(parent + 1), end_(sections[parent].end),
+              size_(sections[parent].child_count) {}
+
+        [[nodiscard]] iterator begin() const noexcept {
+            return {sections_, first_};
+        }
+
+        [[nodiscard]] iterator end() const noexcept {
+            return {sections_, end_};
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        /**
+         * @brief n-th subsection (walks the siblings before it)
+         */
+        [[nodiscard]] const Section& operator[](size_t n) const noexcept;
+    private:
+        const Section* sections_;
+        uint32_t first_;
+        uint32_t end_;
+        size_t size_;
+    };
+
+    SectionTree();
+
+    SectionTree(SectionTree&&) noexcept = default;
+    SectionTree& operator=(SectionTree&&) noexcept = default;
+    SectionTree(const SectionTree&) = delete;
+    SectionTree& operator=(const SectionTree&) = delete;
+
+    /**
+     * @brief Root section (content before the first heading)
+     */
+    [[nodiscard]] const Section& root() const noexcept {
+        return sections_.front();
+    }
+
+    /**
+     * @brief All sections, root first, in document order
+     */
+    [[nodiscard]] std::span<const Section> sections() const noexcept {
+        return sections_;
+    }
+
+    [[nodiscard]] const Section& operator[](size_t index) const noexcept {
+        return sections_[index];
+    }
+
+    /**
+     * @brief Number of sections including the root
+     */
+    [[nodiscard]] size_t size() const noexcept {
+        return sections_.size();
+    }
+
+    [[nodiscard]] size_t index_of(const Section& section) const noexcept {
+        return static_cast<size_t>(&section - sections_.data());
+    }
+
+    [[nodiscard]] Children children(const Section& section) const noexcept {
+        return {sections_.data(), static_cast<uint32_t>(index_of(section))};
+    }
+
+    /**
+     * @brief Parent section (nullptr for root)
+     */
+    [[nodiscard]] const Section* parent(const Section& section) const noexcept {
+        return section.is_root() ? nullptr : &sections_[section.parent];
     }
 
     /**
      * @brief Get total number of content nodes (including all descendants)
      */
-    [[nodiscard]] size_t total_content_count() const noexcept;
+    [[nodiscard]] size_t total_content_count(const Section& section) const noexcept;
 
     /**
      * @brief Get total number of sections (including all descendants)
      */
-    [[nodiscard]] size_t total_section_count() const noexcept;
-};
+    [[nodiscard]] size_t total_section_count(const Section& section) const noexcept {
+        return section.end - index_of(section) - 1;
+    }
+private:
+    friend SectionTree build_section_tree(const std::vector<NodePtr>& nodes);
 
-using SectionNodePtr = std::shared_ptr<SectionNode>;
+    std::vector<Section> sections_;
+    std::vector<char> titles_; // Joined multi-node titles (heap buffer survives moves)
+};
 
 // ============================================================================
 // Tree building
@@ -75,17 +218,17 @@ using SectionNodePtr = std::shared_ptr<SectionNode>;
  *       └── content: [Text 2]
  *
  * @param doc Document to build tree from
- * @return Root node of section tree
+ * @return Section tree (only a root for a null document)
  */
-[[nodiscard]] SectionNodePtr build_section_tree(const DocumentNode* doc);
+[[nodiscard]] SectionTree build_section_tree(const DocumentNode* doc);
 
 /**
  * @brief Build section tree from list of nodes
  *
  * @param nodes List of AST nodes
- * @return Root node of section tree
+ * @return Section tree viewing into nodes
  */
-[[nodiscard]] SectionNodePtr build_section_tree(const std::vector<NodePtr>& nodes);
+[[nodiscard]] SectionTree build_section_tree(const std::vector<NodePtr>& nodes);
 
 // ============================================================================
 // Tree printing
@@ -104,25 +247,18 @@ using SectionNodePtr = std::shared_ptr<SectionNode>;
  *
  * Numbers in parentheses show content node count.
  *
- * @param node Section tree root
+ * @param tree Section tree
  * @param out Output stream
- * @param prefix Current line prefix (used for recursion)
- * @param is_last Whether this is the last child
  */
-void print_section_tree(
-    const SectionNodePtr& node,
-    std::ostream& out,
-    const std::string& prefix = "",
-    bool is_last = true
-);
+void print_section_tree(const SectionTree& tree, std::ostream& out);
 
 /**
  * @brief Get section tree as string
  *
- * @param node Section tree root
+ * @param tree Section tree
  * @return Tree representation as string
  */
-[[nodiscard]] std::string section_tree_to_string(const SectionNodePtr& node);
+[[nodiscard]] std::string section_tree_to_string(const SectionTree& tree);
 
 // ============================================================================
 // Tree traversal
@@ -131,23 +267,23 @@ void print_section_tree(
 /**
  * @brief Visit all sections in tree (depth-first)
  *
- * @param node Section tree root
+ * @param tree Section tree
  * @param visitor Function called for each section
  */
 void traverse_sections(
-    const SectionNodePtr& node,
-    const std::function<void(const SectionNodePtr&)>& visitor
+    const SectionTree& tree,
+    const std::function<void(const Section&)>& visitor
 );
 
 /**
  * @brief Find section by title (case-sensitive)
  *
- * @param node Section tree root
+ * @param tree Section tree
  * @param title Section title to find
- * @return Section node or nullptr if not found
+ * @return First matching section in document order, or nullptr
  */
-[[nodiscard]] SectionNodePtr find_section(
-    const SectionNodePtr& node,
+[[nodiscard]] const Section* find_section(
+    const SectionTree& tree,
     std::string_view title
 );
 
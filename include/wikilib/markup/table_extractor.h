@@ -0,0 +1,162 @@
+#pragma once
+
+/**
+ * @file table_extractor.h
+ * @brief Streaming extraction of wikitables without building an AST
+ *
+ * Walks {| ... |} blocks line by line and yields rows of cells whose text
+ * and attributes are views into the source wikitext. Intended for bulk
+ * export (CSV/TSV) where parse_table() and per-cell NodeLists are too
+ * allocation-heavy.
+ */
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace wikilib::markup {
+
+// ============================================================================
+// Table cell
+// ============================================================================
+
+/**
+ * @brief Single table cell as a view into the source text
+ */
+struct TableCell {
+    std::string_view text; // Cell content, trimmed (may span several lines)
+    std::string_view attributes; // Raw attributes before the cell '|', if any
+    uint32_t rowspan = 1;
+    uint32_t colspan = 1;
+    bool is_header = false; // Started with '!'
+    bool is_span_copy = false; // Grid slot filled by another cell's rowspan/colspan
+};
+
+// ============================================================================
+// Table grid
+// ============================================================================
+
+/**
+ * @brief Rectangular cell grid with rowspan/colspan expanded
+ *
+ * Spanned slots hold a copy of the originating cell with is_span_copy set;
+ * missing cells of short rows are empty. clear() keeps allocated storage so
+ * one grid can be reused for every table of a dump.
+ */
+class TableGrid {
+public:
+    /**
+     * @brief Remove all rows, keeping capacity
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Append row of cells in source order, expanding spans
+     */
+    void add_row(std::span<const TableCell> cells);
+
+    [[nodiscard]] size_t rows() const noexcept {
+        return rows_;
+    }
+
+    [[nodiscard]] size_t columns() const noexcept {
+        return columns_;
+    }
+
+    [[nodiscard]] const TableCell &at(size_t row, size_t column) const noexcept {
+        return cells_[row * columns_ + column];
+    }
+
+    [[nodiscard]] std::span<const TableCell> row(size_t index) const noexcept {
+        return {cells_.data() + index * columns_, columns_};
+    }
+private:
+    void widen(size_t columns);
+
+    std::vector<TableCell> cells_; // rows_ x columns_, row-major
+    size_t rows_ = 0;
+    size_t columns_ = 0;
+
+    // Per column: rows still covered by a rowspan from above, and its cell
+    std::vector<uint32_t> span_rows_;
+    std::vector<TableCell> span_cells_;
+};
+
+// ============================================================================
+// Table extractor
+// ============================================================================
+
+/**
+ * @brief Streaming wikitable reader over raw wikitext
+ *
+ * Example usage:
+ * @code
+ *   TableExtractor tables(wikitext);
+ *   std::vector<TableCell> row;
+ *   while (tables.next_table()) {
+ *       while (tables.next_row(row)) {
+ *           for (const auto& cell : row) { ... cell.text ... }
+ *       }
+ *   }
+ * @endcode
+ *
+ * Nested tables are not reported separately; they stay part of the text
+ * of the cell that contains them.
+ */
+class TableExtractor {
+public:
+    explicit TableExtractor(std::string_view input) noexcept : input_(input) {}
+
+    /**
+     * @brief Skip to the next top-level table
+     * @return false if there are no more tables
+     */
+    bool next_table();
+
+    /**
+     * @brief Read next non-empty row of the current table
+     * @param cells Output cells in source order (cleared first, capacity reused)
+     * @return false at the end of the table
+     */
+    bool next_row(std::vector<TableCell> &cells);
+
+    /**
+     * @brief Read the next table completely into grid
+     * @return false if there are no more tables
+     */
+    bool read_table(TableGrid &grid);
+
+    /**
+     * @brief Attributes from the {| line of the current table
+     */
+    [[nodiscard]] std::string_view table_attributes() const noexcept {
+        return table_attributes_;
+    }
+
+    /**
+     * @brief Caption (|+) of the current table, once reached
+     */
+    [[nodiscard]] std::string_view caption() const noexcept {
+        return caption_;
+    }
+private:
+    std::string_view next_line();
+    void add_cells(std::string_view line, bool is_header, std::vector<TableCell> &cells);
+    void extend_cell(TableCell &cell, std::string_view line);
+
+    std::string_view input_;
+    size_t pos_ = 0;
+    bool in_table_ = false;
+    std::string_view table_attributes_;
+    std::string_view caption_;
+    std::vector<TableCell> scratch_row_;
+};
+
+/**
+ * @brief Parse rowspan or colspan value from cell attributes
+ * @return Span value (at least 1), 1 if absent or invalid
+ */
+[[nodiscard]] uint32_t parse_span_attribute(std::string_view attributes, std::string_view name) noexcept;
+
+} // namespace wikilib::markup
@@ -5,10 +5,15 @@
  * @brief Tokenizer for MediaWiki wikitext markup
  */
 
+#include <cstdint>
+#include <deque>
+#include <span>
 #include <string_view>
 #include <variant>
 #include <vector>
+#include "wikilib/core/namespace_resolver.h"
 #include "wikilib/core/types.h"
+#include "wikilib/markup/html_tags.h"
 
 namespace wikilib::markup {
 
@@ -19,7 +24,7 @@ namespace wikilib::markup {
 /**
  * @brief Types of tokens in MediaWiki markup
  */
-enum class TokenType {
+enum class TokenType : uint8_t {
     // Text
     Text, // Plain text
     Whitespace, // Spaces, tabs (not newlines)
@@ -89,16 +94,44 @@ enum class TokenType {
 
 /**
  * @brief Single token from the tokenizer
+ *
+ * Packed into 16 bytes: the token refers to its source as an offset and
+ * length into the tokenizer input, so four tokens share a cache line.
+ * Views are rebuilt with text() and tag_name(); line and column come from
+ * Tokenizer::location(). Tokenizer rejects inputs of 4 GiB or more.
  */
 struct Token {
+    static constexpr uint8_t SELF_CLOSING = 1 << 0;
+
     TokenType type = TokenType::EndOfInput;
-    std::string_view text; // Raw text of the token
-    SourceRange location;
+    uint8_t flags = 0;
+    uint8_t level = 0; // Heading level, list depth; attribute count of opening HTML tags
+    HtmlTagId tag_id = HtmlTagId::Unknown; // For HTML tags
+    uint32_t offset = 0; // Source range in the input
+    uint32_t length = 0;
+    uint32_t attr_begin = 0; // Opening HTML tags: range in Tokenizer::attributes()
+
+    /**
+     * @brief Raw text of the token (content only for nowiki)
+     */
+    [[nodiscard]] std::string_view text(std::string_view input) const noexcept;
+
+    /**
+     * @brief Name of an HTML tag token as written
+     */
+    [[nodiscard]] std::string_view tag_name(std::string_view input) const noexcept;
+
+    [[nodiscard]] bool self_closing() const noexcept {
+        return (flags & SELF_CLOSING) != 0;
+    }
+
+    [[nodiscard]] uint32_t attr_count() const noexcept {
+        return type == TokenType::HtmlTagOpen ? level : 0;
+    }
 
-    // Extra data for certain token types
-    int level = 0; // Heading level, list depth, etc.
-    std::string_view tag_name; // For HTML tags
-    bool self_closing = false; // For HTML tags
+    [[nodiscard]] size_t end_offset() const noexcept {
+        return size_t{offset} + length;
+    }
 
     [[nodiscard]] bool is(TokenType t) const noexcept {
         return type == t;
@@ -118,6 +151,8 @@ struct Token {
     }
 };
 
+static_assert(sizeof(Token) == 16, "Token should stay packed");
+
 // ============================================================================
 // Tokenizer configuration
 // ============================================================================
@@ -130,7 +165,9 @@ struct TokenizerConfig {
     bool preserve_nowiki = true; // Keep nowiki content
     bool recognize_redirects = true; // Recognize #REDIRECT
     bool recognize_categories = true; // Recognize [[Category:...]]
+    const NamespaceResolver *namespaces = nullptr; // Category namespace names (nullptr = builtin)
     bool lenient = true; // Continue on errors
+    ErrorReporting error_reporting = ErrorReporting::Compact;
 };
 
 // ============================================================================
@@ -145,6 +182,15 @@ struct TokenizerConfig {
  */
 class Tokenizer {
 public:
+    /**
+     * @brief Largest input a token offset can address
+     */
+    static constexpr size_t MAX_INPUT_SIZE = UINT32_MAX;
+
+    /**
+     * @brief Create tokenizer over input
+     * @throws std::length_error if input is larger than MAX_INPUT_SIZE
+     */
     explicit Tokenizer(std::string_view input, TokenizerConfig config = {});
 
     /**
@@ -177,6 +223,46 @@ public:
      */
     [[nodiscard]] const std::vector<ParseError> &errors() const noexcept;
 
+    /**
+     * @brief Get error tallies (kept unless error reporting is Off)
+     */
+    [[nodiscard]] const ErrorCounts &error_counts() const noexcept {
+        return error_counts_;
+    }
+
+    /**
+     * @brief Attributes of an opening HTML tag token, split during scanning
+     *
+     * Views point into the input; valid until reset().
+     */
+    [[nodiscard]] std::span<const HtmlAttribute> attributes(const Token &token) const noexcept;
+
+    /**
+     * @brief Text of a token (view into the input)
+     */
+    [[nodiscard]] std::string_view text(const Token &token) const noexcept {
+        return token.text(input_);
+    }
+
+    /**
+     * @brief Tag name of an HTML tag token (view into the input)
+     */
+    [[nodiscard]] std::string_view tag_name(const Token &token) const noexcept {
+        return token.tag_name(input_);
+    }
+
+    /**
+     * @brief Line and column range of a scanned token
+     */
+    [[nodiscard]] SourceRange location(const Token &token) const noexcept;
+
+    /**
+     * @brief The input being tokenized
+     */
+    [[nodiscard]] std::string_view input() const noexcept {
+        return input_;
+    }
+
     /**
      * @brief Reset tokenizer to beginning
      */
@@ -191,8 +277,11 @@ private:
     TokenizerConfig config_;
     size_t pos_ = 0;
     SourcePosition current_pos_;
-    std::vector<Token> lookahead_;
+    std::deque<Token> lookahead_; // Stable references while peeking ahead
     std::vector<ParseError> errors_;
+    ErrorCounts error_counts_;
+    std::vector<HtmlAttribute> attributes_; // Flat storage for all tag attributes
+    std::vector<uint32_t> line_starts_; // Offsets of scanned lines, for location()
 
     // Context tracking
     int template_depth_ = 0;
@@ -213,15 +302,19 @@ private:
     Token scan_nowiki();
     Token scan_magic_word();
 
+    [[nodiscard]] Token make_token(TokenType type, size_t begin, size_t end) const noexcept;
+    [[nodiscard]] SourcePosition position_at(size_t offset) const noexcept;
+
     void advance(size_t count = 1);
     [[nodiscard]] char current() const noexcept;
     [[nodiscard]] char peek_char(size_t offset = 1) const noexcept;
     [[nodiscard]] bool match(std::string_view str) const noexcept;
     [[nodiscard]] bool at_end() const noexcept;
+    [[nodiscard]] bool at_magic_word() const noexcept; // "__" + upper-case letter
 
     void skip_whitespace();
     void update_line_tracking();
-    void add_error(std::string message, ErrorSeverity severity = ErrorSeverity::Warning);
+    void add_error(ErrorCode code, ErrorSeverity severity = ErrorSeverity::Warning);
 };
 
 // ============================================================================
@@ -235,8 +328,10 @@ private:
 
 /**
  * @brief Extract just the text content from tokens (strip markup)
+ *
+ * @param input The text the tokens were scanned from
  */
-[[nodiscard]] std::string tokens_to_plain_text(std::span<const Token> tokens);
+[[nodiscard]] std::string tokens_to_plain_text(std::string_view input, std::span<const Token> tokens);
 
 /**
  * @brief Convert wikitext to plain text (convenience function)
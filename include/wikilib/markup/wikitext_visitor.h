@@ -6,6 +6,7 @@
  */
 
 #include <functional>
+#include "wikilib/core/namespace_resolver.h"
 #include "wikilib/markup/ast.h"
 
 namespace wikilib::markup {
@@ -178,9 +179,18 @@ public:
         std::string target;
         std::string display;
         bool is_external = false;
+        NamespaceId namespace_id = NS_MAIN; // Namespace of an internal link target
         SourceRange location;
     };
 
+    LinkExtractor() = default;
+
+    /**
+     * @brief Classify link targets with a site's namespace names
+     */
+    explicit LinkExtractor(const NamespaceResolver &namespaces) : namespaces_(&namespaces) {
+    }
+
     void visit(const LinkNode &node) override;
     void visit(const ExternalLinkNode &node) override;
 
@@ -188,6 +198,7 @@ public:
         return links_;
     }
 private:
+    const NamespaceResolver *namespaces_ = &NamespaceResolver::builtin();
     std::vector<ExtractedLink> links_;
 };
 
@@ -0,0 +1,168 @@
+#pragma once
+
+/**
+ * @file json_buffer.h
+ * @brief Append-only JSON output buffer with chunked flushing
+ *
+ * JSON is written straight into one growing byte buffer: strings are
+ * escaped in place, a run of bytes that needs no escaping is copied in
+ * one piece, and numbers go through std::to_chars. A buffer bound to a
+ * file descriptor or stream hands its contents over in large chunks
+ * whenever the flush threshold is passed, so memory stays bounded
+ * however large the document is.
+ */
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace wikilib::output {
+
+/**
+ * @brief JSON byte buffer writing to memory, a file descriptor or a stream
+ *
+ * Example usage:
+ * @code
+ *   JsonBuffer out(STDOUT_FILENO);
+ *   out.put('{');
+ *   out.raw("\"title\": ");
+ *   out.string(page.info.title);
+ *   out.put('}');
+ *   out.flush();
+ * @endcode
+ */
+class JsonBuffer {
+public:
+    static constexpr size_t DEFAULT_FLUSH_THRESHOLD = 64 * 1024;
+
+    /**
+     * @brief Collect output in memory (see take())
+     */
+    JsonBuffer();
+
+    /**
+     * @brief Write output to a file descriptor in chunks (not closed)
+     */
+    explicit JsonBuffer(int fd, size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD);
+
+    /**
+     * @brief Write output to a stream in chunks
+     */
+    explicit JsonBuffer(std::ostream &stream, size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD);
+
+    /**
+     * @brief Flushes pending output to the sink
+     */
+    ~JsonBuffer();
+
+    JsonBuffer(const JsonBuffer &) = delete;
+    JsonBuffer &operator=(const JsonBuffer &) = delete;
+
+    void put(char c) {
+        buffer_.push_back(c);
+    }
+
+    /**
+     * @brief Append bytes as they are (keys, punctuation, literals)
+     */
+    void raw(std::string_view text) {
+        buffer_.append(text);
+    }
+
+    /**
+     * @brief Append n spaces
+     */
+    void spaces(size_t n) {
+        buffer_.append(n, ' ');
+    }
+
+    /**
+     * @brief Append a quoted, escaped string
+     * @param escape_unicode Write non-ASCII characters as \\uXXXX escapes
+     */
+    void string(std::string_view text, bool escape_unicode = false) {
+        buffer_.push_back('"');
+        escaped(text, escape_unicode);
+        buffer_.push_back('"');
+        maybe_flush();
+    }
+
+    /**
+     * @brief Append escaped string content without quotes
+     *
+     * Successive calls between two put('"') build one string from pieces.
+     */
+    void escaped(std::string_view text, bool escape_unicode = false);
+
+    template<std::integral T>
+    void number(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer_.append(digits, result.ptr);
+    }
+
+    void boolean(bool value) {
+        raw(value ? "true" : "false");
+    }
+
+    void null() {
+        raw("null");
+    }
+
+    /**
+     * @brief Hand pending output to the sink once past the flush threshold
+     */
+    void maybe_flush() {
+        if (has_sink() && buffer_.size() >= flush_threshold_) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Hand all pending output to the sink
+     * @return false if writing failed now or earlier
+     */
+    bool flush();
+
+    /**
+     * @brief Move out the collected output (in-memory buffers)
+     */
+    [[nodiscard]] std::string take();
+
+    [[nodiscard]] std::string_view view() const noexcept {
+        return buffer_;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return buffer_.size();
+    }
+
+    /**
+     * @brief Bytes handed to the sink so far
+     */
+    [[nodiscard]] size_t bytes_flushed() const noexcept {
+        return flushed_;
+    }
+
+    [[nodiscard]] bool good() const noexcept {
+        return !failed_;
+    }
+private:
+    [[nodiscard]] bool has_sink() const noexcept {
+        return fd_ >= 0 || stream_ != nullptr;
+    }
+
+    void escape_unicode_sequence(std::string_view text, size_t &i);
+
+    std::string buffer_;
+    int fd_ = -1;
+    std::ostream *stream_ = nullptr;
+    size_t flush_threshold_ = DEFAULT_FLUSH_THRESHOLD;
+    size_t flushed_ = 0;
+    bool failed_ = false;
+};
+
+} // namespace wikilib::output
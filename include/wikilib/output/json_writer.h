@@ -7,11 +7,13 @@
 
 #include <functional>
 #include <memory>
+#include <span>
 #include <ostream>
 #include <string>
 #include <string_view>
 #include "wikilib/dump/page_handler.h"
 #include "wikilib/markup/ast.h"
+#include "wikilib/output/json_buffer.h"
 
 namespace wikilib::output {
 
@@ -27,7 +29,7 @@ struct JsonConfig {
     int indent_size = 2; // Spaces per indent level
     bool include_source_locations = false; // Add location info to nodes
     bool include_raw_text = false; // Include original wikitext
-    bool compact_text_nodes = true; // Merge adjacent text nodes
+    bool compact_text_nodes = false; // Merge adjacent text nodes (escaped piecewise, not concatenated)
     bool escape_unicode = false; // Use \uXXXX escapes
 };
 
@@ -37,6 +39,10 @@ struct JsonConfig {
 
 /**
  * @brief Serialize wikitext AST and page data to JSON
+ *
+ * Output goes straight into a JsonBuffer: keys and per-node-type prefixes
+ * are constant strings, values are escaped in place, and buffers bound to
+ * a file descriptor or stream are flushed in chunks while writing.
  */
 class JsonWriter {
 public:
@@ -64,6 +70,18 @@ public:
     void write_to(const markup::Node &node, std::ostream &out);
     void write_to(const dump::Page &page, std::ostream &out);
 
+    /**
+     * @brief Append to a JSON buffer (flushed in chunks if it has a sink)
+     */
+    void write_to(const markup::Node &node, JsonBuffer &out);
+    void write_to(const dump::Page &page, JsonBuffer &out);
+
+    /**
+     * @brief Write to a file descriptor (not closed)
+     * @return false if writing failed
+     */
+    bool write_to_fd(const markup::Node &node, int fd);
+
     /**
      * @brief Start JSON array (for streaming multiple items)
      */
@@ -93,15 +111,21 @@ public:
 private:
     JsonConfig config_;
     std::ostream *output_ = nullptr;
+    std::unique_ptr<JsonBuffer> array_buffer_; // Chunks array items to output_
     int depth_ = 0;
     bool first_item_ = true;
 
-    void write_node(const markup::Node &node, std::ostream &out);
-    void write_value(std::string_view str, std::ostream &out);
-    void write_indent(std::ostream &out);
-    void write_newline(std::ostream &out);
-    std::string escape_string(std::string_view str);
-    void write_children(const std::vector<std::unique_ptr<markup::Node>> &children, std::ostream &out);
+    void write_page(const dump::Page &page, JsonBuffer &out);
+    void write_node(const markup::Node &node, JsonBuffer &out);
+    void write_text_run(std::span<const std::unique_ptr<markup::Node>> run, JsonBuffer &out);
+    void write_location(size_t begin, size_t end, JsonBuffer &out);
+    void write_value(std::string_view str, JsonBuffer &out);
+    void write_key(std::string_view key, JsonBuffer &out); // ",\n<indent>" + key
+    void write_indent(JsonBuffer &out);
+    void write_newline(JsonBuffer &out);
+    void open(char bracket, JsonBuffer &out);
+    void close(char bracket, JsonBuffer &out);
+    void write_children(const std::vector<std::unique_ptr<markup::Node>> &children, JsonBuffer &out);
 };
 
 // ============================================================================
@@ -162,6 +186,8 @@ public:
 private:
     std::unique_ptr<std::ostream> owned_output_;
     std::ostream *output_;
+    JsonWriter writer_;
+    JsonBuffer buffer_; // Lines are collected here and flushed in chunks
     size_t count_ = 0;
 };
 
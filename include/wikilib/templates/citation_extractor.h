@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * @file citation_extractor.h
+ * @brief Citation mining from <ref> bodies without building an AST
+ *
+ * Combines RefScanner (reference spans) with TemplateSelector (cite
+ * template fields), so every value returned is a view into the page text.
+ */
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "wikilib/markup/ref_scanner.h"
+#include "wikilib/templates/template_selector.h"
+
+namespace wikilib::templates {
+
+/**
+ * @brief Citation template found in a reference
+ */
+struct Citation {
+    size_t ref = 0; // Index into the page's collected refs
+    std::string_view template_name; // e.g. "cite web", as written
+    std::vector<std::pair<std::string_view, std::string_view>> fields; // Selected (name, value) pairs
+};
+
+/**
+ * @brief Extracts refs and their {{cite ...}} fields from page wikitext
+ *
+ * Immutable after construction; extract() may be called concurrently.
+ */
+class CitationExtractor {
+public:
+    /**
+     * @brief Create extractor for given cite fields
+     * @param fields Field names to return (empty = all named fields)
+     * @param templates Template name patterns treated as citations
+     */
+    explicit CitationExtractor(std::vector<std::string> fields = {},
+                               std::vector<std::string> templates = {"Cite *", "Citation"});
+
+    /**
+     * @brief Collect deduplicated refs and the citations inside them
+     * @param wikitext Page text (results point into it)
+     * @param refs Output refs, as collect_refs()
+     * @param citations Output citations, in ref order
+     */
+    void extract(std::string_view wikitext, std::vector<markup::RefSpan> &refs,
+                 std::vector<Citation> &citations) const;
+private:
+    TemplateSelector selector_;
+};
+
+} // namespace wikilib::templates
@@ -10,6 +10,9 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
+#include "wikilib/core/bloom_filter.h"
+#include "wikilib/core/namespace_resolver.h"
 #include "wikilib/core/types.h"
 #include "wikilib/markup/ast.h"
 #include "wikilib/templates/template_parser.h"
@@ -88,6 +91,15 @@ struct ExpansionContext {
 
 /**
  * @brief Configuration for template expansion
+ *
+ * existing_titles holds page titles in dump spelling, as built by
+ * DumpReader::title_filter() ("Szablon:Foo bar"). #ifexist probes it with
+ * its argument as written and with the MediaWiki spelling: trim, '_' to
+ * ' ', the namespace prefix replaced by the site's local name from
+ * namespaces, and the first letter upper-cased only when capital_links is
+ * set. A title the filter rules out takes the "no" branch without asking
+ * the provider, so the filter must cover every page template_exists()
+ * accepts.
  */
 struct ExpanderConfig {
     int max_depth = 40; // Maximum template recursion
@@ -96,6 +108,9 @@ struct ExpanderConfig {
     bool evaluate_lua = false; // Execute Lua modules (requires Lua)
     bool fail_on_missing = false; // Error on missing templates
     bool preserve_unknown = true; // Keep unexpanded if can't expand
+    std::shared_ptr<const BloomFilter> existing_titles; // #ifexist skips the provider for titles not in it
+    std::vector<Namespace> namespaces; // Site namespaces (SiteInfo::namespaces); canonical names if empty
+    bool capital_links = false; // Site upper-cases the first letter of titles (siteinfo <case>first-letter</case>)
 };
 
 // ============================================================================
@@ -158,9 +173,13 @@ private:
     ExpanderConfig config_;
     Stats stats_;
 
+    NamespaceResolver namespaces_;
+
     // Expansion cache
     std::unordered_map<std::string, std::string> cache_;
 
+    [[nodiscard]] bool title_may_exist(std::string_view title) const;
+
     std::string expand_recursive(std::string_view input, ExpansionContext &context);
 
     std::string evaluate_if(const std::vector<std::string> &args);
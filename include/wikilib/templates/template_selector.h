@@ -0,0 +1,143 @@
+#pragma once
+
+/**
+ * @file template_selector.h
+ * @brief Compiled selectors for pulling template arguments from raw wikitext
+ *
+ * Selects fields such as {{Infobox country|population=...}} straight from
+ * page text, without Parser::parse or an AST walk. Only invocations whose
+ * name matches a rule are brace-matched and split, and only the requested
+ * arguments are returned, as views into the input.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "wikilib/core/thread_pool.h"
+
+namespace wikilib::templates {
+
+// ============================================================================
+// Selector rules and results
+// ============================================================================
+
+/**
+ * @brief Template name pattern and the arguments to extract from it
+ *
+ * Names are compared the way MediaWiki resolves titles: an optional
+ * "Template:" prefix, case-insensitive first letter, '_' equal to ' '.
+ * A trailing '*' makes the name a prefix pattern ("Infobox*").
+ * Parameters are named ("population") or positional ("1"); an empty list
+ * selects every argument.
+ */
+struct SelectorRule {
+    std::string template_name;
+    std::vector<std::string> parameters;
+};
+
+/**
+ * @brief One extracted argument
+ */
+struct SelectedArgument {
+    size_t rule = 0; // Index of the matching rule
+    size_t parameter = 0; // Index into rule parameters (0 when selecting all)
+    size_t invocation = 0; // Ordinal of the invocation within the text
+    std::string_view template_name; // Name as written, trimmed
+    std::string_view name; // Argument name as written; empty if positional
+    std::string_view value; // Argument value, trimmed
+};
+
+// ============================================================================
+// Template selector
+// ============================================================================
+
+/**
+ * @brief Immutable matcher compiled from selector rules
+ *
+ * select() is const and keeps no state, so one selector can be shared by
+ * all worker threads of a dump pipeline; select_all() spreads a batch of
+ * pages over a ThreadPool.
+ *
+ * Example usage:
+ * @code
+ *   TemplateSelector selector({{"Infobox country", {"population_estimate", "capital"}}});
+ *   std::vector<SelectedArgument> args;
+ *   selector.select(page_text, args);
+ *   for (const auto& arg : args) { ... arg.value ... }
+ * @endcode
+ */
+class TemplateSelector {
+public:
+    explicit TemplateSelector(std::vector<SelectorRule> rules);
+
+    /**
+     * @brief Extract selected arguments from wikitext
+     * @param wikitext Page text (results point into it)
+     * @param out Output arguments in source order (cleared first)
+     */
+    void select(std::string_view wikitext, std::vector<SelectedArgument> &out) const;
+
+    /**
+     * @brief Extract selected arguments from wikitext
+     */
+    [[nodiscard]] std::vector<SelectedArgument> select(std::string_view wikitext) const;
+
+    /**
+     * @brief Extract selected arguments from many pages in parallel
+     * @param texts Page texts (results point into them)
+     * @param out One argument list per text, in input order; inner vectors
+     *            keep their capacity between batches
+     * @param pool Pool to run on; the calling thread helps
+     */
+    void select_all(std::span<const std::string_view> texts, std::vector<std::vector<SelectedArgument>> &out,
+                    ThreadPool &pool) const;
+
+    /**
+     * @brief select_all() on the shared pool
+     */
+    void select_all(std::span<const std::string_view> texts,
+                    std::vector<std::vector<SelectedArgument>> &out) const {
+        select_all(texts, out, ThreadPool::shared());
+    }
+
+    [[nodiscard]] const std::vector<SelectorRule> &rules() const noexcept {
+        return rules_;
+    }
+private:
+    struct NameHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view sv) const noexcept {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+
+    struct CompiledRule {
+        std::vector<size_t> positional; // Position per rule parameter (0 = named only)
+        bool all = false;
+    };
+
+    void match_rules(std::string_view normalized, std::vector<size_t> &matches) const;
+    void extract(std::string_view wikitext, size_t begin, std::string_view name, const std::vector<size_t> &rules,
+                 size_t invocation, std::vector<SelectedArgument> &out) const;
+
+    std::vector<SelectorRule> rules_;
+    std::vector<CompiledRule> compiled_;
+    std::unordered_map<std::string, std::vector<size_t>, NameHash, std::equal_to<>> exact_; // Normalized name -> rules
+    std::vector<std::pair<std::string, size_t>> prefixes_; // Normalized prefix -> rule
+};
+
+/**
+ * @brief Normalize template name for comparison
+ *
+ * Strips "Template:" prefix and surrounding whitespace, maps '_' to ' ',
+ * collapses repeated spaces and upper-cases an ASCII first letter.
+ */
+[[nodiscard]] std::string normalize_template_name(std::string_view name);
+
+} // namespace wikilib::templates
@@ -0,0 +1,182 @@
+/**
+ * @file arena.cpp
+ * @brief Implementation of mmap-backed bump arenas
+ */
+
+#include "wikilib/core/arena.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace wikilib {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = 2ull << 20;
+
+constexpr size_t align_up(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+#ifdef __linux__
+
+constexpr int MPOL_PREFERRED_MODE = 1; // MPOL_PREFERRED from <numaif.h>
+
+// Prefer the NUMA node the calling thread runs on; must precede first touch
+bool bind_to_local_node(void *data, size_t size) {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return false;
+    }
+    constexpr size_t BITS = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> mask(node / BITS + 1, 0);
+    mask[node / BITS] |= 1ul << (node % BITS);
+    // The kernel reads maxnode - 1 bits
+    return syscall(SYS_mbind, data, size, MPOL_PREFERRED_MODE, mask.data(), mask.size() * BITS + 1, 0) == 0;
+}
+
+#endif
+
+} // namespace
+
+// ============================================================================
+// Arena
+// ============================================================================
+
+Arena::Arena(ArenaConfig config) : config_(config) {
+}
+
+Arena::~Arena() {
+    release();
+}
+
+void *Arena::allocate(size_t bytes, size_t alignment) {
+    bytes = std::max<size_t>(bytes, 1);
+
+    while (true) {
+        // Blocks are huge page aligned, so aligning the offset aligns the pointer
+        while (current_ < blocks_.size()) {
+            Block &block = blocks_[current_];
+            size_t start = align_up(offset_, alignment);
+            if (start + bytes <= block.size) {
+                offset_ = start + bytes;
+                stats_.bytes_used += bytes;
+                stats_.peak_bytes_used = std::max(stats_.peak_bytes_used, stats_.bytes_used);
+                return block.data + start;
+            }
+            current_++;
+            offset_ = 0;
+        }
+        if (!map_block(bytes + alignment)) {
+            throw std::bad_alloc();
+        }
+    }
+}
+
+std::string_view Arena::copy(std::string_view text) {
+    char *data = static_cast<char *>(allocate(text.size(), 1));
+    std::memcpy(data, text.data(), text.size());
+    return {data, text.size()};
+}
+
+void Arena::shrink(void *ptr, size_t old_size, size_t new_size) noexcept {
+    if (current_ >= blocks_.size() || new_size >= old_size) {
+        return;
+    }
+    Block &block = blocks_[current_];
+    if (static_cast<char *>(ptr) + old_size == block.data + offset_) {
+        offset_ -= old_size - new_size;
+        stats_.bytes_used -= old_size - new_size;
+    }
+}
+
+void Arena::reset() noexcept {
+    current_ = 0;
+    offset_ = 0;
+    stats_.bytes_used = 0;
+    stats_.resets++;
+}
+
+void Arena::release() noexcept {
+    for (const auto &block: blocks_) {
+#ifdef __linux__
+        munmap(block.data, block.size);
+#else
+        ::operator delete(block.data, std::align_val_t{HUGE_PAGE_SIZE});
+#endif
+    }
+    blocks_.clear();
+    current_ = 0;
+    offset_ = 0;
+
+    uint64_t resets = stats_.resets;
+    uint64_t peak = stats_.peak_bytes_used;
+    stats_ = ArenaStats{};
+    stats_.resets = resets;
+    stats_.peak_bytes_used = peak;
+}
+
+bool Arena::map_block(size_t min_size) {
+    Block block;
+    block.size = align_up(std::max(config_.block_size, min_size), HUGE_PAGE_SIZE);
+
+#ifdef __linux__
+    if (config_.huge_pages == HugePages::Explicit) {
+        void *data = mmap(nullptr, block.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1,
+                          0);
+        if (data != MAP_FAILED) {
+            block.data = static_cast<char *>(data);
+            stats_.hugetlb_bytes += block.size;
+        }
+    }
+
+    if (!block.data) {
+        // Over-map by one huge page and trim, leaving an aligned block
+        bool aligned = config_.huge_pages != HugePages::Off;
+        size_t length = block.size + (aligned ? HUGE_PAGE_SIZE : 0);
+        void *data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        char *begin = static_cast<char *>(data);
+        block.data = aligned ? reinterpret_cast<char *>(align_up(reinterpret_cast<uintptr_t>(begin), HUGE_PAGE_SIZE))
+                             : begin;
+        if (block.data > begin) {
+            munmap(begin, static_cast<size_t>(block.data - begin));
+        }
+        char *end = begin + length;
+        if (end > block.data + block.size) {
+            munmap(block.data + block.size, static_cast<size_t>(end - (block.data + block.size)));
+        }
+        if (aligned && madvise(block.data, block.size, MADV_HUGEPAGE) == 0) {
+            stats_.thp_bytes += block.size;
+        }
+    }
+
+    if (config_.node_local && bind_to_local_node(block.data, block.size)) {
+        stats_.node_bound_bytes += block.size;
+    }
+#else
+    block.data = static_cast<char *>(::operator new(block.size, std::align_val_t{HUGE_PAGE_SIZE}, std::nothrow));
+    if (!block.data) {
+        return false;
+    }
+#endif
+
+    blocks_.push_back(block);
+    current_ = blocks_.size() - 1;
+    offset_ = 0;
+
+    stats_.bytes_mapped += block.size;
+    stats_.blocks++;
+    return true;
+}
+
+} // namespace wikilib
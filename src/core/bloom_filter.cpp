@@ -0,0 +1,125 @@
+/**
+ * @file bloom_filter.cpp
+ * @brief Implementation of the blocked Bloom filter
+ */
+
+#include "wikilib/core/bloom_filter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace wikilib {
+
+namespace {
+
+constexpr char MAGIC[4] = {'W', 'L', 'B', 'F'};
+
+// Odd multipliers picking one bit per word (as in Parquet's split-block filter)
+constexpr uint32_t SALTS[8] = {0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+                               0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u};
+
+/**
+ * @brief MurmurHash64A; fixed so that serialized filters stay valid
+ */
+uint64_t hash_key(std::string_view key) noexcept {
+    constexpr uint64_t m = 0xc6a4a7935bd1e995ull;
+    constexpr int r = 47;
+    uint64_t h = 0x8445d61a4e774912ull ^ (key.size() * m);
+
+    const char *data = key.data();
+    size_t blocks = key.size() / 8;
+    for (size_t i = 0; i < blocks; ++i) {
+        uint64_t k;
+        std::memcpy(&k, data + i * 8, 8);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    const auto *tail = reinterpret_cast<const unsigned char *>(data + blocks * 8);
+    size_t rest = key.size() & 7;
+    if (rest > 0) {
+        uint64_t k = 0;
+        for (size_t i = 0; i < rest; ++i) {
+            k |= uint64_t{tail[i]} << (8 * i);
+        }
+        h ^= k;
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+} // namespace
+
+// ============================================================================
+// BloomFilter
+// ============================================================================
+
+BloomFilter::BloomFilter(size_t expected_items, double bits_per_item) {
+    double bits = std::max(1.0, static_cast<double>(expected_items) * bits_per_item);
+    blocks_.resize(std::max<size_t>(1, static_cast<size_t>(std::ceil(bits / (8 * sizeof(Block))))), Block{});
+}
+
+void BloomFilter::insert(std::string_view key) noexcept {
+    if (blocks_.empty()) {
+        return;
+    }
+    uint64_t hash = hash_key(key);
+    Block &block = blocks_[block_index(hash)];
+    auto low = static_cast<uint32_t>(hash);
+    for (int i = 0; i < 8; ++i) {
+        block.words[i] |= 1u << ((low * SALTS[i]) >> 27);
+    }
+}
+
+bool BloomFilter::may_contain(std::string_view key) const noexcept {
+    if (blocks_.empty()) {
+        return true;
+    }
+    uint64_t hash = hash_key(key);
+    const Block &block = blocks_[block_index(hash)];
+    auto low = static_cast<uint32_t>(hash);
+    bool all = true;
+    for (int i = 0; i < 8; ++i) {
+        all &= (block.words[i] >> ((low * SALTS[i]) >> 27)) & 1u;
+    }
+    return all;
+}
+
+std::string BloomFilter::serialize() const {
+    uint64_t count = blocks_.size();
+    std::string data(sizeof(MAGIC) + sizeof(count) + size_bytes(), '\0');
+    std::memcpy(data.data(), MAGIC, sizeof(MAGIC));
+    std::memcpy(data.data() + sizeof(MAGIC), &count, sizeof(count));
+    if (count > 0) {
+        std::memcpy(data.data() + sizeof(MAGIC) + sizeof(count), blocks_.data(), size_bytes());
+    }
+    return data;
+}
+
+Result<BloomFilter> BloomFilter::deserialize(std::string_view data) {
+    uint64_t count = 0;
+    if (data.size() < sizeof(MAGIC) + sizeof(count) || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return std::unexpected(ParseError{"Not a Bloom filter", {}, ErrorSeverity::Error, ""});
+    }
+    std::memcpy(&count, data.data() + sizeof(MAGIC), sizeof(count));
+    data.remove_prefix(sizeof(MAGIC) + sizeof(count));
+    if (count > data.size() / sizeof(Block) || data.size() != count * sizeof(Block)) {
+        return std::unexpected(ParseError{"Truncated Bloom filter", {}, ErrorSeverity::Error, ""});
+    }
+
+    BloomFilter filter;
+    filter.blocks_.resize(static_cast<size_t>(count));
+    if (count > 0) {
+        std::memcpy(filter.blocks_.data(), data.data(), data.size());
+    }
+    return filter;
+}
+
+} // namespace wikilib
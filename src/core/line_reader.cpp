@@ -4,9 +4,15 @@
  */
 
 #include "wikilib/core/line_reader.h"
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <cstring>
+#include <fcntl.h>
 #include <istream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace wikilib::core {
 
@@ -212,4 +218,114 @@ bool StreamLineReader::eof() const noexcept {
     return eof_;
 }
 
+// ============================================================================
+// MmapLineReader implementation
+// ============================================================================
+
+struct MmapLineReader::Mapping {
+    void* address = nullptr;
+    size_t length = 0;
+
+    ~Mapping() {
+        if (address) {
+            munmap(address, length);
+        }
+    }
+};
+
+MmapLineReader::MmapLineReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error_ = "Failed to open " + path + ": " + std::strerror(errno);
+        return;
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        error_ = "Failed to stat " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return;
+    }
+
+    // An empty file cannot be mapped; it simply has no lines
+    auto size = static_cast<size_t>(st.st_size);
+    if (size > 0) {
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            error_ = "Failed to map " + path + ": " + std::strerror(errno);
+            ::close(fd);
+            return;
+        }
+        madvise(address, size, MADV_SEQUENTIAL);
+
+        auto mapping = std::make_shared<Mapping>();
+        mapping->address = address;
+        mapping->length = size;
+        data_ = std::string_view(static_cast<const char*>(address), size);
+        mapping_ = std::move(mapping);
+    }
+    ::close(fd);
+}
+
+MmapLineReader MmapLineReader::from_string(std::string_view data) {
+    MmapLineReader reader;
+    reader.data_ = data;
+    return reader;
+}
+
+std::optional<std::string_view> MmapLineReader::read_line_view() {
+    if (position_ >= data_.size()) {
+        return std::nullopt;
+    }
+
+    const char* start = data_.data() + position_;
+    size_t left = data_.size() - position_;
+    const auto* newline = static_cast<const char*>(std::memchr(start, '\n', left));
+
+    size_t length = newline ? static_cast<size_t>(newline - start) : left;
+    position_ += newline ? length + 1 : length;
+    if (length > 0 && start[length - 1] == '\r') {
+        length--;
+    }
+    return std::string_view(start, length);
+}
+
+bool MmapLineReader::read_line(std::string& line) {
+    auto view = read_line_view();
+    if (!view) {
+        return false;
+    }
+    line.assign(*view);
+    return true;
+}
+
+bool MmapLineReader::eof() const noexcept {
+    return position_ >= data_.size();
+}
+
+std::vector<MmapLineReader> MmapLineReader::split(size_t parts) const {
+    std::vector<MmapLineReader> result;
+    std::string_view rest = remaining();
+    parts = std::max<size_t>(parts, 1);
+
+    size_t begin = 0;
+    for (size_t i = 1; i <= parts && begin < rest.size(); ++i) {
+        size_t end = rest.size();
+        if (i < parts) {
+            // Move the nominal boundary to just after the next newline
+            size_t target = std::max(begin, rest.size() / parts * i);
+            size_t newline = rest.find('\n', target);
+            end = newline == std::string_view::npos ? rest.size() : newline + 1;
+        }
+        if (end > begin) {
+            MmapLineReader part;
+            part.mapping_ = mapping_;
+            part.data_ = rest.substr(begin, end - begin);
+            result.push_back(std::move(part));
+        }
+        begin = end;
+    }
+    return result;
+}
+
 } // namespace wikilib::core
@@ -0,0 +1,296 @@
+/**
+ * @file namespace_resolver.cpp
+ * @brief Implementation of namespace name lookup
+ */
+
+#include "wikilib/core/namespace_resolver.h"
+#include <algorithm>
+#include <bit>
+#include "wikilib/core/unicode_utils.h"
+
+namespace wikilib {
+
+namespace {
+
+struct CanonicalName {
+    NamespaceId id;
+    std::string_view name;
+};
+
+constexpr CanonicalName CANONICAL_NAMES[] = {
+    {NS_MEDIA, "Media"},
+    {NS_SPECIAL, "Special"},
+    {NS_TALK, "Talk"},
+    {NS_USER, "User"},
+    {NS_USER + 1, "User talk"},
+    {NS_PROJECT, "Project"},
+    {NS_PROJECT + 1, "Project talk"},
+    {NS_FILE, "File"},
+    {NS_FILE + 1, "File talk"},
+    {NS_MEDIAWIKI, "MediaWiki"},
+    {NS_MEDIAWIKI + 1, "MediaWiki talk"},
+    {NS_TEMPLATE, "Template"},
+    {NS_TEMPLATE + 1, "Template talk"},
+    {NS_HELP, "Help"},
+    {NS_HELP + 1, "Help talk"},
+    {NS_CATEGORY, "Category"},
+    {NS_CATEGORY + 1, "Category talk"},
+    {NS_MODULE, "Module"},
+    {NS_MODULE + 1, "Module talk"},
+};
+
+// Accepted on every wiki alongside the canonical names
+constexpr NamespaceResolver::Alias CANONICAL_ALIASES[] = {
+    {"Image", NS_FILE},
+    {"Image talk", NS_FILE + 1},
+};
+
+constexpr NamespaceResolver::Alias BUILTIN_ALIASES[] = {
+    {"Kategoria", NS_CATEGORY},
+};
+
+constexpr char fold(char c) noexcept {
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<char>(c - 'A' + 'a');
+    }
+    return c == '_' ? ' ' : c;
+}
+
+constexpr bool is_name_space(char c) noexcept {
+    return c == ' ' || c == '_' || c == '\t';
+}
+
+std::string_view trim_name(std::string_view name) noexcept {
+    while (!name.empty() && is_name_space(name.front())) {
+        name.remove_prefix(1);
+    }
+    while (!name.empty() && is_name_space(name.back())) {
+        name.remove_suffix(1);
+    }
+    return name;
+}
+
+// FNV-1a over the folded name
+uint64_t hash_name(std::string_view name) noexcept {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c: name) {
+        hash ^= static_cast<unsigned char>(fold(c));
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Slot of a key for a bucket displacement
+uint32_t displace(uint64_t hash, uint32_t seed) noexcept {
+    uint32_t x = static_cast<uint32_t>(hash >> 32) ^ (seed * 0x9E3779B9u);
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+} // namespace
+
+std::string_view canonical_namespace_name(NamespaceId id) noexcept {
+    for (const auto &entry: CANONICAL_NAMES) {
+        if (entry.id == id) {
+            return entry.name;
+        }
+    }
+    return {};
+}
+
+std::string PageInfo::full_title() const {
+    return full_title(NamespaceResolver::builtin());
+}
+
+std::string PageInfo::full_title(const NamespaceResolver &resolver) const {
+    // A title whose prefix names its own namespace is complete; "Foo:Bar" in Template is not
+    std::string_view prefix = canonical_namespace_name(namespace_id);
+    if (prefix.empty() || resolver.namespace_of(title) == namespace_id) {
+        return title;
+    }
+    std::string full(prefix);
+    full += ':';
+    full += title;
+    return full;
+}
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+NamespaceResolver::NamespaceResolver() : NamespaceResolver(std::span<const Namespace>{}) {
+}
+
+NamespaceResolver::NamespaceResolver(std::span<const Namespace> namespaces, std::span<const Alias> aliases) {
+    std::vector<std::pair<std::string, NamespaceId>> names;
+
+    // Site names first so that they win over a clashing canonical name
+    auto add = [&names](std::string_view name, NamespaceId id) {
+        name = trim_name(name);
+        if (name.empty()) {
+            return;
+        }
+        names.emplace_back(std::string(name), id);
+        std::string lower = unicode::to_lower(name);
+        if (lower != name) {
+            names.emplace_back(std::move(lower), id);
+        }
+    };
+    for (const auto &ns: namespaces) {
+        add(ns.name, ns.id);
+        add(ns.canonical_name, ns.id);
+    }
+    for (const auto &[name, id]: aliases) {
+        add(name, id);
+    }
+    for (const auto &entry: CANONICAL_NAMES) {
+        add(entry.name, entry.id);
+    }
+    for (const auto &[name, id]: CANONICAL_ALIASES) {
+        add(name, id);
+    }
+
+    build(std::move(names));
+}
+
+const NamespaceResolver &NamespaceResolver::builtin() {
+    static const NamespaceResolver resolver({}, BUILTIN_ALIASES);
+    return resolver;
+}
+
+void NamespaceResolver::build(std::vector<std::pair<std::string, NamespaceId>> names) {
+    // Store folded keys, dropping names that fold to one already seen
+    struct Key {
+        uint32_t offset;
+        uint32_t length;
+        NamespaceId id;
+        uint64_t hash;
+    };
+    std::vector<Key> keys;
+    for (auto &[name, id]: names) {
+        std::transform(name.begin(), name.end(), name.begin(), fold);
+        bool seen = std::any_of(keys.begin(), keys.end(), [&](const Key &key) {
+            return std::string_view(keys_).substr(key.offset, key.length) == name;
+        });
+        if (seen) {
+            continue;
+        }
+        keys.push_back({static_cast<uint32_t>(keys_.size()), static_cast<uint32_t>(name.size()), id, hash_name(name)});
+        keys_ += name;
+        max_length_ = std::max(max_length_, name.size());
+    }
+    names_ = keys.size();
+
+    // Hash and displace: keys are grouped into buckets by one half of the
+    // hash, and each bucket (largest first) gets the first seed that puts
+    // all of its keys into free slots
+    uint32_t bucket_count = std::bit_ceil(static_cast<uint32_t>(std::max<size_t>(keys.size() / 2, 1)));
+    uint32_t slot_count = std::bit_ceil(static_cast<uint32_t>(std::max<size_t>(keys.size() * 2, 2)));
+
+    while (true) {
+        bucket_mask_ = bucket_count - 1;
+        slot_mask_ = slot_count - 1;
+        slots_.assign(slot_count, Slot{});
+        seeds_.assign(bucket_count, 0);
+
+        std::vector<std::vector<const Key *>> buckets(bucket_count);
+        for (const auto &key: keys) {
+            buckets[key.hash & bucket_mask_].push_back(&key);
+        }
+        std::vector<uint32_t> order(bucket_count);
+        for (uint32_t i = 0; i < bucket_count; ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        bool placed_all = true;
+        std::vector<uint32_t> taken;
+        for (uint32_t bucket: order) {
+            if (buckets[bucket].empty()) {
+                break;
+            }
+            bool placed = false;
+            for (uint32_t seed = 0; seed < (1u << 16) && !placed; ++seed) {
+                taken.clear();
+                placed = true;
+                for (const Key *key: buckets[bucket]) {
+                    uint32_t slot = displace(key->hash, seed) & slot_mask_;
+                    if (slots_[slot].length != 0 || std::find(taken.begin(), taken.end(), slot) != taken.end()) {
+                        placed = false;
+                        break;
+                    }
+                    taken.push_back(slot);
+                }
+                if (placed) {
+                    seeds_[bucket] = seed;
+                    for (size_t i = 0; i < taken.size(); ++i) {
+                        const Key *key = buckets[bucket][i];
+                        slots_[taken[i]] = {key->offset, key->length, key->id};
+                    }
+                }
+            }
+            if (!placed) {
+                placed_all = false;
+                break;
+            }
+        }
+        if (placed_all) {
+            return;
+        }
+        slot_count *= 2;
+    }
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+std::optional<NamespaceId> NamespaceResolver::find(std::string_view name) const noexcept {
+    name = trim_name(name);
+    if (name.empty() || name.size() > max_length_ || slots_.empty()) {
+        return std::nullopt;
+    }
+
+    uint64_t hash = hash_name(name);
+    const Slot &slot = slots_[displace(hash, seeds_[hash & bucket_mask_]) & slot_mask_];
+    if (slot.length != name.size()) {
+        return std::nullopt;
+    }
+    const char *key = keys_.data() + slot.offset;
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (fold(name[i]) != key[i]) {
+            return std::nullopt;
+        }
+    }
+    return slot.id;
+}
+
+ResolvedTitle NamespaceResolver::resolve(std::string_view title) const noexcept {
+    ResolvedTitle result;
+    result.local = title;
+
+    size_t colon = title.find(':');
+    if (colon == std::string_view::npos) {
+        return result;
+    }
+    auto id = find(title.substr(0, colon));
+    if (!id) {
+        return result;
+    }
+
+    result.namespace_id = *id;
+    result.prefix = trim_name(title.substr(0, colon));
+    std::string_view local = title.substr(colon + 1);
+    while (!local.empty() && is_name_space(local.front())) {
+        local.remove_prefix(1);
+    }
+    result.local = local;
+    return result;
+}
+
+} // namespace wikilib
@@ -476,6 +476,16 @@ std::optional<std::string_view> get_line(std::string_view str, size_t line_numbe
 
 namespace wikilib {
 
+std::string_view error_code_message(ErrorCode code) noexcept {
+    switch (code) {
+        case ErrorCode::None:
+            return "";
+        case ErrorCode::MaxDepthExceeded:
+            return "Maximum nesting depth exceeded";
+    }
+    return "";
+}
+
 std::string ParseError::format() const {
     std::string result;
 
@@ -492,7 +502,7 @@ std::string ParseError::format() const {
             break;
     }
 
-    result += message;
+    result += message.empty() ? error_code_message(code) : std::string_view(message);
 
     // Add location if available
     if (location.begin.line > 0) {
@@ -511,4 +521,18 @@ std::string ParseError::format() const {
     return result;
 }
 
+std::string ParseError::format(std::string_view source) const {
+    if (!context.empty() || location.begin.offset > source.size()) {
+        return format();
+    }
+
+    size_t offset = location.begin.offset;
+    size_t begin = offset > 20 ? offset - 20 : 0;
+    size_t end = std::min(offset + 20, source.size());
+
+    ParseError copy = *this;
+    copy.context = std::string(source.substr(begin, end - begin));
+    return copy.format();
+}
+
 } // namespace wikilib
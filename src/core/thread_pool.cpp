@@ -0,0 +1,341 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implementation of the work-stealing task pool
+ */
+
+#include "wikilib/core/thread_pool.h"
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace wikilib {
+
+namespace {
+
+// Pool and worker index of the calling thread
+thread_local const ThreadPool *current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+#ifdef __linux__
+
+// Parse a sysfs CPU list such as "0-3,8-11"
+std::vector<int> parse_cpu_list(const std::string &list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t comma = list.find(',', pos);
+        std::string range = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception &) {
+            // Ignore malformed entries
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+    return cpus;
+}
+
+// CPUs grouped by NUMA node, nodes in id order
+std::vector<int> cpus_by_node() {
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    std::error_code ec;
+    for (const auto &entry: std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+        std::string name = entry.path().filename().string();
+        if (!name.starts_with("node") || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        std::ifstream in(entry.path() / "cpulist");
+        std::string list;
+        std::getline(in, list);
+        nodes.emplace_back(std::stoi(name.substr(4)), parse_cpu_list(list));
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    std::vector<int> cpus;
+    for (const auto &node: nodes) {
+        cpus.insert(cpus.end(), node.second.begin(), node.second.end());
+    }
+    if (cpus.empty()) {
+        for (unsigned cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+void pin_thread(std::thread &thread, int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+}
+
+#endif
+
+} // namespace
+
+// ============================================================================
+// ThreadPool::Impl
+// ============================================================================
+
+struct ThreadPool::Impl {
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks; // Owner at the back, thieves at the front
+    };
+
+    const ThreadPool *owner = nullptr;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex injection_mutex;
+    std::deque<Task> injection; // Tasks from threads outside the pool
+
+    // Sleeping workers; pending counts queued tasks
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    std::atomic<size_t> pending{0};
+    bool stopping = false;
+
+    void push(Task task);
+    std::optional<Task> take(size_t worker);
+    std::optional<Task> take_external();
+    void worker_loop(size_t worker);
+};
+
+void ThreadPool::Impl::push(Task task) {
+    {
+        // Counted first (and under the sleep lock) so that pending never
+        // drops below the number of queued tasks and no wakeup is missed
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (current_pool == owner) {
+        Worker &own = *workers[current_index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injection_mutex);
+        injection.push_back(std::move(task));
+    }
+    sleep_cv.notify_one();
+}
+
+std::optional<ThreadPool::Task> ThreadPool::Impl::take(size_t worker) {
+    {
+        Worker &own = *workers[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            Task task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    if (auto task = take_external()) {
+        return task;
+    }
+
+    // Steal the oldest task of another worker, starting after our own index
+    for (size_t i = 1; i < workers.size(); ++i) {
+        Worker &victim = *workers[(worker + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            Task task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<ThreadPool::Task> ThreadPool::Impl::take_external() {
+    std::lock_guard<std::mutex> lock(injection_mutex);
+    if (injection.empty()) {
+        return std::nullopt;
+    }
+    Task task = std::move(injection.front());
+    injection.pop_front();
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+}
+
+void ThreadPool::Impl::worker_loop(size_t worker) {
+    current_pool = owner;
+    current_index = worker;
+
+    while (true) {
+        if (auto task = take(worker)) {
+            (*task)();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_cv.wait(lock, [this] { return stopping || pending.load(std::memory_order_relaxed) > 0; });
+        if (stopping && pending.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// ThreadPool
+// ============================================================================
+
+ThreadPool::ThreadPool(ThreadPoolConfig config) : impl_(std::make_unique<Impl>()) {
+    impl_->owner = this;
+
+    size_t n = config.threads;
+    if (n == 0) {
+        n = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t w = 0; w < n; ++w) {
+        impl_->workers.push_back(std::make_unique<Impl::Worker>());
+    }
+
+#ifdef __linux__
+    std::vector<int> cpus = config.pin_workers ? cpus_by_node() : std::vector<int>{};
+#endif
+    impl_->threads.reserve(n);
+    for (size_t w = 0; w < n; ++w) {
+        impl_->threads.emplace_back([this, w] { impl_->worker_loop(w); });
+#ifdef __linux__
+        if (!cpus.empty()) {
+            pin_thread(impl_->threads.back(), cpus[w % cpus.size()]);
+        }
+#endif
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->sleep_mutex);
+        impl_->stopping = true;
+    }
+    impl_->sleep_cv.notify_all();
+    for (auto &thread: impl_->threads) {
+        thread.join();
+    }
+}
+
+ThreadPool &ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+size_t ThreadPool::size() const noexcept {
+    return impl_->workers.size();
+}
+
+int ThreadPool::current_worker() const noexcept {
+    return current_pool == this ? static_cast<int>(current_index) : -1;
+}
+
+void ThreadPool::post(Task task) {
+    impl_->push(std::move(task));
+}
+
+bool ThreadPool::run_pending_task() {
+    auto task = current_pool == this ? impl_->take(current_index) : impl_->take_external();
+    if (!task) {
+        return false;
+    }
+    (*task)();
+    return true;
+}
+
+// ============================================================================
+// Parallel loops
+// ============================================================================
+
+void parallel_for(ThreadPool &pool, size_t begin, size_t end, const std::function<void(size_t, size_t)> &body,
+                  size_t grain) {
+    if (begin >= end) {
+        return;
+    }
+    size_t count = end - begin;
+    if (grain == 0) {
+        // A few chunks per worker leave room for stealing on uneven work
+        grain = std::max<size_t>(1, count / (pool.size() * 4));
+    }
+    size_t chunks = (count + grain - 1) / grain;
+
+    // Helpers may start after the loop is over, so the state is shared
+    struct LoopState {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<LoopState>();
+
+    auto work = [state, &body, begin, end, grain, chunks] {
+        while (true) {
+            size_t chunk = state->next.fetch_add(1);
+            if (chunk >= chunks) {
+                return;
+            }
+            size_t first = begin + chunk * grain;
+            try {
+                body(first, std::min(end, first + grain));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) {
+                    state->error = std::current_exception();
+                }
+            }
+            if (state->done.fetch_add(1) + 1 == chunks) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done_cv.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(chunks, pool.size() + 1) - 1;
+    for (size_t i = 0; i < helpers; ++i) {
+        pool.post(work);
+    }
+    work();
+
+    // Chunks still running elsewhere; a worker keeps running pool tasks
+    bool on_pool = pool.current_worker() >= 0;
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (state->done.load() < chunks) {
+        if (!on_pool) {
+            state->done_cv.wait(lock);
+            continue;
+        }
+        lock.unlock();
+        bool ran = pool.run_pending_task();
+        lock.lock();
+        if (!ran && state->done.load() < chunks) {
+            state->done_cv.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+} // namespace wikilib
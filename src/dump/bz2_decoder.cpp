@@ -0,0 +1,915 @@
+/**
+ * @file bz2_decoder.cpp
+ * @brief Implementation of the in-tree bzip2 decoder
+ */
+
+#include "wikilib/dump/bz2_decoder.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "wikilib/core/thread_pool.h"
+
+namespace wikilib::dump {
+
+namespace {
+
+constexpr uint64_t BLOCK_MAGIC = 0x314159265359ull;
+constexpr uint64_t END_MAGIC = 0x177245385090ull;
+constexpr uint64_t MAGIC_MASK = (1ull << 48) - 1;
+
+constexpr int MAX_CODE_LENGTH = 20;
+constexpr int LOOKUP_BITS = 10;
+constexpr int MAX_GROUPS = 6;
+constexpr int GROUP_SIZE = 50;
+constexpr size_t MAX_SELECTORS = 18002; // As in libbz2 1.0.8; further selectors are read and ignored
+constexpr int MAX_ALPHA = 258;
+constexpr int RUNA = 0;
+constexpr int RUNB = 1;
+
+// bzip2 uses the MSB-first CRC-32 (polynomial 0x04c11db7)
+constexpr std::array<uint32_t, 256> CRC_TABLE = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i << 24;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04c11db7u : crc << 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}();
+
+uint32_t block_crc(const char *data, size_t size) {
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = (crc << 8) ^ CRC_TABLE[(crc >> 24) ^ static_cast<uint8_t>(data[i])];
+    }
+    return ~crc;
+}
+
+std::atomic<Bz2Backend> &backend_setting() {
+    static std::atomic<Bz2Backend> backend = [] {
+        const char *env = std::getenv("WIKILIB_BZ2_BACKEND");
+        return env && std::string_view(env) == "native" ? Bz2Backend::Native : Bz2Backend::Libbz2;
+    }();
+    return backend;
+}
+
+ParseError decode_error(const char *message) {
+    return ParseError{std::string("BZ2 decompression failed: ") + message, {}, ErrorSeverity::Error, ""};
+}
+
+// ============================================================================
+// Bit reader
+// ============================================================================
+
+/**
+ * @brief MSB-first bit reader over a byte buffer, starting at any bit
+ *
+ * Reads past the end return zero bits and set overrun().
+ */
+class BitReader {
+public:
+    BitReader(std::string_view data, uint64_t bit_pos) :
+        data_(reinterpret_cast<const uint8_t *>(data.data())), size_(data.size()), byte_pos_(bit_pos / 8),
+        pos_(bit_pos - bit_pos % 8), total_bits_(uint64_t{data.size()} * 8) {
+        refill();
+        consume(static_cast<int>(bit_pos % 8));
+    }
+
+    /**
+     * @brief Next n bits (n <= 32) without consuming them
+     */
+    [[nodiscard]] uint32_t peek(int n) {
+        if (count_ < n) {
+            refill();
+        }
+        return static_cast<uint32_t>(buffer_ >> (64 - n));
+    }
+
+    void consume(int n) {
+        buffer_ <<= n;
+        count_ -= n;
+        pos_ += static_cast<uint64_t>(n);
+    }
+
+    uint32_t bits(int n) {
+        uint32_t value = peek(n);
+        consume(n);
+        return value;
+    }
+
+    [[nodiscard]] uint64_t bits48() {
+        uint64_t high = bits(24);
+        return (high << 24) | bits(24);
+    }
+
+    [[nodiscard]] uint64_t position() const noexcept {
+        return pos_;
+    }
+
+    [[nodiscard]] bool overrun() const noexcept {
+        return pos_ > total_bits_;
+    }
+private:
+    void refill() {
+        while (count_ <= 56 && byte_pos_ < size_) {
+            buffer_ |= uint64_t{data_[byte_pos_++]} << (56 - count_);
+            count_ += 8;
+        }
+        if (count_ < 0) {
+            count_ = 0; // Past the end: zero bits
+        }
+    }
+
+    const uint8_t *data_;
+    size_t size_;
+    size_t byte_pos_;
+    uint64_t buffer_ = 0; // Next bits, left-aligned
+    int count_ = 0; // Valid bits in buffer_
+    uint64_t pos_; // Bits consumed from the start of data
+    uint64_t total_bits_;
+};
+
+// ============================================================================
+// Huffman tables
+// ============================================================================
+
+/**
+ * @brief Canonical Huffman decoder resolving up to two symbols per lookup
+ *
+ * An entry of the 10-bit table holds the first symbol in the window and,
+ * when its code leaves room for another complete code, the second one:
+ * bits 0-4 first length, 5-9 total length, 10-11 symbol count (0 = code
+ * longer than 10 bits), 12-20 first symbol, 21-29 second symbol.
+ */
+class HuffmanTable {
+public:
+    bool build(const uint8_t *lengths, int alpha_size) {
+        int min_len = MAX_CODE_LENGTH;
+        max_len_ = 0;
+        for (int i = 0; i < alpha_size; ++i) {
+            min_len = std::min<int>(min_len, lengths[i]);
+            max_len_ = std::max<int>(max_len_, lengths[i]);
+        }
+
+        // Single-symbol table first: (symbol << 5) | length, 0 = longer code
+        std::array<uint16_t, 1 << LOOKUP_BITS> single{};
+        limit_.fill(-1);
+        int code = 0;
+        int index = 0;
+        for (int len = min_len; len <= max_len_; ++len) {
+            base_[static_cast<size_t>(len)] = index - code;
+            for (int sym = 0; sym < alpha_size; ++sym) {
+                if (lengths[sym] != len) {
+                    continue;
+                }
+                if (code >= (1 << len)) {
+                    return false; // Over-subscribed: no code of this length is left
+                }
+                perm_[static_cast<size_t>(index++)] = static_cast<uint16_t>(sym);
+                if (len <= LOOKUP_BITS) {
+                    int shift = LOOKUP_BITS - len;
+                    auto entry = static_cast<uint16_t>((sym << 5) | len);
+                    std::fill_n(single.begin() + (code << shift), 1 << shift, entry);
+                }
+                code++;
+            }
+            limit_[static_cast<size_t>(len)] = code - 1;
+            code <<= 1;
+        }
+
+        // Pair up symbols; never read past the end-of-block symbol
+        const int end_of_block = alpha_size - 1;
+        for (uint32_t window = 0; window < single.size(); ++window) {
+            uint16_t first = single[window];
+            if (first == 0) {
+                lookup_[window] = 0;
+                continue;
+            }
+            uint32_t first_len = first & 31u;
+            uint32_t first_sym = first >> 5;
+            uint32_t entry = first_len | (first_len << 5) | (1u << 10) | (first_sym << 12);
+            if (first_len < LOOKUP_BITS && static_cast<int>(first_sym) != end_of_block) {
+                uint16_t second = single[(window << first_len) & (single.size() - 1)];
+                uint32_t second_len = second & 31u;
+                if (second != 0 && second_len <= LOOKUP_BITS - first_len) {
+                    entry = first_len | ((first_len + second_len) << 5) | (2u << 10) | (first_sym << 12) |
+                            (static_cast<uint32_t>(second >> 5) << 21);
+                }
+            }
+            lookup_[window] = entry;
+        }
+        return true;
+    }
+
+    [[nodiscard]] uint32_t entry(uint32_t window20) const noexcept {
+        return lookup_[window20 >> (MAX_CODE_LENGTH - LOOKUP_BITS)];
+    }
+
+    /**
+     * @brief Decode a code longer than 10 bits, -1 if invalid
+     */
+    int decode_long(uint32_t window20, BitReader &reader) const {
+        for (int len = LOOKUP_BITS + 1; len <= max_len_; ++len) {
+            auto code = static_cast<int>(window20 >> (MAX_CODE_LENGTH - len));
+            if (code <= limit_[static_cast<size_t>(len)]) {
+                reader.consume(len);
+                return perm_[static_cast<size_t>(base_[static_cast<size_t>(len)] + code)];
+            }
+        }
+        return -1;
+    }
+private:
+    std::array<uint32_t, 1 << LOOKUP_BITS> lookup_{};
+    std::array<int, MAX_CODE_LENGTH + 1> limit_{}; // Largest code of each length
+    std::array<int, MAX_CODE_LENGTH + 1> base_{}; // perm_ index minus first code of each length
+    std::array<uint16_t, MAX_ALPHA> perm_{}; // Symbols in code order
+    int max_len_ = 0;
+};
+
+// ============================================================================
+// Output buffers
+// ============================================================================
+
+/**
+ * @brief Decoder output appended to a std::string
+ */
+class StringOutput {
+public:
+    explicit StringOutput(std::string &buffer) : buffer_(buffer), size(buffer.size()) {
+    }
+
+    /**
+     * @brief Make room for needed bytes in total; returns the buffer
+     */
+    char *reserve(size_t needed) {
+        if (needed > buffer_.size()) {
+            buffer_.resize(std::max(buffer_.size() * 2, needed));
+        }
+        return buffer_.data();
+    }
+
+    void finish() {
+        buffer_.resize(size);
+    }
+
+    std::string &buffer_;
+    size_t size; // Bytes written
+};
+
+/**
+ * @brief Decoder output in one arena allocation, moved on growth
+ */
+class ArenaOutput {
+public:
+    ArenaOutput(Arena &arena, size_t estimate) : arena_(arena) {
+        reserve(std::max<size_t>(estimate, 4096));
+    }
+
+    char *reserve(size_t needed) {
+        if (needed > capacity_) {
+            size_t capacity = std::max(capacity_ * 2, needed);
+            char *bigger = arena_.allocate_array<char>(capacity);
+            if (capacity_ > 0) {
+                std::memcpy(bigger, data_, capacity_); // Includes a block being written
+            }
+            data_ = bigger;
+            capacity_ = capacity;
+        }
+        return data_;
+    }
+
+    std::string_view finish() {
+        arena_.shrink(data_, capacity_, size);
+        return {data_, size};
+    }
+
+    void abandon() {
+        arena_.shrink(data_, capacity_, 0);
+    }
+
+    size_t size = 0; // Bytes written
+private:
+    Arena &arena_;
+    char *data_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+// ============================================================================
+// Block decoding
+// ============================================================================
+
+struct BlockInfo {
+    uint32_t crc = 0; // Stored CRC (verified)
+    uint64_t end_bit = 0; // First bit after the block
+    bool truncated = false; // Failed because the input ended
+};
+
+/**
+ * @brief Decode the block whose magic starts at bit_pos, appending to out
+ * @return Error message (out unchanged), or nullptr
+ */
+template<typename Output>
+const char *decode_block(std::string_view input, uint64_t bit_pos, uint32_t max_block, Output &out,
+                         BlockInfo &info) {
+    BitReader reader(input, bit_pos);
+    auto fail = [&](const char *message) {
+        info.truncated = reader.overrun();
+        return message;
+    };
+
+    if (reader.bits48() != BLOCK_MAGIC) {
+        return fail("bad block header");
+    }
+    info.crc = reader.bits(32);
+    if (reader.bits(1) != 0) {
+        return fail("randomised blocks are not supported");
+    }
+    uint32_t orig_ptr = reader.bits(24);
+
+    // Symbol map: which byte values occur in the block
+    std::array<uint8_t, 256> seq_to_unseq{};
+    int in_use = 0;
+    uint32_t in_use16 = reader.bits(16);
+    for (int i = 0; i < 16; ++i) {
+        if (in_use16 & (0x8000u >> i)) {
+            uint32_t bits = reader.bits(16);
+            for (int j = 0; j < 16; ++j) {
+                if (bits & (0x8000u >> j)) {
+                    seq_to_unseq[static_cast<size_t>(in_use++)] = static_cast<uint8_t>(i * 16 + j);
+                }
+            }
+        }
+    }
+    if (in_use == 0) {
+        return fail("empty symbol map");
+    }
+    int alpha_size = in_use + 2;
+
+    // Selectors, MTF-coded in unary
+    auto groups = static_cast<int>(reader.bits(3));
+    auto selector_count = static_cast<size_t>(reader.bits(15));
+    if (groups < 2 || groups > MAX_GROUPS || selector_count < 1) {
+        return fail("bad selector header");
+    }
+    std::vector<uint8_t> selectors;
+    selectors.reserve(std::min(selector_count, MAX_SELECTORS));
+    std::array<uint8_t, MAX_GROUPS> selector_mtf = {0, 1, 2, 3, 4, 5};
+    for (size_t i = 0; i < selector_count; ++i) {
+        int j = 0;
+        while (reader.bits(1)) {
+            if (++j >= groups || reader.overrun()) {
+                return fail("bad selector");
+            }
+        }
+        if (i < MAX_SELECTORS) {
+            uint8_t value = selector_mtf[static_cast<size_t>(j)];
+            std::copy_backward(selector_mtf.begin(), selector_mtf.begin() + j, selector_mtf.begin() + j + 1);
+            selector_mtf[0] = value;
+            selectors.push_back(value);
+        }
+    }
+
+    // Code lengths, delta-coded
+    std::array<HuffmanTable, MAX_GROUPS> tables;
+    for (int t = 0; t < groups; ++t) {
+        std::array<uint8_t, MAX_ALPHA> lengths{};
+        auto length = static_cast<int>(reader.bits(5));
+        for (int i = 0; i < alpha_size; ++i) {
+            while (true) {
+                if (length < 1 || length > MAX_CODE_LENGTH || reader.overrun()) {
+                    return fail("bad code length");
+                }
+                if (!reader.bits(1)) {
+                    break;
+                }
+                length += reader.bits(1) ? -1 : 1;
+            }
+            lengths[static_cast<size_t>(i)] = static_cast<uint8_t>(length);
+        }
+        if (!tables[static_cast<size_t>(t)].build(lengths.data(), alpha_size)) {
+            return fail("bad Huffman code");
+        }
+    }
+
+    // Huffman and MTF/RLE2 decoding into tt (byte in the low 8 bits)
+    thread_local std::vector<uint32_t> tt;
+    tt.resize(max_block);
+    std::array<uint32_t, 256> counts{};
+    std::array<uint8_t, 256> mtf{};
+    for (int i = 0; i < 256; ++i) {
+        mtf[static_cast<size_t>(i)] = static_cast<uint8_t>(i);
+    }
+
+    const int end_of_block = in_use + 1;
+    uint32_t block_size = 0;
+    uint32_t run = 0;
+    uint32_t run_weight = 1;
+    size_t group = 0;
+    int group_left = 0;
+    int pending = -1; // Second symbol of the last lookup
+    const HuffmanTable *table = nullptr;
+
+    while (true) {
+        if (group_left == 0) {
+            if (group >= selectors.size()) {
+                return fail("too few selectors");
+            }
+            table = &tables[selectors[group++]];
+            group_left = GROUP_SIZE;
+        }
+        group_left--;
+
+        int sym = pending;
+        pending = -1;
+        if (sym < 0) {
+            uint32_t window = reader.peek(MAX_CODE_LENGTH);
+            uint32_t entry = table->entry(window);
+            uint32_t count = (entry >> 10) & 3u;
+            if (count == 2 && group_left > 0) {
+                // Both codes belong to this group of 50
+                reader.consume(static_cast<int>((entry >> 5) & 31u));
+                sym = static_cast<int>((entry >> 12) & 511u);
+                pending = static_cast<int>(entry >> 21);
+            } else if (count != 0) {
+                reader.consume(static_cast<int>(entry & 31u));
+                sym = static_cast<int>((entry >> 12) & 511u);
+            } else {
+                sym = table->decode_long(window, reader);
+            }
+            if (sym < 0 || reader.overrun()) {
+                return fail("bad Huffman symbol");
+            }
+        }
+
+        if (sym == RUNA || sym == RUNB) {
+            if (run_weight > max_block) {
+                return fail("run too long");
+            }
+            run += run_weight << (sym == RUNB ? 1 : 0);
+            run_weight <<= 1;
+            continue;
+        }
+
+        if (run > 0) {
+            if (run > max_block - block_size) {
+                return fail("block too long");
+            }
+            uint8_t byte = seq_to_unseq[mtf[0]];
+            counts[byte] += run;
+            std::fill_n(tt.begin() + block_size, run, byte);
+            block_size += run;
+            run = 0;
+            run_weight = 1;
+        }
+
+        if (sym == end_of_block) {
+            break;
+        }
+        if (block_size >= max_block) {
+            return fail("block too long");
+        }
+        auto index = static_cast<size_t>(sym - 1);
+        uint8_t value = mtf[index];
+        std::memmove(mtf.data() + 1, mtf.data(), index);
+        mtf[0] = value;
+        uint8_t byte = seq_to_unseq[value];
+        counts[byte]++;
+        tt[block_size++] = byte;
+    }
+    info.end_bit = reader.position();
+
+    if (orig_ptr >= block_size) {
+        return fail("bad BWT origin");
+    }
+
+    // Inverse BWT: link each position to its successor in the upper 24 bits
+    std::array<uint32_t, 256> next{};
+    for (size_t i = 0, sum = 0; i < 256; ++i) {
+        next[i] = static_cast<uint32_t>(sum);
+        sum += counts[i];
+    }
+    for (uint32_t i = 0; i < block_size; ++i) {
+        uint8_t byte = tt[i] & 0xff;
+        tt[next[byte]++] |= i << 8;
+    }
+
+    // Walk the chain straight into the output, undoing the initial
+    // run-length coding (4 equal bytes + count)
+    const size_t start = out.size;
+    size_t n = start;
+    size_t capacity = start + block_size + block_size / 4;
+    char *data = out.reserve(capacity);
+    uint32_t pos = tt[orig_ptr] >> 8;
+    int prev = -1;
+    int same = 0;
+    for (uint32_t i = 0; i < block_size; ++i) {
+        uint32_t entry = tt[pos];
+        pos = entry >> 8;
+        auto byte = static_cast<uint8_t>(entry);
+
+        size_t emit = same == 4 ? byte : 1;
+        if (n + emit > capacity) {
+            capacity = std::max(capacity * 2, n + emit);
+            data = out.reserve(capacity);
+        }
+        if (same == 4) {
+            std::memset(data + n, prev, emit);
+            n += emit;
+            same = 0;
+            continue;
+        }
+        if (byte == prev) {
+            same++;
+        } else {
+            prev = byte;
+            same = 1;
+        }
+        data[n++] = static_cast<char>(byte);
+    }
+
+    if (block_crc(data + start, n - start) != info.crc) {
+        return fail("block CRC mismatch");
+    }
+    out.size = n;
+    return nullptr;
+}
+
+/**
+ * @brief Bit positions of block magics from from_bit up to the first end magic
+ *
+ * Magic patterns can also occur inside compressed data; callers only use
+ * a candidate when the previous block ends exactly there.
+ */
+std::vector<uint64_t> find_block_starts(std::string_view input, uint64_t from_bit) {
+    std::vector<uint64_t> starts;
+    uint64_t window = 0;
+    size_t first = static_cast<size_t>(from_bit / 8);
+    for (size_t i = first; i < input.size(); ++i) {
+        window = (window << 8) | static_cast<uint8_t>(input[i]);
+        uint64_t loaded = uint64_t{i - first + 1} * 8;
+        uint64_t end = uint64_t{i + 1} * 8;
+        for (int shift = 7; shift >= 0; --shift) {
+            if (loaded < 48u + static_cast<uint64_t>(shift)) {
+                continue;
+            }
+            uint64_t value = (window >> shift) & MAGIC_MASK;
+            uint64_t start = end - static_cast<uint64_t>(shift) - 48;
+            if (start < from_bit) {
+                continue;
+            }
+            if (value == BLOCK_MAGIC) {
+                starts.push_back(start);
+            } else if (value == END_MAGIC) {
+                return starts;
+            }
+        }
+    }
+    return starts;
+}
+
+/**
+ * @brief Block size limit from a "BZh1".."BZh9" header at offset, 0 if none
+ */
+uint32_t stream_block_limit(std::string_view input, size_t offset) {
+    if (input.size() - offset < 4 || input.substr(offset, 3) != "BZh" || input[offset + 3] < '1' ||
+        input[offset + 3] > '9') {
+        return 0;
+    }
+    return static_cast<uint32_t>(input[offset + 3] - '0') * 100000;
+}
+
+uint32_t combine_crc(uint32_t combined, uint32_t block) {
+    return ((combined << 1) | (combined >> 31)) ^ block;
+}
+
+/**
+ * @brief Blocks of one stream decoded ahead on a thread pool
+ */
+struct ParallelBlock {
+    std::string data;
+    BlockInfo info;
+    const char *error = nullptr;
+};
+
+/**
+ * @brief Decode the stream whose header starts at byte offset
+ * @return Error message, or nullptr with offset moved past the stream
+ */
+template<typename Output>
+const char *decode_stream(std::string_view input, size_t &offset, Output &out, const Bz2DecodeConfig &config) {
+    uint32_t max_block = stream_block_limit(input, offset);
+    if (max_block == 0) {
+        return "not BZ2 data";
+    }
+    uint64_t pos = uint64_t{offset + 4} * 8;
+
+    // Decode candidate blocks in parallel; the chain below picks the real ones
+    std::vector<uint64_t> starts;
+    std::vector<ParallelBlock> decoded;
+    if (config.pool && input.size() - offset >= config.min_parallel_size) {
+        starts = find_block_starts(input, pos);
+        decoded.resize(starts.size());
+        if (starts.size() > 1) {
+            parallel_for(*config.pool, 0, starts.size(), [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    StringOutput block_out(decoded[i].data);
+                    decoded[i].error = decode_block(input, starts[i], max_block, block_out, decoded[i].info);
+                    block_out.finish();
+                }
+            }, 1);
+        } else {
+            starts.clear();
+        }
+    }
+
+    uint32_t combined_crc = 0;
+    while (true) {
+        BitReader reader(input, pos);
+        uint64_t magic = reader.bits48();
+        if (reader.overrun()) {
+            return "unexpected end of data";
+        }
+        if (magic == END_MAGIC) {
+            if (reader.bits(32) != combined_crc || reader.overrun()) {
+                return "stream CRC mismatch";
+            }
+            offset = static_cast<size_t>((reader.position() + 7) / 8);
+            return nullptr;
+        }
+
+        BlockInfo info;
+        auto it = std::lower_bound(starts.begin(), starts.end(), pos);
+        ParallelBlock *block = it != starts.end() && *it == pos ? &decoded[static_cast<size_t>(it - starts.begin())]
+                                                                 : nullptr;
+        if (block && !block->error) {
+            // Copy the block decoded ahead into place
+            char *data = out.reserve(out.size + block->data.size());
+            std::memcpy(data + out.size, block->data.data(), block->data.size());
+            out.size += block->data.size();
+            info = block->info;
+            block->data = std::string();
+        } else if (const char *error = decode_block(input, pos, max_block, out, info)) {
+            return error;
+        }
+
+        combined_crc = combine_crc(combined_crc, info.crc);
+        pos = info.end_bit;
+    }
+}
+
+/**
+ * @brief Decode all concatenated streams into out
+ */
+template<typename Output>
+const char *decode_all(std::string_view compressed, Output &out, const Bz2DecodeConfig &config) {
+    size_t offset = 0;
+    do {
+        if (const char *error = decode_stream(compressed, offset, out, config)) {
+            return error;
+        }
+        // Concatenated streams follow byte-aligned; anything else is trailing garbage
+    } while (stream_block_limit(compressed, offset) != 0);
+    return nullptr;
+}
+
+} // namespace
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+void set_bz2_backend(Bz2Backend backend) noexcept {
+    backend_setting().store(backend, std::memory_order_relaxed);
+}
+
+Bz2Backend bz2_backend() noexcept {
+    return backend_setting().load(std::memory_order_relaxed);
+}
+
+Result<std::string> native_decompress_bz2(std::string_view compressed, const Bz2DecodeConfig &config) {
+    std::string result;
+    StringOutput out(result);
+    if (const char *error = decode_all(compressed, out, config)) {
+        return std::unexpected(decode_error(error));
+    }
+    out.finish();
+    return result;
+}
+
+Result<std::string_view> native_decompress_bz2(std::string_view compressed, Arena &arena,
+                                               const Bz2DecodeConfig &config) {
+    // Typical dump chunks expand 5-10x; the unused tail goes back to the arena
+    ArenaOutput out(arena, compressed.size() * 10);
+    if (const char *error = decode_all(compressed, out, config)) {
+        out.abandon();
+        return std::unexpected(decode_error(error));
+    }
+    return out.finish();
+}
+
+Result<uint64_t> native_decompress_bz2_blocks(std::string_view compressed,
+                                              const std::function<bool(std::string_view)> &on_output,
+                                              size_t block_size) {
+    uint32_t max_block = stream_block_limit(compressed, 0);
+    if (max_block == 0) {
+        return std::unexpected(decode_error("not BZ2 data"));
+    }
+    block_size = std::max<size_t>(block_size, 1);
+
+    uint64_t pos = 32;
+    uint32_t combined_crc = 0;
+    uint64_t produced = 0;
+    std::string block;
+    while (true) {
+        BitReader reader(compressed, pos);
+        uint64_t magic = reader.bits48();
+        if (reader.overrun()) {
+            return std::unexpected(decode_error("unexpected end of data"));
+        }
+        if (magic == END_MAGIC) {
+            if (reader.bits(32) != combined_crc || reader.overrun()) {
+                return std::unexpected(decode_error("stream CRC mismatch"));
+            }
+            return produced;
+        }
+
+        block.clear();
+        StringOutput out(block);
+        BlockInfo info;
+        if (const char *error = decode_block(compressed, pos, max_block, out, info)) {
+            return std::unexpected(decode_error(error));
+        }
+        out.finish();
+        combined_crc = combine_crc(combined_crc, info.crc);
+        pos = info.end_bit;
+
+        for (size_t offset = 0; offset < block.size(); offset += block_size) {
+            std::string_view piece = std::string_view(block).substr(offset, block_size);
+            produced += piece.size();
+            if (!on_output(piece)) {
+                return produced; // Stopped by the caller
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Bz2FileDecoder
+// ============================================================================
+
+struct Bz2FileDecoder::Impl {
+    FILE *file = nullptr;
+    bool file_eof = false;
+
+    // Compressed bytes read ahead; bit_pos is the decoding position in them
+    std::string input;
+    uint64_t bit_pos = 0;
+
+    bool in_stream = false;
+    bool seen_stream = false;
+    uint32_t max_block = 0;
+    uint32_t combined_crc = 0;
+
+    // Decoded block being handed out
+    std::string output;
+    size_t output_pos = 0;
+
+    bool done = false;
+    std::string error_message;
+
+    void fill(size_t bytes);
+    bool next_block();
+    bool fail(const char *message);
+};
+
+void Bz2FileDecoder::Impl::fill(size_t bytes) {
+    // Drop consumed input, then read until bytes are available past bit_pos
+    size_t consumed = static_cast<size_t>(bit_pos / 8);
+    if (consumed > 0) {
+        input.erase(0, consumed);
+        bit_pos -= uint64_t{consumed} * 8;
+    }
+    while (input.size() < bytes && !file_eof) {
+        size_t old_size = input.size();
+        size_t want = std::max<size_t>(bytes - old_size, 256 * 1024);
+        input.resize(old_size + want);
+        size_t got = std::fread(input.data() + old_size, 1, want, file);
+        input.resize(old_size + got);
+        file_eof = got < want;
+    }
+}
+
+bool Bz2FileDecoder::Impl::fail(const char *message) {
+    error_message = decode_error(message).message;
+    done = true;
+    return false;
+}
+
+bool Bz2FileDecoder::Impl::next_block() {
+    output.clear();
+    output_pos = 0;
+
+    while (!done) {
+        if (!in_stream) {
+            fill(4);
+            if (input.empty()) {
+                done = true;
+                return false;
+            }
+            max_block = stream_block_limit(input, 0);
+            if (max_block == 0) {
+                // Trailing bytes after the last stream are ignored
+                done = true;
+                return seen_stream ? false : fail("not BZ2 data");
+            }
+            bit_pos = 32;
+            in_stream = true;
+            seen_stream = true;
+            combined_crc = 0;
+        }
+
+        // A compressed block is rarely larger than its decoded size
+        size_t want = max_block + max_block / 2 + 4096;
+        while (true) {
+            fill(want);
+            BitReader reader(input, bit_pos);
+            uint64_t magic = reader.bits48();
+
+            if (magic == END_MAGIC) {
+                uint32_t stored = reader.bits(32);
+                if (reader.overrun()) {
+                    return fail("unexpected end of data");
+                }
+                if (stored != combined_crc) {
+                    return fail("stream CRC mismatch");
+                }
+                bit_pos = (reader.position() + 7) / 8 * 8;
+                in_stream = false;
+                break;
+            }
+            if (reader.overrun()) {
+                return fail("unexpected end of data");
+            }
+
+            output.clear(); // A failed attempt may have grown it
+            StringOutput out(output);
+            BlockInfo info;
+            if (const char *error = decode_block(input, bit_pos, max_block, out, info)) {
+                if (info.truncated && !file_eof) {
+                    want *= 2; // Larger than expected; read further ahead and retry
+                    continue;
+                }
+                return fail(error);
+            }
+            out.finish();
+            combined_crc = combine_crc(combined_crc, info.crc);
+            bit_pos = info.end_bit;
+            return true;
+        }
+    }
+    return false;
+}
+
+Bz2FileDecoder::Bz2FileDecoder(FILE *file) : impl_(std::make_unique<Impl>()) {
+    impl_->file = file;
+    impl_->done = file == nullptr;
+}
+
+Bz2FileDecoder::~Bz2FileDecoder() = default;
+
+size_t Bz2FileDecoder::read(char *buffer, size_t n) {
+    size_t total = 0;
+    while (total < n) {
+        if (impl_->output_pos == impl_->output.size() && !impl_->next_block()) {
+            break;
+        }
+        size_t chunk = std::min(n - total, impl_->output.size() - impl_->output_pos);
+        std::memcpy(buffer + total, impl_->output.data() + impl_->output_pos, chunk);
+        impl_->output_pos += chunk;
+        total += chunk;
+    }
+    return total;
+}
+
+bool Bz2FileDecoder::eof() const noexcept {
+    return impl_->done && impl_->output_pos == impl_->output.size();
+}
+
+void Bz2FileDecoder::reset() {
+    FILE *file = impl_->file;
+    *impl_ = Impl{};
+    impl_->file = file;
+    impl_->done = file == nullptr;
+}
+
+std::string_view Bz2FileDecoder::error() const noexcept {
+    return impl_->error_message;
+}
+
+} // namespace wikilib::dump
@@ -4,6 +4,7 @@
  */
 
 #include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/bz2_decoder.h"
 #include <algorithm>
 #include <bzlib.h>
 #include <cstring>
@@ -31,26 +32,54 @@ struct Bz2Stream::Impl {
     size_t buffer_pos = 0;
     size_t buffer_len = 0;
 
-    // Line reading buffer
+    // Carry buffer for lines spanning a refill
     std::string line_buffer;
 
+    // Read-ahead bytes handed from one stream to the next
+    char unused[BZ_MAX_UNUSED];
+
+    // Set instead of bz_file when the native backend is selected
+    std::unique_ptr<Bz2FileDecoder> native;
+
+    bool open();
+
     bool open_next_stream();
     void close_bz();
 };
 
 bool Bz2Stream::Impl::open_next_stream() {
+    // libbz2 reads ahead; bytes past the end of a stream belong to the next one
+    int n_unused = 0;
     if (bz_file) {
+        if (bz_error == BZ_STREAM_END) {
+            void *unused_ptr = nullptr;
+            BZ2_bzReadGetUnused(&bz_error, bz_file, &unused_ptr, &n_unused);
+            if (bz_error == BZ_OK && n_unused > 0) {
+                std::memcpy(unused, unused_ptr, static_cast<size_t>(n_unused));
+            } else {
+                n_unused = 0;
+            }
+        }
         BZ2_bzReadClose(&bz_error, bz_file);
         bz_file = nullptr;
     }
 
-    if (!file || feof(file)) {
+    if (!file) {
         at_eof = true;
         return false;
     }
 
+    if (n_unused == 0) {
+        int c = fgetc(file);
+        if (c == EOF) {
+            at_eof = true;
+            return false;
+        }
+        ungetc(c, file);
+    }
+
     bz_error = BZ_OK;
-    bz_file = BZ2_bzReadOpen(&bz_error, file, 0, 0, nullptr, 0);
+    bz_file = BZ2_bzReadOpen(&bz_error, file, 0, 0, n_unused > 0 ? unused : nullptr, n_unused);
 
     if (bz_error != BZ_OK || !bz_file) {
         error_message = "Failed to open BZ2 stream";
@@ -61,6 +90,14 @@ bool Bz2Stream::Impl::open_next_stream() {
     return true;
 }
 
+bool Bz2Stream::Impl::open() {
+    if (bz2_backend() == Bz2Backend::Native) {
+        native = std::make_unique<Bz2FileDecoder>(file);
+        return true;
+    }
+    return open_next_stream();
+}
+
 void Bz2Stream::Impl::close_bz() {
     if (bz_file) {
         BZ2_bzReadClose(&bz_error, bz_file);
@@ -77,7 +114,7 @@ Bz2Stream::Bz2Stream(const std::string &path) : impl_(std::make_unique<Impl>())
     }
     impl_->own_file = true;
 
-    if (!impl_->open_next_stream()) {
+    if (!impl_->open()) {
         return;
     }
 }
@@ -92,7 +129,7 @@ Bz2Stream::Bz2Stream(FILE *file, bool own_file) : impl_(std::make_unique<Impl>()
         return;
     }
 
-    if (!impl_->open_next_stream()) {
+    if (!impl_->open()) {
         return;
     }
 }
@@ -113,7 +150,7 @@ Bz2Stream &Bz2Stream::operator=(Bz2Stream &&other) noexcept {
 }
 
 bool Bz2Stream::is_open() const noexcept {
-    return impl_ && impl_->file && impl_->bz_file && !impl_->at_eof;
+    return impl_ && impl_->file && (impl_->bz_file || impl_->native) && !impl_->at_eof;
 }
 
 bool Bz2Stream::eof() const noexcept {
@@ -121,7 +158,24 @@ bool Bz2Stream::eof() const noexcept {
 }
 
 size_t Bz2Stream::read(char *buffer, size_t n) {
-    if (!impl_ || !impl_->bz_file || impl_->at_eof) {
+    if (!impl_ || impl_->at_eof) {
+        return 0;
+    }
+
+    if (impl_->native) {
+        size_t total_read = impl_->native->read(buffer, n);
+        impl_->decompressed_bytes += total_read;
+        if (impl_->native->eof()) {
+            impl_->at_eof = true;
+            if (!impl_->native->error().empty()) {
+                impl_->error_message = impl_->native->error();
+            }
+        }
+        impl_->compressed_bytes = static_cast<uint64_t>(ftell(impl_->file));
+        return total_read;
+    }
+
+    if (!impl_->bz_file) {
         return 0;
     }
 
@@ -157,24 +211,51 @@ size_t Bz2Stream::read(char *buffer, size_t n) {
 }
 
 std::optional<std::string> Bz2Stream::read_line() {
-    if (!impl_ || impl_->at_eof) {
+    auto line = read_line_view();
+    if (!line) {
         return std::nullopt;
     }
+    return std::string(*line);
+}
 
+std::optional<std::string_view> Bz2Stream::read_line_view() {
+    if (!impl_) {
+        return std::nullopt;
+    }
+
+    // Carry buffer holds the head of a line that straddles a refill
     impl_->line_buffer.clear();
+    bool carrying = false;
 
     while (true) {
-        // Check if we have buffered data
-        while (impl_->buffer_pos < impl_->buffer_len) {
-            char c = impl_->buffer[impl_->buffer_pos++];
-            if (c == '\n') {
+        if (impl_->buffer_pos < impl_->buffer_len) {
+            const char *begin = impl_->buffer + impl_->buffer_pos;
+            size_t available = impl_->buffer_len - impl_->buffer_pos;
+            const char *nl = static_cast<const char *>(std::memchr(begin, '\n', available));
+
+            if (nl) {
+                size_t len = static_cast<size_t>(nl - begin);
+                impl_->buffer_pos += len + 1;
+
+                std::string_view line;
+                if (carrying) {
+                    impl_->line_buffer.append(begin, len);
+                    line = impl_->line_buffer;
+                } else {
+                    line = std::string_view(begin, len);
+                }
+
                 // Remove trailing \r if present
-                if (!impl_->line_buffer.empty() && impl_->line_buffer.back() == '\r') {
-                    impl_->line_buffer.pop_back();
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
                 }
-                return impl_->line_buffer;
+                return line;
             }
-            impl_->line_buffer += c;
+
+            // No newline in remaining data - carry it over the refill
+            impl_->line_buffer.append(begin, available);
+            impl_->buffer_pos = impl_->buffer_len;
+            carrying = true;
         }
 
         // Refill buffer
@@ -184,7 +265,7 @@ std::optional<std::string> Bz2Stream::read_line() {
         if (impl_->buffer_len == 0) {
             // EOF reached
             if (!impl_->line_buffer.empty()) {
-                return impl_->line_buffer;
+                return std::string_view(impl_->line_buffer);
             }
             return std::nullopt;
         }
@@ -231,8 +312,13 @@ bool Bz2Stream::seek_to_stream(uint64_t offset) {
     impl_->at_eof = false;
     impl_->buffer_pos = 0;
     impl_->buffer_len = 0;
+    impl_->line_buffer.clear();
 
     // Open new BZ2 stream
+    if (impl_->native) {
+        impl_->native->reset();
+        return true;
+    }
     return impl_->open_next_stream();
 }
 
@@ -245,6 +331,7 @@ void Bz2Stream::close() {
         return;
 
     impl_->close_bz();
+    impl_->native.reset();
 
     if (impl_->file && impl_->own_file) {
         fclose(impl_->file);
@@ -257,11 +344,47 @@ void Bz2Stream::close() {
 // Utility functions
 // ============================================================================
 
+namespace {
+
+std::string decompress_error_message(int ret) {
+    std::string error_msg = "BZ2 decompression failed: ";
+    switch (ret) {
+        case BZ_CONFIG_ERROR:
+            error_msg += "config error";
+            break;
+        case BZ_PARAM_ERROR:
+            error_msg += "param error";
+            break;
+        case BZ_MEM_ERROR:
+            error_msg += "memory error";
+            break;
+        case BZ_DATA_ERROR:
+            error_msg += "data error";
+            break;
+        case BZ_DATA_ERROR_MAGIC:
+            error_msg += "not BZ2 data";
+            break;
+        case BZ_UNEXPECTED_EOF:
+            error_msg += "unexpected EOF";
+            break;
+        default:
+            error_msg += "unknown error";
+            break;
+    }
+    return error_msg;
+}
+
+} // namespace
+
 Result<std::string> decompress_bz2(std::string_view compressed) {
     if (compressed.size() < 4) {
         return std::unexpected(ParseError{"Data too short to be BZ2", {}, ErrorSeverity::Error, ""});
     }
 
+    if (bz2_backend() == Bz2Backend::Native) {
+        return native_decompress_bz2(compressed);
+    }
+
     // Estimate output size (typically 5-10x compression ratio)
     size_t output_size = compressed.size() * 10;
     std::string result;
@@ -286,37 +409,89 @@ Result<std::string> decompress_bz2(std::string_view compressed) {
     }
 
     if (ret != BZ_OK) {
-        std::string error_msg = "BZ2 decompression failed: ";
-        switch (ret) {
-            case BZ_CONFIG_ERROR:
-                error_msg += "config error";
-                break;
-            case BZ_PARAM_ERROR:
-                error_msg += "param error";
-                break;
-            case BZ_MEM_ERROR:
-                error_msg += "memory error";
-                break;
-            case BZ_DATA_ERROR:
-                error_msg += "data error";
-                break;
-            case BZ_DATA_ERROR_MAGIC:
-                error_msg += "not BZ2 data";
-                break;
-            case BZ_UNEXPECTED_EOF:
-                error_msg += "unexpected EOF";
-                break;
-            default:
-                error_msg += "unknown error";
-                break;
-        }
-        return std::unexpected(ParseError{error_msg, {}, ErrorSeverity::Error, ""});
+        return std::unexpected(ParseError{decompress_error_message(ret), {}, ErrorSeverity::Error, ""});
     }
 
     result.resize(dest_len);
     return result;
 }
 
+Result<std::string_view> decompress_bz2(std::string_view compressed, Arena &arena) {
+    if (compressed.size() < 4) {
+        return std::unexpected(ParseError{"Data too short to be BZ2", {}, ErrorSeverity::Error, ""});
+    }
+
+    if (bz2_backend() == Bz2Backend::Native) {
+        return native_decompress_bz2(compressed, arena);
+    }
+
+    // Same size estimates as above; the unused tail goes back to the arena
+    int ret = BZ_OUTBUFF_FULL;
+    for (size_t ratio: {10, 50}) {
+        size_t output_size = compressed.size() * ratio;
+        char *output = arena.allocate_array<char>(output_size);
+        unsigned int dest_len = static_cast<unsigned int>(output_size);
+
+        ret = BZ2_bzBuffToBuffDecompress(output, &dest_len, const_cast<char *>(compressed.data()),
+                                         static_cast<unsigned int>(compressed.size()), 0, 0);
+        if (ret == BZ_OK) {
+            arena.shrink(output, output_size, dest_len);
+            return std::string_view(output, dest_len);
+        }
+        arena.shrink(output, output_size, 0);
+        if (ret != BZ_OUTBUFF_FULL) {
+            break;
+        }
+    }
+    return std::unexpected(ParseError{decompress_error_message(ret), {}, ErrorSeverity::Error, ""});
+}
+
+Result<uint64_t> decompress_bz2_blocks(std::string_view compressed,
+                                       const std::function<bool(std::string_view)> &on_output, size_t block_size) {
+    if (bz2_backend() == Bz2Backend::Native) {
+        return native_decompress_bz2_blocks(compressed, on_output, block_size);
+    }
+
+    bz_stream strm{};
+    int ret = BZ2_bzDecompressInit(&strm, 0, 0);
+    if (ret != BZ_OK) {
+        return std::unexpected(ParseError{decompress_error_message(ret), {}, ErrorSeverity::Error, ""});
+    }
+    strm.next_in = const_cast<char *>(compressed.data());
+    strm.avail_in = static_cast<unsigned int>(compressed.size());
+
+    std::string block(std::max<size_t>(block_size, 1), '\0');
+    uint64_t produced = 0;
+    while (true) {
+        strm.next_out = block.data();
+        strm.avail_out = static_cast<unsigned int>(block.size());
+        ret = BZ2_bzDecompress(&strm);
+        if (ret != BZ_OK && ret != BZ_STREAM_END) {
+            break;
+        }
+
+        size_t used = block.size() - strm.avail_out;
+        produced += used;
+        if (used > 0 && !on_output(std::string_view(block.data(), used))) {
+            ret = BZ_STREAM_END; // Stopped by the caller
+            break;
+        }
+        if (ret == BZ_STREAM_END) {
+            break;
+        }
+        if (strm.avail_in == 0 && used == 0) {
+            ret = BZ_UNEXPECTED_EOF;
+            break;
+        }
+    }
+    BZ2_bzDecompressEnd(&strm);
+
+    if (ret != BZ_STREAM_END) {
+        return std::unexpected(ParseError{decompress_error_message(ret), {}, ErrorSeverity::Error, ""});
+    }
+    return produced;
+}
+
 Result<std::string> compress_bz2(std::string_view data, int compression_level) {
     if (compression_level < 1)
         compression_level = 1;
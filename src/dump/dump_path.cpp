@@ -4,8 +4,8 @@
  */
 
 #include "wikilib/dump/dump_path.h"
+#include "wikilib/core/line_reader.h"
 #include <algorithm>
-#include <fstream>
 #include <stdexcept>
 
 namespace fs = std::filesystem;
@@ -275,20 +275,19 @@ std::optional<fs::path> find_dump_fetcher_dir(const fs::path& start) {
 
 std::vector<std::string> read_terms_file(const std::string& filename) {
     std::vector<std::string> terms;
-    std::ifstream file(filename);
+    core::MmapLineReader file(filename);
 
-    if (!file) {
+    if (!file.is_open()) {
         return terms;
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
+    while (auto line = file.read_line_view()) {
         // Trim whitespace
-        size_t start = line.find_first_not_of(" \t\r\n");
-        size_t end = line.find_last_not_of(" \t\r\n");
+        size_t start = line->find_first_not_of(" \t\r\n");
+        size_t end = line->find_last_not_of(" \t\r\n");
 
-        if (start != std::string::npos && end != std::string::npos) {
-            terms.push_back(line.substr(start, end - start + 1));
+        if (start != std::string_view::npos && end != std::string_view::npos) {
+            terms.emplace_back(line->substr(start, end - start + 1));
         }
     }
 
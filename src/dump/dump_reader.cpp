@@ -5,8 +5,12 @@
 
 #include "wikilib/dump/dump_reader.h"
 #include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/bz2_decoder.h"
 #include "wikilib/dump/bz2_line_reader.h"
 #include "wikilib/dump/index_chunker.h"
+#include "wikilib/dump/page_handler.h"
+#include "wikilib/dump/xml_reader.h"
+#include "wikilib/core/text_utils.hpp"
 #include <algorithm>
 #include <chrono>
 #include <cstring>
@@ -28,6 +32,7 @@ struct DumpReader::Impl {
     // Index data
     bool index_is_loaded = false;
     std::unordered_map<std::string, IndexedPage> page_map;
+    BloomFilter title_filter;  // Answers most misses before page_map is probed
     std::vector<uint64_t> chunk_offsets;  // Start offset for each chunk
 
     // File handle for dump
@@ -44,6 +49,9 @@ struct DumpReader::Impl {
     // Open dump file
     bool open_dump();
 
+    // Read compressed bytes of a range
+    bool read_range(uint64_t start, uint64_t length, std::vector<char>& compressed);
+
     // Streaming decompression of a range
     std::string decompress_range(uint64_t start, uint64_t length);
 };
@@ -62,25 +70,42 @@ bool DumpReader::Impl::open_dump() {
     return true;
 }
 
-std::string DumpReader::Impl::decompress_range(uint64_t start, uint64_t length) {
+bool DumpReader::Impl::read_range(uint64_t start, uint64_t length, std::vector<char>& compressed) {
     if (!open_dump()) {
-        return {};
+        return false;
     }
 
     // Seek to start position
     if (fseek(dump_file, static_cast<long>(start), SEEK_SET) != 0) {
         error_message = "Seek failed";
-        return {};
+        return false;
     }
 
     // Read compressed data
-    std::vector<char> compressed(length);
+    compressed.resize(length);
     size_t bytes_read = fread(compressed.data(), 1, length, dump_file);
     if (bytes_read != length) {
         error_message = "Failed to read compressed data";
+        return false;
+    }
+    return true;
+}
+
+std::string DumpReader::Impl::decompress_range(uint64_t start, uint64_t length) {
+    std::vector<char> compressed;
+    if (!read_range(start, length, compressed)) {
         return {};
     }
 
+    if (bz2_backend() == Bz2Backend::Native) {
+        auto native = native_decompress_bz2(std::string_view(compressed.data(), compressed.size()));
+        if (!native) {
+            error_message = native.error().message;
+            return {};
+        }
+        return std::move(*native);
+    }
+
     // Streaming decompression with adaptive buffer
     // Start with reasonable estimate and grow if needed
     std::string result;
@@ -185,6 +210,11 @@ void DumpReader::load_index(std::function<void(size_t)> progress_callback) {
         // Add final offset (EOF)
         impl_->chunk_offsets.push_back(dump_size);
 
+        impl_->title_filter = BloomFilter(impl_->page_map.size());
+        for (const auto& [title, page] : impl_->page_map) {
+            impl_->title_filter.insert(title);
+        }
+
         impl_->index_is_loaded = true;
 
         // Final progress update
@@ -209,10 +239,17 @@ size_t DumpReader::chunk_count() const noexcept {
 }
 
 bool DumpReader::has_page(const std::string& title) const {
-    return impl_->page_map.contains(title);
+    return impl_->title_filter.may_contain(title) && impl_->page_map.contains(title);
+}
+
+const BloomFilter& DumpReader::title_filter() const noexcept {
+    return impl_->title_filter;
 }
 
 std::optional<IndexedPage> DumpReader::get_page_info(const std::string& title) const {
+    if (!impl_->title_filter.may_contain(title)) {
+        return std::nullopt;
+    }
     auto it = impl_->page_map.find(title);
     if (it == impl_->page_map.end()) {
         return std::nullopt;
@@ -229,14 +266,24 @@ ExtractedPage DumpReader::extract_page(const std::string& title) {
         return result;
     }
 
-    // Decompress the chunk
-    std::string xml = decompress_chunk(info->chunk_index);
-    if (xml.empty()) {
+    if (info->chunk_index >= chunk_count()) {
+        impl_->error_message = "Chunk index out of range";
+        return result;
+    }
+    uint64_t start = impl_->chunk_offsets[info->chunk_index];
+    uint64_t end = impl_->chunk_offsets[info->chunk_index + 1];
+    std::vector<char> compressed;
+    if (!impl_->read_range(start, end - start, compressed)) {
         return result;
     }
 
-    // Extract page from XML
-    result.content = extract_page_from_xml(title, xml);
+    // Decompression stops right after the page
+    auto content = extract_page_from_bz2(title, std::string_view(compressed.data(), compressed.size()));
+    if (!content) {
+        impl_->error_message = content.error().message;
+        return result;
+    }
+    result.content = std::move(*content);
     result.id = info->id;
     result.found = !result.content.empty();
 
@@ -339,11 +386,11 @@ void DumpReader::process_all(
     std::string page_content;
     bool in_page = false;
 
-    while (auto line = stream.read_line()) {
-        const std::string& l = *line;
+    while (auto line = stream.read_line_view()) {
+        std::string_view l = *line;
 
         // Simple state machine for page boundaries
-        if (l.find("<page>") != std::string::npos) {
+        if (l.find("<page>") != std::string_view::npos) {
             in_page = true;
             page_content.clear();
         }
@@ -353,7 +400,7 @@ void DumpReader::process_all(
             page_content += '\n';
         }
 
-        if (l.find("</page>") != std::string::npos && in_page) {
+        if (in_page && l.find("</page>") != std::string_view::npos) {
             in_page = false;
 
             // Parse this page
@@ -424,6 +471,103 @@ std::string extract_page_from_xml(
     return {};
 }
 
+namespace {
+
+/**
+ * @brief Finds the <page> element with a given title in XML arriving in pieces
+ *
+ * Titles are compared after entity decoding, as dumps escape & and ".
+ */
+class PageLocator {
+public:
+    explicit PageLocator(const std::string& title) : title_(title) {}
+
+    /**
+     * @brief Continue scanning after data was appended to xml
+     * @return true once the whole page is in xml
+     */
+    bool scan(std::string_view xml) {
+        static constexpr std::string_view TITLE_OPEN = "<title>";
+        static constexpr std::string_view TITLE_CLOSE = "</title>";
+        static constexpr std::string_view PAGE_OPEN = "<page>";
+        static constexpr std::string_view PAGE_CLOSE = "</page>";
+
+        while (page_begin_ == std::string_view::npos) {
+            size_t open = xml.find(TITLE_OPEN, scan_);
+            size_t close = open == std::string_view::npos ? open : xml.find(TITLE_CLOSE, open + TITLE_OPEN.size());
+            if (close == std::string_view::npos) {
+                // A tag may be split across blocks
+                scan_ = open != std::string_view::npos ? open : resume_point(xml, TITLE_OPEN);
+                return false;
+            }
+
+            std::string_view raw = xml.substr(open + TITLE_OPEN.size(), close - open - TITLE_OPEN.size());
+            scan_ = close + TITLE_CLOSE.size();
+            bool match = raw.find('&') == std::string_view::npos ? raw == title_
+                                                                 : text::decode_html_entities(raw) == title_;
+            if (match) {
+                size_t page = xml.rfind(PAGE_OPEN, open);
+                page_begin_ = page == std::string_view::npos ? 0 : page;
+            }
+        }
+
+        size_t close = xml.find(PAGE_CLOSE, scan_);
+        if (close == std::string_view::npos) {
+            scan_ = resume_point(xml, PAGE_CLOSE);
+            return false;
+        }
+        page_end_ = close + PAGE_CLOSE.size();
+        return true;
+    }
+
+    [[nodiscard]] bool found() const noexcept {
+        return page_begin_ != std::string_view::npos;
+    }
+
+    /**
+     * @brief The page element, or everything from its start until scan() returns true
+     */
+    [[nodiscard]] std::string_view page(std::string_view xml) const {
+        return found() ? xml.substr(page_begin_, page_end_ - page_begin_) : std::string_view{};
+    }
+
+private:
+    [[nodiscard]] size_t resume_point(std::string_view xml, std::string_view tag) const {
+        return std::max(scan_, xml.size() - std::min(xml.size(), tag.size() - 1));
+    }
+
+    const std::string& title_;
+    size_t scan_ = 0;
+    size_t page_begin_ = std::string_view::npos;
+    size_t page_end_ = std::string_view::npos;
+};
+
+} // namespace
+
+Result<std::string> extract_page_from_bz2(const std::string& title, std::string_view compressed_chunk) {
+    std::string xml;
+    PageLocator locator(title);
+
+    auto produced = decompress_bz2_blocks(compressed_chunk, [&](std::string_view block) {
+        xml.append(block);
+        return !locator.scan(xml);
+    });
+    if (!produced) {
+        return std::unexpected(produced.error());
+    }
+    if (!locator.found()) {
+        return std::string{};
+    }
+
+    // Parse only the page (up to the end of the chunk if it never closes)
+    PageHandler handler(std::make_unique<XmlReader>(XmlReader::from_string(locator.page(xml))));
+    auto page = handler.next_page();
+    if (!page || page->info.title != title) {
+        return std::string{};
+    }
+    return std::string(page->content());
+}
+
 std::vector<std::pair<std::string, std::string>> extract_all_from_xml(
     const std::string& xml_chunk
 ) {
@@ -0,0 +1,428 @@
+/**
+ * @file dump_scheduler.cpp
+ * @brief Implementation of multi-dump job scheduler
+ */
+
+#include "wikilib/dump/dump_scheduler.h"
+#include <algorithm>
+#include <bzlib.h>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "wikilib/dump/index_chunker.h"
+
+namespace wikilib::dump {
+
+namespace {
+
+constexpr size_t INPUT_BUFFER_SIZE = 1 << 20;
+constexpr size_t OUTPUT_STEP = 1 << 20;
+constexpr size_t PAGE_BATCH_BYTES = 8 << 20; // Decompressed bytes before pages are handed out mid-stream
+
+class FileSink : public DumpSink {
+public:
+    explicit FileSink(const std::filesystem::path &path) : file_(fopen(path.string().c_str(), "wb")) {
+    }
+
+    ~FileSink() override {
+        FileSink::close();
+    }
+
+    void write(std::string_view data) override {
+        if (file_) {
+            fwrite(data.data(), 1, data.size(), file_);
+        }
+    }
+
+    void close() override {
+        if (file_) {
+            fclose(file_);
+            file_ = nullptr;
+        }
+    }
+private:
+    FILE *file_;
+};
+
+struct Task {
+    size_t dump = 0;
+    uint64_t start = 0;
+    uint64_t end = 0;
+
+    [[nodiscard]] uint64_t bytes() const noexcept {
+        return end - start;
+    }
+};
+
+struct DumpState {
+    DumpPath path;
+    std::string dump_file;
+    std::unique_ptr<DumpSink> sink;
+    std::mutex sink_mutex;
+
+    explicit DumpState(const DumpPath &p) : path(p) {
+    }
+};
+
+struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<size_t> tasks; // Descending by size
+};
+
+} // namespace
+
+std::unique_ptr<DumpSink> make_file_sink(const std::filesystem::path &path) {
+    return std::make_unique<FileSink>(path);
+}
+
+// ============================================================================
+// DumpScheduler implementation
+// ============================================================================
+
+struct DumpScheduler::Impl {
+    DumpSchedulerConfig config;
+    std::vector<std::unique_ptr<DumpState>> dumps;
+    SinkFactory sink_factory;
+    ProgressCallback progress_callback;
+
+    std::vector<Task> tasks;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+    std::mutex progress_mutex;
+    std::vector<DumpProgress> progress;
+
+    void plan();
+    void plan_dump(size_t index);
+    void distribute(size_t workers);
+    std::optional<size_t> take_task(size_t worker);
+    void worker_loop(size_t worker, const PageProcessor &processor);
+    void run_task(const Task &task, const PageProcessor &processor);
+    void flush(DumpState &dump, std::string &out);
+    void finish_task(const Task &task, uint64_t pages, std::string error);
+};
+
+void DumpScheduler::Impl::plan() {
+    tasks.clear();
+    progress.clear();
+    progress.resize(dumps.size());
+
+    for (size_t i = 0; i < dumps.size(); ++i) {
+        plan_dump(i);
+    }
+}
+
+void DumpScheduler::Impl::plan_dump(size_t index) {
+    DumpState &dump = *dumps[index];
+    DumpProgress &prog = progress[index];
+
+    try {
+        prog.name = dump.path.symbolic_name();
+        dump.dump_file = dump.path.dump_path().string();
+    } catch (const std::exception &e) {
+        prog.error = e.what();
+        prog.finished = true;
+        return;
+    }
+
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(dump.dump_file, ec);
+    if (ec) {
+        prog.error = "Failed to stat dump file: " + dump.dump_file;
+        prog.finished = true;
+        return;
+    }
+    prog.bytes_total = size;
+
+    dump.sink = sink_factory ? sink_factory(dump.path) : nullptr;
+    size_t first = tasks.size();
+
+    // Split at chunk offsets from the index; header and footer streams hold no pages
+    if (size > config.split_threshold && dump.path.index_exists()) {
+        try {
+            auto chunker = IndexChunker::from_file(dump.path.index_path().string(), size);
+            IndexChunk chunk;
+            uint64_t task_start = 0;
+            while (chunker.next_chunk(chunk)) {
+                if (chunk.start_offset > task_start && chunk.start_offset - task_start >= config.task_bytes) {
+                    tasks.push_back({index, task_start, chunk.start_offset});
+                    task_start = chunk.start_offset;
+                }
+            }
+            tasks.push_back({index, task_start, size});
+        } catch (const std::exception &) {
+            // Unreadable index: process the dump as one task
+            tasks.resize(first);
+        }
+    }
+    if (tasks.size() == first) {
+        tasks.push_back({index, 0, size});
+    }
+
+    prog.tasks_total = tasks.size() - first;
+}
+
+void DumpScheduler::Impl::distribute(size_t workers) {
+    std::vector<size_t> order(tasks.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this](size_t a, size_t b) { return tasks[a].bytes() > tasks[b].bytes(); });
+
+    queues.clear();
+    for (size_t w = 0; w < workers; ++w) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        queues[i % workers]->tasks.push_back(order[i]);
+    }
+}
+
+std::optional<size_t> DumpScheduler::Impl::take_task(size_t worker) {
+    {
+        std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+        auto &own = queues[worker]->tasks;
+        if (!own.empty()) {
+            size_t task = own.front();
+            own.pop_front();
+            return task;
+        }
+    }
+
+    // Steal the largest pending task of any other worker
+    while (true) {
+        size_t victim = queues.size();
+        uint64_t best = 0;
+        for (size_t w = 0; w < queues.size(); ++w) {
+            if (w == worker) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(queues[w]->mutex);
+            if (!queues[w]->tasks.empty() &&
+                (victim == queues.size() || tasks[queues[w]->tasks.front()].bytes() > best)) {
+                victim = w;
+                best = tasks[queues[w]->tasks.front()].bytes();
+            }
+        }
+        if (victim == queues.size()) {
+            return std::nullopt;
+        }
+
+        std::lock_guard<std::mutex> lock(queues[victim]->mutex);
+        auto &stolen = queues[victim]->tasks;
+        if (!stolen.empty()) {
+            size_t task = stolen.front();
+            stolen.pop_front();
+            return task;
+        }
+    }
+}
+
+void DumpScheduler::Impl::worker_loop(size_t worker, const PageProcessor &processor) {
+    while (auto task = take_task(worker)) {
+        run_task(tasks[*task], processor);
+    }
+}
+
+void DumpScheduler::Impl::flush(DumpState &dump, std::string &out) {
+    if (out.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(dump.sink_mutex);
+    if (dump.sink) {
+        dump.sink->write(out);
+    }
+    out.clear();
+}
+
+void DumpScheduler::Impl::run_task(const Task &task, const PageProcessor &processor) {
+    DumpState &dump = *dumps[task.dump];
+    uint64_t pages = 0;
+    std::string out;
+
+    // Hand complete <page> elements of xml to the processor; returns bytes consumed
+    PageScanner scanner;
+    auto process_pages = [&](std::string_view xml, bool final) {
+        return scanner.scan(xml, final, [&](std::string_view, const Page &page) {
+            processor(dump.path, page, out);
+            pages++;
+            if (out.size() >= config.sink_flush_bytes) {
+                flush(dump, out);
+            }
+            return true;
+        });
+    };
+
+    std::unique_ptr<FILE, int (*)(FILE *)> file(fopen(dump.dump_file.c_str(), "rb"), &fclose);
+    if (!file || fseek(file.get(), static_cast<long>(task.start), SEEK_SET) != 0) {
+        finish_task(task, pages, "Failed to open dump file: " + dump.dump_file);
+        return;
+    }
+
+    // Decompress the range stream by stream, keeping only unprocessed output
+    std::vector<char> input(INPUT_BUFFER_SIZE);
+    std::string xml;
+    size_t used = 0;
+    uint64_t remaining = task.bytes();
+    std::string error;
+
+    bz_stream strm{};
+    bool open = false;
+    strm.avail_in = 0;
+
+    while (true) {
+        if (strm.avail_in == 0 && remaining > 0) {
+            size_t want = static_cast<size_t>(std::min<uint64_t>(remaining, input.size()));
+            size_t got = fread(input.data(), 1, want, file.get());
+            if (got == 0) {
+                error = "Failed to read dump at offset " + std::to_string(task.end - remaining);
+                break;
+            }
+            remaining -= got;
+            strm.next_in = input.data();
+            strm.avail_in = static_cast<unsigned int>(got);
+        }
+        if (strm.avail_in == 0 && remaining == 0) {
+            if (open) {
+                error = "Truncated BZ2 stream in " + dump.dump_file;
+            }
+            break;
+        }
+
+        if (!open) {
+            if (BZ2_bzDecompressInit(&strm, 0, 0) != BZ_OK) {
+                error = "Failed to initialize BZ2 decompressor";
+                break;
+            }
+            open = true;
+        }
+
+        if (xml.size() - used < OUTPUT_STEP) {
+            xml.resize(used + OUTPUT_STEP);
+        }
+        strm.next_out = xml.data() + used;
+        strm.avail_out = static_cast<unsigned int>(xml.size() - used);
+
+        int ret = BZ2_bzDecompress(&strm);
+        used = static_cast<size_t>(strm.next_out - xml.data());
+        if (ret != BZ_OK && ret != BZ_STREAM_END) {
+            error = "BZ2 decompression failed in " + dump.dump_file;
+            break;
+        }
+
+        bool stream_end = ret == BZ_STREAM_END;
+        if (stream_end || used >= PAGE_BATCH_BYTES) {
+            size_t consumed = process_pages(std::string_view(xml.data(), used), stream_end);
+            xml.erase(0, consumed);
+            used -= consumed;
+        }
+        if (stream_end) {
+            BZ2_bzDecompressEnd(&strm);
+            open = false;
+        }
+    }
+    if (open) {
+        BZ2_bzDecompressEnd(&strm);
+    }
+
+    flush(dump, out);
+    finish_task(task, pages, std::move(error));
+}
+
+void DumpScheduler::Impl::finish_task(const Task &task, uint64_t pages, std::string error) {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    DumpProgress &prog = progress[task.dump];
+    prog.bytes_done += task.bytes();
+    prog.pages += pages;
+    prog.tasks_done++;
+    if (prog.error.empty()) {
+        prog.error = std::move(error);
+    }
+
+    if (prog.tasks_done == prog.tasks_total) {
+        prog.finished = true;
+        DumpState &dump = *dumps[task.dump];
+        std::lock_guard<std::mutex> sink_lock(dump.sink_mutex);
+        if (dump.sink) {
+            dump.sink->close();
+        }
+    }
+
+    if (progress_callback) {
+        progress_callback(prog);
+    }
+}
+
+// ============================================================================
+// DumpScheduler public interface
+// ============================================================================
+
+DumpScheduler::DumpScheduler(DumpSchedulerConfig config) : impl_(std::make_unique<Impl>()) {
+    impl_->config = config;
+}
+
+DumpScheduler::~DumpScheduler() = default;
+
+void DumpScheduler::add_dump(const DumpPath &dump) {
+    impl_->dumps.push_back(std::make_unique<DumpState>(dump));
+}
+
+size_t DumpScheduler::add_project(const DumpPath &base) {
+    size_t added = 0;
+    for (const auto &lang: base.available_languages()) {
+        DumpPath dump = base;
+        dump.set_language(lang);
+        if (dump.dump_exists() && dump.index_exists()) {
+            add_dump(dump);
+            added++;
+        }
+    }
+    return added;
+}
+
+void DumpScheduler::set_sink_factory(SinkFactory factory) {
+    impl_->sink_factory = std::move(factory);
+}
+
+void DumpScheduler::set_progress_callback(ProgressCallback callback) {
+    impl_->progress_callback = std::move(callback);
+}
+
+bool DumpScheduler::run(const PageProcessor &processor) {
+    impl_->plan();
+
+    std::optional<ThreadPool> own_pool;
+    ThreadPool *pool = impl_->config.pool;
+    if (!pool) {
+        size_t threads = impl_->config.threads;
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        own_pool.emplace(ThreadPoolConfig{std::max<size_t>(1, std::min(threads, impl_->tasks.size()))});
+        pool = &*own_pool;
+    }
+    size_t n = std::max<size_t>(1, std::min(pool->size(), impl_->tasks.size()));
+    impl_->distribute(n);
+
+    // One task per worker queue; the queues do the balancing
+    parallel_for(*pool, 0, n, [this, &processor](size_t first, size_t last) {
+        for (size_t w = first; w < last; ++w) {
+            impl_->worker_loop(w, processor);
+        }
+    }, 1);
+
+    return std::all_of(impl_->progress.begin(), impl_->progress.end(),
+                       [](const DumpProgress &p) { return p.error.empty(); });
+}
+
+const std::vector<DumpProgress> &DumpScheduler::progress() const noexcept {
+    return impl_->progress;
+}
+
+size_t DumpScheduler::task_count() const noexcept {
+    return impl_->tasks.size();
+}
+
+} // namespace wikilib::dump
@@ -6,7 +6,6 @@
 #include "wikilib/dump/index_chunker.h"
 #include "wikilib/dump/bz2_line_reader.h"
 #include "wikilib/dump/bz2_stream.h"
-#include <fstream>
 
 namespace wikilib::dump {
 
@@ -16,35 +15,50 @@ namespace wikilib::dump {
 
 struct IndexChunker::Impl {
     std::unique_ptr<core::LineReader> reader;
+    core::MmapLineReader* mapped = nullptr;  // reader, if it can hand out views
+    std::string line;  // Copy buffer for readers without views
     uint64_t eof_offset = 0;
     bool at_eof = false;
     bool is_start = true;
     IndexEntry current_entry;
     size_t chunks_processed = 0;
 
+    void set_reader(std::unique_ptr<core::LineReader> line_reader);
     bool read_entry(IndexEntry& entry);
 };
 
-bool IndexChunker::Impl::read_entry(IndexEntry& entry) {
-    std::string line;
+void IndexChunker::Impl::set_reader(std::unique_ptr<core::LineReader> line_reader) {
+    reader = std::move(line_reader);
+    mapped = dynamic_cast<core::MmapLineReader*>(reader.get());
+}
 
-    if (!reader->read_line(line)) {
-        return false;
-    }
+bool IndexChunker::Impl::read_entry(IndexEntry& entry) {
+    while (true) {
+        std::string_view view;
+        if (mapped) {
+            auto next = mapped->read_line_view();
+            if (!next) {
+                return false;
+            }
+            view = *next;
+        } else {
+            if (!reader->read_line(line)) {
+                return false;
+            }
+            view = line;
+        }
 
-    auto parsed = parse_index_line(line);
-    if (!parsed) {
-        // Skip invalid lines and try next
-        return read_entry(entry);
+        // Skip invalid lines
+        if (auto parsed = parse_index_line(view)) {
+            entry = std::move(*parsed);
+            return true;
+        }
     }
-
-    entry = std::move(*parsed);
-    return true;
 }
 
 IndexChunker::IndexChunker(std::unique_ptr<core::LineReader> reader, uint64_t eof_offset)
     : impl_(std::make_unique<Impl>()) {
-    impl_->reader = std::move(reader);
+    impl_->set_reader(std::move(reader));
     impl_->eof_offset = eof_offset;
 }
 
@@ -56,15 +70,15 @@ IndexChunker IndexChunker::from_file(const std::string& index_path, uint64_t eof
     // Detect if file is BZ2 compressed
     if (index_path.ends_with(".bz2")) {
         // Use BZ2 line reader
-        chunker.impl_->reader = std::make_unique<Bz2LineReader>(index_path);
+        chunker.impl_->set_reader(std::make_unique<Bz2LineReader>(index_path));
     } else {
-        // Use standard stream reader
-        auto stream = std::make_unique<std::ifstream>(index_path);
-        if (!stream->is_open()) {
+        // Plain index: map it and read lines in place
+        auto reader = std::make_unique<core::MmapLineReader>(index_path);
+        if (!reader->is_open()) {
             chunker.impl_->at_eof = true;
             return chunker;
         }
-        chunker.impl_->reader = std::make_unique<core::StreamLineReader>(*stream);
+        chunker.impl_->set_reader(std::move(reader));
     }
 
     return chunker;
@@ -133,6 +147,14 @@ size_t IndexChunker::chunks_processed() const noexcept {
 // Utility functions
 // ============================================================================
 
+bool read_dump_range(FILE* file, uint64_t start, uint64_t end, std::string& out) {
+    if (fseek(file, static_cast<long>(start), SEEK_SET) != 0) {
+        return false;
+    }
+    out.resize(end - start);
+    return fread(out.data(), 1, out.size(), file) == out.size();
+}
+
 std::vector<IndexChunk> load_index_chunks(
     const std::string& index_path,
     uint64_t eof_offset
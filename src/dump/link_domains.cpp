@@ -0,0 +1,151 @@
+/**
+ * @file link_domains.cpp
+ * @brief Implementation of parallel link domain counting
+ */
+
+#include "wikilib/dump/link_domains.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/index_chunker.h"
+#include "wikilib/dump/page_handler.h"
+
+namespace wikilib::dump {
+
+namespace {
+
+// State shared by all workers; chunker and error are guarded by mutex
+struct SharedState {
+    std::mutex mutex;
+    IndexChunker *chunker = nullptr;
+    std::string error;
+    std::atomic<bool> failed{false};
+};
+
+struct WorkerResult {
+    markup::DomainCounter domains;
+    uint64_t pages = 0;
+    uint64_t chunks = 0;
+};
+
+bool wanted(const LinkDomainConfig &config, NamespaceId ns) {
+    if (!config.namespaces) {
+        return true;
+    }
+    return std::find(config.namespaces->begin(), config.namespaces->end(), ns) != config.namespaces->end();
+}
+
+void run_worker(const std::string &dump_path, const LinkDomainConfig &config, SharedState &shared,
+                WorkerResult &result) {
+    auto fail = [&shared](std::string message) {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (!shared.failed.exchange(true)) {
+            shared.error = std::move(message);
+        }
+    };
+
+    std::unique_ptr<FILE, int (*)(FILE *)> dump(fopen(dump_path.c_str(), "rb"), &fclose);
+    if (!dump) {
+        fail("Failed to open dump file: " + dump_path);
+        return;
+    }
+
+    IndexChunk chunk;
+    std::string compressed;
+    Arena arena; // Decompressed chunks, reused from chunk to chunk
+    PageScanner scanner;
+    while (!shared.failed.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            if (!shared.chunker->next_chunk(chunk)) {
+                return;
+            }
+        }
+
+        if (!read_dump_range(dump.get(), chunk.start_offset, chunk.end_offset, compressed)) {
+            fail("Failed to read chunk at offset " + std::to_string(chunk.start_offset));
+            return;
+        }
+        arena.reset();
+        auto xml = decompress_bz2(compressed, arena);
+        if (!xml) {
+            fail(xml.error().message);
+            return;
+        }
+        result.chunks++;
+
+        scanner.scan(*xml, true, [&](std::string_view, const Page &page) {
+            if (wanted(config, page.info.namespace_id)) {
+                result.domains.add_text(page.content());
+                result.pages++;
+            }
+            return true;
+        });
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Link domain counting
+// ============================================================================
+
+LinkDomainResult count_link_domains(const std::string &dump_path, const std::string &index_path,
+                                    const LinkDomainConfig &config) {
+    LinkDomainResult result;
+    result.domains = markup::DomainCounter(config.normalize);
+
+    std::error_code ec;
+    uint64_t dump_size = std::filesystem::file_size(dump_path, ec);
+    if (ec) {
+        result.error = "Failed to stat dump file: " + dump_path;
+        return result;
+    }
+
+    std::optional<IndexChunker> chunker;
+    try {
+        chunker.emplace(IndexChunker::from_file(index_path, dump_size));
+    } catch (const std::exception &e) {
+        result.error = std::string("Failed to open index: ") + e.what();
+        return result;
+    }
+
+    std::optional<ThreadPool> own_pool;
+    ThreadPool *pool = config.pool;
+    if (!pool) {
+        own_pool.emplace(ThreadPoolConfig{config.threads});
+        pool = &*own_pool;
+    }
+    size_t n = pool->size();
+
+    SharedState shared;
+    shared.chunker = &*chunker;
+
+    std::vector<WorkerResult> workers(n, WorkerResult{markup::DomainCounter(config.normalize)});
+    parallel_for(*pool, 0, n, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            run_worker(dump_path, config, shared, workers[i]);
+        }
+    }, 1);
+
+    if (shared.failed) {
+        result.error = shared.error;
+        return result;
+    }
+
+    for (const auto &worker: workers) {
+        result.domains.merge(worker.domains);
+        result.pages_scanned += worker.pages;
+        result.chunks_read += worker.chunks;
+    }
+    result.success = true;
+    return result;
+}
+
+} // namespace wikilib::dump
@@ -0,0 +1,278 @@
+/**
+ * @file multistream_writer.cpp
+ * @brief Implementation of parallel multistream BZ2 dump writer
+ */
+
+#include "wikilib/dump/multistream_writer.h"
+#include <cstdio>
+#include <deque>
+#include <optional>
+#include <vector>
+#include "wikilib/core/thread_pool.h"
+#include "wikilib/dump/bz2_stream.h"
+
+namespace wikilib::dump {
+
+// ============================================================================
+// MultistreamWriter implementation
+// ============================================================================
+
+struct MultistreamWriter::Impl {
+    using EntryList = std::vector<std::pair<PageId, std::string>>;
+
+    // One BZ2 stream, compressing on the pool or already compressed
+    struct Job {
+        Future<Result<std::string>> compressed;
+        EntryList entries;
+    };
+
+    MultistreamConfig config;
+    FILE *dump_file = nullptr;
+    FILE *index_file = nullptr;
+    std::string error_message;
+    Stats stats;
+    uint64_t offset = 0; // Bytes written to dump file
+    bool finished = false;
+
+    // Page group being collected
+    std::string group_xml;
+    EntryList group_entries;
+
+    // Index lines not yet compressed
+    std::string index_text;
+    static constexpr size_t INDEX_FLUSH_SIZE = 1024 * 1024;
+
+    std::optional<ThreadPool> own_pool;
+    ThreadPool *pool = nullptr;
+
+    // Jobs in submission order
+    std::deque<Job> pending;
+
+    void fail(std::string message);
+    void start_pool();
+    void submit(std::string data, EntryList entries);
+    void flush_group();
+    void write_completed(bool wait_all);
+    void write_stream(Result<std::string> compressed, const EntryList &entries);
+    void flush_index(bool force);
+};
+
+// Keep the first error; nothing more is written once a stream is lost
+void MultistreamWriter::Impl::fail(std::string message) {
+    if (error_message.empty()) {
+        error_message = std::move(message);
+    }
+}
+
+void MultistreamWriter::Impl::start_pool() {
+    pool = config.pool;
+    if (!pool) {
+        own_pool.emplace(ThreadPoolConfig{config.threads});
+        pool = &*own_pool;
+    }
+    if (config.max_pending_streams == 0) {
+        config.max_pending_streams = 4 * pool->size();
+    }
+}
+
+void MultistreamWriter::Impl::submit(std::string data, EntryList entries) {
+    if (!error_message.empty()) {
+        return;
+    }
+    int level = config.compression_level;
+    pending.push_back(Job{pool->submit([data = std::move(data), level] { return compress_bz2(data, level); }),
+                          std::move(entries)});
+    write_completed(false);
+}
+
+void MultistreamWriter::Impl::flush_group() {
+    if (group_entries.empty()) {
+        return;
+    }
+
+    submit(std::move(group_xml), std::move(group_entries));
+    group_xml = std::string();
+    group_entries = EntryList();
+}
+
+void MultistreamWriter::Impl::write_completed(bool wait_all) {
+    while (!pending.empty()) {
+        // Block only when everything must be written or too much is in flight
+        if (!pending.front().compressed.ready() && !wait_all && pending.size() <= config.max_pending_streams) {
+            return;
+        }
+
+        Job job = std::move(pending.front());
+        pending.pop_front();
+        write_stream(job.compressed.get(), job.entries);
+    }
+}
+
+void MultistreamWriter::Impl::write_stream(Result<std::string> compressed, const EntryList &entries) {
+    // Streams after a lost one would be indexed at the wrong offsets
+    if (!error_message.empty()) {
+        return;
+    }
+    if (!compressed) {
+        fail(compressed.error().message);
+        return;
+    }
+
+    if (fwrite(compressed->data(), 1, compressed->size(), dump_file) != compressed->size()) {
+        fail("Failed to write dump stream");
+        return;
+    }
+
+    for (const auto &[id, title]: entries) {
+        index_text += std::to_string(offset);
+        index_text += ':';
+        index_text += std::to_string(id);
+        index_text += ':';
+        index_text += title;
+        index_text += '\n';
+    }
+
+    offset += compressed->size();
+    stats.pages_written += entries.size();
+    stats.streams_written++;
+    stats.bytes_compressed += compressed->size();
+
+    flush_index(false);
+}
+
+void MultistreamWriter::Impl::flush_index(bool force) {
+    if (index_text.empty() || (!force && index_text.size() < INDEX_FLUSH_SIZE)) {
+        return;
+    }
+
+    // Index is itself multistream, one BZ2 stream per flush
+    auto compressed = compress_bz2(index_text, config.compression_level);
+    if (!compressed) {
+        fail(compressed.error().message);
+        return;
+    }
+
+    if (fwrite(compressed->data(), 1, compressed->size(), index_file) != compressed->size()) {
+        fail("Failed to write index stream");
+        return;
+    }
+    index_text.clear();
+}
+
+MultistreamWriter::MultistreamWriter(const std::string &dump_path, const std::string &index_path,
+                                     MultistreamConfig config) : impl_(std::make_unique<Impl>()) {
+    impl_->config = config;
+    if (impl_->config.pages_per_stream == 0) {
+        impl_->config.pages_per_stream = 1;
+    }
+
+    impl_->dump_file = fopen(dump_path.c_str(), "wb");
+    if (!impl_->dump_file) {
+        impl_->error_message = "Failed to open dump file for writing: " + dump_path;
+        return;
+    }
+
+    impl_->index_file = fopen(index_path.c_str(), "wb");
+    if (!impl_->index_file) {
+        impl_->error_message = "Failed to open index file for writing: " + index_path;
+        fclose(impl_->dump_file);
+        impl_->dump_file = nullptr;
+        return;
+    }
+
+    impl_->start_pool();
+}
+
+MultistreamWriter::~MultistreamWriter() {
+    if (!impl_->finished) {
+        (void) finish();
+    }
+}
+
+bool MultistreamWriter::is_open() const noexcept {
+    return impl_->dump_file && impl_->index_file;
+}
+
+void MultistreamWriter::write_header(std::string_view header_xml) {
+    if (!is_open() || impl_->finished) {
+        return;
+    }
+
+    impl_->flush_group();
+    impl_->stats.bytes_uncompressed += header_xml.size();
+    impl_->submit(std::string(header_xml), {});
+}
+
+void MultistreamWriter::add_page(PageId id, std::string_view title, std::string_view page_xml) {
+    if (!is_open() || impl_->finished) {
+        return;
+    }
+
+    impl_->group_xml += page_xml;
+    if (!page_xml.empty() && page_xml.back() != '\n') {
+        impl_->group_xml += '\n';
+    }
+    impl_->group_entries.emplace_back(id, std::string(title));
+    impl_->stats.bytes_uncompressed += page_xml.size();
+
+    if (impl_->group_entries.size() >= impl_->config.pages_per_stream) {
+        impl_->flush_group();
+    }
+}
+
+void MultistreamWriter::add_compressed_stream(std::string_view compressed,
+                                              const std::vector<std::pair<PageId, std::string>> &entries) {
+    if (!is_open() || impl_->finished || !impl_->error_message.empty()) {
+        return;
+    }
+
+    impl_->flush_group();
+
+    // Queue as completed job so it is written after streams still compressing
+    Promise<Result<std::string>> done;
+    done.set_value(std::string(compressed));
+    impl_->pending.push_back(Impl::Job{done.get_future(), entries});
+    impl_->write_completed(false);
+}
+
+bool MultistreamWriter::finish(std::string_view footer_xml) {
+    if (impl_->finished) {
+        return impl_->error_message.empty();
+    }
+    impl_->finished = true;
+
+    if (!is_open()) {
+        return false;
+    }
+
+    impl_->flush_group();
+    if (!footer_xml.empty()) {
+        impl_->stats.bytes_uncompressed += footer_xml.size();
+        impl_->submit(std::string(footer_xml), {});
+    }
+
+    impl_->write_completed(true);
+    impl_->own_pool.reset();
+    impl_->flush_index(true);
+
+    if (fclose(impl_->dump_file) != 0) {
+        impl_->fail("Failed to close dump file");
+    }
+    if (fclose(impl_->index_file) != 0) {
+        impl_->fail("Failed to close index file");
+    }
+    impl_->dump_file = nullptr;
+    impl_->index_file = nullptr;
+
+    return impl_->error_message.empty();
+}
+
+const MultistreamWriter::Stats &MultistreamWriter::stats() const noexcept {
+    return impl_->stats;
+}
+
+std::string_view MultistreamWriter::error() const noexcept {
+    return impl_->error_message;
+}
+
+} // namespace wikilib::dump
@@ -59,13 +59,39 @@ struct PageHandler::Impl {
     Stats stats;
     std::string error_message;
     bool header_parsed = false;
+    bool page_started = false; // parse_header() already consumed <page>
     bool at_eof = false;
 
+    std::string number_text; // Reused for <id>, <ns> and <parentid>
+
     void parse_header();
-    std::optional<Page> read_page();
-    Revision parse_revision();
+    bool read_page(Page &page);
+    void parse_revision(Revision &rev);
+    uint64_t read_number();
 };
 
+namespace {
+
+// Reset for refilling, keeping string capacities
+void clear_revision(Revision &rev) {
+    rev.id = 0;
+    rev.parent_id = 0;
+    rev.timestamp.clear();
+    rev.contributor.clear();
+    rev.comment.clear();
+    rev.content.clear();
+    rev.model.clear();
+    rev.format.clear();
+    rev.sha1.clear();
+}
+
+} // namespace
+
+uint64_t PageHandler::Impl::read_number() {
+    reader->read_text(number_text);
+    return std::stoull(number_text);
+}
+
 void PageHandler::Impl::parse_header() {
     if (header_parsed || !reader)
         return;
@@ -85,17 +111,21 @@ void PageHandler::Impl::parse_header() {
                 site_info.base_url = reader->read_text();
             } else if (event->name == "generator") {
                 site_info.generator = reader->read_text();
+            } else if (event->name == "case") {
+                site_info.capital_links = reader->read_text() == "first-letter";
             } else if (event->name == "namespace") {
                 Namespace ns;
                 if (auto key = event->get_attribute("key")) {
                     ns.id = std::stoi(std::string(*key));
                 }
                 ns.name = reader->read_text();
-                ns.canonical_name = ns.name;
+                std::string_view canonical = canonical_namespace_name(ns.id);
+                ns.canonical_name = canonical.empty() ? ns.name : std::string(canonical);
                 site_info.namespaces.push_back(std::move(ns));
             } else if (event->name == "page") {
                 // Reached first page, stop parsing header
-                // We need to handle this page
+                // read_page() continues from inside this page
+                page_started = true;
                 break;
             }
         } else if (event->type == XmlEventType::EndElement) {
@@ -106,8 +136,8 @@ void PageHandler::Impl::parse_header() {
     }
 }
 
-Revision PageHandler::Impl::parse_revision() {
-    Revision rev;
+void PageHandler::Impl::parse_revision(Revision &rev) {
+    clear_revision(rev);
     int depth = 1;
 
     while (depth > 0) {
@@ -118,13 +148,13 @@ Revision PageHandler::Impl::parse_revision() {
         if (event->type == XmlEventType::StartElement) {
             depth++;
             if (event->name == "id" && depth == 2) {
-                rev.id = std::stoull(reader->read_text());
+                rev.id = read_number();
                 depth--;
             } else if (event->name == "parentid") {
-                rev.parent_id = std::stoull(reader->read_text());
+                rev.parent_id = read_number();
                 depth--;
             } else if (event->name == "timestamp") {
-                rev.timestamp = reader->read_text();
+                reader->read_text(rev.timestamp);
                 depth--;
             } else if (event->name == "contributor") {
                 // Parse contributor - can have username or ip
@@ -136,7 +166,7 @@ Revision PageHandler::Impl::parse_revision() {
                     if (ce->type == XmlEventType::StartElement) {
                         contrib_depth++;
                         if (ce->name == "username" || ce->name == "ip") {
-                            rev.contributor = reader->read_text();
+                            reader->read_text(rev.contributor);
                             contrib_depth--;
                         }
                     } else if (ce->type == XmlEventType::EndElement) {
@@ -145,40 +175,38 @@ Revision PageHandler::Impl::parse_revision() {
                 }
                 depth--;
             } else if (event->name == "comment") {
-                rev.comment = reader->read_text();
+                reader->read_text(rev.comment);
                 depth--;
             } else if (event->name == "model") {
-                rev.model = reader->read_text();
+                reader->read_text(rev.model);
                 depth--;
             } else if (event->name == "format") {
-                rev.format = reader->read_text();
+                reader->read_text(rev.format);
                 depth--;
             } else if (event->name == "text") {
-                rev.content = reader->read_text();
+                reader->read_text(rev.content);
                 depth--;
             } else if (event->name == "sha1") {
-                rev.sha1 = reader->read_text();
+                reader->read_text(rev.sha1);
                 depth--;
             }
         } else if (event->type == XmlEventType::EndElement) {
             depth--;
         }
     }
-
-    return rev;
 }
 
-std::optional<Page> PageHandler::Impl::read_page() {
+bool PageHandler::Impl::read_page(Page &page) {
     if (!reader || at_eof) {
-        return std::nullopt;
+        return false;
     }
 
     // Find start of <page>
-    while (true) {
+    while (!page_started) {
         auto event = reader->next();
         if (!event) {
             at_eof = true;
-            return std::nullopt;
+            return false;
         }
 
         if (event->type == XmlEventType::StartElement && event->name == "page") {
@@ -187,11 +215,20 @@ std::optional<Page> PageHandler::Impl::read_page() {
 
         if (event->type == XmlEventType::EndDocument) {
             at_eof = true;
-            return std::nullopt;
+            return false;
         }
     }
 
-    Page page;
+    page_started = false;
+
+    // Refill the page in place; revision slots beyond the new count are dropped
+    page.info.id = 0;
+    page.info.title.clear();
+    page.info.namespace_id = 0;
+    page.info.revision_id = 0;
+    page.info.timestamp.clear();
+    page.info.redirect_target.reset();
+    size_t revision_count = 0;
     int depth = 1;
 
     while (depth > 0) {
@@ -203,13 +240,14 @@ std::optional<Page> PageHandler::Impl::read_page() {
             depth++;
 
             if (event->name == "title") {
-                page.info.title = reader->read_text();
+                reader->read_text(page.info.title);
                 depth--;
             } else if (event->name == "ns") {
-                page.info.namespace_id = std::stoi(reader->read_text());
+                reader->read_text(number_text);
+                page.info.namespace_id = std::stoi(number_text);
                 depth--;
             } else if (event->name == "id" && depth == 2) {
-                page.info.id = std::stoull(reader->read_text());
+                page.info.id = read_number();
                 depth--;
             } else if (event->name == "redirect") {
                 if (auto title = event->get_attribute("title")) {
@@ -217,18 +255,22 @@ std::optional<Page> PageHandler::Impl::read_page() {
                 }
                 stats.redirects_found++;
             } else if (event->name == "revision") {
-                page.revisions.push_back(parse_revision());
+                if (revision_count == page.revisions.size()) {
+                    page.revisions.emplace_back();
+                }
+                parse_revision(page.revisions[revision_count++]);
                 depth--;
             }
         } else if (event->type == XmlEventType::EndElement) {
             depth--;
         }
     }
+    page.revisions.resize(revision_count);
 
     stats.pages_read++;
     stats.bytes_processed = reader->bytes_processed();
 
-    return page;
+    return true;
 }
 
 PageHandler::PageHandler(const std::string &dump_path) : impl_(std::make_unique<Impl>()) {
@@ -260,15 +302,12 @@ void PageHandler::process(PageCallback callback) {
 
 void PageHandler::process(PageCallback callback, const PageFilter &filter) {
     size_t count = 0;
+    Page page; // Refilled for every page so steady-state reading reuses its buffers
 
-    while (true) {
-        auto page = next_page(filter);
-        if (!page)
-            break;
-
+    while (next_page(page, filter)) {
         impl_->stats.pages_processed++;
 
-        if (!callback(*page)) {
+        if (!callback(page)) {
             break;
         }
 
@@ -280,21 +319,36 @@ void PageHandler::process(PageCallback callback, const PageFilter &filter) {
 }
 
 std::optional<Page> PageHandler::next_page() {
-    return impl_ ? impl_->read_page() : std::nullopt;
+    Page page;
+    if (!next_page(page)) {
+        return std::nullopt;
+    }
+    return page;
 }
 
 std::optional<Page> PageHandler::next_page(const PageFilter &filter) {
-    while (true) {
-        auto page = next_page();
-        if (!page)
-            return std::nullopt;
+    Page page;
+    if (!next_page(page, filter)) {
+        return std::nullopt;
+    }
+    return page;
+}
 
-        if (filter.matches(*page)) {
-            return page;
-        }
+bool PageHandler::next_page(Page &reuse) {
+    return impl_ && impl_->read_page(reuse);
+}
 
+bool PageHandler::next_page(Page &reuse, const PageFilter &filter) {
+    while (next_page(reuse)) {
+        if (filter.matches(reuse)) {
+            if (filter.only_latest_revision && reuse.revisions.size() > 1) {
+                reuse.revisions.erase(reuse.revisions.begin(), reuse.revisions.end() - 1);
+            }
+            return true;
+        }
         impl_->stats.pages_skipped++;
     }
+    return false;
 }
 
 const PageHandler::SiteInfo &PageHandler::site_info() const {
@@ -315,6 +369,40 @@ std::string_view PageHandler::error() const noexcept {
     return impl_ ? impl_->error_message : "";
 }
 
+// ============================================================================
+// PageScanner
+// ============================================================================
+
+size_t PageScanner::scan(std::string_view xml, bool final, const Callback &callback) {
+    static constexpr std::string_view PAGE_OPEN = "<page>";
+    static constexpr std::string_view PAGE_CLOSE = "</page>";
+
+    size_t first = xml.find(PAGE_OPEN);
+    if (first == std::string_view::npos) {
+        // Keep a possible partial "<page>" at the end
+        return final ? xml.size() : xml.size() - std::min(xml.size(), PAGE_OPEN.size() - 1);
+    }
+    size_t last = xml.rfind(PAGE_CLOSE);
+    if (last == std::string_view::npos || last < first) {
+        return final ? xml.size() : first;
+    }
+    last += PAGE_CLOSE.size();
+
+    // Pages come out of the handler in document order, so the n-th page
+    // parsed is the n-th <page>...</page> span of xml
+    PageHandler handler(std::make_unique<XmlReader>(XmlReader::from_string(xml.substr(first, last - first))));
+    size_t pos = first;
+    while (pos < last && handler.next_page(page_)) {
+        size_t start = xml.find(PAGE_OPEN, pos);
+        size_t end = xml.find(PAGE_CLOSE, start) + PAGE_CLOSE.size();
+        pos = end;
+        if (!callback(xml.substr(start, end - start), page_)) {
+            return pos;
+        }
+    }
+    return final ? xml.size() : last;
+}
+
 // ============================================================================
 // Convenience functions
 // ============================================================================
@@ -327,8 +415,9 @@ void process_dump(const std::string &path, PageCallback callback, const PageFilt
 size_t count_pages(const std::string &path, const PageFilter &filter) {
     size_t count = 0;
     PageHandler handler(path);
+    Page page;
 
-    while (auto page = handler.next_page(filter)) {
+    while (handler.next_page(page, filter)) {
         ++count;
         if (filter.max_pages.has_value() && count >= *filter.max_pages) {
             break;
@@ -340,9 +429,10 @@ size_t count_pages(const std::string &path, const PageFilter &filter) {
 
 std::optional<Page> find_page(const std::string &path, std::string_view title) {
     PageHandler handler(path);
+    Page page;
 
-    while (auto page = handler.next_page()) {
-        if (page->info.title == title) {
+    while (handler.next_page(page)) {
+        if (page.info.title == title) {
             return page;
         }
     }
@@ -354,7 +444,7 @@ std::vector<Page> extract_templates(const std::string &path) {
     std::vector<Page> templates;
 
     PageFilter filter;
-    filter.namespaces = std::vector<NamespaceId>{10}; // Template namespace
+    filter.namespaces = std::vector<NamespaceId>{NS_TEMPLATE};
 
     PageHandler handler(path);
     handler.process(
@@ -0,0 +1,244 @@
+/**
+ * @file subdump_writer.cpp
+ * @brief Implementation of filtered multistream sub-dump builder
+ */
+
+#include "wikilib/dump/subdump_writer.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "wikilib/core/namespace_resolver.h"
+#include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/index_chunker.h"
+#include "wikilib/dump/xml_reader.h"
+
+namespace wikilib::dump {
+
+namespace {
+
+// Answer for one index entry without looking at the page
+enum class EntryMatch { Yes, No, Unknown };
+
+class EntryClassifier {
+public:
+    EntryClassifier(const PageFilter &filter, NamespaceResolver namespaces) :
+        filter_(filter), namespaces_(std::move(namespaces)) {
+    }
+
+    EntryMatch classify(const IndexEntry &entry) const {
+        if (filter_.namespaces.has_value()) {
+            NamespaceId ns = namespaces_.namespace_of(entry.title);
+            bool found = false;
+            for (NamespaceId id: *filter_.namespaces) {
+                if (id == ns) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                return EntryMatch::No;
+            }
+        }
+
+        if (filter_.title_prefix.has_value() && !entry.title.starts_with(*filter_.title_prefix)) {
+            return EntryMatch::No;
+        }
+
+        if (filter_.title_contains.has_value() && entry.title.find(*filter_.title_contains) == std::string::npos) {
+            return EntryMatch::No;
+        }
+
+        // Redirects are only visible in the page XML
+        return filter_.include_redirects ? EntryMatch::Yes : EntryMatch::Unknown;
+    }
+
+private:
+    const PageFilter &filter_;
+    NamespaceResolver namespaces_;
+};
+
+// Page XML keeping only its last <revision> (the one Page::latest_revision() returns)
+std::string_view latest_revision_only(std::string_view page_xml, std::string &buffer) {
+    size_t first = page_xml.find("<revision>");
+    size_t last = page_xml.rfind("<revision>");
+    if (first == last) {
+        return page_xml;
+    }
+    buffer.assign(page_xml.substr(0, first));
+    buffer.append(page_xml.substr(last));
+    return buffer;
+}
+
+// Number of <revision> tags in xml, counting stops past limit
+size_t count_revisions(std::string_view xml, size_t limit) {
+    size_t count = 0;
+    for (size_t pos = xml.find("<revision>"); pos != std::string_view::npos && count <= limit;
+         pos = xml.find("<revision>", pos + 10)) {
+        ++count;
+    }
+    return count;
+}
+
+NamespaceResolver read_namespaces(std::string_view header_xml) {
+    PageHandler handler(std::make_unique<XmlReader>(XmlReader::from_string(header_xml)));
+    return handler.site_info().namespace_resolver();
+}
+
+} // namespace
+
+// ============================================================================
+// Sub-dump builder
+// ============================================================================
+
+SubdumpResult write_subdump(const std::string &dump_path, const std::string &index_path,
+                            const std::string &out_dump_path, const std::string &out_index_path,
+                            const PageFilter &filter, MultistreamConfig config) {
+    SubdumpResult result;
+
+    std::error_code ec;
+    uint64_t dump_size = std::filesystem::file_size(dump_path, ec);
+    if (ec) {
+        result.error = "Failed to stat dump file: " + dump_path;
+        return result;
+    }
+
+    std::unique_ptr<FILE, int (*)(FILE *)> dump(fopen(dump_path.c_str(), "rb"), &fclose);
+    if (!dump) {
+        result.error = "Failed to open dump file: " + dump_path;
+        return result;
+    }
+
+    std::optional<IndexChunker> chunker;
+    try {
+        chunker.emplace(IndexChunker::from_file(index_path, dump_size));
+    } catch (const std::exception &e) {
+        result.error = std::string("Failed to open index: ") + e.what();
+        return result;
+    }
+
+    IndexChunk chunk;
+    if (!chunker->next_chunk(chunk)) {
+        result.error = "Index is empty: " + index_path;
+        return result;
+    }
+
+    MultistreamWriter writer(out_dump_path, out_index_path, config);
+    if (!writer.is_open()) {
+        result.error = std::string(writer.error());
+        return result;
+    }
+
+    // Header stream precedes the first indexed chunk; copy it unchanged
+    std::string compressed;
+    if (!read_dump_range(dump.get(), 0, chunk.start_offset, compressed)) {
+        result.error = "Failed to read dump header";
+        return result;
+    }
+    auto header_xml = decompress_bz2(compressed);
+    if (!header_xml) {
+        result.error = header_xml.error().message;
+        return result;
+    }
+    writer.add_compressed_stream(compressed, {});
+
+    EntryClassifier classifier(filter, read_namespaces(*header_xml));
+    std::vector<std::pair<PageId, std::string>> entries;
+    Arena arena; // Decompressed chunks, reused from chunk to chunk
+    PageScanner scanner;
+    std::string trimmed; // Page XML with older revisions dropped
+    size_t remaining = filter.max_pages.value_or(SIZE_MAX);
+
+    do {
+        if (remaining == 0) {
+            break;
+        }
+
+        size_t matched = 0;
+        bool undecided = false;
+        for (const auto &entry: chunk.entries) {
+            switch (classifier.classify(entry)) {
+                case EntryMatch::Yes:
+                    ++matched;
+                    break;
+                case EntryMatch::Unknown:
+                    undecided = true;
+                    break;
+                case EntryMatch::No:
+                    break;
+            }
+        }
+
+        if (matched == 0 && !undecided) {
+            result.chunks_skipped++;
+            continue;
+        }
+
+        if (!read_dump_range(dump.get(), chunk.start_offset, chunk.end_offset, compressed)) {
+            result.error = "Failed to read chunk at offset " + std::to_string(chunk.start_offset);
+            return result;
+        }
+
+        auto copy_chunk = [&] {
+            entries.clear();
+            for (const auto &entry: chunk.entries) {
+                entries.emplace_back(entry.page_id, entry.title);
+            }
+            writer.add_compressed_stream(compressed, entries);
+            result.chunks_copied++;
+            result.pages_written += matched;
+            remaining -= matched;
+        };
+
+        // The last chunk also holds the </mediawiki> stream, so it is never copied
+        bool copyable = !undecided && matched == chunk.size() && matched <= remaining && chunk.end_offset != dump_size;
+        if (copyable && !filter.only_latest_revision) {
+            copy_chunk();
+            continue;
+        }
+
+        arena.reset();
+        auto xml = decompress_bz2(compressed, arena);
+        if (!xml) {
+            result.error = xml.error().message;
+            return result;
+        }
+
+        // Older revisions are only visible in the page XML; every page has
+        // one, so no more <revision> tags than pages means the chunk is still
+        // copied rather than recompressed
+        if (copyable && count_revisions(*xml, chunk.size()) <= chunk.size()) {
+            copy_chunk();
+            continue;
+        }
+
+        // Filter page by page, keeping the original page XML
+        scanner.scan(*xml, true, [&](std::string_view page_xml, const Page &page) {
+            if (filter.matches(page)) {
+                if (filter.only_latest_revision) {
+                    page_xml = latest_revision_only(page_xml, trimmed);
+                }
+                writer.add_page(page.info.id, page.info.title, page_xml);
+                result.pages_written++;
+                remaining--;
+            }
+            return remaining > 0;
+        });
+        result.chunks_reencoded++;
+    } while (chunker->next_chunk(chunk));
+
+    if (!writer.finish()) {
+        result.error = std::string(writer.error());
+        return result;
+    }
+
+    result.success = true;
+    return result;
+}
+
+} // namespace wikilib::dump
@@ -8,7 +8,7 @@
 #include <cstring>
 #include <fstream>
 #include <sstream>
-#include <stack>
+#include <unordered_map>
 #include "wikilib/dump/bz2_stream.h"
 
 namespace wikilib::dump {
@@ -35,10 +35,11 @@ struct XmlReader::Impl {
     std::unique_ptr<std::istream> plain_stream;
     std::string buffer;
     size_t buffer_pos = 0;
-    std::stack<std::string> element_stack;
+    std::vector<uint32_t> element_stack; // Interned ids of open elements
     bool at_eof = false;
     bool document_started = false;
     bool document_ended = false;
+    bool pending_end = false; // Self-closing element still needs its EndElement
     std::string error_message;
     uint64_t bytes_processed = 0;
 
@@ -46,6 +47,19 @@ struct XmlReader::Impl {
     std::string current_element_name;
     std::string current_text;
     std::vector<std::pair<std::string, std::string>> current_attributes;
+    uint32_t current_element_id = 0;
+
+    // Element name interning
+    struct NameHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view sv) const noexcept {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> name_ids;
 
     static constexpr size_t BUFFER_SIZE = 64 * 1024;
     char read_buffer[BUFFER_SIZE];
@@ -54,7 +68,8 @@ struct XmlReader::Impl {
     char peek_char();
     char get_char();
     bool skip_whitespace();
-    std::string read_name();
+    void read_name(std::string &name);
+    uint32_t intern(std::string_view name);
     std::string read_quoted_string();
     std::string decode_entities(std::string_view text);
     void skip_until(char c);
@@ -132,8 +147,8 @@ bool XmlReader::Impl::skip_whitespace() {
     return true;
 }
 
-std::string XmlReader::Impl::read_name() {
-    std::string name;
+void XmlReader::Impl::read_name(std::string &name) {
+    name.clear();
     while (true) {
         char c = peek_char();
         if (c == '\0')
@@ -144,7 +159,18 @@ std::string XmlReader::Impl::read_name() {
             break;
         }
     }
-    return name;
+}
+
+uint32_t XmlReader::Impl::intern(std::string_view name) {
+    auto it = name_ids.find(name);
+    if (it != name_ids.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<uint32_t>(names.size());
+    names.emplace_back(name);
+    name_ids.emplace(names.back(), id);
+    return id;
 }
 
 std::string XmlReader::Impl::read_quoted_string() {
@@ -366,6 +392,13 @@ std::optional<XmlEvent> XmlReader::next() {
         return XmlEvent{XmlEventType::StartDocument, {}, {}, {}};
     }
 
+    // Close self-closing element returned by previous call
+    if (impl_->pending_end) {
+        impl_->pending_end = false;
+        impl_->element_stack.pop_back();
+        return XmlEvent{XmlEventType::EndElement, impl_->current_element_name, {}, {}};
+    }
+
     impl_->skip_whitespace();
 
     if (impl_->peek_char() == '\0') {
@@ -420,11 +453,11 @@ std::optional<XmlEvent> XmlReader::next() {
         // End element
         if (impl_->peek_char() == '/') {
             impl_->get_char();
-            impl_->current_element_name = impl_->read_name();
+            impl_->read_name(impl_->current_element_name);
             impl_->skip_until('>');
 
             if (!impl_->element_stack.empty()) {
-                impl_->element_stack.pop();
+                impl_->element_stack.pop_back();
             }
 
             return XmlEvent{XmlEventType::EndElement, impl_->current_element_name, {}, {}};
@@ -437,7 +470,8 @@ std::optional<XmlEvent> XmlReader::next() {
         }
 
         // Start element
-        impl_->current_element_name = impl_->read_name();
+        impl_->read_name(impl_->current_element_name);
+        impl_->current_element_id = impl_->intern(impl_->current_element_name);
         impl_->current_attributes.clear();
 
         // Read attributes
@@ -448,7 +482,8 @@ std::optional<XmlEvent> XmlReader::next() {
             if (c == '/' || c == '>' || c == '\0')
                 break;
 
-            std::string attr_name = impl_->read_name();
+            std::string attr_name;
+            impl_->read_name(attr_name);
             if (attr_name.empty())
                 break;
 
@@ -482,12 +517,9 @@ std::optional<XmlEvent> XmlReader::next() {
             event.attributes.push_back({name, value});
         }
 
-        if (!self_closing) {
-            impl_->element_stack.push(impl_->current_element_name);
-        } else {
-            // For self-closing, we'll need to return EndElement next
-            // For simplicity, just push and will pop on next call
-        }
+        // Self-closing elements stay open until the EndElement of the next call
+        impl_->element_stack.push_back(impl_->current_element_id);
+        impl_->pending_end = self_closing;
 
         return event;
     }
@@ -532,10 +564,16 @@ void XmlReader::skip_element() {
 }
 
 std::string XmlReader::read_text() {
+    std::string text;
+    read_text(text);
+    return text;
+}
+
+void XmlReader::read_text(std::string &text) {
+    text.clear();
     if (!impl_)
-        return "";
+        return;
 
-    std::string text;
     int start_depth = static_cast<int>(impl_->element_stack.size());
 
     while (true) {
@@ -551,8 +589,6 @@ std::string XmlReader::read_text() {
             }
         }
     }
-
-    return text;
 }
 
 bool XmlReader::eof() const noexcept {
@@ -568,23 +604,29 @@ std::string XmlReader::current_path() const {
         return "";
 
     std::string path;
-    std::stack<std::string> temp = impl_->element_stack;
-    std::vector<std::string> elements;
-
-    while (!temp.empty()) {
-        elements.push_back(temp.top());
-        temp.pop();
-    }
-
-    for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+    for (uint32_t id: impl_->element_stack) {
         if (!path.empty())
             path += '/';
-        path += *it;
+        path += impl_->names[id];
     }
 
     return path;
 }
 
+uint32_t XmlReader::intern_name(std::string_view name) {
+    return impl_ ? impl_->intern(name) : 0;
+}
+
+std::span<const uint32_t> XmlReader::path_ids() const noexcept {
+    if (!impl_)
+        return {};
+    return impl_->element_stack;
+}
+
+uint32_t XmlReader::current_element_id() const noexcept {
+    return impl_ ? impl_->current_element_id : 0;
+}
+
 uint64_t XmlReader::bytes_processed() const noexcept {
     return impl_ ? impl_->bytes_processed : 0;
 }
@@ -607,21 +649,35 @@ std::optional<std::string_view> XmlElementIterator::Element::attribute(std::stri
 }
 
 XmlElementIterator::XmlElementIterator(XmlReader &reader, std::string path) : reader_(reader), path_(std::move(path)) {
-    // Split path into parts
+    // Split path into parts and compile them to interned ids
+    std::string_view rest = path_;
     size_t start = 0;
-    while (start < path_.size()) {
-        size_t end = path_.find('/', start);
-        if (end == std::string::npos) {
-            path_parts_.push_back(path_.substr(start));
+    while (start < rest.size()) {
+        size_t end = rest.find('/', start);
+        if (end == std::string_view::npos) {
+            path_ids_.push_back(reader_.intern_name(rest.substr(start)));
             break;
         }
         if (end > start) {
-            path_parts_.push_back(path_.substr(start, end - start));
+            path_ids_.push_back(reader_.intern_name(rest.substr(start, end - start)));
         }
         start = end + 1;
     }
 }
 
+bool XmlElementIterator::matches_current() const noexcept {
+    if (path_ids_.empty()) {
+        return true;
+    }
+    if (path_ids_.size() == 1) {
+        return reader_.current_element_id() == path_ids_[0];
+    }
+
+    // Full path match: integer compares over the open element stack
+    auto current = reader_.path_ids();
+    return std::equal(current.begin(), current.end(), path_ids_.begin(), path_ids_.end());
+}
+
 std::optional<XmlElementIterator::Element> XmlElementIterator::next() {
     while (true) {
         auto event = reader_.next();
@@ -630,20 +686,7 @@ std::optional<XmlElementIterator::Element> XmlElementIterator::next() {
         }
 
         if (event->type == XmlEventType::StartElement) {
-            // Check if current path matches
-            std::string current = reader_.current_path();
-
-            bool matches = false;
-            if (path_parts_.empty()) {
-                matches = true;
-            } else if (path_parts_.size() == 1) {
-                matches = (event->name == path_parts_[0]);
-            } else {
-                // Check full path match
-                matches = (current == path_);
-            }
-
-            if (matches) {
+            if (matches_current()) {
                 Element elem;
                 elem.name = event->name;
                 elem.attributes = event->attributes;
@@ -316,7 +316,33 @@ std::string HtmlTagNode::to_wikitext() const {
     return result;
 }
 
+void HtmlTagNode::add_attribute(std::string name, std::string value) {
+    HtmlAttrId id = lookup_html_attribute(name);
+    auto slot = static_cast<size_t>(id);
+    // First occurrence wins, as in browsers; slots only address the first 255
+    if (id != HtmlAttrId::Unknown && attribute_slots[slot] == 0 && attributes.size() < UINT8_MAX) {
+        attribute_slots[slot] = static_cast<uint8_t>(attributes.size() + 1);
+    }
+    attributes.emplace_back(std::move(name), std::move(value));
+}
+
+std::optional<std::string_view> HtmlTagNode::get_attribute(HtmlAttrId id) const {
+    if (id == HtmlAttrId::Unknown) {
+        return std::nullopt;
+    }
+    uint8_t slot = attribute_slots[static_cast<size_t>(id)];
+    if (slot == 0 || slot > attributes.size()) {
+        return std::nullopt;
+    }
+    return attributes[slot - 1].second;
+}
+
 std::optional<std::string_view> HtmlTagNode::get_attribute(std::string_view name) const {
+    // Fast path for indexed names; fall back to a scan for attributes pushed directly
+    if (auto slot = attribute_slots[static_cast<size_t>(lookup_html_attribute(name))];
+        slot != 0 && slot <= attributes.size() && attributes[slot - 1].first == name) {
+        return attributes[slot - 1].second;
+    }
     for (const auto &[attr_name, attr_value]: attributes) {
         if (attr_name == name) {
             return attr_value;
@@ -0,0 +1,459 @@
+/**
+ * @file external_links.cpp
+ * @brief Implementation of external link scanning and URL normalization
+ */
+
+#include "wikilib/markup/external_links.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include "wikilib/core/text_utils.hpp"
+#include "wikilib/core/unicode_utils.h"
+
+namespace wikilib::markup {
+
+namespace {
+
+// Protocols of MediaWiki's $wgUrlProtocols that use "://", sorted
+constexpr std::array<std::string_view, 16> URL_SCHEMES = {"ftp",  "ftps", "git",  "gopher", "http", "https",
+                                                          "irc",  "ircs", "mms",  "nntp",   "redis", "sftp",
+                                                          "ssh",  "svn",  "telnet", "worldwind"};
+
+static_assert(std::is_sorted(URL_SCHEMES.begin(), URL_SCHEMES.end()));
+
+bool is_alnum(char c) noexcept {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+char to_lower(char c) noexcept {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+int hex_value(char c) noexcept {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = to_lower(c);
+    return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+bool is_unreserved(char c) noexcept {
+    return is_alnum(c) || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+// Characters ending a URL in unexpanded wikitext
+bool ends_url(std::string_view text, size_t i) noexcept {
+    auto c = static_cast<unsigned char>(text[i]);
+    if (c <= 0x20 || c == 0x7F) {
+        return true;
+    }
+    switch (c) {
+        case '<':
+        case '>':
+        case '"':
+        case '[':
+        case ']':
+        case '|':
+            return true;
+        case '{':
+        case '}':
+        case '\'':
+            return i + 1 < text.size() && text[i + 1] == text[i];
+        case 0xC2: // U+00A0 no-break space
+            return i + 1 < text.size() && static_cast<unsigned char>(text[i + 1]) == 0xA0;
+        default:
+            return false;
+    }
+}
+
+struct Authority {
+    std::string_view host;
+    std::string_view port;
+};
+
+// Host and port of the authority following "://"; rest receives path onwards
+Authority split_authority(std::string_view after_scheme, std::string_view &rest) noexcept {
+    size_t end = after_scheme.find_first_of("/?#");
+    std::string_view authority = after_scheme.substr(0, end);
+    rest = end == std::string_view::npos ? std::string_view{} : after_scheme.substr(end);
+
+    size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority.remove_prefix(at + 1);
+    }
+
+    Authority result;
+    if (authority.starts_with('[')) {
+        size_t close = authority.find(']');
+        if (close == std::string_view::npos) {
+            result.host = authority;
+            return result;
+        }
+        result.host = authority.substr(0, close + 1);
+        if (close + 1 < authority.size() && authority[close + 1] == ':') {
+            result.port = authority.substr(close + 2);
+        }
+        return result;
+    }
+
+    size_t colon = authority.rfind(':');
+    result.host = authority.substr(0, colon);
+    if (colon != std::string_view::npos) {
+        result.port = authority.substr(colon + 1);
+    }
+    return result;
+}
+
+std::string_view default_port(std::string_view scheme) noexcept {
+    if (scheme == "http") {
+        return "80";
+    }
+    if (scheme == "https") {
+        return "443";
+    }
+    if (scheme == "ftp") {
+        return "21";
+    }
+    return {};
+}
+
+// RFC 3492 bias adaptation
+uint32_t adapt(uint32_t delta, uint32_t points, bool first) noexcept {
+    constexpr uint32_t base = 36, tmin = 1, tmax = 26, skew = 38, damp = 700;
+    delta = first ? delta / damp : delta / 2;
+    delta += delta / points;
+    uint32_t k = 0;
+    while (delta > ((base - tmin) * tmax) / 2) {
+        delta /= base - tmin;
+        k += base;
+    }
+    return k + (base - tmin + 1) * delta / (delta + skew);
+}
+
+} // namespace
+
+// ============================================================================
+// Link scanner
+// ============================================================================
+
+bool is_url_scheme(std::string_view scheme) noexcept {
+    std::array<char, 16> lower{};
+    if (scheme.empty() || scheme.size() > lower.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < scheme.size(); ++i) {
+        lower[i] = to_lower(scheme[i]);
+    }
+    return std::binary_search(URL_SCHEMES.begin(), URL_SCHEMES.end(), std::string_view(lower.data(), scheme.size()));
+}
+
+bool ExternalLinkScanner::skip_comment(size_t colon) {
+    if (!comment_known_ || (comment_ != std::string_view::npos && comment_ < pos_)) {
+        comment_ = input_.find("<!--", pos_);
+        comment_known_ = true;
+    }
+    if (comment_ == std::string_view::npos || comment_ > colon) {
+        return false;
+    }
+
+    size_t end = input_.find("-->", comment_ + 4);
+    pos_ = end == std::string_view::npos ? input_.size() : end + 3;
+    comment_known_ = false;
+    return true;
+}
+
+bool ExternalLinkScanner::next(ExternalUrl &link) {
+    while (pos_ < input_.size()) {
+        const void *found = std::memchr(input_.data() + pos_, ':', input_.size() - pos_);
+        if (!found) {
+            pos_ = input_.size();
+            return false;
+        }
+
+        size_t colon = static_cast<size_t>(static_cast<const char *>(found) - input_.data());
+        if (skip_comment(colon)) {
+            continue;
+        }
+        pos_ = colon + 1;
+        if (input_.substr(colon + 1, 2) != "//") {
+            continue;
+        }
+
+        size_t scheme = colon;
+        while (scheme > 0 && is_alnum(input_[scheme - 1])) {
+            --scheme;
+        }
+        if (!is_url_scheme(input_.substr(scheme, colon - scheme))) {
+            continue;
+        }
+
+        size_t end = colon + 3;
+        while (end < input_.size() && !ends_url(input_, end)) {
+            ++end;
+        }
+
+        std::string_view url = input_.substr(scheme, end - scheme);
+        bool bracketed = scheme > 0 && input_[scheme - 1] == '[';
+        if (!bracketed) {
+            // Trailing punctuation belongs to the sentence, not the link
+            std::string_view strip = url.find('(') == std::string_view::npos ? ",;.:!?)" : ",;.:!?";
+            while (url.size() > colon + 3 - scheme && strip.find(url.back()) != std::string_view::npos) {
+                url.remove_suffix(1);
+            }
+        }
+
+        pos_ = end;
+        if (url.size() == colon + 3 - scheme) {
+            continue; // Scheme without host
+        }
+
+        link.url = url;
+        link.offset = scheme;
+        link.bracketed = bracketed;
+        return true;
+    }
+    return false;
+}
+
+void collect_external_urls(std::string_view wikitext, std::vector<ExternalUrl> &out) {
+    out.clear();
+    ExternalLinkScanner scanner(wikitext);
+    ExternalUrl link;
+    while (scanner.next(link)) {
+        out.push_back(link);
+    }
+}
+
+// ============================================================================
+// URL normalization
+// ============================================================================
+
+std::string_view url_host(std::string_view url) noexcept {
+    size_t sep = url.find("://");
+    if (sep == std::string_view::npos) {
+        return {};
+    }
+    std::string_view rest;
+    return split_authority(url.substr(sep + 3), rest).host;
+}
+
+bool decode_punycode(std::string_view label, std::string &out) {
+    constexpr uint32_t base = 36, tmin = 1, tmax = 26;
+    constexpr uint32_t max = std::numeric_limits<uint32_t>::max();
+
+    std::u32string decoded;
+    size_t basic = label.rfind('-');
+    size_t in = 0;
+    if (basic != std::string_view::npos) {
+        for (size_t j = 0; j < basic; ++j) {
+            if (static_cast<unsigned char>(label[j]) >= 0x80) {
+                return false;
+            }
+            decoded.push_back(static_cast<char32_t>(label[j]));
+        }
+        in = basic + 1;
+    }
+
+    uint32_t n = 128;
+    uint32_t i = 0;
+    uint32_t bias = 72;
+    while (in < label.size()) {
+        uint32_t old_i = i;
+        uint32_t w = 1;
+        for (uint32_t k = base;; k += base) {
+            if (in >= label.size()) {
+                return false;
+            }
+            char c = to_lower(label[in++]);
+            uint32_t digit;
+            if (c >= 'a' && c <= 'z') {
+                digit = static_cast<uint32_t>(c - 'a');
+            } else if (c >= '0' && c <= '9') {
+                digit = static_cast<uint32_t>(c - '0') + 26;
+            } else {
+                return false;
+            }
+            if (digit > (max - i) / w) {
+                return false;
+            }
+            i += digit * w;
+            uint32_t t = k <= bias ? tmin : (k >= bias + tmax ? tmax : k - bias);
+            if (digit < t) {
+                break;
+            }
+            if (w > max / (base - t)) {
+                return false;
+            }
+            w *= base - t;
+        }
+
+        auto points = static_cast<uint32_t>(decoded.size() + 1);
+        bias = adapt(i - old_i, points, old_i == 0);
+        if (i / points > max - n) {
+            return false;
+        }
+        n += i / points;
+        i %= points;
+        if (n > 0x10FFFF || (n >= 0xD800 && n <= 0xDFFF)) {
+            return false;
+        }
+        decoded.insert(decoded.begin() + i, static_cast<char32_t>(n));
+        ++i;
+    }
+
+    for (char32_t cp: decoded) {
+        out += unicode::encode_utf8(cp);
+    }
+    return true;
+}
+
+bool normalize_url(std::string_view url, std::string &out, const UrlNormalizeOptions &options) {
+    out.clear();
+
+    size_t sep = url.find("://");
+    if (sep == std::string_view::npos || sep == 0) {
+        return false;
+    }
+    std::string_view scheme = url.substr(0, sep);
+    for (char c: scheme) {
+        if (!is_alnum(c) && c != '+' && c != '-' && c != '.') {
+            return false;
+        }
+    }
+
+    std::string_view rest;
+    Authority authority = split_authority(url.substr(sep + 3), rest);
+    std::string_view host = authority.host;
+    while (host.ends_with('.')) {
+        host.remove_suffix(1);
+    }
+    if (host.empty()) {
+        return false;
+    }
+
+    for (char c: scheme) {
+        out += to_lower(c);
+    }
+    out += "://";
+
+    size_t scheme_end = out.size() - 3;
+    if (options.strip_www && host.size() > 4 && text::starts_with_ignore_case_ascii(host, "www.")) {
+        host.remove_prefix(4);
+    }
+
+    // Host labels, lower-cased and optionally IDN-decoded
+    size_t label_start = 0;
+    while (label_start <= host.size()) {
+        size_t dot = host.find('.', label_start);
+        if (dot == std::string_view::npos) {
+            dot = host.size();
+        }
+        std::string_view label = host.substr(label_start, dot - label_start);
+
+        size_t mark = out.size();
+        bool decoded = false;
+        if (options.decode_idn && text::starts_with_ignore_case_ascii(label, "xn--")) {
+            decoded = decode_punycode(label.substr(4), out);
+            if (!decoded) {
+                out.resize(mark);
+            }
+            for (size_t j = mark; j < out.size(); ++j) {
+                out[j] = to_lower(out[j]);
+            }
+        }
+        if (!decoded) {
+            for (char c: label) {
+                out += to_lower(c);
+            }
+        }
+        if (dot < host.size()) {
+            out += '.';
+        }
+        label_start = dot + 1;
+    }
+
+    std::string_view lower_scheme(out.data(), scheme_end);
+    if (!authority.port.empty() && authority.port != default_port(lower_scheme)) {
+        out += ':';
+        out += authority.port;
+    }
+
+    if (options.strip_fragment) {
+        rest = rest.substr(0, rest.find('#'));
+    }
+    if (!rest.starts_with('/')) {
+        out += '/';
+    }
+
+    for (size_t i = 0; i < rest.size(); ++i) {
+        char c = rest[i];
+        if (c != '%' || i + 2 >= rest.size() || hex_value(rest[i + 1]) < 0 || hex_value(rest[i + 2]) < 0) {
+            out += c;
+            continue;
+        }
+        auto value = static_cast<char>(hex_value(rest[i + 1]) * 16 + hex_value(rest[i + 2]));
+        if (is_unreserved(value)) {
+            out += value;
+        } else {
+            static constexpr char HEX[] = "0123456789ABCDEF";
+            out += '%';
+            out += HEX[static_cast<unsigned char>(value) >> 4];
+            out += HEX[static_cast<unsigned char>(value) & 0xF];
+        }
+        i += 2;
+    }
+    return true;
+}
+
+// ============================================================================
+// DomainCounter implementation
+// ============================================================================
+
+void DomainCounter::add_text(std::string_view wikitext) {
+    collect_external_urls(wikitext, urls_);
+    for (const auto &link: urls_) {
+        add_url(link.url);
+    }
+}
+
+void DomainCounter::add_url(std::string_view url) {
+    if (!normalize_url(url, buffer_, options_)) {
+        return;
+    }
+    std::string_view host = url_host(buffer_);
+    auto it = counts_.find(host);
+    if (it == counts_.end()) {
+        it = counts_.emplace(std::string(host), 0).first;
+    }
+    it->second++;
+    total_++;
+}
+
+void DomainCounter::merge(const DomainCounter &other) {
+    for (const auto &[host, n]: other.counts_) {
+        counts_[host] += n;
+    }
+    total_ += other.total_;
+}
+
+std::vector<std::pair<std::string, uint64_t>> DomainCounter::top(size_t limit) const {
+    std::vector<std::pair<std::string, uint64_t>> result(counts_.begin(), counts_.end());
+    auto order = [](const auto &a, const auto &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    if (limit > 0 && limit < result.size()) {
+        std::partial_sort(result.begin(), result.begin() + static_cast<ptrdiff_t>(limit), result.end(), order);
+        result.resize(limit);
+    } else {
+        std::sort(result.begin(), result.end(), order);
+    }
+    return result;
+}
+
+uint64_t DomainCounter::count(std::string_view host) const {
+    auto it = counts_.find(host);
+    return it != counts_.end() ? it->second : 0;
+}
+
+} // namespace wikilib::markup
@@ -0,0 +1,135 @@
+/**
+ * @file html_tags.cpp
+ * @brief Implementation of interned HTML tag and attribute tables
+ */
+
+#include "wikilib/markup/html_tags.h"
+#include <algorithm>
+#include <array>
+
+namespace wikilib::markup {
+
+namespace {
+
+// Index + 1 equals the enum value; both tables must stay sorted
+constexpr std::array<std::string_view, static_cast<size_t>(HtmlTagId::Wbr)> TAG_NAMES = {
+    "abbr", "b", "bdi", "bdo", "big", "blockquote", "br", "caption", "center",
+    "cite", "code", "col", "colgroup", "data", "dd", "del", "dfn", "div", "dl",
+    "dt", "em", "font", "h1", "h2", "h3", "h4", "h5", "h6", "hr", "i", "ins",
+    "kbd", "li", "link", "mark", "meta", "ol", "p", "pre", "q", "rb", "rp",
+    "rt", "ruby", "s", "samp", "small", "span", "strike", "strong", "sub",
+    "sup", "table", "td", "th", "time", "tr", "tt", "u", "ul", "var", "wbr"
+};
+
+constexpr std::array<std::string_view, HTML_ATTR_COUNT - 1> ATTR_NAMES = {
+    "align", "alt", "bgcolor", "border", "cellpadding", "cellspacing", "class", "colspan",
+    "dir", "group", "height", "id", "lang", "name", "rowspan", "scope", "style", "title",
+    "valign", "width"
+};
+
+static_assert(std::is_sorted(TAG_NAMES.begin(), TAG_NAMES.end()));
+static_assert(std::is_sorted(ATTR_NAMES.begin(), ATTR_NAMES.end()));
+
+bool is_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+} // namespace
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+HtmlTagId lookup_html_tag(std::string_view name) noexcept {
+    auto it = std::lower_bound(TAG_NAMES.begin(), TAG_NAMES.end(), name);
+    if (it == TAG_NAMES.end() || *it != name) {
+        return HtmlTagId::Unknown;
+    }
+    return static_cast<HtmlTagId>(it - TAG_NAMES.begin() + 1);
+}
+
+std::string_view html_tag_name(HtmlTagId id) noexcept {
+    auto index = static_cast<size_t>(id);
+    return index == 0 || index > TAG_NAMES.size() ? std::string_view{} : TAG_NAMES[index - 1];
+}
+
+HtmlAttrId lookup_html_attribute(std::string_view name) noexcept {
+    // Attribute names are short; lower-case into a small buffer
+    std::array<char, 16> lower{};
+    if (name.empty() || name.size() > lower.size()) {
+        return HtmlAttrId::Unknown;
+    }
+    for (size_t i = 0; i < name.size(); ++i) {
+        char c = name[i];
+        lower[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    std::string_view key(lower.data(), name.size());
+
+    auto it = std::lower_bound(ATTR_NAMES.begin(), ATTR_NAMES.end(), key);
+    if (it == ATTR_NAMES.end() || *it != key) {
+        return HtmlAttrId::Unknown;
+    }
+    return static_cast<HtmlAttrId>(it - ATTR_NAMES.begin() + 1);
+}
+
+// ============================================================================
+// Attribute splitting
+// ============================================================================
+
+size_t split_html_attributes(std::string_view text, std::vector<HtmlAttribute> &out) {
+    size_t count = 0;
+    size_t i = 0;
+
+    while (i < text.size()) {
+        if (is_space(text[i]) || text[i] == '/') {
+            ++i;
+            continue;
+        }
+
+        size_t name_begin = i;
+        while (i < text.size() && !is_space(text[i]) && text[i] != '=' && text[i] != '/') {
+            ++i;
+        }
+
+        HtmlAttribute attr;
+        attr.name = text.substr(name_begin, i - name_begin);
+
+        while (i < text.size() && is_space(text[i])) {
+            ++i;
+        }
+        if (i < text.size() && text[i] == '=') {
+            ++i;
+            while (i < text.size() && is_space(text[i])) {
+                ++i;
+            }
+            if (i < text.size() && (text[i] == '"' || text[i] == '\'')) {
+                char quote = text[i++];
+                size_t end = text.find(quote, i);
+                if (end == std::string_view::npos) {
+                    end = text.size();
+                }
+                attr.value = text.substr(i, end - i);
+                i = std::min(end + 1, text.size());
+            } else {
+                size_t value_begin = i;
+                while (i < text.size() && !is_space(text[i])) {
+                    ++i;
+                }
+                attr.value = text.substr(value_begin, i - value_begin);
+            }
+        }
+
+        if (attr.name.empty()) {
+            // Stray '=' without a name
+            continue;
+        }
+
+        attr.id = lookup_html_attribute(attr.name);
+        out.push_back(attr);
+        ++count;
+    }
+
+    return count;
+}
+
+} // namespace wikilib::markup
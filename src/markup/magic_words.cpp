@@ -0,0 +1,87 @@
+/**
+ * @file magic_words.cpp
+ * @brief Implementation of behavior switch lookup
+ */
+
+#include "wikilib/markup/magic_words.h"
+#include <array>
+
+namespace wikilib::markup {
+
+namespace {
+
+struct SwitchName {
+    std::string_view name;
+    BehaviorSwitch id;
+};
+
+// Canonical names first, in enum order; aliases after
+constexpr std::array<SwitchName, 21> SWITCH_NAMES = {{
+    {"TOC", BehaviorSwitch::Toc},
+    {"NOTOC", BehaviorSwitch::NoToc},
+    {"FORCETOC", BehaviorSwitch::ForceToc},
+    {"NOEDITSECTION", BehaviorSwitch::NoEditSection},
+    {"NEWSECTIONLINK", BehaviorSwitch::NewSectionLink},
+    {"NONEWSECTIONLINK", BehaviorSwitch::NoNewSectionLink},
+    {"NOGALLERY", BehaviorSwitch::NoGallery},
+    {"HIDDENCAT", BehaviorSwitch::HiddenCat},
+    {"EXPECTUNUSEDCATEGORY", BehaviorSwitch::ExpectUnusedCategory},
+    {"EXPECTUNUSEDTEMPLATE", BehaviorSwitch::ExpectUnusedTemplate},
+    {"NOCONTENTCONVERT", BehaviorSwitch::NoContentConvert},
+    {"NOTITLECONVERT", BehaviorSwitch::NoTitleConvert},
+    {"INDEX", BehaviorSwitch::Index},
+    {"NOINDEX", BehaviorSwitch::NoIndex},
+    {"STATICREDIRECT", BehaviorSwitch::StaticRedirect},
+    {"DISAMBIG", BehaviorSwitch::Disambig},
+    {"NOGLOBAL", BehaviorSwitch::NoGlobal},
+    {"ARCHIVEDTALK", BehaviorSwitch::ArchivedTalk},
+    {"NOTALK", BehaviorSwitch::NoTalk},
+    {"NOCC", BehaviorSwitch::NoContentConvert},
+    {"NOTC", BehaviorSwitch::NoTitleConvert},
+}};
+
+constexpr size_t TABLE_SIZE = 32;
+
+// Collision-free over SWITCH_NAMES (checked below)
+constexpr size_t hash_word(std::string_view w) noexcept {
+    auto at = [w](size_t i) { return static_cast<size_t>(static_cast<unsigned char>(w[i])); };
+    return (w.size() * 24 + at(0) * 26 + at(w.size() / 2) + at(w.size() - 1)) % TABLE_SIZE;
+}
+
+// Slot -> index + 1 into SWITCH_NAMES (0 = empty); 0 if the hash collides
+constexpr std::array<uint8_t, TABLE_SIZE> build_table() {
+    std::array<uint8_t, TABLE_SIZE> table{};
+    for (size_t i = 0; i < SWITCH_NAMES.size(); ++i) {
+        size_t h = hash_word(SWITCH_NAMES[i].name);
+        if (table[h] != 0) {
+            return {};
+        }
+        table[h] = static_cast<uint8_t>(i + 1);
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, TABLE_SIZE> SWITCH_TABLE = build_table();
+
+static_assert(SWITCH_TABLE[hash_word("TOC")] != 0, "behavior switch hash has collisions");
+static_assert(static_cast<size_t>(SWITCH_NAMES[BEHAVIOR_SWITCH_COUNT - 1].id) == BEHAVIOR_SWITCH_COUNT - 1);
+
+} // namespace
+
+std::optional<BehaviorSwitch> lookup_behavior_switch(std::string_view word) noexcept {
+    if (word.empty()) {
+        return std::nullopt;
+    }
+    uint8_t slot = SWITCH_TABLE[hash_word(word)];
+    if (slot == 0 || SWITCH_NAMES[slot - 1].name != word) {
+        return std::nullopt;
+    }
+    return SWITCH_NAMES[slot - 1].id;
+}
+
+std::string_view behavior_switch_name(BehaviorSwitch id) noexcept {
+    auto index = static_cast<size_t>(id);
+    return index < BEHAVIOR_SWITCH_COUNT ? SWITCH_NAMES[index].name : std::string_view{};
+}
+
+} // namespace wikilib::markup
@@ -5,6 +5,7 @@
 
 #include "wikilib/markup/parser.h"
 #include <algorithm>
+#include <initializer_list>
 #include <sstream>
 #include "wikilib/core/types.h"
 #include "wikilib/markup/ast.h"
@@ -24,14 +25,13 @@ ParseResult Parser::parse(std::string_view input) {
 }
 
 ParseResult Parser::parse(std::string_view input, [[maybe_unused]] const PageInfo &page) {
-    tokenizer_ = std::make_unique<Tokenizer>(input, config_.tokenizer);
-    errors_.clear();
-    depth_ = 0;
+    start(input);
 
     auto doc = std::make_unique<DocumentNode>();
 
     // Parse content
     doc->content = parse_content();
+    doc->behavior_switches = switches_;
 
     // Collect categories and check for redirect
     for (const auto &node: doc->content) {
@@ -46,26 +46,44 @@ ParseResult Parser::parse(std::string_view input, [[maybe_unused]] const PageInf
     for (const auto &err: tokenizer_->errors()) {
         errors_.push_back(err);
     }
+    error_counts_.merge(tokenizer_->error_counts());
 
     ParseResult result;
     result.document = std::move(doc);
     result.errors = std::move(errors_);
+    result.error_counts = error_counts_;
 
     return result;
 }
 
-NodeList Parser::parse_inline(std::string_view input) {
-    tokenizer_ = std::make_unique<Tokenizer>(input, config_.tokenizer);
+void Parser::start(std::string_view input) {
+    TokenizerConfig tokenizer_config = config_.tokenizer;
+    tokenizer_config.error_reporting = config_.error_reporting;
+    tokenizer_ = std::make_unique<Tokenizer>(input, tokenizer_config);
+    input_ = input;
     errors_.clear();
+    error_counts_ = {};
     depth_ = 0;
+    switches_.reset();
+    quote_runs_.clear();
+    quote_events_.clear();
+    quote_run_ = 0;
+    quote_consumed_ = 0;
+    quote_line_end_ = 0;
+    reopen_.clear();
+    reopen_line_end_ = 0;
+    next_span_ = 0;
+    frames_.clear();
+}
+
+NodeList Parser::parse_inline(std::string_view input) {
+    start(input);
 
     return parse_inline_content();
 }
 
 std::vector<TemplateParameter> Parser::parse_template_params(std::string_view input) {
-    tokenizer_ = std::make_unique<Tokenizer>(input, config_.tokenizer);
-    errors_.clear();
-    depth_ = 0;
+    start(input);
 
     std::vector<TemplateParameter> params;
 
@@ -131,6 +149,9 @@ NodeList Parser::parse_content() {
         auto node = parse_node();
         if (node) {
             nodes.push_back(std::move(node));
+        } else if (!at_end()) {
+            // End marker without its construct, e.g. a stray "]" or "</span>"
+            nodes.push_back(token_as_text());
         }
     }
 
@@ -149,6 +170,8 @@ NodeList Parser::parse_block_content() {
         auto node = parse_node();
         if (node) {
             nodes.push_back(std::move(node));
+        } else if (!at_end()) {
+            nodes.push_back(token_as_text());
         }
     }
 
@@ -181,13 +204,49 @@ NodeList Parser::parse_inline_content() {
 // ============================================================================
 
 NodePtr Parser::parse_node() {
+    const size_t base = frames_.size();
+    NodePtr node = start_node();
+
+    while (frames_.size() > base) {
+        const size_t top = frames_.size() - 1;
+        Step step = step_frame(frames_[top]);
+        if (step == Step::Pushed) {
+            continue;
+        }
+        if (step == Step::Child) {
+            NodePtr child = start_node();
+            if (frames_.size() == top + 1) {
+                add_child(frames_[top], std::move(child));
+            }
+            continue;
+        }
+
+        NodePtr done = finish_frame(frames_[top]);
+        if (frames_[top].nested) {
+            depth_--;
+        }
+        frames_.pop_back();
+        if (frames_.size() > base) {
+            add_child(frames_.back(), std::move(done));
+        } else {
+            node = std::move(done);
+        }
+    }
+
+    return node;
+}
+
+NodePtr Parser::start_node() {
     if (at_end()) {
         return nullptr;
     }
 
-    DepthGuard guard(*this);
-    if (guard.exceeded()) {
-        add_error("Maximum nesting depth exceeded", ErrorSeverity::Error);
+    if (depth_ >= config_.max_depth) {
+        add_error(ErrorCode::MaxDepthExceeded, ErrorSeverity::Error);
+        return nullptr;
+    }
+
+    if (!reopen_.empty() && (reopen_formatting() || at_end())) {
         return nullptr;
     }
 
@@ -196,8 +255,8 @@ NodePtr Parser::parse_node() {
     switch (tok.type) {
         case TokenType::Text:
         case TokenType::Whitespace: {
-            auto node = std::make_unique<TextNode>(std::string(tok.text));
-            node->location = tok.location;
+            auto node = std::make_unique<TextNode>(std::string(token_text(tok)));
+            node->location = token_location(tok);
             advance();
             return node;
         }
@@ -236,14 +295,14 @@ NodePtr Parser::parse_node() {
                 return parse_list();
             }
             advance();
-            return std::make_unique<TextNode>(std::string(tok.text));
+            return std::make_unique<TextNode>(std::string(token_text(tok)));
 
         case TokenType::TableStart:
             if (config_.parse_tables) {
                 return parse_table();
             }
             advance();
-            return std::make_unique<TextNode>(std::string(tok.text));
+            return std::make_unique<TextNode>(std::string(token_text(tok)));
 
         case TokenType::HtmlTagOpen:
             return parse_html_tag();
@@ -251,47 +310,54 @@ NodePtr Parser::parse_node() {
         case TokenType::HtmlComment: {
             auto node = std::make_unique<CommentNode>();
             // Extract content between <!-- and -->
-            std::string_view content = tok.text;
+            std::string_view content = token_text(tok);
             if (content.size() > 7) { // "<!--" + "-->"
                 content = content.substr(4, content.size() - 7);
             }
             node->content = std::string(content);
-            node->location = tok.location;
+            node->location = token_location(tok);
             advance();
             return node;
         }
 
         case TokenType::NoWiki: {
             auto node = std::make_unique<NoWikiNode>();
-            std::string_view content = tok.text;
+            std::string_view content = token_text(tok);
             // Extract content between <nowiki> and </nowiki>
             if (content.starts_with("<nowiki>") && content.ends_with("</nowiki>")) {
                 content = content.substr(8, content.size() - 17);
             }
             node->content = std::string(content);
-            node->location = tok.location;
+            node->location = token_location(tok);
             advance();
             return node;
         }
 
         case TokenType::HorizontalRule: {
             auto node = std::make_unique<HorizontalRuleNode>();
-            node->location = tok.location;
+            node->location = token_location(tok);
             advance();
             return node;
         }
 
         case TokenType::MagicWord: {
             auto node = std::make_unique<MagicWordNode>();
-            node->word = std::string(tok.text);
-            node->location = tok.location;
+            std::string_view word = token_text(tok);
+            node->word = std::string(word);
+            if (word.size() > 4) {
+                node->behavior = lookup_behavior_switch(word.substr(2, word.size() - 4));
+            }
+            if (node->behavior) {
+                switches_.set(static_cast<size_t>(*node->behavior));
+            }
+            node->location = token_location(tok);
             advance();
             return node;
         }
 
         case TokenType::Redirect: {
             auto node = std::make_unique<RedirectNode>();
-            node->location = tok.location;
+            node->location = token_location(tok);
             advance();
 
             // Skip whitespace
@@ -305,7 +371,7 @@ NodePtr Parser::parse_node() {
                 // Read target until ]] or |
                 std::string target;
                 while (!at_end() && !check(TokenType::LinkClose) && !check(TokenType::LinkSeparator)) {
-                    target += current().text;
+                    target += token_text(current());
                     advance();
                 }
                 node->target = target;
@@ -323,8 +389,8 @@ NodePtr Parser::parse_node() {
             // These are usually consumed by higher-level constructs
             // If we see them here, treat as text
             {
-                auto node = std::make_unique<TextNode>(std::string(tok.text));
-                node->location = tok.location;
+                auto node = std::make_unique<TextNode>(std::string(token_text(tok)));
+                node->location = token_location(tok);
                 advance();
                 return node;
             }
@@ -344,13 +410,13 @@ NodePtr Parser::parse_node() {
                 return nullptr;
             }
             advance();
-            return std::make_unique<TextNode>(std::string(tok.text));
+            return std::make_unique<TextNode>(std::string(token_text(tok)));
 
         default:
             // Unknown token - treat as text
             {
-                auto node = std::make_unique<TextNode>(std::string(tok.text));
-                node->location = tok.location;
+                auto node = std::make_unique<TextNode>(std::string(token_text(tok)));
+                node->location = token_location(tok);
                 advance();
                 return node;
             }
@@ -359,7 +425,7 @@ NodePtr Parser::parse_node() {
 
 NodePtr Parser::parse_paragraph() {
     auto para = std::make_unique<ParagraphNode>();
-    SourcePosition start = current().location.begin;
+    SourcePosition start = token_location(current()).begin;
 
     para->content = parse_inline_content();
 
@@ -374,12 +440,12 @@ NodePtr Parser::parse_heading() {
     auto heading = std::make_unique<HeadingNode>();
     const Token &opening_tok = current();
     int opening_level = opening_tok.level;
-    heading->location.begin = opening_tok.location.begin;
+    heading->location.begin = token_location(opening_tok).begin;
 
     // Headings must start at column 1 (beginning of line)
-    if (opening_tok.location.begin.column != 1) {
+    if (token_location(opening_tok).begin.column != 1) {
         // Not at line start - treat as text
-        auto text = std::make_unique<TextNode>(std::string(opening_tok.text));
+        auto text = std::make_unique<TextNode>(std::string(token_text(opening_tok)));
         advance();
         return text;
     }
@@ -415,7 +481,7 @@ NodePtr Parser::parse_heading() {
             auto title_text = std::make_unique<TextNode>(std::string(title_equals, '='));
             heading->content.push_back(std::move(title_text));
         }
-        heading->location.end = opening_tok.location.end;
+        heading->location.end = token_location(opening_tok).end;
         if (check(TokenType::Newline)) {
             advance();
         }
@@ -436,7 +502,7 @@ NodePtr Parser::parse_heading() {
                     only_whitespace_after = false;
                     break;
                 }
-                for (char c : t.text) {
+                for (char c : token_text(t)) {
                     if (c != ' ' && c != '\t') {
                         only_whitespace_after = false;
                         break;
@@ -457,7 +523,7 @@ NodePtr Parser::parse_heading() {
         auto text = std::make_unique<TextNode>();
         text->text = std::string(opening_level, '=');
         for (const auto& tok : line_tokens) {
-            text->text += std::string(tok.text);
+            text->text += std::string(token_text(tok));
         }
         if (check(TokenType::Newline)) {
             advance();
@@ -470,14 +536,14 @@ NodePtr Parser::parse_heading() {
         const Token& tok = line_tokens[i];
         if (tok.type == TokenType::Heading) {
             // Heading tokens inside become text (e.g., == in title)
-            auto text_node = std::make_unique<TextNode>(std::string(tok.text));
+            auto text_node = std::make_unique<TextNode>(std::string(token_text(tok)));
             heading->content.push_back(std::move(text_node));
         } else if (tok.type == TokenType::Text || tok.type == TokenType::Whitespace) {
-            auto text_node = std::make_unique<TextNode>(std::string(tok.text));
+            auto text_node = std::make_unique<TextNode>(std::string(token_text(tok)));
             heading->content.push_back(std::move(text_node));
         } else {
             // For other token types, just add as text for now
-            auto text_node = std::make_unique<TextNode>(std::string(tok.text));
+            auto text_node = std::make_unique<TextNode>(std::string(token_text(tok)));
             heading->content.push_back(std::move(text_node));
         }
     }
@@ -485,7 +551,7 @@ NodePtr Parser::parse_heading() {
     // Calculate actual level: min of opening and closing
     int actual_level = std::min(opening_level, closing_level);
     heading->level = actual_level;
-    heading->location.end = line_tokens[closing_idx].location.end;
+    heading->location.end = token_location(line_tokens[closing_idx]).end;
 
     // Add excess = signs to content
     if (opening_level > actual_level) {
@@ -528,68 +594,23 @@ NodePtr Parser::parse_list() {
             break;
     }
 
-    list->location.begin = first.location.begin;
-
-    // Parse list items
-    while (!at_end() && (check(TokenType::BulletList) || check(TokenType::NumberedList) ||
-                         check(TokenType::DefinitionTerm) || check(TokenType::DefinitionDesc))) {
-        auto item = parse_list_item();
-        if (item) {
-            list->items.push_back(std::move(item));
-        }
+    list->location.begin = token_location(first).begin;
 
-        // Skip newline between items
-        if (check(TokenType::Newline)) {
-            advance();
-        } else {
-            break;
-        }
-    }
-
-    if (!list->items.empty()) {
-        list->location.end = list->items.back()->location.end;
-    }
-
-    return list;
-}
-
-NodePtr Parser::parse_list_item() {
-    auto item = std::make_unique<ListItemNode>();
-    const Token &tok = current();
-
-    item->depth = tok.level;
-    item->is_definition_term = (tok.type == TokenType::DefinitionTerm);
-    item->location.begin = tok.location.begin;
-
-    advance(); // skip list marker
-
-    // Parse item content until newline
-    while (!at_end() && !check(TokenType::Newline)) {
-        auto node = parse_node();
-        if (node) {
-            item->content.push_back(std::move(node));
-        } else {
-            break;
-        }
-    }
-
-    if (!item->content.empty()) {
-        item->location.end = item->content.back()->location.end;
-    }
-
-    return item;
+    // Items are parsed as ListItem frames
+    push_frame(FrameKind::List, std::move(list));
+    return nullptr;
 }
 
 NodePtr Parser::parse_table() {
     auto table = std::make_unique<TableNode>();
-    table->location.begin = current().location.begin;
+    table->location.begin = token_location(current()).begin;
 
     advance(); // skip {|
 
     // Parse table attributes (rest of first line)
     std::string attrs;
     while (!at_end() && !check(TokenType::Newline)) {
-        attrs += current().text;
+        attrs += token_text(current());
         advance();
     }
     table->attributes = attrs;
@@ -598,141 +619,14 @@ NodePtr Parser::parse_table() {
         advance();
     }
 
-    // Parse table content
-    while (!at_end() && !check(TokenType::TableEnd)) {
-        if (check(TokenType::TableCaption)) {
-            advance(); // skip |+
-            std::string caption;
-            while (!at_end() && !check(TokenType::Newline)) {
-                caption += current().text;
-                advance();
-            }
-            table->caption = caption;
-            if (check(TokenType::Newline)) {
-                advance();
-            }
-        } else if (check(TokenType::TableRowStart)) {
-            auto row = parse_table_row();
-            if (row) {
-                table->rows.push_back(std::move(row));
-            }
-        } else if (check(TokenType::TableHeaderCell) || check(TokenType::TableDataCell)) {
-            // Implicit first row
-            auto row = std::make_unique<TableRowNode>();
-            row->location.begin = current().location.begin;
-
-            while (!at_end() && !check(TokenType::TableEnd) && !check(TokenType::TableRowStart)) {
-                auto cell = parse_table_cell();
-                if (cell) {
-                    row->cells.push_back(std::move(cell));
-                }
-                if (check(TokenType::Newline)) {
-                    advance();
-                }
-            }
-
-            if (!row->cells.empty()) {
-                row->location.end = row->cells.back()->location.end;
-                table->rows.push_back(std::move(row));
-            }
-        } else {
-            advance(); // skip unknown tokens in table
-        }
-    }
-
-    if (check(TokenType::TableEnd)) {
-        table->location.end = current().location.end;
-        advance();
-    }
-
-    return table;
-}
-
-NodePtr Parser::parse_table_row() {
-    auto row = std::make_unique<TableRowNode>();
-    row->location.begin = current().location.begin;
-
-    advance(); // skip |-
-
-    // Parse row attributes
-    std::string attrs;
-    while (!at_end() && !check(TokenType::Newline)) {
-        attrs += current().text;
-        advance();
-    }
-    row->attributes = attrs;
-
-    if (check(TokenType::Newline)) {
-        advance();
-    }
-
-    // Parse cells until next row or table end
-    while (!at_end() && !check(TokenType::TableEnd) && !check(TokenType::TableRowStart)) {
-        if (check(TokenType::TableHeaderCell) || check(TokenType::TableDataCell)) {
-            auto cell = parse_table_cell();
-            if (cell) {
-                row->cells.push_back(std::move(cell));
-            }
-        } else if (check(TokenType::Newline)) {
-            advance();
-        } else {
-            break;
-        }
-    }
-
-    if (!row->cells.empty()) {
-        row->location.end = row->cells.back()->location.end;
-    }
-
-    return row;
-}
-
-NodePtr Parser::parse_table_cell() {
-    auto cell = std::make_unique<TableCellNode>();
-    cell->location.begin = current().location.begin;
-    cell->is_header = check(TokenType::TableHeaderCell);
-
-    advance(); // skip | or !
-
-    // Check for cell attributes (text | more text)
-    // First, check if there's a | before newline
-    NodeList content;
-    bool found_separator = false;
-
-    while (!at_end() && !check(TokenType::Newline) && !check(TokenType::TableHeaderCell) &&
-           !check(TokenType::TableDataCell) && !check(TokenType::TableRowStart) && !check(TokenType::TableEnd)) {
-        if (check(TokenType::Pipe) && !found_separator) {
-            found_separator = true;
-            // Everything before was attributes
-            std::string attrs;
-            for (const auto &node: content) {
-                attrs += node->to_plain_text();
-            }
-            cell->attributes = attrs;
-            content.clear();
-            advance();
-        } else {
-            auto node = parse_node();
-            if (node) {
-                content.push_back(std::move(node));
-            } else {
-                break;
-            }
-        }
-    }
-
-    cell->content = std::move(content);
-
-    if (!cell->content.empty()) {
-        cell->location.end = cell->content.back()->location.end;
-    }
-
-    return cell;
+    // Rows and cells are parsed as frames
+    push_frame(FrameKind::Table, std::move(table));
+    return nullptr;
 }
 
 NodePtr Parser::parse_template() {
     auto tmpl = std::make_unique<TemplateNode>();
-    tmpl->location.begin = current().location.begin;
+    tmpl->location.begin = token_location(current()).begin;
     tmpl->is_parser_function = check(TokenType::ParserFunction);
 
     advance(); // skip {{ or {{#
@@ -745,7 +639,7 @@ NodePtr Parser::parse_template() {
     // Parse template name until | or }}
     std::string name;
     while (!at_end() && !check(TokenType::Pipe) && !check(TokenType::TemplateClose)) {
-        name += current().text;
+        name += token_text(current());
         advance();
     }
 
@@ -758,74 +652,27 @@ NodePtr Parser::parse_template() {
         tmpl->name = name;
     }
 
-    // Parse parameters
-    if (check(TokenType::Pipe)) {
+    // Parameters are parsed by step_template()
+    bool has_params = check(TokenType::Pipe);
+    if (has_params) {
         advance(); // skip first |
-
-        while (!at_end() && !check(TokenType::TemplateClose)) {
-            TemplateParameter param;
-            NodeList value_nodes;
-            std::string potential_name;
-            bool found_equals = false;
-
-            while (!at_end() && !check(TokenType::Pipe) && !check(TokenType::TemplateClose)) {
-                if (check(TokenType::Equals) && !found_equals) {
-                    found_equals = true;
-                    // Everything before is the name
-                    for (const auto &node: value_nodes) {
-                        potential_name += node->to_plain_text();
-                    }
-                    // Trim
-                    size_t s = potential_name.find_first_not_of(" \t\n");
-                    size_t e = potential_name.find_last_not_of(" \t\n");
-                    if (s != std::string::npos && e != std::string::npos) {
-                        param.name = potential_name.substr(s, e - s + 1);
-                    } else {
-                        param.name = potential_name;
-                    }
-                    value_nodes.clear();
-                    advance(); // skip =
-                } else {
-                    auto node = parse_node();
-                    if (node) {
-                        value_nodes.push_back(std::move(node));
-                    } else {
-                        // Handle nested templates/links that return nullptr at their close
-                        if (check(TokenType::TemplateClose) || check(TokenType::Pipe)) {
-                            break;
-                        }
-                        advance();
-                    }
-                }
-            }
-
-            param.value = std::move(value_nodes);
-            tmpl->parameters.push_back(std::move(param));
-
-            if (check(TokenType::Pipe)) {
-                advance();
-            }
-        }
-    }
-
-    if (check(TokenType::TemplateClose)) {
-        tmpl->location.end = current().location.end;
-        advance();
     }
 
-    return tmpl;
+    push_frame(FrameKind::Template, std::move(tmpl));
+    frames_.back().open = has_params;
+    return nullptr;
 }
 
 NodePtr Parser::parse_parameter() {
     auto param = std::make_unique<ParameterNode>();
-    param->location.begin = current().location.begin;
+    param->location.begin = token_location(current()).begin;
 
     advance(); // skip {{{
 
     // Parse parameter name until | or }}}
     std::string name;
     while (!at_end() && !check(TokenType::Pipe) && !check(TokenType::ParameterClose)) {
-        name += current().text;
+        name += token_text(current());
         advance();
     }
 
@@ -838,47 +685,34 @@ NodePtr Parser::parse_parameter() {
         param->name = name;
     }
 
-    // Parse default value if present
-    if (check(TokenType::Pipe)) {
+    // Default value if present
+    bool has_default = check(TokenType::Pipe);
+    if (has_default) {
         advance(); // skip |
-
-        while (!at_end() && !check(TokenType::ParameterClose)) {
-            auto node = parse_node();
-            if (node) {
-                param->default_value.push_back(std::move(node));
-            } else {
-                if (check(TokenType::ParameterClose)) {
-                    break;
-                }
-                advance();
-            }
-        }
     }
 
-    if (check(TokenType::ParameterClose)) {
-        param->location.end = current().location.end;
-        advance();
-    }
-
-    return param;
+    push_frame(FrameKind::Parameter, std::move(param));
+    frames_.back().open = has_default;
+    return nullptr;
 }
 
 NodePtr Parser::parse_link() {
     bool is_category = check(TokenType::Category);
-    SourcePosition start = current().location.begin;
+    SourcePosition start = token_location(current()).begin;
 
     advance(); // skip [[
 
     // Parse target until | or ]]
     std::string target;
     while (!at_end() && !check(TokenType::LinkSeparator) && !check(TokenType::LinkClose)) {
-        target += current().text;
+        target += token_text(current());
         advance();
     }
 
     // Handle category
-    if (is_category || target.starts_with("Category:") || target.starts_with("category:") ||
-        target.starts_with("Kategoria:") || target.starts_with("kategoria:")) {
+    const NamespaceResolver &namespaces =
+            config_.tokenizer.namespaces ? *config_.tokenizer.namespaces : NamespaceResolver::builtin();
+    if (is_category || namespaces.namespace_of(target) == NS_CATEGORY) {
         auto cat = std::make_unique<CategoryNode>();
         cat->location.begin = start;
 
@@ -895,14 +729,14 @@ NodePtr Parser::parse_link() {
             advance();
             std::string sort_key;
             while (!at_end() && !check(TokenType::LinkClose)) {
-                sort_key += current().text;
+                sort_key += token_text(current());
                 advance();
             }
             cat->sort_key = sort_key;
         }
 
         if (check(TokenType::LinkClose)) {
-            cat->location.end = current().location.end;
+            cat->location.end = token_location(current()).end;
             advance();
         }
 
@@ -922,34 +756,20 @@ NodePtr Parser::parse_link() {
 
     link->target = target;
 
-    // Parse display text if present
-    if (check(TokenType::LinkSeparator)) {
+    // Display text if present
+    bool has_text = check(TokenType::LinkSeparator);
+    if (has_text) {
         advance(); // skip |
-
-        while (!at_end() && !check(TokenType::LinkClose)) {
-            auto node = parse_node();
-            if (node) {
-                link->display_content.push_back(std::move(node));
-            } else {
-                if (check(TokenType::LinkClose)) {
-                    break;
-                }
-                advance();
-            }
-        }
     }
 
-    if (check(TokenType::LinkClose)) {
-        link->location.end = current().location.end;
-        advance();
-    }
-
-    return link;
+    push_frame(FrameKind::Link, std::move(link));
+    frames_.back().open = has_text;
+    return nullptr;
 }
 
 NodePtr Parser::parse_external_link() {
     auto link = std::make_unique<ExternalLinkNode>();
-    link->location.begin = current().location.begin;
+    link->location.begin = token_location(current()).begin;
     link->bracketed = true;
 
     advance(); // skip [
@@ -957,7 +777,7 @@ NodePtr Parser::parse_external_link() {
     // Parse URL (until space or ])
     std::string url;
     while (!at_end() && !check(TokenType::Whitespace) && !check(TokenType::ExternalLinkClose)) {
-        url += current().text;
+        url += token_text(current());
         advance();
     }
     link->url = url;
@@ -967,103 +787,797 @@ NodePtr Parser::parse_external_link() {
         advance();
     }
 
-    // Parse display text
-    while (!at_end() && !check(TokenType::ExternalLinkClose)) {
-        auto node = parse_node();
-        if (node) {
-            link->display_content.push_back(std::move(node));
-        } else {
-            break;
+    // Display text follows as children
+    push_frame(FrameKind::ExternalLink, std::move(link));
+    return nullptr;
+}
+
+NodePtr Parser::parse_formatting() {
+    auto event = peek_quote_event();
+
+    // A close inside a link, template or tag ends a span opened outside
+    // it; that span's node ends together with the construct
+    while (event && *event >= QuoteEvent::CloseBold) {
+        for (size_t i = frames_.size(); i-- > 0;) {
+            Frame &frame = frames_[i];
+            if (frame.kind == FrameKind::Formatting && !frame.closed && frame.close == *event) {
+                frame.closed = true;
+                frame.stop = true;
+                break;
+            }
+        }
+        size_t offset = current().offset;
+        consume_quote_event();
+        if (current().offset != offset) {
+            return start_node(); // Nothing opens here
         }
+        event = peek_quote_event();
     }
 
-    if (check(TokenType::ExternalLinkClose)) {
-        link->location.end = current().location.end;
-        advance();
+    const Token &tok = current();
+    if (!event || *event == QuoteEvent::Apostrophe) {
+        auto text = std::make_unique<TextNode>(event ? std::string("'") : std::string(token_text(tok)));
+        text->location = token_location(tok);
+        if (event) {
+            consume_quote_event();
+        } else {
+            advance();
+        }
+        return text;
     }
 
-    return link;
+    QuoteEvent close = *event == QuoteEvent::OpenBold     ? QuoteEvent::CloseBold
+                       : *event == QuoteEvent::OpenItalic ? QuoteEvent::CloseItalic
+                                                          : QuoteEvent::CloseBoldItalic;
+    push_formatting(close);
+    consume_quote_event(); // skip opening '''
+    return nullptr;
 }
 
-NodePtr Parser::parse_formatting() {
+void Parser::push_formatting(QuoteEvent close) {
     auto fmt = std::make_unique<FormattingNode>();
-    const Token &tok = current();
-
-    fmt->location.begin = tok.location.begin;
-
-    switch (tok.type) {
-        case TokenType::Bold:
+    fmt->location.begin = token_location(current()).begin;
+    switch (close) {
+        case QuoteEvent::CloseBold:
             fmt->style = FormattingNode::Style::Bold;
             break;
-        case TokenType::Italic:
+        case QuoteEvent::CloseItalic:
             fmt->style = FormattingNode::Style::Italic;
             break;
-        case TokenType::BoldItalic:
-            fmt->style = FormattingNode::Style::BoldItalic;
-            break;
         default:
+            fmt->style = FormattingNode::Style::BoldItalic;
             break;
     }
 
-    advance(); // skip opening '''
+    push_frame(FrameKind::Formatting, std::move(fmt));
+    frames_.back().close = close;
+    frames_.back().span = next_span_++;
+    frames_.back().line_end = quote_line_end_;
+}
 
-    // Parse content until matching closing marker or newline
-    while (!at_end() && !check(TokenType::Newline)) {
-        // Check for closing marker
-        if ((fmt->style == FormattingNode::Style::Bold && check(TokenType::Bold)) ||
-            (fmt->style == FormattingNode::Style::Italic && check(TokenType::Italic)) ||
-            (fmt->style == FormattingNode::Style::BoldItalic && check(TokenType::BoldItalic))) {
-            fmt->location.end = current().location.end;
-            advance();
+bool Parser::reopen_formatting() {
+    while (!reopen_.empty()) {
+        if (at_end() || current().offset >= reopen_line_end_) {
+            reopen_.clear();
+            return false;
+        }
+
+        // Not before an end marker: the construct it ends is still open
+        switch (current().type) {
+            case TokenType::LinkClose:
+            case TokenType::TemplateClose:
+            case TokenType::ParameterClose:
+            case TokenType::ExternalLinkClose:
+            case TokenType::HtmlTagClose:
+                return false;
+            case TokenType::TableEnd:
+            case TokenType::TableRowStart:
+                if (config_.parse_tables) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+
+        // A close right after the construct ends the span without a node
+        auto event = current().is_formatting() ? peek_quote_event() : std::nullopt;
+        if (event && *event == reopen_.back().close) {
+            reopen_.pop_back();
+            consume_quote_event();
+            continue;
+        }
+
+        for (const auto &span: reopen_) {
+            push_formatting(span.close);
+        }
+        reopen_.clear();
+        return true;
+    }
+    return false;
+}
+
+void Parser::resolve_quotes() {
+    quote_runs_.clear();
+    quote_events_.clear();
+    quote_run_ = 0;
+    quote_consumed_ = 0;
+
+    // Collect apostrophe runs up to the end of the line
+    for (size_t n = 0;; ++n) {
+        const Token &tok = tokenizer_->peek(n);
+        if (tok.type == TokenType::Newline || tok.type == TokenType::EndOfInput) {
+            quote_line_end_ = tok.offset;
             break;
         }
+        if (tok.is_formatting()) {
+            QuoteRun run;
+            run.offset = tok.offset;
+            run.length = static_cast<uint8_t>(tok.length);
+            quote_runs_.push_back(run);
+        }
+    }
 
-        auto node = parse_node();
-        if (node) {
-            fmt->content.push_back(std::move(node));
+    // With an odd number of both bold and italic runs, one bold run is read
+    // as an apostrophe plus italic: preferably one after a single-letter
+    // word, else one after a longer word, else one after a space
+    size_t italics = 0;
+    size_t bolds = 0;
+    for (const auto &run: quote_runs_) {
+        italics += run.length != 3;
+        bolds += run.length != 2;
+    }
+    if (italics % 2 == 1 && bolds % 2 == 1) {
+        size_t line_begin = 0;
+        if (quote_runs_.front().offset > 0) {
+            size_t newline = input_.rfind('\n', quote_runs_.front().offset - 1);
+            line_begin = newline == std::string_view::npos ? 0 : newline + 1;
+        }
+
+        constexpr size_t none = std::string_view::npos;
+        size_t single_letter = none;
+        size_t multi_letter = none;
+        size_t space = none;
+        for (size_t i = 0; i < quote_runs_.size(); ++i) {
+            if (quote_runs_[i].length != 3) {
+                continue;
+            }
+            size_t begin = i == 0 ? line_begin : quote_runs_[i - 1].offset + quote_runs_[i - 1].length;
+            size_t pos = quote_runs_[i].offset;
+            char x1 = pos > begin ? input_[pos - 1] : '\0';
+            char x2 = pos > begin + 1 ? input_[pos - 2] : '\0';
+            if (x1 == ' ') {
+                if (space == none) {
+                    space = i;
+                }
+            } else if (x2 == ' ') {
+                single_letter = i;
+                break;
+            } else if (multi_letter == none) {
+                multi_letter = i;
+            }
+        }
+
+        size_t demote = single_letter != none ? single_letter : multi_letter != none ? multi_letter : space;
+        if (demote != none) {
+            quote_runs_[demote].length = 2;
+            quote_runs_[demote].demoted = true;
+        }
+    }
+
+    // Run the bold/italic state machine; BoldItalic has bold outside
+    // italic, ItalicBold the reverse, Both is a single ''''' node
+    enum class State { None, Italic, Bold, BoldItalic, ItalicBold, Both };
+    State state = State::None;
+    auto emit = [this](std::initializer_list<QuoteEvent> events) {
+        quote_events_.insert(quote_events_.end(), events);
+    };
+
+    for (size_t i = 0; i < quote_runs_.size(); ++i) {
+        QuoteRun &run = quote_runs_[i];
+        run.first_event = static_cast<uint32_t>(quote_events_.size());
+        if (run.demoted) {
+            emit({QuoteEvent::Apostrophe});
+        }
+
+        if (run.length == 2) {
+            switch (state) {
+                case State::Italic:
+                    emit({QuoteEvent::CloseItalic});
+                    state = State::None;
+                    break;
+                case State::BoldItalic:
+                    emit({QuoteEvent::CloseItalic});
+                    state = State::Bold;
+                    break;
+                case State::ItalicBold:
+                    emit({QuoteEvent::CloseBold, QuoteEvent::CloseItalic, QuoteEvent::OpenBold});
+                    state = State::Bold;
+                    break;
+                default:
+                    emit({QuoteEvent::OpenItalic});
+                    state = state == State::Bold ? State::BoldItalic : State::Italic;
+                    break;
+            }
+        } else if (run.length == 3) {
+            switch (state) {
+                case State::Bold:
+                    emit({QuoteEvent::CloseBold});
+                    state = State::None;
+                    break;
+                case State::BoldItalic:
+                    emit({QuoteEvent::CloseItalic, QuoteEvent::CloseBold, QuoteEvent::OpenItalic});
+                    state = State::Italic;
+                    break;
+                case State::ItalicBold:
+                    emit({QuoteEvent::CloseBold});
+                    state = State::Italic;
+                    break;
+                default:
+                    emit({QuoteEvent::OpenBold});
+                    state = state == State::Italic ? State::ItalicBold : State::Bold;
+                    break;
+            }
         } else {
-            break;
+            switch (state) {
+                case State::Bold:
+                    emit({QuoteEvent::CloseBold, QuoteEvent::OpenItalic});
+                    state = State::Italic;
+                    break;
+                case State::Italic:
+                    emit({QuoteEvent::CloseItalic, QuoteEvent::OpenBold});
+                    state = State::Bold;
+                    break;
+                case State::BoldItalic:
+                    emit({QuoteEvent::CloseItalic, QuoteEvent::CloseBold});
+                    state = State::None;
+                    break;
+                case State::ItalicBold:
+                    emit({QuoteEvent::CloseBold, QuoteEvent::CloseItalic});
+                    state = State::None;
+                    break;
+                case State::Both:
+                    emit({QuoteEvent::CloseBoldItalic});
+                    state = State::None;
+                    break;
+                case State::None: {
+                    // Nesting order is decided by the run that follows
+                    uint8_t next = i + 1 < quote_runs_.size() ? quote_runs_[i + 1].length : 0;
+                    if (next == 2) {
+                        emit({QuoteEvent::OpenBold, QuoteEvent::OpenItalic});
+                        state = State::BoldItalic;
+                    } else if (next == 3) {
+                        emit({QuoteEvent::OpenItalic, QuoteEvent::OpenBold});
+                        state = State::ItalicBold;
+                    } else {
+                        emit({QuoteEvent::OpenBoldItalic});
+                        state = State::Both;
+                    }
+                    break;
+                }
+            }
         }
+
+        run.event_count = static_cast<uint8_t>(quote_events_.size() - run.first_event);
+    }
+}
+
+std::optional<Parser::QuoteEvent> Parser::peek_quote_event() {
+    size_t offset = current().offset;
+    if (quote_runs_.empty() || offset >= quote_line_end_) {
+        resolve_quotes();
     }
 
-    return fmt;
+    // Runs consumed by other constructs are skipped
+    while (quote_run_ < quote_runs_.size() && quote_runs_[quote_run_].offset < offset) {
+        quote_run_++;
+        quote_consumed_ = 0;
+    }
+    if (quote_run_ == quote_runs_.size() || quote_runs_[quote_run_].offset != offset) {
+        return std::nullopt;
+    }
+
+    const QuoteRun &run = quote_runs_[quote_run_];
+    if (quote_consumed_ >= run.event_count) {
+        return std::nullopt;
+    }
+    return quote_events_[run.first_event + quote_consumed_];
+}
+
+void Parser::consume_quote_event() {
+    if (++quote_consumed_ >= quote_runs_[quote_run_].event_count) {
+        quote_run_++;
+        quote_consumed_ = 0;
+        advance();
+    }
 }
 
 NodePtr Parser::parse_html_tag() {
     auto tag = std::make_unique<HtmlTagNode>();
     const Token &tok = current();
 
-    tag->location.begin = tok.location.begin;
-    tag->tag_name = std::string(tok.tag_name);
-    tag->self_closing = tok.self_closing;
+    tag->location.begin = token_location(tok).begin;
+    tag->tag_name = std::string(tokenizer_->tag_name(tok));
+    tag->tag_id = tok.tag_id;
+    tag->self_closing = tok.self_closing();
+    for (const auto &attr: tokenizer_->attributes(tok)) {
+        tag->add_attribute(std::string(attr.name), std::string(attr.value));
+    }
 
     advance(); // skip opening tag
 
-    if (!tag->self_closing) {
-        // Parse content until closing tag
-        while (!at_end() && !check(TokenType::HtmlTagClose)) {
-            auto node = parse_node();
-            if (node) {
-                tag->content.push_back(std::move(node));
+    if (tag->self_closing) {
+        return tag;
+    }
+
+    // Content up to the closing tag follows as children
+    push_frame(FrameKind::HtmlTag, std::move(tag));
+    return nullptr;
+}
+
+// ============================================================================
+// Frame engine
+// ============================================================================
+
+void Parser::push_frame(FrameKind kind, NodePtr node) {
+    Frame frame;
+    frame.kind = kind;
+    frame.node = std::move(node);
+    frame.nested = kind != FrameKind::ListItem && kind != FrameKind::TableRow && kind != FrameKind::ImplicitRow &&
+                   kind != FrameKind::TableCell;
+    if (frame.nested) {
+        depth_++;
+    }
+    frames_.push_back(std::move(frame));
+}
+
+Parser::Step Parser::step_frame(Frame &frame) {
+    switch (frame.kind) {
+        case FrameKind::Formatting:
+            // Content runs until the matching close; the end of the line
+            // closes whatever is still open
+            if (frame.stop || at_end() || check(TokenType::Newline) ||
+                current().offset >= frame.line_end) {
+                return Step::Done;
+            }
+            if (current().is_formatting()) {
+                // Closes of cut-off spans are left to start_node()
+                auto next = peek_quote_event();
+                if (next && *next >= QuoteEvent::CloseBold &&
+                    (reopen_.empty() || *next != reopen_.back().close)) {
+                    if (*next == frame.close) {
+                        frame.node->location.end = token_location(current()).end;
+                        frame.closed = true;
+                        consume_quote_event();
+                    }
+                    return Step::Done;
+                }
+            }
+            return Step::Child;
+
+        case FrameKind::List:
+            if (frame.stop || at_end() ||
+                !(check(TokenType::BulletList) || check(TokenType::NumberedList) ||
+                  check(TokenType::DefinitionTerm) || check(TokenType::DefinitionDesc))) {
+                return Step::Done;
             } else {
-                break;
+                auto item = std::make_unique<ListItemNode>();
+                const Token &tok = current();
+                item->depth = tok.level;
+                item->is_definition_term = (tok.type == TokenType::DefinitionTerm);
+                item->location.begin = token_location(tok).begin;
+
+                advance(); // skip list marker
+                push_frame(FrameKind::ListItem, std::move(item));
+                return Step::Pushed;
             }
+
+        case FrameKind::ListItem:
+            // Item content runs until newline
+            if (frame.stop || at_end() || check(TokenType::Newline)) {
+                return Step::Done;
+            }
+            return Step::Child;
+
+        case FrameKind::Table:
+            return step_table(frame);
+
+        case FrameKind::TableRow:
+            return step_table_row();
+
+        case FrameKind::ImplicitRow:
+            if (at_end() || check(TokenType::TableEnd) || check(TokenType::TableRowStart)) {
+                return Step::Done;
+            } else {
+                auto cell = std::make_unique<TableCellNode>();
+                cell->location.begin = token_location(current()).begin;
+                cell->is_header = check(TokenType::TableHeaderCell);
+
+                advance(); // skip | or !
+                push_frame(FrameKind::TableCell, std::move(cell));
+                return Step::Pushed;
+            }
+
+        case FrameKind::TableCell:
+            return step_table_cell(frame);
+
+        case FrameKind::Template:
+            return step_template(frame);
+
+        case FrameKind::Parameter:
+            if (!frame.open || at_end() || check(TokenType::ParameterClose)) {
+                return Step::Done;
+            }
+            return Step::Child;
+
+        case FrameKind::Link:
+            if (!frame.open || at_end() || check(TokenType::LinkClose)) {
+                return Step::Done;
+            }
+            return Step::Child;
+
+        case FrameKind::ExternalLink:
+            if (frame.stop || at_end() || check(TokenType::ExternalLinkClose)) {
+                return Step::Done;
+            }
+            return Step::Child;
+
+        case FrameKind::HtmlTag:
+            if (frame.stop || at_end() || check(TokenType::HtmlTagClose)) {
+                return Step::Done;
+            }
+            return Step::Child;
+    }
+    return Step::Done;
+}
+
+Parser::Step Parser::step_table(Frame &frame) {
+    auto *table = static_cast<TableNode *>(frame.node.get());
+
+    while (!at_end() && !check(TokenType::TableEnd)) {
+        if (check(TokenType::TableCaption)) {
+            advance(); // skip |+
+            std::string caption;
+            while (!at_end() && !check(TokenType::Newline)) {
+                caption += token_text(current());
+                advance();
+            }
+            table->caption = caption;
+            if (check(TokenType::Newline)) {
+                advance();
+            }
+        } else if (check(TokenType::TableRowStart)) {
+            auto row = std::make_unique<TableRowNode>();
+            row->location.begin = token_location(current()).begin;
+
+            advance(); // skip |-
+
+            // Parse row attributes
+            std::string attrs;
+            while (!at_end() && !check(TokenType::Newline)) {
+                attrs += token_text(current());
+                advance();
+            }
+            row->attributes = attrs;
+
+            if (check(TokenType::Newline)) {
+                advance();
+            }
+
+            push_frame(FrameKind::TableRow, std::move(row));
+            return Step::Pushed;
+        } else if (check(TokenType::TableHeaderCell) || check(TokenType::TableDataCell)) {
+            // Implicit first row
+            auto row = std::make_unique<TableRowNode>();
+            row->location.begin = token_location(current()).begin;
+            push_frame(FrameKind::ImplicitRow, std::move(row));
+            return Step::Pushed;
+        } else {
+            advance(); // skip unknown tokens in table
         }
+    }
 
-        // Check if closing tag matches
-        if (check(TokenType::HtmlTagClose)) {
-            tag->location.end = current().location.end;
-            advance();
+    return Step::Done;
+}
+
+Parser::Step Parser::step_table_row() {
+    // Cells until next row or table end
+    while (!at_end() && !check(TokenType::TableEnd) && !check(TokenType::TableRowStart)) {
+        if (check(TokenType::TableHeaderCell) || check(TokenType::TableDataCell)) {
+            auto cell = std::make_unique<TableCellNode>();
+            cell->location.begin = token_location(current()).begin;
+            cell->is_header = check(TokenType::TableHeaderCell);
+
+            advance(); // skip | or !
+            push_frame(FrameKind::TableCell, std::move(cell));
+            return Step::Pushed;
         }
+        if (!check(TokenType::Newline)) {
+            break;
+        }
+        advance();
+    }
+
+    return Step::Done;
+}
+
+Parser::Step Parser::step_table_cell(Frame &frame) {
+    auto *cell = static_cast<TableCellNode *>(frame.node.get());
+
+    if (frame.stop || at_end() || check(TokenType::Newline) || check(TokenType::TableHeaderCell) ||
+        check(TokenType::TableDataCell) || check(TokenType::TableRowStart) || check(TokenType::TableEnd)) {
+        return Step::Done;
     }
 
-    return tag;
+    // Cell attributes (text | more text): everything before the first | was attributes
+    if (check(TokenType::Pipe) && !frame.split) {
+        frame.split = true;
+        std::string attrs;
+        for (const auto &node: cell->content) {
+            attrs += node->to_plain_text();
+        }
+        cell->attributes = attrs;
+        cell->content.clear();
+        advance();
+        return step_table_cell(frame);
+    }
+
+    return Step::Child;
+}
+
+Parser::Step Parser::step_template(Frame &frame) {
+    auto *tmpl = static_cast<TemplateNode *>(frame.node.get());
+
+    if (!frame.open) {
+        return Step::Done;
+    }
+
+    while (true) {
+        if (!frame.in_param) {
+            if (at_end() || check(TokenType::TemplateClose)) {
+                return Step::Done;
+            }
+            frame.in_param = true;
+            frame.split = false;
+            frame.param = TemplateParameter{};
+        }
+
+        if (at_end() || check(TokenType::Pipe) || check(TokenType::TemplateClose)) {
+            tmpl->parameters.push_back(std::move(frame.param));
+            frame.in_param = false;
+            if (check(TokenType::Pipe)) {
+                advance();
+            }
+            continue;
+        }
+
+        if (check(TokenType::Equals) && !frame.split) {
+            frame.split = true;
+            // Everything before is the name
+            std::string potential_name;
+            for (const auto &node: frame.param.value) {
+                potential_name += node->to_plain_text();
+            }
+            // Trim
+            size_t s = potential_name.find_first_not_of(" \t\n");
+            size_t e = potential_name.find_last_not_of(" \t\n");
+            if (s != std::string::npos && e != std::string::npos) {
+                frame.param.name = potential_name.substr(s, e - s + 1);
+            } else {
+                frame.param.name = potential_name;
+            }
+            frame.param.value.clear();
+            advance(); // skip =
+            continue;
+        }
+
+        return Step::Child;
+    }
+}
+
+void Parser::add_child(Frame &frame, NodePtr child) {
+    NodeList *content = nullptr;
+    switch (frame.kind) {
+        case FrameKind::Formatting:
+            content = &static_cast<FormattingNode *>(frame.node.get())->content;
+            break;
+
+        case FrameKind::List:
+            if (child) {
+                static_cast<ListNode *>(frame.node.get())->items.push_back(std::move(child));
+            }
+            // Skip newline between items
+            if (check(TokenType::Newline)) {
+                advance();
+            } else {
+                frame.stop = true;
+            }
+            return;
+
+        case FrameKind::ListItem:
+            content = &static_cast<ListItemNode *>(frame.node.get())->content;
+            break;
+
+        case FrameKind::Table:
+            if (child) {
+                static_cast<TableNode *>(frame.node.get())->rows.push_back(std::move(child));
+            }
+            return;
+
+        case FrameKind::TableRow:
+        case FrameKind::ImplicitRow:
+            if (child) {
+                static_cast<TableRowNode *>(frame.node.get())->cells.push_back(std::move(child));
+            }
+            if (frame.kind == FrameKind::ImplicitRow && check(TokenType::Newline)) {
+                advance();
+            }
+            return;
+
+        case FrameKind::TableCell:
+            content = &static_cast<TableCellNode *>(frame.node.get())->content;
+            break;
+
+        case FrameKind::ExternalLink:
+            content = &static_cast<ExternalLinkNode *>(frame.node.get())->display_content;
+            break;
+
+        case FrameKind::HtmlTag:
+            content = &static_cast<HtmlTagNode *>(frame.node.get())->content;
+            break;
+
+        // Children of these skip stray end markers instead of stopping
+        case FrameKind::Template:
+            if (child) {
+                frame.param.value.push_back(std::move(child));
+            } else if (!check(TokenType::TemplateClose) && !check(TokenType::Pipe)) {
+                advance();
+            }
+            return;
+
+        case FrameKind::Parameter:
+            if (child) {
+                static_cast<ParameterNode *>(frame.node.get())->default_value.push_back(std::move(child));
+            } else if (!check(TokenType::ParameterClose)) {
+                advance();
+            }
+            return;
+
+        case FrameKind::Link:
+            if (child) {
+                static_cast<LinkNode *>(frame.node.get())->display_content.push_back(std::move(child));
+            } else if (!check(TokenType::LinkClose)) {
+                advance();
+            }
+            return;
+    }
+
+    if (child) {
+        content->push_back(std::move(child));
+    } else {
+        frame.stop = true;
+    }
+}
+
+NodePtr Parser::finish_frame(Frame &frame) {
+    Node &node = *frame.node;
+
+    switch (frame.kind) {
+        case FrameKind::Formatting:
+            // Ended by an enclosing construct before its close: the span
+            // goes on after that construct
+            if (!frame.closed && !at_end() && !check(TokenType::Newline) && current().offset < frame.line_end) {
+                auto pos = std::upper_bound(reopen_.begin(), reopen_.end(), frame.span,
+                                            [](uint32_t span, const ReopenSpan &other) {
+                                                return span < other.span;
+                                            });
+                reopen_.insert(pos, ReopenSpan{frame.close, frame.span});
+                reopen_line_end_ = frame.line_end;
+            }
+            break;
+
+        case FrameKind::List: {
+            auto &list = static_cast<ListNode &>(node);
+            if (!list.items.empty()) {
+                list.location.end = list.items.back()->location.end;
+            }
+            break;
+        }
+
+        case FrameKind::ListItem: {
+            auto &item = static_cast<ListItemNode &>(node);
+            if (!item.content.empty()) {
+                item.location.end = item.content.back()->location.end;
+            }
+            break;
+        }
+
+        case FrameKind::Table:
+            if (check(TokenType::TableEnd)) {
+                node.location.end = token_location(current()).end;
+                advance();
+            }
+            break;
+
+        case FrameKind::TableRow:
+        case FrameKind::ImplicitRow: {
+            auto &row = static_cast<TableRowNode &>(node);
+            if (!row.cells.empty()) {
+                row.location.end = row.cells.back()->location.end;
+            } else if (frame.kind == FrameKind::ImplicitRow) {
+                return nullptr;
+            }
+            break;
+        }
+
+        case FrameKind::TableCell: {
+            auto &cell = static_cast<TableCellNode &>(node);
+            if (!cell.content.empty()) {
+                cell.location.end = cell.content.back()->location.end;
+            }
+            break;
+        }
+
+        case FrameKind::Template:
+            if (check(TokenType::TemplateClose)) {
+                node.location.end = token_location(current()).end;
+                advance();
+            }
+            break;
+
+        case FrameKind::Parameter:
+            if (check(TokenType::ParameterClose)) {
+                node.location.end = token_location(current()).end;
+                advance();
+            }
+            break;
+
+        case FrameKind::Link:
+            if (check(TokenType::LinkClose)) {
+                node.location.end = token_location(current()).end;
+                advance();
+            }
+            break;
+
+        case FrameKind::ExternalLink:
+            if (check(TokenType::ExternalLinkClose)) {
+                node.location.end = token_location(current()).end;
+                advance();
+            }
+            break;
+
+        case FrameKind::HtmlTag:
+            // Check if closing tag matches
+            if (check(TokenType::HtmlTagClose)) {
+                node.location.end = token_location(current()).end;
+                advance();
+            }
+            break;
+    }
+
+    return std::move(frame.node);
 }
 
 // ============================================================================
 // Helper methods
 // ============================================================================
 
+NodePtr Parser::token_as_text() {
+    const Token &tok = current();
+    auto node = std::make_unique<TextNode>(std::string(token_text(tok)));
+    node->location = token_location(tok);
+    advance();
+    return node;
+}
+
+std::string_view Parser::token_text(const Token &token) const {
+    return tokenizer_ ? tokenizer_->text(token) : std::string_view{};
+}
+
+SourceRange Parser::token_location(const Token &token) const {
+    return tokenizer_ ? tokenizer_->location(token) : SourceRange{};
+}
+
 void Parser::advance() {
     if (tokenizer_) {
         (void)tokenizer_->next();
@@ -1098,11 +1612,20 @@ bool Parser::at_end() const {
     return check(TokenType::EndOfInput);
 }
 
-void Parser::add_error(std::string message, ErrorSeverity severity) {
+void Parser::add_error(ErrorCode code, ErrorSeverity severity) {
+    if (config_.error_reporting == ErrorReporting::Off) {
+        return;
+    }
+    error_counts_.add(code, severity);
+    if (config_.error_reporting == ErrorReporting::Counters) {
+        return;
+    }
+
+    // Message is produced by ParseError::format()
     ParseError err;
-    err.message = std::move(message);
-    err.location = current().location;
+    err.location = token_location(current());
     err.severity = severity;
+    err.code = code;
     errors_.push_back(std::move(err));
 }
 
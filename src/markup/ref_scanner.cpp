@@ -0,0 +1,266 @@
+/**
+ * @file ref_scanner.cpp
+ * @brief Implementation of <ref> and <references> scanner
+ */
+
+#include "wikilib/markup/ref_scanner.h"
+#include <cstring>
+#include <unordered_map>
+#include "wikilib/core/text_utils.hpp"
+
+namespace wikilib::markup {
+
+namespace {
+
+bool is_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Tag name must be followed by whitespace, '>' or '/'
+bool tag_name_at(std::string_view text, size_t pos, std::string_view name) noexcept {
+    if (!text::starts_with_ignore_case_ascii(text.substr(pos), name)) {
+        return false;
+    }
+    size_t after = pos + name.size();
+    return after == text.size() || is_space(text[after]) || text[after] == '>' || text[after] == '/';
+}
+
+// Position of "</name" at or after from, or npos
+size_t find_close_tag(std::string_view text, size_t from, std::string_view name) noexcept {
+    while (true) {
+        size_t pos = text.find("</", from);
+        if (pos == std::string_view::npos) {
+            return pos;
+        }
+        if (tag_name_at(text, pos + 2, name)) {
+            return pos;
+        }
+        from = pos + 2;
+    }
+}
+
+// Skip a block element (<nowiki>, <pre>) starting at open; returns position after it
+size_t skip_block(std::string_view text, size_t open, std::string_view name) noexcept {
+    size_t gt = text.find('>', open);
+    if (gt == std::string_view::npos) {
+        return text.size();
+    }
+    if (text[gt - 1] == '/') {
+        return gt + 1;
+    }
+    size_t close = find_close_tag(text, gt + 1, name);
+    if (close == std::string_view::npos) {
+        return text.size();
+    }
+    size_t end = text.find('>', close);
+    return end == std::string_view::npos ? text.size() : end + 1;
+}
+
+} // namespace
+
+// ============================================================================
+// RefScanner implementation
+// ============================================================================
+
+bool RefScanner::parse_tag(size_t open, bool references, RefSpan &ref) {
+    ref = RefSpan{};
+    ref.is_references = references;
+    ref.location.begin.offset = open;
+
+    // Attributes up to '>' or '/>'
+    size_t i = open + 1 + (references ? 10 : 3);
+    bool closed = false;
+    while (i < input_.size()) {
+        char c = input_[i];
+        if (is_space(c)) {
+            ++i;
+            continue;
+        }
+        if (c == '>') {
+            ++i;
+            closed = true;
+            break;
+        }
+        if (c == '/') {
+            ++i;
+            if (i < input_.size() && input_[i] == '>') {
+                ++i;
+                ref.self_closing = true;
+                closed = true;
+                break;
+            }
+            continue;
+        }
+
+        size_t name_begin = i;
+        while (i < input_.size() && !is_space(input_[i]) && input_[i] != '=' && input_[i] != '>' &&
+               input_[i] != '/') {
+            ++i;
+        }
+        std::string_view attr = input_.substr(name_begin, i - name_begin);
+        if (attr.empty()) {
+            ++i;
+            continue;
+        }
+
+        while (i < input_.size() && is_space(input_[i])) {
+            ++i;
+        }
+        if (i >= input_.size() || input_[i] != '=') {
+            continue;
+        }
+        ++i;
+        while (i < input_.size() && is_space(input_[i])) {
+            ++i;
+        }
+
+        std::string_view value;
+        if (i < input_.size() && (input_[i] == '"' || input_[i] == '\'')) {
+            char quote = input_[i++];
+            size_t end = input_.find(quote, i);
+            if (end == std::string_view::npos) {
+                break;
+            }
+            value = input_.substr(i, end - i);
+            i = end + 1;
+        } else {
+            size_t begin = i;
+            while (i < input_.size() && !is_space(input_[i]) && input_[i] != '>' &&
+                   !(input_[i] == '/' && i + 1 < input_.size() && input_[i + 1] == '>')) {
+                ++i;
+            }
+            value = input_.substr(begin, i - begin);
+        }
+
+        if (text::equals_ignore_case_ascii(attr, "name")) {
+            ref.name = text::trim(value);
+        } else if (text::equals_ignore_case_ascii(attr, "group")) {
+            ref.group = text::trim(value);
+        }
+    }
+
+    if (!closed) {
+        pos_ = open + 1;
+        return false;
+    }
+
+    if (ref.self_closing) {
+        ref.location.end.offset = i;
+        pos_ = i;
+        return true;
+    }
+
+    std::string_view tag = references ? "references" : "ref";
+    size_t close = find_close_tag(input_, i, tag);
+    if (close == std::string_view::npos) {
+        if (!references) {
+            // Unterminated <ref>: not a reference
+            pos_ = i;
+            return false;
+        }
+        ref.location.end.offset = i;
+        pos_ = i;
+        return true;
+    }
+
+    size_t end = input_.find('>', close);
+    end = end == std::string_view::npos ? input_.size() : end + 1;
+
+    ref.body = input_.substr(i, close - i);
+    ref.location.end.offset = end;
+
+    // List-defined refs live inside <references>, so keep scanning its body
+    pos_ = references ? i : end;
+    return true;
+}
+
+bool RefScanner::next(RefSpan &ref) {
+    while (pos_ < input_.size()) {
+        const void *found = std::memchr(input_.data() + pos_, '<', input_.size() - pos_);
+        if (!found) {
+            pos_ = input_.size();
+            return false;
+        }
+
+        size_t open = static_cast<size_t>(static_cast<const char *>(found) - input_.data());
+        size_t name = open + 1;
+
+        if (input_.substr(name, 3) == "!--") {
+            size_t close = input_.find("-->", name + 3);
+            pos_ = close == std::string_view::npos ? input_.size() : close + 3;
+            continue;
+        }
+
+        if (tag_name_at(input_, name, "ref")) {
+            if (parse_tag(open, false, ref)) {
+                return true;
+            }
+            continue;
+        }
+
+        if (tag_name_at(input_, name, "references")) {
+            if (parse_tag(open, true, ref)) {
+                return true;
+            }
+            continue;
+        }
+
+        if (tag_name_at(input_, name, "nowiki")) {
+            pos_ = skip_block(input_, open, "nowiki");
+            continue;
+        }
+
+        if (tag_name_at(input_, name, "pre")) {
+            pos_ = skip_block(input_, open, "pre");
+            continue;
+        }
+
+        pos_ = name;
+    }
+    return false;
+}
+
+// ============================================================================
+// Page-level collection
+// ============================================================================
+
+void collect_refs(std::string_view wikitext, std::vector<RefSpan> &out) {
+    out.clear();
+
+    std::unordered_multimap<std::string_view, size_t> named;
+    RefScanner scanner(wikitext);
+    RefSpan ref;
+
+    while (scanner.next(ref)) {
+        if (ref.is_references) {
+            continue;
+        }
+        if (ref.name.empty()) {
+            out.push_back(ref);
+            continue;
+        }
+
+        bool merged = false;
+        auto [begin, end] = named.equal_range(ref.name);
+        for (auto it = begin; it != end; ++it) {
+            RefSpan &existing = out[it->second];
+            if (existing.group != ref.group) {
+                continue;
+            }
+            existing.uses++;
+            if (existing.body.empty() && !ref.body.empty()) {
+                existing.body = ref.body;
+                existing.self_closing = false;
+            }
+            merged = true;
+            break;
+        }
+
+        if (!merged) {
+            named.emplace(ref.name, out.size());
+            out.push_back(ref);
+        }
+    }
+}
+
+} // namespace wikilib::markup
@@ -5,126 +5,172 @@
 
 #include "wikilib/markup/section_tree.h"
 #include "wikilib/core/text_utils.hpp"
+#include <ostream>
 #include <sstream>
-#include <stack>
 
 namespace wikilib::markup {
 
 // ============================================================================
-// SectionNode methods
+// SectionTree methods
 // ============================================================================
 
-size_t SectionNode::total_content_count() const noexcept {
-    size_t count = content.size();
-    for (const auto& child : children) {
-        count += child->total_content_count();
+const Section& SectionTree::Children::operator[](size_t n) const noexcept {
+    uint32_t index = first_;
+    for (size_t i = 0; i < n; ++i) {
+        index = sections_[index].end;
     }
-    return count;
+    return sections_[index];
 }
 
-size_t SectionNode::total_section_count() const noexcept {
-    size_t count = children.size();
-    for (const auto& child : children) {
-        count += child->total_section_count();
-    }
-    return count;
+SectionTree::SectionTree() {
+    sections_.emplace_back();
+    sections_.front().end = 1;
+}
+
+size_t SectionTree::total_content_count(const Section& section) const noexcept {
+    // Content of a subtree is contiguous in the node list, interrupted
+    // only by the headings of its subsections
+    size_t index = index_of(section);
+    const Section& last = sections_[section.end - 1];
+    size_t nodes = static_cast<size_t>(last.content.data() + last.content.size() - section.content.data());
+    return nodes - (section.end - index - 1);
 }
 
 // ============================================================================
 // Tree building
 // ============================================================================
 
-SectionNodePtr build_section_tree(const DocumentNode* doc) {
+SectionTree build_section_tree(const DocumentNode* doc) {
     if (!doc) {
-        auto root = std::make_shared<SectionNode>();
-        root->level = 0;
-        return root;
+        return SectionTree();
     }
     return build_section_tree(doc->content);
 }
 
-SectionNodePtr build_section_tree(const std::vector<NodePtr>& nodes) {
-    auto root = std::make_shared<SectionNode>();
-    root->level = 0;
-
-    // Stack: pair of (level, section node)
-    std::stack<std::pair<int, SectionNodePtr>> stack;
-    stack.emplace(0, root);
-
-    for (const auto& node : nodes) {
-        if (node->type == NodeType::Heading) {
-            auto* heading = static_cast<HeadingNode*>(node.get());
-
-            // Create new section
-            auto section = std::make_shared<SectionNode>();
-            section->level = heading->level;
+SectionTree build_section_tree(const std::vector<NodePtr>& nodes) {
+    SectionTree tree;
+    auto& sections = tree.sections_;
+
+    // Titles joined from several text nodes: (section, offset, length) in titles_
+    struct JoinedTitle {
+        size_t section;
+        size_t offset;
+        size_t length;
+    };
+    std::vector<JoinedTitle> joined;
+
+    // Open sections, innermost last (heading levels bound the depth)
+    std::vector<uint32_t> open{0};
+    size_t content_begin = 0;
+
+    auto close_content = [&](size_t until) {
+        Section& current = sections.back();
+        current.content = std::span<const NodePtr>(nodes).subspan(content_begin, until - content_begin);
+    };
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i]->type != NodeType::Heading) {
+            continue;
+        }
+        const auto* heading = static_cast<const HeadingNode*>(nodes[i].get());
+        close_content(i);
+        content_begin = i + 1;
+
+        // Find parent with lower level
+        auto index = static_cast<uint32_t>(sections.size());
+        while (open.size() > 1 && sections[open.back()].level >= heading->level) {
+            sections[open.back()].end = index;
+            open.pop_back();
+        }
 
-            // Extract title from heading content
+        Section section;
+        section.level = heading->level;
+        section.parent = open.back();
+        sections[section.parent].child_count++;
+
+        // Title from the heading's text nodes; a single node is viewed in place
+        const TextNode* single = nullptr;
+        size_t text_nodes = 0;
+        for (const auto& child : heading->content) {
+            if (child->type == NodeType::Text) {
+                single = static_cast<const TextNode*>(child.get());
+                text_nodes++;
+            }
+        }
+        if (text_nodes == 1) {
+            section.title = wikilib::text::trim(single->text);
+        } else if (text_nodes > 1) {
+            size_t offset = tree.titles_.size();
             for (const auto& child : heading->content) {
                 if (child->type == NodeType::Text) {
-                    auto* text = static_cast<TextNode*>(child.get());
-                    section->title += text->text;
+                    const std::string& text = static_cast<const TextNode*>(child.get())->text;
+                    tree.titles_.insert(tree.titles_.end(), text.begin(), text.end());
                 }
             }
+            joined.push_back({sections.size(), offset, tree.titles_.size() - offset});
+        }
 
-            // Trim whitespace from title
-            section->title = std::string(wikilib::text::trim(section->title));
+        sections.push_back(section);
+        open.push_back(index);
+    }
+    close_content(nodes.size());
 
-            // Find parent with lower level
-            while (!stack.empty() && stack.top().first >= heading->level) {
-                stack.pop();
-            }
+    for (uint32_t index : open) {
+        sections[index].end = static_cast<uint32_t>(sections.size());
+    }
 
-            // Add as child of parent
-            stack.top().second->children.push_back(section);
-            stack.emplace(heading->level, section);
-        } else {
-            // Add content to current section
-            stack.top().second->content.push_back(node.get());
-        }
+    // The title buffer no longer grows, so views into it stay valid
+    for (const auto& title : joined) {
+        sections[title.section].title =
+                wikilib::text::trim(std::string_view(tree.titles_.data() + title.offset, title.length));
     }
 
-    return root;
+    return tree;
 }
 
 // ============================================================================
 // Tree printing
 // ============================================================================
 
-void print_section_tree(
-    const SectionNodePtr& node,
+namespace {
+
+void print_section(
+    const SectionTree& tree,
+    const Section& section,
     std::ostream& out,
     const std::string& prefix,
     bool is_last
 ) {
-    if (!node) {
-        return;
-    }
-
     // Print current node
-    if (!node->is_root()) {
+    if (!section.is_root()) {
         out << prefix;
         out << (is_last ? "└── " : "├── ");
-        out << node->title << "(" << node->content.size() << ")\n";
+        out << section.title << "(" << section.content.size() << ")\n";
     } else {
         // Root node
-        out << "ROOT(" << node->content.size() << ")\n";
+        out << "ROOT(" << section.content.size() << ")\n";
     }
 
     // Print children
-    for (size_t i = 0; i < node->children.size(); ++i) {
-        bool last = (i == node->children.size() - 1);
-        std::string new_prefix = prefix;
-        if (!node->is_root()) {
-            new_prefix += (is_last ? "    " : "│   ");
-        }
-        print_section_tree(node->children[i], out, new_prefix, last);
+    std::string new_prefix = prefix;
+    if (!section.is_root()) {
+        new_prefix += (is_last ? "    " : "│   ");
+    }
+    for (const Section& child : tree.children(section)) {
+        bool last = child.end == section.end;
+        print_section(tree, child, out, new_prefix, last);
     }
 }
 
-std::string section_tree_to_string(const SectionNodePtr& node) {
+} // namespace
+
+void print_section_tree(const SectionTree& tree, std::ostream& out) {
+    print_section(tree, tree.root(), out, "", true);
+}
+
+std::string section_tree_to_string(const SectionTree& tree) {
     std::ostringstream oss;
-    print_section_tree(node, oss);
+    print_section_tree(tree, oss);
     return oss.str();
 }
 
@@ -133,39 +179,24 @@ std::string section_tree_to_string(const SectionNodePtr& node) {
 // ============================================================================
 
 void traverse_sections(
-    const SectionNodePtr& node,
-    const std::function<void(const SectionNodePtr&)>& visitor
+    const SectionTree& tree,
+    const std::function<void(const Section&)>& visitor
 ) {
-    if (!node) {
-        return;
-    }
-
-    visitor(node);
-
-    for (const auto& child : node->children) {
-        traverse_sections(child, visitor);
+    // Storage order is depth-first order
+    for (const Section& section : tree.sections()) {
+        visitor(section);
     }
 }
 
-SectionNodePtr find_section(
-    const SectionNodePtr& node,
+const Section* find_section(
+    const SectionTree& tree,
     std::string_view title
 ) {
-    if (!node) {
-        return nullptr;
-    }
-
-    if (node->title == title) {
-        return node;
-    }
-
-    for (const auto& child : node->children) {
-        auto found = find_section(child, title);
-        if (found) {
-            return found;
+    for (const Section& section : tree.sections()) {
+        if (section.title == title) {
+            return &section;
         }
     }
-
     return nullptr;
 }
 
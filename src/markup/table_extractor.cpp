@@ -0,0 +1,389 @@
+/**
+ * @file table_extractor.cpp
+ * @brief Implementation of streaming wikitable extraction
+ */
+
+#include "wikilib/markup/table_extractor.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include "wikilib/core/text_utils.hpp"
+
+namespace wikilib::markup {
+
+namespace {
+
+// Same limits MediaWiki's sanitizer applies
+constexpr uint32_t MAX_COLSPAN = 1000;
+constexpr uint32_t MAX_ROWSPAN = 65534;
+
+std::string_view skip_indent(std::string_view line) noexcept {
+    size_t i = 0;
+    while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) {
+        ++i;
+    }
+    return line.substr(i);
+}
+
+// Net change in {{ }} nesting over text
+int brace_balance(std::string_view text) noexcept {
+    int balance = 0;
+    for (size_t i = 0; i + 1 < text.size(); ++i) {
+        if (text[i] == '{' && text[i + 1] == '{') {
+            ++balance;
+            ++i;
+        } else if (text[i] == '}' && text[i + 1] == '}') {
+            --balance;
+            ++i;
+        }
+    }
+    return balance;
+}
+
+// Track [[ ]] and {{ }} nesting while scanning for separators
+struct MarkupDepth {
+    int depth = 0;
+
+    // Returns number of characters consumed by a bracket pair at i (0 if none)
+    size_t update(std::string_view text, size_t i) noexcept {
+        if (i + 1 >= text.size()) {
+            return 0;
+        }
+        char c = text[i];
+        char n = text[i + 1];
+        if ((c == '[' && n == '[') || (c == '{' && n == '{')) {
+            ++depth;
+            return 2;
+        }
+        if ((c == ']' && n == ']') || (c == '}' && n == '}')) {
+            if (depth > 0) {
+                --depth;
+            }
+            return 2;
+        }
+        return 0;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// Span attributes
+// ============================================================================
+
+uint32_t parse_span_attribute(std::string_view attributes, std::string_view name) noexcept {
+    size_t pos = 0;
+    while (pos + name.size() <= attributes.size()) {
+        std::string_view rest = attributes.substr(pos);
+        if (!text::starts_with_ignore_case_ascii(rest, name) ||
+            (pos > 0 && (std::isalnum(static_cast<unsigned char>(attributes[pos - 1])) || attributes[pos - 1] == '-'))) {
+            ++pos;
+            continue;
+        }
+
+        size_t i = pos + name.size();
+        while (i < attributes.size() && attributes[i] == ' ') {
+            ++i;
+        }
+        if (i >= attributes.size() || attributes[i] != '=') {
+            pos = i;
+            continue;
+        }
+        ++i;
+        while (i < attributes.size() && (attributes[i] == ' ' || attributes[i] == '"' || attributes[i] == '\'')) {
+            ++i;
+        }
+
+        uint32_t value = 0;
+        auto [end, ec] = std::from_chars(attributes.data() + i, attributes.data() + attributes.size(), value);
+        if (ec != std::errc() || value == 0) {
+            return 1;
+        }
+        return std::min(value, text::starts_with_ignore_case_ascii(name, "rowspan") ? MAX_ROWSPAN : MAX_COLSPAN);
+    }
+    return 1;
+}
+
+// ============================================================================
+// TableGrid implementation
+// ============================================================================
+
+void TableGrid::clear() noexcept {
+    cells_.clear();
+    rows_ = 0;
+    columns_ = 0;
+    span_rows_.clear();
+    span_cells_.clear();
+}
+
+void TableGrid::widen(size_t columns) {
+    if (columns <= columns_) {
+        return;
+    }
+
+    // Re-stride existing rows from the back so nothing is overwritten early
+    cells_.resize(rows_ * columns);
+    for (size_t r = rows_; r-- > 0;) {
+        for (size_t c = columns_; c-- > 0;) {
+            cells_[r * columns + c] = cells_[r * columns_ + c];
+        }
+        std::fill(cells_.begin() + static_cast<ptrdiff_t>(r * columns + columns_),
+                  cells_.begin() + static_cast<ptrdiff_t>((r + 1) * columns), TableCell{});
+    }
+
+    columns_ = columns;
+    span_rows_.resize(columns, 0);
+    span_cells_.resize(columns);
+}
+
+void TableGrid::add_row(std::span<const TableCell> cells) {
+    size_t r = rows_++;
+    cells_.resize(rows_ * columns_);
+    std::fill(cells_.begin() + static_cast<ptrdiff_t>(r * columns_), cells_.end(), TableCell{});
+
+    size_t col = 0;
+    auto fill_from_above = [&] {
+        while (col < columns_ && span_rows_[col] > 0) {
+            cells_[r * columns_ + col] = span_cells_[col];
+            span_rows_[col]--;
+            ++col;
+        }
+    };
+
+    for (const auto &cell: cells) {
+        fill_from_above();
+        widen(col + cell.colspan);
+
+        for (uint32_t k = 0; k < cell.colspan; ++k) {
+            TableCell &slot = cells_[r * columns_ + col + k];
+            slot = cell;
+            slot.is_span_copy = k > 0;
+
+            if (cell.rowspan > 1) {
+                span_rows_[col + k] = cell.rowspan - 1;
+                span_cells_[col + k] = cell;
+                span_cells_[col + k].is_span_copy = true;
+            } else if (span_rows_[col + k] > 0) {
+                // A colspan overlapping a rowspan from above uses up this row of it
+                span_rows_[col + k]--;
+            }
+        }
+        col += cell.colspan;
+    }
+
+    // Rowspans reaching past the last cell of this row
+    for (; col < columns_; ++col) {
+        if (span_rows_[col] > 0) {
+            cells_[r * columns_ + col] = span_cells_[col];
+            span_rows_[col]--;
+        }
+    }
+}
+
+// ============================================================================
+// TableExtractor implementation
+// ============================================================================
+
+std::string_view TableExtractor::next_line() {
+    size_t end = input_.find('\n', pos_);
+    if (end == std::string_view::npos) {
+        end = input_.size();
+    }
+    std::string_view line = input_.substr(pos_, end - pos_);
+    pos_ = std::min(end + 1, input_.size());
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+bool TableExtractor::next_table() {
+    if (in_table_) {
+        while (next_row(scratch_row_)) {
+        }
+    }
+
+    // Only "{|" at line start (after indentation) opens a table
+    while (pos_ < input_.size()) {
+        size_t found = input_.find("{|", pos_);
+        if (found == std::string_view::npos) {
+            pos_ = input_.size();
+            return false;
+        }
+
+        size_t line_start = found;
+        while (line_start > 0 && (input_[line_start - 1] == ' ' || input_[line_start - 1] == '\t')) {
+            --line_start;
+        }
+        if (line_start > 0 && input_[line_start - 1] != '\n') {
+            pos_ = found + 2;
+            continue;
+        }
+
+        pos_ = found + 2;
+        table_attributes_ = text::trim(next_line());
+        caption_ = {};
+        in_table_ = true;
+        return true;
+    }
+    return false;
+}
+
+void TableExtractor::extend_cell(TableCell &cell, std::string_view line) {
+    const char *end = line.data() + line.size();
+    if (cell.text.empty()) {
+        cell.text = text::trim(line);
+        return;
+    }
+    cell.text = text::trim_right(std::string_view(cell.text.data(), static_cast<size_t>(end - cell.text.data())));
+}
+
+void TableExtractor::add_cells(std::string_view line, bool is_header, std::vector<TableCell> &cells) {
+    char sep = is_header ? '!' : '|';
+    MarkupDepth markup;
+
+    // Split on || (and !! on header lines) outside links and templates
+    size_t start = 0;
+    for (size_t i = 0; i <= line.size(); ++i) {
+        bool at_end = i == line.size();
+        if (!at_end) {
+            if (size_t skip = markup.update(line, i)) {
+                i += skip - 1;
+                continue;
+            }
+            if (markup.depth > 0 || i + 1 >= line.size() || line[i + 1] != line[i] ||
+                (line[i] != '|' && line[i] != sep)) {
+                continue;
+            }
+        }
+
+        std::string_view raw = line.substr(start, i - start);
+        TableCell cell;
+        cell.is_header = is_header;
+
+        // Attributes end at the first single '|' outside markup
+        MarkupDepth inner;
+        size_t bar = std::string_view::npos;
+        for (size_t j = 0; j < raw.size(); ++j) {
+            if (size_t skip = inner.update(raw, j)) {
+                j += skip - 1;
+                continue;
+            }
+            if (inner.depth == 0 && raw[j] == '|') {
+                bar = j;
+                break;
+            }
+        }
+
+        if (bar != std::string_view::npos && raw.substr(0, bar).find("[[") == std::string_view::npos) {
+            cell.attributes = text::trim(raw.substr(0, bar));
+            cell.text = text::trim(raw.substr(bar + 1));
+            cell.rowspan = parse_span_attribute(cell.attributes, "rowspan");
+            cell.colspan = parse_span_attribute(cell.attributes, "colspan");
+        } else {
+            cell.text = text::trim(raw);
+        }
+        cells.push_back(cell);
+
+        start = i + 2;
+        ++i;
+    }
+}
+
+bool TableExtractor::next_row(std::vector<TableCell> &cells) {
+    cells.clear();
+    if (!in_table_) {
+        return false;
+    }
+
+    bool has_cell = false; // Continuation lines extend cells.back()
+    int nested = 0; // Depth of tables nested inside the current cell
+    int braces = 0; // Open {{ carried across lines
+
+    while (pos_ < input_.size()) {
+        std::string_view line = next_line();
+        std::string_view t = skip_indent(line);
+
+        // Row and table boundaries end an unclosed {{, so a broken template cannot swallow the rest of
+        // the page; "| key = value" lines of a multi-line template keep it open
+        if (nested == 0 && braces > 0 && (t.starts_with("|-") || t.starts_with("|}") || t.starts_with("{|"))) {
+            braces = 0;
+        }
+
+        if (nested > 0 || braces > 0) {
+            if (t.starts_with("{|")) {
+                ++nested;
+            } else if (t.starts_with("|}") && nested > 0) {
+                --nested;
+            }
+            if (has_cell) {
+                extend_cell(cells.back(), line);
+            }
+            braces = std::max(0, braces + brace_balance(t));
+            continue;
+        }
+
+        if (t.starts_with("{|")) {
+            ++nested;
+            if (has_cell) {
+                extend_cell(cells.back(), line);
+            }
+            continue;
+        }
+
+        if (t.starts_with("|}")) {
+            in_table_ = false;
+            return !cells.empty();
+        }
+
+        if (t.starts_with("|-")) {
+            if (!cells.empty()) {
+                return true;
+            }
+            has_cell = false;
+            continue;
+        }
+
+        if (t.starts_with("|+")) {
+            std::string_view body = t.substr(2);
+            size_t bar = body.find('|');
+            if (bar != std::string_view::npos && body.substr(0, bar).find("[[") == std::string_view::npos &&
+                body.substr(0, bar).find("{{") == std::string_view::npos) {
+                body = body.substr(bar + 1);
+            }
+            caption_ = text::trim(body);
+            has_cell = false;
+            continue;
+        }
+
+        if (t.starts_with('|') || t.starts_with('!')) {
+            add_cells(t.substr(1), t[0] == '!', cells);
+            has_cell = !cells.empty();
+            braces = std::max(0, brace_balance(t));
+            continue;
+        }
+
+        // Plain line continues the last cell
+        if (has_cell) {
+            extend_cell(cells.back(), line);
+            braces = std::max(0, braces + brace_balance(t));
+        }
+    }
+
+    in_table_ = false;
+    return !cells.empty();
+}
+
+bool TableExtractor::read_table(TableGrid &grid) {
+    if (!next_table()) {
+        return false;
+    }
+
+    grid.clear();
+    while (next_row(scratch_row_)) {
+        grid.add_row(scratch_row_);
+    }
+    return true;
+}
+
+} // namespace wikilib::markup
@@ -7,7 +7,9 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <stdexcept>
 #include "wikilib/core/types.h"
+#include "wikilib/markup/magic_words.h"
 
 namespace wikilib::markup {
 
@@ -103,40 +105,22 @@ namespace wikilib::markup {
 // Helper functions
 // ============================================================================
 
-/**
- * @brief Check if a tag name is a valid HTML tag allowed in MediaWiki
- *
- * Based on tags from MediaWiki's Sanitizer.php and common HTML tags
- * used in wikis. Does not include "nowiki" which is handled specially.
- */
-static bool is_valid_html_tag(std::string_view tag_name) noexcept {
-    // List of allowed HTML tags in MediaWiki (from TagFactory.h)
-    // Sorted alphabetically for easier maintenance
-    static constexpr std::array<std::string_view, 63> valid_tags = {
-        "abbr", "b", "bdi", "bdo", "big", "blockquote", "br", "caption", "center",
-        "cite", "code", "col", "colgroup", "data", "dd", "del", "dfn", "div", "dl",
-        "dt", "em", "font", "h1", "h2", "h3", "h4", "h5", "h6", "hr", "i", "ins",
-        "kbd", "li", "link", "mark", "meta", "ol", "p", "pre", "q", "rb", "rp",
-        "rt", "ruby", "s", "samp", "small", "span", "strike", "strong", "sub",
-        "sup", "table", "td", "th", "time", "tr", "tt", "u", "ul", "var", "wbr"
-    };
-
-    // Binary search since array is sorted
-    return std::binary_search(valid_tags.begin(), valid_tags.end(), tag_name);
-}
-
 // ============================================================================
 // Tokenizer implementation
 // ============================================================================
 
 Tokenizer::Tokenizer(std::string_view input, TokenizerConfig config) :
     input_(input), config_(config), pos_(0), current_pos_{1, 1, 0}, at_line_start_(true) {
+    // Tokens store 32-bit offsets and lengths
+    if (input.size() > MAX_INPUT_SIZE) {
+        throw std::length_error("Wikitext input exceeds 4 GiB");
+    }
 }
 
 Token Tokenizer::next() {
     if (!lookahead_.empty()) {
         Token tok = lookahead_.front();
-        lookahead_.erase(lookahead_.begin());
+        lookahead_.pop_front();
         return tok;
     }
     return scan_token();
@@ -173,12 +157,23 @@ void Tokenizer::reset() {
     current_pos_ = {1, 1, 0};
     lookahead_.clear();
     errors_.clear();
+    error_counts_ = {};
+    attributes_.clear();
+    line_starts_.clear();
     template_depth_ = 0;
     link_depth_ = 0;
     at_line_start_ = true;
     in_table_ = false;
 }
 
+std::span<const HtmlAttribute> Tokenizer::attributes(const Token &token) const noexcept {
+    uint32_t count = token.attr_count();
+    if (count == 0 || size_t{token.attr_begin} + count > attributes_.size()) {
+        return {};
+    }
+    return {attributes_.data() + token.attr_begin, count};
+}
+
 std::vector<Token> Tokenizer::tokenize_all() {
     std::vector<Token> tokens;
     while (has_more()) {
@@ -191,25 +186,76 @@ std::vector<Token> Tokenizer::tokenize_all() {
     return tokens;
 }
 
+SourceRange Tokenizer::location(const Token &token) const noexcept {
+    return {position_at(token.offset), position_at(token.end_offset())};
+}
+
 // ============================================================================
-// Helper to create tokens without missing-initializer warnings
+// Token accessors
 // ============================================================================
 
-static Token make_token(TokenType type, std::string_view text, SourceRange location) {
+std::string_view Token::text(std::string_view input) const noexcept {
+    if (offset > input.size()) {
+        return {};
+    }
+    std::string_view raw = input.substr(offset, length);
+    if (type == TokenType::NoWiki) {
+        // Only the content between <nowiki> and </nowiki> is text
+        if (self_closing()) {
+            return {};
+        }
+        raw.remove_prefix(std::min<size_t>(raw.size(), 8));
+        if (raw.ends_with("</nowiki>")) {
+            raw.remove_suffix(9);
+        }
+    }
+    return raw;
+}
+
+std::string_view Token::tag_name(std::string_view input) const noexcept {
+    if (type != TokenType::HtmlTagOpen && type != TokenType::HtmlTagClose) {
+        return {};
+    }
+    std::string_view raw = text(input);
+    size_t begin = raw.starts_with("</") ? 2 : 1;
+    size_t end = begin;
+    while (end < raw.size() &&
+           (std::isalnum(static_cast<unsigned char>(raw[end])) || raw[end] == '-' || raw[end] == '_')) {
+        end++;
+    }
+    return raw.substr(std::min(begin, raw.size()), end - begin);
+}
+
+// ============================================================================
+// Token construction and positions
+// ============================================================================
+
+Token Tokenizer::make_token(TokenType type, size_t begin, size_t end) const noexcept {
     Token tok;
     tok.type = type;
-    tok.text = text;
-    tok.location = location;
+    tok.offset = static_cast<uint32_t>(begin);
+    tok.length = static_cast<uint32_t>(end - begin);
     return tok;
 }
 
+SourcePosition Tokenizer::position_at(size_t offset) const noexcept {
+    // line_starts_ holds the start of every line after the first
+    auto after = std::upper_bound(line_starts_.begin(), line_starts_.end(), offset);
+    size_t line_start = after == line_starts_.begin() ? 0 : *(after - 1);
+    SourcePosition pos;
+    pos.line = static_cast<uint32_t>(after - line_starts_.begin()) + 1;
+    pos.column = static_cast<uint32_t>(offset - line_start) + 1;
+    pos.offset = offset;
+    return pos;
+}
+
 // ============================================================================
 // Private scanning methods
 // ============================================================================
 
 Token Tokenizer::scan_token() {
     if (at_end()) {
-        return make_token(TokenType::EndOfInput, {}, {current_pos_, current_pos_});
+        return make_token(TokenType::EndOfInput, pos_, pos_);
     }
 
     SourcePosition start = current_pos_;
@@ -219,7 +265,7 @@ Token Tokenizer::scan_token() {
     if (c == '\n') {
         advance();
         at_line_start_ = true;
-        return make_token(TokenType::Newline, input_.substr(start.offset, 1), {start, current_pos_});
+        return make_token(TokenType::Newline, start.offset, pos_);
     }
 
     // Line-start constructs
@@ -228,11 +274,10 @@ Token Tokenizer::scan_token() {
 
         // Horizontal rule: ---- at line start
         if (c == '-' && match("----")) {
-            size_t begin = pos_;
             while (!at_end() && current() == '-') {
                 advance();
             }
-            return make_token(TokenType::HorizontalRule, input_.substr(begin, pos_ - begin), {start, current_pos_});
+            return make_token(TokenType::HorizontalRule, start.offset, pos_);
         }
 
         // Heading: == at line start
@@ -249,7 +294,7 @@ Token Tokenizer::scan_token() {
         if (c == '{' && peek_char() == '|') {
             advance(2);
             in_table_ = true;
-            return make_token(TokenType::TableStart, input_.substr(start.offset, 2), {start, current_pos_});
+            return make_token(TokenType::TableStart, start.offset, pos_);
         }
 
         // Table row/end at line start
@@ -257,26 +302,26 @@ Token Tokenizer::scan_token() {
             if (peek_char() == '}') {
                 advance(2);
                 in_table_ = false;
-                return make_token(TokenType::TableEnd, input_.substr(start.offset, 2), {start, current_pos_});
+                return make_token(TokenType::TableEnd, start.offset, pos_);
             }
             if (peek_char() == '-') {
                 advance(2);
-                return make_token(TokenType::TableRowStart, input_.substr(start.offset, 2), {start, current_pos_});
+                return make_token(TokenType::TableRowStart, start.offset, pos_);
             }
             if (peek_char() == '+') {
                 advance(2);
-                return make_token(TokenType::TableCaption, input_.substr(start.offset, 2), {start, current_pos_});
+                return make_token(TokenType::TableCaption, start.offset, pos_);
             }
             if (in_table_) {
                 advance();
-                return make_token(TokenType::TableDataCell, input_.substr(start.offset, 1), {start, current_pos_});
+                return make_token(TokenType::TableDataCell, start.offset, pos_);
             }
         }
 
         // Table header cell: ! at line start
         if (c == '!' && in_table_) {
             advance();
-            return make_token(TokenType::TableHeaderCell, input_.substr(start.offset, 1), {start, current_pos_});
+            return make_token(TokenType::TableHeaderCell, start.offset, pos_);
         }
     }
 
@@ -305,10 +350,10 @@ Token Tokenizer::scan_token() {
         if (peek_char() == ']' && link_depth_ > 0) {
             advance(2);
             link_depth_--;
-            return make_token(TokenType::LinkClose, input_.substr(start.offset, 2), {start, current_pos_});
+            return make_token(TokenType::LinkClose, start.offset, pos_);
         }
         advance();
-        return make_token(TokenType::ExternalLinkClose, input_.substr(start.offset, 1), {start, current_pos_});
+        return make_token(TokenType::ExternalLinkClose, start.offset, pos_);
     }
 
     // Templates and parameters: {{{ or {{
@@ -321,12 +366,12 @@ Token Tokenizer::scan_token() {
         if (match("}}}") && template_depth_ > 0) {
             advance(3);
             template_depth_--;
-            return make_token(TokenType::ParameterClose, input_.substr(start.offset, 3), {start, current_pos_});
+            return make_token(TokenType::ParameterClose, start.offset, pos_);
         }
         if (match("}}") && template_depth_ > 0) {
             advance(2);
             template_depth_--;
-            return make_token(TokenType::TemplateClose, input_.substr(start.offset, 2), {start, current_pos_});
+            return make_token(TokenType::TemplateClose, start.offset, pos_);
         }
     }
 
@@ -334,19 +379,19 @@ Token Tokenizer::scan_token() {
     if (c == '|') {
         advance();
         if (link_depth_ > 0) {
-            return make_token(TokenType::LinkSeparator, input_.substr(start.offset, 1), {start, current_pos_});
+            return make_token(TokenType::LinkSeparator, start.offset, pos_);
         }
         if (template_depth_ > 0 || in_table_) {
-            return make_token(TokenType::Pipe, input_.substr(start.offset, 1), {start, current_pos_});
+            return make_token(TokenType::Pipe, start.offset, pos_);
         }
         // Outside special context, treat as text
-        return make_token(TokenType::Text, input_.substr(start.offset, 1), {start, current_pos_});
+        return make_token(TokenType::Text, start.offset, pos_);
     }
 
     // Equals (in template context)
     if (c == '=' && template_depth_ > 0) {
         advance();
-        return make_token(TokenType::Equals, input_.substr(start.offset, 1), {start, current_pos_});
+        return make_token(TokenType::Equals, start.offset, pos_);
     }
 
     // HTML comment: <!--
@@ -365,16 +410,15 @@ Token Tokenizer::scan_token() {
     }
 
     // Magic words: __WORD__
-    if (c == '_' && match("__")) {
+    if (c == '_' && at_magic_word()) {
         return scan_magic_word();
     }
 
     // Redirect at start
     if (c == '#' && config_.recognize_redirects) {
         if (match("#REDIRECT") || match("#redirect") || match("#Redirect")) {
-            size_t begin = pos_;
             advance(9); // #REDIRECT
-            return make_token(TokenType::Redirect, input_.substr(begin, 9), {start, current_pos_});
+            return make_token(TokenType::Redirect, start.offset, pos_);
         }
     }
 
@@ -391,7 +435,11 @@ Token Tokenizer::scan_text() {
 
         // Stop at special characters
         if (c == '\n' || c == '[' || c == ']' || c == '{' || c == '}' || c == '|' || c == '\'' || c == '<' ||
-            c == '=' || c == '_' || c == '*' || c == '#' || c == ';' || c == ':' || c == '!' || c == '-') {
+            c == '=' || c == '*' || c == '#' || c == ';' || c == ':' || c == '!' || c == '-') {
+            break;
+        }
+        // Underscores in titles and identifiers stay in the text run
+        if (c == '_' && at_magic_word()) {
             break;
         }
 
@@ -403,42 +451,38 @@ Token Tokenizer::scan_text() {
         advance();
     }
 
-    return make_token(TokenType::Text, input_.substr(begin, pos_ - begin), {start, current_pos_});
+    return make_token(TokenType::Text, start.offset, pos_);
 }
 
 Token Tokenizer::scan_formatting() {
     SourcePosition start = current_pos_;
-    size_t begin = pos_;
-    int count = 0;
-
-    while (!at_end() && current() == '\'' && count < 5) {
-        advance();
+    size_t count = 0;
+    while (pos_ + count < input_.size() && input_[pos_ + count] == '\'') {
         count++;
     }
 
-    TokenType type;
-    if (count >= 5) {
-        type = TokenType::BoldItalic;
-    } else if (count >= 3) {
-        type = TokenType::Bold;
-        // If we consumed more than 3, put back the extras
-        if (count == 4) {
-            // 4 apostrophes: treat as italic + text apostrophe + italic?
-            // Or bold + one extra. Let's return bold and leave one.
-            // Actually, for simplicity, return 3 as bold
-            // Adjust position back by 1
-            pos_--;
-            current_pos_.column--;
-            current_pos_.offset--;
-        }
-    } else if (count >= 2) {
-        type = TokenType::Italic;
-    } else {
-        // Single apostrophe is just text
-        return make_token(TokenType::Text, input_.substr(begin, 1), {start, current_pos_});
-    }
-
-    return make_token(type, input_.substr(begin, pos_ - begin), {start, current_pos_});
+    // Runs are split like MediaWiki's doQuotes: surplus apostrophes of a
+    // four-run or of a run longer than five are text before the markup
+    size_t length = count;
+    if (count == 4) {
+        length = 1;
+    } else if (count > 5) {
+        length = count - 5;
+    }
+    advance(length);
+
+    TokenType type = TokenType::Text;
+    if (length == count) {
+        if (count == 5) {
+            type = TokenType::BoldItalic;
+        } else if (count == 3) {
+            type = TokenType::Bold;
+        } else if (count == 2) {
+            type = TokenType::Italic;
+        }
+    }
+
+    return make_token(type, start.offset, pos_);
 }
 
 Token Tokenizer::scan_link() {
@@ -450,20 +494,24 @@ Token Tokenizer::scan_link() {
 
         // Check for category
         if (config_.recognize_categories) {
-            // Look for Category: prefix
-            std::string_view rest = input_.substr(pos_);
-            if (rest.starts_with("Category:") || rest.starts_with("category:") || rest.starts_with("Kategoria:") ||
-                rest.starts_with("kategoria:")) {
-                return make_token(TokenType::Category, input_.substr(start.offset, 2), {start, current_pos_});
+            // Look for a category namespace prefix; no name is longer than
+            // max_length(), so the colon search stays short
+            const NamespaceResolver &resolver =
+                    config_.namespaces ? *config_.namespaces : NamespaceResolver::builtin();
+            std::string_view rest = input_.substr(pos_, resolver.max_length() + 1);
+            size_t colon = rest.find_first_of(":|]\n");
+            if (colon != std::string_view::npos && rest[colon] == ':' &&
+                resolver.find(rest.substr(0, colon)) == NS_CATEGORY) {
+                return make_token(TokenType::Category, start.offset, pos_);
             }
         }
 
-        return make_token(TokenType::LinkOpen, input_.substr(start.offset, 2), {start, current_pos_});
+        return make_token(TokenType::LinkOpen, start.offset, pos_);
     }
 
     // Single [ for external link
     advance();
-    return make_token(TokenType::ExternalLinkOpen, input_.substr(start.offset, 1), {start, current_pos_});
+    return make_token(TokenType::ExternalLinkOpen, start.offset, pos_);
 }
 
 Token Tokenizer::scan_template() {
@@ -473,7 +521,7 @@ Token Tokenizer::scan_template() {
     if (match("{{{")) {
         advance(3);
         template_depth_++;
-        return make_token(TokenType::ParameterOpen, input_.substr(start.offset, 3), {start, current_pos_});
+        return make_token(TokenType::ParameterOpen, start.offset, pos_);
     }
 
     // Template: {{
@@ -483,15 +531,15 @@ Token Tokenizer::scan_template() {
 
         // Check for parser function: {{#
         if (!at_end() && current() == '#') {
-            return make_token(TokenType::ParserFunction, input_.substr(start.offset, 2), {start, current_pos_});
+            return make_token(TokenType::ParserFunction, start.offset, pos_);
         }
 
-        return make_token(TokenType::TemplateOpen, input_.substr(start.offset, 2), {start, current_pos_});
+        return make_token(TokenType::TemplateOpen, start.offset, pos_);
     }
 
     // Single { is just text
     advance();
-    return make_token(TokenType::Text, input_.substr(start.offset, 1), {start, current_pos_});
+    return make_token(TokenType::Text, start.offset, pos_);
 }
 
 Token Tokenizer::scan_table() {
@@ -500,31 +548,30 @@ Token Tokenizer::scan_table() {
     if (match("{|")) {
         advance(2);
         in_table_ = true;
-        return make_token(TokenType::TableStart, input_.substr(start.offset, 2), {start, current_pos_});
+        return make_token(TokenType::TableStart, start.offset, pos_);
     }
 
     if (match("|}")) {
         advance(2);
         in_table_ = false;
-        return make_token(TokenType::TableEnd, input_.substr(start.offset, 2), {start, current_pos_});
+        return make_token(TokenType::TableEnd, start.offset, pos_);
     }
 
     if (match("|-")) {
         advance(2);
-        return make_token(TokenType::TableRowStart, input_.substr(start.offset, 2), {start, current_pos_});
+        return make_token(TokenType::TableRowStart, start.offset, pos_);
     }
 
     if (match("|+")) {
         advance(2);
-        return make_token(TokenType::TableCaption, input_.substr(start.offset, 2), {start, current_pos_});
+        return make_token(TokenType::TableCaption, start.offset, pos_);
     }
 
     advance();
-    return make_token(TokenType::TableDataCell, input_.substr(start.offset, 1), {start, current_pos_});
+    return make_token(TokenType::TableDataCell, start.offset, pos_);
 }
 
 Token Tokenizer::scan_heading() {
-    SourcePosition start = current_pos_;
     size_t begin = pos_;
     int level = 0;
 
@@ -534,17 +581,13 @@ Token Tokenizer::scan_heading() {
         level++;
     }
 
-    Token tok;
-    tok.type = TokenType::Heading;
-    tok.text = input_.substr(begin, pos_ - begin);
-    tok.location = {start, current_pos_};
-    tok.level = level;
+    Token tok = make_token(TokenType::Heading, begin, pos_);
+    tok.level = static_cast<uint8_t>(level);
 
     return tok;
 }
 
 Token Tokenizer::scan_list_marker() {
-    SourcePosition start = current_pos_;
     size_t begin = pos_;
     char marker = current();
     int depth = 0;
@@ -574,11 +617,8 @@ Token Tokenizer::scan_list_marker() {
             break;
     }
 
-    Token tok;
-    tok.type = type;
-    tok.text = input_.substr(begin, pos_ - begin);
-    tok.location = {start, current_pos_};
-    tok.level = depth;
+    Token tok = make_token(type, begin, pos_);
+    tok.level = static_cast<uint8_t>(std::min(depth, 255));
 
     return tok;
 }
@@ -604,43 +644,56 @@ Token Tokenizer::scan_html_tag() {
 
     // Check if tag name is valid
     // If not, treat '<' as plain text and don't consume the rest
-    if (!is_valid_html_tag(tag_name)) {
+    HtmlTagId tag_id = lookup_html_tag(tag_name);
+    if (tag_id == HtmlTagId::Unknown) {
         // Reset position to just after '<'
         pos_ = begin + 1;
         current_pos_.column = start.column + 1;
         current_pos_.offset = pos_;
 
         // Return '<' as text
-        return make_token(TokenType::Text, input_.substr(begin, 1), {start, current_pos_});
+        return make_token(TokenType::Text, start.offset, pos_);
     }
 
     // Skip to end of tag
+    size_t attrs_start = pos_;
     bool self_closing = false;
     while (!at_end() && current() != '>') {
         if (current() == '/' && peek_char() == '>') {
             self_closing = true;
-            advance(); // skip /
-            break;     // > will be consumed below
+            break;
         }
         advance();
     }
+    size_t attrs_end = pos_;
 
+    if (self_closing) {
+        advance(); // skip /, > is consumed below
+    }
     if (!at_end()) {
         advance(); // skip >
     }
 
-    Token tok;
-    tok.type = is_closing ? TokenType::HtmlTagClose : TokenType::HtmlTagOpen;
-    tok.text = input_.substr(begin, pos_ - begin);
-    tok.location = {start, current_pos_};
-    tok.tag_name = tag_name;
-    tok.self_closing = self_closing;
+    Token tok = make_token(is_closing ? TokenType::HtmlTagClose : TokenType::HtmlTagOpen, begin, pos_);
+    tok.tag_id = tag_id;
+    tok.flags = self_closing ? Token::SELF_CLOSING : 0;
+
+    // Split attributes once here so AST nodes and callers never re-parse them.
+    // The count shares the level byte; attributes past 255 are dropped.
+    if (!is_closing) {
+        tok.attr_begin = static_cast<uint32_t>(attributes_.size());
+        size_t count = split_html_attributes(input_.substr(attrs_start, attrs_end - attrs_start), attributes_);
+        if (count > 255) {
+            attributes_.resize(tok.attr_begin + 255);
+            count = 255;
+        }
+        tok.level = static_cast<uint8_t>(count);
+    }
 
     return tok;
 }
 
 Token Tokenizer::scan_html_comment() {
-    SourcePosition start = current_pos_;
     size_t begin = pos_;
 
     advance(4); // skip <!--
@@ -654,10 +707,7 @@ Token Tokenizer::scan_html_comment() {
         advance();
     }
 
-    Token tok;
-    tok.type = TokenType::HtmlComment;
-    tok.text = input_.substr(begin, pos_ - begin);
-    tok.location = {start, current_pos_};
+    Token tok = make_token(TokenType::HtmlComment, begin, pos_);
 
     if (!config_.preserve_comments) {
         // Return next token instead if not preserving
@@ -673,19 +723,13 @@ Token Tokenizer::scan_nowiki() {
     // Check for self-closing <nowiki/>
     if (match("<nowiki/>")) {
         advance(9);
-        Token tok;
-        tok.type = TokenType::NoWiki;
-        tok.text = ""; // No content in self-closing tag
-        tok.location = {start, current_pos_};
-        tok.self_closing = true;
+        Token tok = make_token(TokenType::NoWiki, start.offset, pos_);
+        tok.flags = Token::SELF_CLOSING; // No content
         return tok;
     }
 
     advance(8); // skip <nowiki>
 
-    // Content starts here
-    size_t content_begin = pos_;
-
     // Find </nowiki>
     while (!at_end()) {
         if (match("</nowiki>")) {
@@ -694,40 +738,38 @@ Token Tokenizer::scan_nowiki() {
         advance();
     }
 
-    // Content ends here (before </nowiki>)
-    size_t content_end = pos_;
-
     if (match("</nowiki>")) {
         advance(9);
     }
 
-    Token tok;
-    tok.type = TokenType::NoWiki;
-    tok.text = input_.substr(content_begin, content_end - content_begin);
-    tok.location = {start, current_pos_};
-
-    return tok;
+    // The token spans the tags; Token::text() strips them again
+    return make_token(TokenType::NoWiki, start.offset, pos_);
 }
 
 Token Tokenizer::scan_magic_word() {
     SourcePosition start = current_pos_;
-    size_t begin = pos_;
 
     advance(2); // skip __
 
-    // Read word
-    while (!at_end() && (std::isalnum(static_cast<unsigned char>(current())) || current() == '_')) {
+    // Behavior switch names are upper-case letters only
+    size_t word_begin = pos_;
+    while (!at_end() && current() >= 'A' && current() <= 'Z') {
         advance();
     }
+    std::string_view word = input_.substr(word_begin, pos_ - word_begin);
 
-    // Check for closing __
-    if (match("__")) {
+    if (match("__") && lookup_behavior_switch(word)) {
         advance(2);
-        return make_token(TokenType::MagicWord, input_.substr(begin, pos_ - begin), {start, current_pos_});
+        return make_token(TokenType::MagicWord, start.offset, pos_);
     }
 
-    // Not a valid magic word, return as text
-    return make_token(TokenType::Text, input_.substr(begin, pos_ - begin), {start, current_pos_});
+    // Not a known switch, return as text
+    return make_token(TokenType::Text, start.offset, pos_);
+}
+
+bool Tokenizer::at_magic_word() const noexcept {
+    char c = peek_char(2);
+    return peek_char() == '_' && c >= 'A' && c <= 'Z';
 }
 
 // ============================================================================
@@ -739,6 +781,9 @@ void Tokenizer::advance(size_t count) {
         if (input_[pos_] == '\n') {
             current_pos_.line++;
             current_pos_.column = 1;
+            if (line_starts_.empty() || line_starts_.back() <= pos_) {
+                line_starts_.push_back(static_cast<uint32_t>(pos_ + 1));
+            }
         } else {
             current_pos_.column++;
         }
@@ -784,17 +829,20 @@ void Tokenizer::update_line_tracking() {
     at_line_start_ = true;
 }
 
-void Tokenizer::add_error(std::string message, ErrorSeverity severity) {
+void Tokenizer::add_error(ErrorCode code, ErrorSeverity severity) {
+    if (config_.error_reporting == ErrorReporting::Off) {
+        return;
+    }
+    error_counts_.add(code, severity);
+    if (config_.error_reporting == ErrorReporting::Counters) {
+        return;
+    }
+
+    // Message and context are produced by ParseError::format()
     ParseError err;
-    err.message = std::move(message);
     err.location = {current_pos_, current_pos_};
     err.severity = severity;
-
-    // Extract some context
-    size_t ctx_start = (pos_ > 20) ? pos_ - 20 : 0;
-    size_t ctx_end = std::min(pos_ + 20, input_.size());
-    err.context = std::string(input_.substr(ctx_start, ctx_end - ctx_start));
-
+    err.code = code;
     errors_.push_back(std::move(err));
 }
 
@@ -816,7 +864,7 @@ bool looks_like_wikitext(std::string_view text) noexcept {
     return false;
 }
 
-std::string tokens_to_plain_text(std::span<const Token> tokens) {
+std::string tokens_to_plain_text(std::string_view input, std::span<const Token> tokens) {
     std::string result;
     result.reserve(tokens.size() * 10); // rough estimate
 
@@ -824,7 +872,7 @@ std::string tokens_to_plain_text(std::span<const Token> tokens) {
         switch (tok.type) {
             case TokenType::Text:
             case TokenType::Whitespace:
-                result += tok.text;
+                result += tok.text(input);
                 break;
             case TokenType::Newline:
                 result += '\n';
@@ -841,7 +889,7 @@ std::string tokens_to_plain_text(std::span<const Token> tokens) {
 std::string wikitext_to_plain_text(std::string_view input) {
     Tokenizer tok(input);
     auto tokens = tok.tokenize_all();
-    return tokens_to_plain_text(tokens);
+    return tokens_to_plain_text(input, tokens);
 }
 
 std::string strip_comments(std::string_view input) {
@@ -904,9 +952,9 @@ std::string strip_comments_and_nowiki(std::string_view input) {
         if (t.type == TokenType::HtmlTagOpen) continue;  // HTML tags are stripped
         if (t.type == TokenType::HtmlTagClose) continue;
         if (t.type == TokenType::NoWiki) {
-            result += t.text;  // NoWiki content is literal (protected from interpretation)
+            result += t.text(no_comments);  // NoWiki content is literal (protected from interpretation)
         } else {
-            result += std::string(t.text);
+            result += t.text(no_comments);
         }
     }
     return result;
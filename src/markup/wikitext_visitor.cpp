@@ -498,6 +498,13 @@ void LinkExtractor::visit(const LinkNode &node) {
     ExtractedLink link;
     link.target = node.full_target();
     link.is_external = false;
+
+    // A leading colon links to the page instead of categorizing or embedding
+    std::string_view target = node.target;
+    if (target.starts_with(':')) {
+        target.remove_prefix(1);
+    }
+    link.namespace_id = namespaces_->namespace_of(target);
     link.location = node.location;
 
     if (node.has_custom_display()) {
@@ -0,0 +1,162 @@
+/**
+ * @file json_buffer.cpp
+ * @brief Implementation of the JSON output buffer
+ */
+
+#include "wikilib/output/json_buffer.h"
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+
+namespace wikilib::output {
+
+namespace {
+
+// Escape of each byte: 0 = copied as is, 'u' = \u00XX, else the letter after '\'
+constexpr std::array<char, 256> ESCAPES = [] {
+    std::array<char, 256> table{};
+    for (size_t c = 0; c < 0x20; ++c) {
+        table[c] = 'u';
+    }
+    table['"'] = '"';
+    table['\\'] = '\\';
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    return table;
+}();
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+void append_u_escape(std::string &out, uint32_t unit) {
+    char escape[6] = {'\\', 'u', HEX_DIGITS[(unit >> 12) & 0xF], HEX_DIGITS[(unit >> 8) & 0xF],
+                      HEX_DIGITS[(unit >> 4) & 0xF], HEX_DIGITS[unit & 0xF]};
+    out.append(escape, sizeof(escape));
+}
+
+} // namespace
+
+// ============================================================================
+// JsonBuffer
+// ============================================================================
+
+JsonBuffer::JsonBuffer() = default;
+
+JsonBuffer::JsonBuffer(int fd, size_t flush_threshold) : fd_(fd), flush_threshold_(flush_threshold) {
+    buffer_.reserve(flush_threshold_ + flush_threshold_ / 4);
+}
+
+JsonBuffer::JsonBuffer(std::ostream &stream, size_t flush_threshold) :
+    stream_(&stream), flush_threshold_(flush_threshold) {
+    buffer_.reserve(flush_threshold_ + flush_threshold_ / 4);
+}
+
+JsonBuffer::~JsonBuffer() {
+    flush();
+}
+
+void JsonBuffer::escaped(std::string_view text, bool escape_unicode) {
+    const auto *data = reinterpret_cast<const unsigned char *>(text.data());
+    size_t run_start = 0;
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = data[i];
+        char escape = ESCAPES[c];
+        if (escape == 0 && (c < 0x80 || !escape_unicode)) {
+            continue;
+        }
+
+        // Copy the run of plain bytes before this one in a single append
+        buffer_.append(text.data() + run_start, i - run_start);
+        if (c >= 0x80) {
+            escape_unicode_sequence(text, i);
+        } else if (escape == 'u') {
+            append_u_escape(buffer_, c);
+        } else {
+            char pair[2] = {'\\', escape};
+            buffer_.append(pair, 2);
+        }
+        run_start = i + 1;
+    }
+    buffer_.append(text.data() + run_start, text.size() - run_start);
+}
+
+void JsonBuffer::escape_unicode_sequence(std::string_view text, size_t &i) {
+    auto c = static_cast<unsigned char>(text[i]);
+    uint32_t codepoint = 0;
+    size_t remaining = 0;
+
+    if ((c & 0xE0) == 0xC0) {
+        codepoint = c & 0x1F;
+        remaining = 1;
+    } else if ((c & 0xF0) == 0xE0) {
+        codepoint = c & 0x0F;
+        remaining = 2;
+    } else if ((c & 0xF8) == 0xF0) {
+        codepoint = c & 0x07;
+        remaining = 3;
+    }
+    if (remaining == 0 || i + remaining >= text.size()) {
+        // Invalid or truncated UTF-8, pass through
+        buffer_.push_back(static_cast<char>(c));
+        return;
+    }
+
+    for (size_t j = 0; j < remaining; ++j) {
+        auto next = static_cast<unsigned char>(text[i + j + 1]);
+        if ((next & 0xC0) != 0x80) {
+            // Invalid UTF-8, pass through
+            buffer_.push_back(static_cast<char>(c));
+            return;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    i += remaining;
+
+    if (codepoint <= 0xFFFF) {
+        append_u_escape(buffer_, codepoint);
+    } else {
+        // Surrogate pair for codepoints above the BMP
+        codepoint -= 0x10000;
+        append_u_escape(buffer_, 0xD800 + ((codepoint >> 10) & 0x3FF));
+        append_u_escape(buffer_, 0xDC00 + (codepoint & 0x3FF));
+    }
+}
+
+bool JsonBuffer::flush() {
+    if (!has_sink() || buffer_.empty()) {
+        return !failed_;
+    }
+
+    if (fd_ >= 0) {
+        const char *data = buffer_.data();
+        size_t left = buffer_.size();
+        while (left > 0 && !failed_) {
+            ssize_t written = ::write(fd_, data, left);
+            if (written < 0) {
+                failed_ = errno != EINTR;
+                continue;
+            }
+            data += written;
+            left -= static_cast<size_t>(written);
+        }
+    } else {
+        stream_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        failed_ = failed_ || !*stream_;
+    }
+
+    flushed_ += buffer_.size();
+    buffer_.clear();
+    return !failed_;
+}
+
+std::string JsonBuffer::take() {
+    std::string result;
+    result.swap(buffer_);
+    return result;
+}
+
+} // namespace wikilib::output
@@ -4,14 +4,34 @@
  */
 
 #include "wikilib/output/json_writer.h"
-#include <cstdio>
+#include <array>
 #include <fstream>
-#include <iomanip>
-#include <sstream>
 #include "wikilib/markup/parser.h"
 
 namespace wikilib::output {
 
+namespace {
+
+constexpr size_t NODE_TYPE_COUNT = static_cast<size_t>(markup::NodeType::Document) + 1;
+
+/**
+ * @brief Constant "type" member of each node type, built once
+ */
+std::string_view type_field(markup::NodeType type) {
+    static const auto table = [] {
+        std::array<std::string, NODE_TYPE_COUNT> fields;
+        for (size_t i = 0; i < NODE_TYPE_COUNT; ++i) {
+            fields[i] = "\"type\": \"";
+            fields[i] += markup::node_type_name(static_cast<markup::NodeType>(i));
+            fields[i] += '"';
+        }
+        return fields;
+    }();
+    return table[static_cast<size_t>(type)];
+}
+
+} // namespace
+
 // ============================================================================
 // JsonWriter implementation
 // ============================================================================
@@ -23,9 +43,9 @@ JsonWriter::JsonWriter(std::ostream &output, JsonConfig config) : config_(std::m
 }
 
 std::string JsonWriter::write(const markup::Node &node) {
-    std::ostringstream oss;
-    write_to(node, oss);
-    return oss.str();
+    JsonBuffer out;
+    write_to(node, out);
+    return out.take();
 }
 
 std::string JsonWriter::write(const markup::DocumentNode &doc) {
@@ -33,270 +53,200 @@ std::string JsonWriter::write(const markup::DocumentNode &doc) {
 }
 
 std::string JsonWriter::write(const dump::Page &page) {
-    std::ostringstream oss;
-    write_to(page, oss);
-    return oss.str();
+    JsonBuffer out;
+    write_to(page, out);
+    return out.take();
 }
 
 void JsonWriter::write_to(const markup::Node &node, std::ostream &out) {
+    JsonBuffer buffer(out);
+    write_to(node, buffer);
+}
+
+void JsonWriter::write_to(const dump::Page &page, std::ostream &out) {
+    JsonBuffer buffer(out);
+    write_to(page, buffer);
+}
+
+void JsonWriter::write_to(const markup::Node &node, JsonBuffer &out) {
     depth_ = 0;
     write_node(node, out);
 }
 
-void JsonWriter::write_to(const dump::Page &page, std::ostream &out) {
+void JsonWriter::write_to(const dump::Page &page, JsonBuffer &out) {
     depth_ = 0;
+    write_page(page, out);
+}
 
-    out << '{';
-    write_newline(out);
-    depth_++;
+bool JsonWriter::write_to_fd(const markup::Node &node, int fd) {
+    JsonBuffer out(fd);
+    write_to(node, out);
+    return out.flush();
+}
 
-    // Page info
-    write_indent(out);
-    out << "\"id\": " << page.info.id << ',';
-    write_newline(out);
+void JsonWriter::write_page(const dump::Page &page, JsonBuffer &out) {
+    open('{', out);
 
+    // Page info
     write_indent(out);
-    out << "\"title\": ";
+    out.raw(R"("id": )");
+    out.number(page.info.id);
+    write_key(R"("title": )", out);
     write_value(page.info.title, out);
-    out << ',';
-    write_newline(out);
-
-    write_indent(out);
-    out << "\"namespace\": " << page.info.namespace_id << ',';
-    write_newline(out);
-
-    write_indent(out);
-    out << "\"redirect\": ";
+    write_key(R"("namespace": )", out);
+    out.number(page.info.namespace_id);
+    write_key(R"("redirect": )", out);
     if (page.info.redirect_target.has_value()) {
         write_value(*page.info.redirect_target, out);
     } else {
-        out << "null";
+        out.null();
     }
-    out << ',';
-    write_newline(out);
 
     // Revisions
-    write_indent(out);
-    out << "\"revisions\": [";
-    write_newline(out);
-    depth_++;
+    write_key(R"("revisions": )", out);
+    open('[', out);
 
     bool first_rev = true;
     for (const auto &rev: page.revisions) {
         if (!first_rev) {
-            out << ',';
+            out.put(',');
             write_newline(out);
         }
         first_rev = false;
 
         write_indent(out);
-        out << '{';
-        write_newline(out);
-        depth_++;
+        open('{', out);
 
         write_indent(out);
-        out << "\"id\": " << rev.id << ',';
-        write_newline(out);
-
+        out.raw(R"("id": )");
+        out.number(rev.id);
         if (rev.parent_id != 0) {
-            write_indent(out);
-            out << "\"parent_id\": " << rev.parent_id << ',';
-            write_newline(out);
+            write_key(R"("parent_id": )", out);
+            out.number(rev.parent_id);
         }
-
-        write_indent(out);
-        out << "\"timestamp\": ";
+        write_key(R"("timestamp": )", out);
         write_value(rev.timestamp, out);
-        out << ',';
-        write_newline(out);
-
-        write_indent(out);
-        out << "\"contributor\": ";
+        write_key(R"("contributor": )", out);
         write_value(rev.contributor, out);
-        out << ',';
-        write_newline(out);
-
         if (!rev.comment.empty()) {
-            write_indent(out);
-            out << "\"comment\": ";
+            write_key(R"("comment": )", out);
             write_value(rev.comment, out);
-            out << ',';
-            write_newline(out);
         }
-
-        write_indent(out);
-        out << "\"model\": ";
+        write_key(R"("model": )", out);
         write_value(rev.model, out);
-        out << ',';
-        write_newline(out);
-
-        write_indent(out);
-        out << "\"format\": ";
+        write_key(R"("format": )", out);
         write_value(rev.format, out);
-        out << ',';
-        write_newline(out);
-
         if (config_.include_raw_text) {
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("content": )", out);
             write_value(rev.content, out);
-            out << ',';
-            write_newline(out);
         }
-
         if (!rev.sha1.empty()) {
-            write_indent(out);
-            out << "\"sha1\": ";
+            write_key(R"("sha1": )", out);
             write_value(rev.sha1, out);
         }
 
-        write_newline(out);
-        depth_--;
-        write_indent(out);
-        out << '}';
+        close('}', out);
+        out.maybe_flush();
     }
 
+    close(']', out);
     write_newline(out);
     depth_--;
-    write_indent(out);
-    out << ']';
-    write_newline(out);
-
-    depth_--;
-    out << '}';
+    out.put('}');
 }
 
 void JsonWriter::begin_array() {
     if (output_) {
-        *output_ << '[';
-        write_newline(*output_);
-        depth_++;
+        array_buffer_ = std::make_unique<JsonBuffer>(*output_);
+        open('[', *array_buffer_);
         first_item_ = true;
     }
 }
 
 void JsonWriter::write_array_item(const dump::Page &page) {
-    if (output_) {
+    if (array_buffer_) {
         if (!first_item_) {
-            *output_ << ',';
-            write_newline(*output_);
+            array_buffer_->put(',');
+            write_newline(*array_buffer_);
         }
         first_item_ = false;
 
-        write_indent(*output_);
-        write_to(page, *output_);
+        write_indent(*array_buffer_);
+        write_page(page, *array_buffer_);
+        array_buffer_->maybe_flush();
     }
 }
 
 void JsonWriter::write_array_item(const markup::DocumentNode &doc) {
-    if (output_) {
+    if (array_buffer_) {
         if (!first_item_) {
-            *output_ << ',';
-            write_newline(*output_);
+            array_buffer_->put(',');
+            write_newline(*array_buffer_);
         }
         first_item_ = false;
 
-        write_indent(*output_);
-        write_to(doc, *output_);
+        write_indent(*array_buffer_);
+        write_node(doc, *array_buffer_);
     }
 }
 
 void JsonWriter::end_array() {
-    if (output_) {
-        write_newline(*output_);
-        depth_--;
-        write_indent(*output_);
-        *output_ << ']';
+    if (array_buffer_) {
+        close(']', *array_buffer_);
+        array_buffer_.reset(); // Flushes the rest
     }
 }
 
-void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
+void JsonWriter::write_node(const markup::Node &node, JsonBuffer &out) {
     using namespace markup;
 
-    out << '{';
-    write_newline(out);
-    depth_++;
-
-    // Type field
+    open('{', out);
     write_indent(out);
-    out << "\"type\": ";
-    write_value(node_type_name(node.type), out);
+    out.raw(type_field(node.type));
 
     // Source location (optional)
     if (config_.include_source_locations) {
-        out << ',';
-        write_newline(out);
-        write_indent(out);
-        out << "\"location\": {";
-        write_newline(out);
-        depth_++;
-        write_indent(out);
-        out << "\"start\": " << node.location.begin.offset << ',';
-        write_newline(out);
-        write_indent(out);
-        out << "\"end\": " << node.location.end.offset;
-        write_newline(out);
-        depth_--;
-        write_indent(out);
-        out << '}';
+        write_location(node.location.begin.offset, node.location.end.offset, out);
     }
 
     // Node-specific fields
     switch (node.type) {
         case NodeType::Text: {
             const auto &text_node = static_cast<const TextNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"text\": ";
+            write_key(R"("text": )", out);
             write_value(text_node.text, out);
             break;
         }
 
         case NodeType::Formatting: {
             const auto &fmt = static_cast<const FormattingNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"style\": ";
+            write_key(R"("style": )", out);
             switch (fmt.style) {
                 case FormattingNode::Style::Bold:
-                    write_value("bold", out);
+                    out.raw(R"("bold")");
                     break;
                 case FormattingNode::Style::Italic:
-                    write_value("italic", out);
+                    out.raw(R"("italic")");
                     break;
                 case FormattingNode::Style::BoldItalic:
-                    write_value("bold_italic", out);
+                    out.raw(R"("bold_italic")");
                     break;
             }
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("content": )", out);
             write_children(fmt.content, out);
             break;
         }
 
         case NodeType::Link: {
             const auto &link = static_cast<const LinkNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"target\": ";
+            write_key(R"("target": )", out);
             write_value(link.target, out);
             if (!link.anchor.empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"anchor\": ";
+                write_key(R"("anchor": )", out);
                 write_value(link.anchor, out);
             }
             if (!link.display_content.empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"display\": ";
+                write_key(R"("display": )", out);
                 write_children(link.display_content, out);
             }
             break;
@@ -304,16 +254,10 @@ void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
 
         case NodeType::ExternalLink: {
             const auto &link = static_cast<const ExternalLinkNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"url\": ";
+            write_key(R"("url": )", out);
             write_value(link.url, out);
             if (!link.display_content.empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"display\": ";
+                write_key(R"("display": )", out);
                 write_children(link.display_content, out);
             }
             break;
@@ -321,72 +265,45 @@ void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
 
         case NodeType::Template: {
             const auto &tmpl = static_cast<const TemplateNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"name\": ";
+            write_key(R"("name": )", out);
             write_value(tmpl.name, out);
             if (!tmpl.parameters.empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"parameters\": [";
-                write_newline(out);
-                depth_++;
+                write_key(R"("parameters": )", out);
+                open('[', out);
 
                 bool first = true;
                 for (const auto &param: tmpl.parameters) {
                     if (!first) {
-                        out << ',';
+                        out.put(',');
                         write_newline(out);
                     }
                     first = false;
 
                     write_indent(out);
-                    out << '{';
-                    write_newline(out);
-                    depth_++;
-
+                    open('{', out);
                     write_indent(out);
-                    out << "\"name\": ";
+                    out.raw(R"("name": )");
                     if (param.name.has_value()) {
                         write_value(*param.name, out);
                     } else {
-                        out << "null";
+                        out.null();
                     }
-                    out << ',';
-                    write_newline(out);
-
-                    write_indent(out);
-                    out << "\"value\": ";
+                    write_key(R"("value": )", out);
                     write_children(param.value, out);
-
-                    write_newline(out);
-                    depth_--;
-                    write_indent(out);
-                    out << '}';
+                    close('}', out);
                 }
 
-                write_newline(out);
-                depth_--;
-                write_indent(out);
-                out << ']';
+                close(']', out);
             }
             break;
         }
 
         case NodeType::Parameter: {
             const auto &param = static_cast<const ParameterNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"name\": ";
+            write_key(R"("name": )", out);
             write_value(param.name, out);
             if (!param.default_value.empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"default\": ";
+                write_key(R"("default": )", out);
                 write_children(param.default_value, out);
             }
             break;
@@ -394,75 +311,51 @@ void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
 
         case NodeType::Heading: {
             const auto &heading = static_cast<const HeadingNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"level\": " << heading.level << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("level": )", out);
+            out.number(heading.level);
+            write_key(R"("content": )", out);
             write_children(heading.content, out);
             break;
         }
 
         case NodeType::List: {
             const auto &list = static_cast<const ListNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"list_type\": ";
+            write_key(R"("list_type": )", out);
             switch (list.list_type) {
                 case ListNode::ListType::Bullet:
-                    write_value("bullet", out);
+                    out.raw(R"("bullet")");
                     break;
                 case ListNode::ListType::Numbered:
-                    write_value("numbered", out);
+                    out.raw(R"("numbered")");
                     break;
                 case ListNode::ListType::Definition:
-                    write_value("definition", out);
+                    out.raw(R"("definition")");
                     break;
             }
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"items\": ";
+            write_key(R"("items": )", out);
             write_children(list.items, out);
             break;
         }
 
         case NodeType::ListItem: {
             const auto &item = static_cast<const ListItemNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"depth\": " << item.depth << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"is_definition_term\": " << (item.is_definition_term ? "true" : "false") << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("depth": )", out);
+            out.number(item.depth);
+            write_key(R"("is_definition_term": )", out);
+            out.boolean(item.is_definition_term);
+            write_key(R"("content": )", out);
             write_children(item.content, out);
             break;
         }
 
         case NodeType::Table: {
             const auto &table = static_cast<const TableNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"attributes\": ";
+            write_key(R"("attributes": )", out);
             write_value(table.attributes, out);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"rows\": ";
+            write_key(R"("rows": )", out);
             write_children(table.rows, out);
             if (table.caption.has_value()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"caption\": ";
+                write_key(R"("caption": )", out);
                 write_value(*table.caption, out);
             }
             break;
@@ -470,80 +363,52 @@ void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
 
         case NodeType::TableRow: {
             const auto &row = static_cast<const TableRowNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"attributes\": ";
+            write_key(R"("attributes": )", out);
             write_value(row.attributes, out);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"cells\": ";
+            write_key(R"("cells": )", out);
             write_children(row.cells, out);
             break;
         }
 
         case NodeType::TableCell: {
             const auto &cell = static_cast<const TableCellNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"is_header\": " << (cell.is_header ? "true" : "false") << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"attributes\": ";
+            write_key(R"("is_header": )", out);
+            out.boolean(cell.is_header);
+            write_key(R"("attributes": )", out);
             write_value(cell.attributes, out);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("content": )", out);
             write_children(cell.content, out);
             break;
         }
 
         case NodeType::HtmlTag: {
             const auto &tag = static_cast<const HtmlTagNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"tag_name\": ";
+            write_key(R"("tag_name": )", out);
             write_value(tag.tag_name, out);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"self_closing\": " << (tag.self_closing ? "true" : "false");
+            write_key(R"("self_closing": )", out);
+            out.boolean(tag.self_closing);
             if (!tag.attributes.empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"attributes\": {";
-                write_newline(out);
-                depth_++;
+                write_key(R"("attributes": )", out);
+                open('{', out);
 
                 bool first = true;
                 for (const auto &[key, value]: tag.attributes) {
                     if (!first) {
-                        out << ',';
+                        out.put(',');
                         write_newline(out);
                     }
                     first = false;
 
                     write_indent(out);
                     write_value(key, out);
-                    out << ": ";
+                    out.raw(": ");
                     write_value(value, out);
                 }
 
-                write_newline(out);
-                depth_--;
-                write_indent(out);
-                out << '}';
+                close('}', out);
             }
             if (!tag.content.empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"content\": ";
+                write_key(R"("content": )", out);
                 write_children(tag.content, out);
             }
             break;
@@ -551,36 +416,24 @@ void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
 
         case NodeType::Comment: {
             const auto &comment = static_cast<const CommentNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("content": )", out);
             write_value(comment.content, out);
             break;
         }
 
         case NodeType::NoWiki: {
             const auto &nowiki = static_cast<const NoWikiNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("content": )", out);
             write_value(nowiki.content, out);
             break;
         }
 
         case NodeType::Category: {
             const auto &cat = static_cast<const CategoryNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"category\": ";
+            write_key(R"("category": )", out);
             write_value(cat.category, out);
             if (!cat.sort_key.empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"sort_key\": ";
+                write_key(R"("sort_key": )", out);
                 write_value(cat.sort_key, out);
             }
             break;
@@ -588,30 +441,21 @@ void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
 
         case NodeType::Redirect: {
             const auto &redirect = static_cast<const RedirectNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"target\": ";
+            write_key(R"("target": )", out);
             write_value(redirect.target, out);
             break;
         }
 
         case NodeType::MagicWord: {
             const auto &magic = static_cast<const MagicWordNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"word\": ";
+            write_key(R"("word": )", out);
             write_value(magic.word, out);
             break;
         }
 
         case NodeType::Paragraph: {
             const auto &para = static_cast<const ParagraphNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("content": )", out);
             write_children(para.content, out);
             break;
         }
@@ -623,10 +467,7 @@ void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
 
         case NodeType::Document: {
             const auto &doc = static_cast<const DocumentNode &>(node);
-            out << ',';
-            write_newline(out);
-            write_indent(out);
-            out << "\"content\": ";
+            write_key(R"("content": )", out);
             write_children(doc.content, out);
             break;
         }
@@ -634,170 +475,129 @@ void JsonWriter::write_node(const markup::Node &node, std::ostream &out) {
         default:
             // Unknown node type - include children if any
             if (!node.children().empty()) {
-                out << ',';
-                write_newline(out);
-                write_indent(out);
-                out << "\"children\": ";
+                write_key(R"("children": )", out);
                 write_children(node.children(), out);
             }
             break;
     }
 
-    write_newline(out);
-    depth_--;
-    write_indent(out);
-    out << '}';
+    close('}', out);
+    out.maybe_flush();
 }
 
-void JsonWriter::write_value(std::string_view str, std::ostream &out) {
-    out << '"' << escape_string(str) << '"';
-}
+void JsonWriter::write_text_run(std::span<const std::unique_ptr<markup::Node>> run, JsonBuffer &out) {
+    if (run.size() == 1) {
+        write_node(*run.front(), out);
+        return;
+    }
 
-void JsonWriter::write_indent(std::ostream &out) {
-    if (config_.pretty_print) {
-        for (int i = 0; i < depth_ * config_.indent_size; ++i) {
-            out << ' ';
-        }
+    // One text node whose value is escaped piece by piece
+    open('{', out);
+    write_indent(out);
+    out.raw(type_field(markup::NodeType::Text));
+    if (config_.include_source_locations) {
+        write_location(run.front()->location.begin.offset, run.back()->location.end.offset, out);
+    }
+    write_key(R"("text": )", out);
+    out.put('"');
+    for (const auto &node: run) {
+        out.escaped(static_cast<const markup::TextNode &>(*node).text, config_.escape_unicode);
     }
+    out.put('"');
+    close('}', out);
+    out.maybe_flush();
 }
 
-void JsonWriter::write_newline(std::ostream &out) {
-    if (config_.pretty_print) {
-        out << '\n';
-    }
+void JsonWriter::write_location(size_t begin, size_t end, JsonBuffer &out) {
+    write_key(R"("location": )", out);
+    open('{', out);
+    write_indent(out);
+    out.raw(R"("start": )");
+    out.number(begin);
+    write_key(R"("end": )", out);
+    out.number(end);
+    close('}', out);
 }
 
-std::string JsonWriter::escape_string(std::string_view str) {
-    std::string result;
-    result.reserve(str.size() + str.size() / 8); // Allow for some escaping
-
-    for (size_t i = 0; i < str.size(); ++i) {
-        unsigned char c = static_cast<unsigned char>(str[i]);
-
-        switch (c) {
-            case '"':
-                result += "\\\"";
-                break;
-            case '\\':
-                result += "\\\\";
-                break;
-            case '\b':
-                result += "\\b";
-                break;
-            case '\f':
-                result += "\\f";
-                break;
-            case '\n':
-                result += "\\n";
-                break;
-            case '\r':
-                result += "\\r";
-                break;
-            case '\t':
-                result += "\\t";
-                break;
-            default:
-                if (c < 0x20) {
-                    // Control character - escape as \u00XX
-                    char buf[8];
-                    snprintf(buf, sizeof(buf), "\\u%04x", c);
-                    result += buf;
-                } else if (config_.escape_unicode && c > 0x7F) {
-                    // Non-ASCII character - escape as \uXXXX
-                    // Handle UTF-8 sequences
-                    uint32_t codepoint = 0;
-                    int remaining = 0;
-
-                    if ((c & 0xE0) == 0xC0) {
-                        codepoint = c & 0x1F;
-                        remaining = 1;
-                    } else if ((c & 0xF0) == 0xE0) {
-                        codepoint = c & 0x0F;
-                        remaining = 2;
-                    } else if ((c & 0xF8) == 0xF0) {
-                        codepoint = c & 0x07;
-                        remaining = 3;
-                    } else {
-                        // Invalid UTF-8 start byte, just pass through
-                        result += static_cast<char>(c);
-                        continue;
-                    }
+void JsonWriter::write_value(std::string_view str, JsonBuffer &out) {
+    out.string(str, config_.escape_unicode);
+}
 
-                    bool valid = true;
-                    for (int j = 0; j < remaining && i + j + 1 < str.size(); ++j) {
-                        unsigned char next = static_cast<unsigned char>(str[i + j + 1]);
-                        if ((next & 0xC0) != 0x80) {
-                            valid = false;
-                            break;
-                        }
-                        codepoint = (codepoint << 6) | (next & 0x3F);
-                    }
+void JsonWriter::write_key(std::string_view key, JsonBuffer &out) {
+    out.put(',');
+    write_newline(out);
+    write_indent(out);
+    out.raw(key);
+}
 
-                    if (valid) {
-                        i += remaining;
-                        if (codepoint <= 0xFFFF) {
-                            char buf[8];
-                            snprintf(buf, sizeof(buf), "\\u%04x", codepoint);
-                            result += buf;
-                        } else {
-                            // Surrogate pair for codepoints > 0xFFFF
-                            codepoint -= 0x10000;
-                            uint16_t high = 0xD800 + ((codepoint >> 10) & 0x3FF);
-                            uint16_t low = 0xDC00 + (codepoint & 0x3FF);
-                            char buf[16];
-                            snprintf(buf, sizeof(buf), "\\u%04x\\u%04x", high, low);
-                            result += buf;
-                        }
-                    } else {
-                        // Invalid UTF-8, pass through
-                        result += static_cast<char>(c);
-                    }
-                } else {
-                    result += static_cast<char>(c);
-                }
-                break;
-        }
+void JsonWriter::write_indent(JsonBuffer &out) {
+    if (config_.pretty_print && depth_ > 0) {
+        out.spaces(static_cast<size_t>(depth_ * config_.indent_size));
     }
+}
 
-    return result;
+void JsonWriter::write_newline(JsonBuffer &out) {
+    if (config_.pretty_print) {
+        out.put('\n');
+    }
 }
 
-// Private helper methods for writing children
-void JsonWriter::write_children(const std::vector<std::unique_ptr<markup::Node>> &children, std::ostream &out) {
-    out << '[';
+void JsonWriter::open(char bracket, JsonBuffer &out) {
+    out.put(bracket);
     write_newline(out);
     depth_++;
+}
+
+void JsonWriter::close(char bracket, JsonBuffer &out) {
+    write_newline(out);
+    depth_--;
+    write_indent(out);
+    out.put(bracket);
+}
+
+void JsonWriter::write_children(const std::vector<std::unique_ptr<markup::Node>> &children, JsonBuffer &out) {
+    open('[', out);
 
     bool first = true;
-    for (const auto &child: children) {
-        if (!child)
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (!children[i]) {
             continue;
+        }
 
         if (!first) {
-            out << ',';
+            out.put(',');
             write_newline(out);
         }
         first = false;
-
         write_indent(out);
-        write_node(*child, out);
+
+        if (config_.compact_text_nodes && children[i]->type == markup::NodeType::Text) {
+            size_t end = i + 1;
+            while (end < children.size() && children[end] && children[end]->type == markup::NodeType::Text) {
+                end++;
+            }
+            write_text_run(std::span(children).subspan(i, end - i), out);
+            i = end - 1;
+        } else {
+            write_node(*children[i], out);
+        }
     }
 
-    write_newline(out);
-    depth_--;
-    write_indent(out);
-    out << ']';
+    close(']', out);
 }
 
 // ============================================================================
 // JsonLinesWriter implementation
 // ============================================================================
 
-JsonLinesWriter::JsonLinesWriter(std::ostream &output) : owned_output_(nullptr), output_(&output) {
+// JSONL requires single-line JSON
+JsonLinesWriter::JsonLinesWriter(std::ostream &output) :
+    owned_output_(nullptr), output_(&output), writer_(JsonConfig{.pretty_print = false}), buffer_(*output_) {
 }
 
 JsonLinesWriter::JsonLinesWriter(const std::string &path) :
-    owned_output_(std::make_unique<std::ofstream>(path)), output_(owned_output_.get()) {
+    owned_output_(std::make_unique<std::ofstream>(path)), output_(owned_output_.get()),
+    writer_(JsonConfig{.pretty_print = false}), buffer_(*output_) {
 }
 
 JsonLinesWriter::~JsonLinesWriter() {
@@ -808,11 +608,9 @@ void JsonLinesWriter::write(const dump::Page &page) {
     if (!output_)
         return;
 
-    JsonConfig config;
-    config.pretty_print = false; // JSONL requires single-line JSON
-
-    JsonWriter writer(config);
-    *output_ << writer.write(page) << '\n';
+    writer_.write_to(page, buffer_);
+    buffer_.put('\n');
+    buffer_.maybe_flush();
     ++count_;
 }
 
@@ -820,13 +618,15 @@ void JsonLinesWriter::write(const dump::Page &page, TransformFunc transform) {
     if (!output_ || !transform)
         return;
 
-    std::string json = transform(page);
-    *output_ << json << '\n';
+    buffer_.raw(transform(page));
+    buffer_.put('\n');
+    buffer_.maybe_flush();
     ++count_;
 }
 
 void JsonLinesWriter::flush() {
     if (output_) {
+        buffer_.flush();
         output_->flush();
     }
 }
@@ -204,9 +204,9 @@ void PlainTextConverter::process_node(const markup::Node &node, std::string &out
         case NodeType::HtmlTag: {
             const auto &tag = static_cast<const HtmlTagNode &>(node);
             // Handle some specific tags
-            if (tag.tag_name == "br") {
+            if (tag.tag_id == markup::HtmlTagId::Br) {
                 output += '\n';
-            } else if (tag.tag_name == "p") {
+            } else if (tag.tag_id == markup::HtmlTagId::P) {
                 add_paragraph_break(output);
                 process_children(node, output);
                 add_paragraph_break(output);
@@ -0,0 +1,60 @@
+/**
+ * @file citation_extractor.cpp
+ * @brief Implementation of citation extraction from <ref> bodies
+ */
+
+#include "wikilib/templates/citation_extractor.h"
+#include <cstdint>
+
+namespace wikilib::templates {
+
+namespace {
+
+std::vector<SelectorRule> make_rules(std::vector<std::string> fields, std::vector<std::string> templates) {
+    std::vector<SelectorRule> rules;
+    rules.reserve(templates.size());
+    for (auto &name: templates) {
+        rules.push_back({std::move(name), fields});
+    }
+    return rules;
+}
+
+} // namespace
+
+CitationExtractor::CitationExtractor(std::vector<std::string> fields, std::vector<std::string> templates) :
+    selector_(make_rules(std::move(fields), std::move(templates))) {
+}
+
+void CitationExtractor::extract(std::string_view wikitext, std::vector<markup::RefSpan> &refs,
+                                std::vector<Citation> &citations) const {
+    markup::collect_refs(wikitext, refs);
+    citations.clear();
+
+    std::vector<SelectedArgument> args;
+    std::vector<size_t> by_invocation; // Invocation ordinal -> citation index
+    for (size_t r = 0; r < refs.size(); ++r) {
+        if (refs[r].body.empty()) {
+            continue;
+        }
+
+        selector_.select(refs[r].body, args);
+
+        // One citation per invocation; nested cites interleave their arguments
+        by_invocation.clear();
+        for (const auto &arg: args) {
+            if (arg.name.empty()) {
+                continue;
+            }
+            if (arg.invocation >= by_invocation.size()) {
+                by_invocation.resize(arg.invocation + 1, SIZE_MAX);
+            }
+            if (by_invocation[arg.invocation] == SIZE_MAX) {
+                by_invocation[arg.invocation] = citations.size();
+                citations.push_back({r, arg.template_name, {}});
+            }
+            citations[by_invocation[arg.invocation]].fields.emplace_back(arg.name, arg.value);
+        }
+    }
+}
+
+} // namespace wikilib::templates
@@ -11,6 +11,8 @@
 #include <iomanip>
 #include <sstream>
 #include <stack>
+#include "wikilib/core/text_utils.hpp"
+#include "wikilib/core/unicode_utils.h"
 #include "wikilib/templates/template_parser.h"
 
 namespace wikilib::templates {
@@ -59,8 +61,52 @@ std::optional<std::string_view> ExpansionContext::get_param(std::string_view nam
 // TemplateExpander implementation
 // ============================================================================
 
+namespace {
+
+// MediaWiki spelling of a title short of case: trimmed, '_' as ' ', runs of
+// spaces collapsed and any #fragment dropped
+std::string clean_title(std::string_view title) {
+    std::string result(title);
+    std::replace(result.begin(), result.end(), '_', ' ');
+    result = text::collapse_whitespace(result);
+    std::string_view view = result;
+    if (size_t hash = view.find('#'); hash != std::string_view::npos) {
+        view = view.substr(0, hash);
+    }
+    return std::string(text::trim(view));
+}
+
+} // namespace
+
 TemplateExpander::TemplateExpander(std::shared_ptr<TemplateProvider> provider, ExpanderConfig config) :
-    provider_(std::move(provider)), config_(std::move(config)) {
+    provider_(std::move(provider)), config_(std::move(config)),
+    namespaces_(config_.namespaces.empty() ? NamespaceResolver::builtin() : NamespaceResolver(config_.namespaces)) {
+}
+
+// Probe the filter with the title as written and as the dump spells it:
+// the prefix mapped to the site's local namespace name and, on wikis with
+// capital links, the first letter of the local part upper-cased. Either hit
+// lets the provider decide.
+bool TemplateExpander::title_may_exist(std::string_view title) const {
+    const BloomFilter &filter = *config_.existing_titles;
+    if (filter.may_contain(title)) {
+        return true;
+    }
+
+    std::string cleaned = clean_title(title);
+    ResolvedTitle resolved = namespaces_.resolve(cleaned);
+    std::string local = config_.capital_links ? unicode::capitalize_first(resolved.local) : std::string(resolved.local);
+
+    std::string candidate;
+    if (resolved.namespace_id != NS_MAIN) {
+        auto ns = std::find_if(config_.namespaces.begin(), config_.namespaces.end(),
+                               [&](const Namespace &n) { return n.id == resolved.namespace_id; });
+        candidate = ns != config_.namespaces.end() ? ns->name
+                                                   : std::string(canonical_namespace_name(resolved.namespace_id));
+        candidate += ':';
+    }
+    candidate += local;
+    return candidate != title && filter.may_contain(candidate);
 }
 
 Result<std::string> TemplateExpander::expand(std::string_view input, const PageInfo &page) {
@@ -195,7 +241,8 @@ Result<std::string> TemplateExpander::evaluate_parser_function(ParserFunction fu
         case ParserFunction::Ifexist:
             if (args.empty())
                 return "";
-            if (provider_->template_exists(args[0])) {
+            if ((!config_.existing_titles || title_may_exist(args[0])) &&
+                provider_->template_exists(args[0])) {
                 return args.size() > 1 ? args[1] : "";
             }
             return args.size() > 2 ? args[2] : "";
@@ -0,0 +1,299 @@
+/**
+ * @file template_selector.cpp
+ * @brief Implementation of compiled template argument selectors
+ */
+
+#include "wikilib/templates/template_selector.h"
+#include <array>
+#include <charconv>
+#include <optional>
+#include "wikilib/core/text_utils.hpp"
+
+namespace wikilib::templates {
+
+namespace {
+
+constexpr size_t MAX_NAME_LENGTH = 256;
+
+bool is_name_space(char c) noexcept {
+    return c == ' ' || c == '_' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Normalize into buf; nullopt if the result does not fit
+std::optional<size_t> normalize_into(std::string_view name, char *buf, size_t capacity) noexcept {
+    auto trim_name = [](std::string_view s) {
+        while (!s.empty() && is_name_space(s.front())) {
+            s.remove_prefix(1);
+        }
+        while (!s.empty() && is_name_space(s.back())) {
+            s.remove_suffix(1);
+        }
+        return s;
+    };
+
+    name = trim_name(name);
+    if (text::starts_with_ignore_case_ascii(name, "template:")) {
+        name = trim_name(name.substr(9));
+    }
+
+    size_t len = 0;
+    bool in_space = false;
+    for (char c: name) {
+        if (is_name_space(c)) {
+            in_space = true;
+            continue;
+        }
+        if (len + (in_space ? 2 : 1) > capacity) {
+            return std::nullopt;
+        }
+        if (in_space) {
+            buf[len++] = ' ';
+            in_space = false;
+        }
+        buf[len++] = c;
+    }
+
+    if (len > 0 && buf[0] >= 'a' && buf[0] <= 'z') {
+        buf[0] = static_cast<char>(buf[0] - 'a' + 'A');
+    }
+    return len;
+}
+
+} // namespace
+
+std::string normalize_template_name(std::string_view name) {
+    std::string result(name.size(), '\0');
+    auto len = normalize_into(name, result.data(), result.size());
+    result.resize(len.value_or(0));
+    return result;
+}
+
+// ============================================================================
+// TemplateSelector implementation
+// ============================================================================
+
+TemplateSelector::TemplateSelector(std::vector<SelectorRule> rules) : rules_(std::move(rules)) {
+    compiled_.resize(rules_.size());
+
+    for (size_t r = 0; r < rules_.size(); ++r) {
+        const auto &rule = rules_[r];
+        auto &compiled = compiled_[r];
+
+        compiled.all = rule.parameters.empty();
+        for (const auto &param: rule.parameters) {
+            size_t position = 0;
+            auto [ptr, ec] = std::from_chars(param.data(), param.data() + param.size(), position);
+            if (ec != std::errc() || ptr != param.data() + param.size()) {
+                position = 0;
+            }
+            compiled.positional.push_back(position);
+        }
+
+        std::string_view pattern = rule.template_name;
+        if (pattern.ends_with('*')) {
+            pattern.remove_suffix(1);
+            // Keep trailing space of "Infobox *" significant after normalization
+            bool spaced = !pattern.empty() && is_name_space(pattern.back());
+            std::string prefix = normalize_template_name(pattern);
+            if (spaced && !prefix.empty()) {
+                prefix += ' ';
+            }
+            prefixes_.emplace_back(std::move(prefix), r);
+        } else {
+            exact_[normalize_template_name(pattern)].push_back(r);
+        }
+    }
+}
+
+void TemplateSelector::match_rules(std::string_view normalized, std::vector<size_t> &matches) const {
+    if (auto it = exact_.find(normalized); it != exact_.end()) {
+        matches.insert(matches.end(), it->second.begin(), it->second.end());
+    }
+    for (const auto &[prefix, rule]: prefixes_) {
+        if (normalized.starts_with(prefix)) {
+            matches.push_back(rule);
+        }
+    }
+}
+
+void TemplateSelector::select(std::string_view wikitext, std::vector<SelectedArgument> &out) const {
+    out.clear();
+
+    std::array<char, MAX_NAME_LENGTH> buf;
+    std::vector<size_t> matches;
+    size_t invocation = 0;
+    size_t pos = 0;
+
+    while (true) {
+        size_t start = wikitext.find("{{", pos);
+        if (start == std::string_view::npos) {
+            break;
+        }
+        pos = start + 2;
+
+        // {{{parameter}}} is not an invocation
+        if (pos < wikitext.size() && wikitext[pos] == '{') {
+            pos = start + 3;
+            continue;
+        }
+
+        // Name runs to the first '|' or '}'; a nested '{' means a computed name
+        size_t name_end = wikitext.find_first_of("|{}", pos);
+        if (name_end == std::string_view::npos) {
+            break;
+        }
+        if (wikitext[name_end] == '{') {
+            continue;
+        }
+
+        std::string_view raw_name = wikitext.substr(pos, name_end - pos);
+        auto len = normalize_into(raw_name, buf.data(), buf.size());
+        if (!len) {
+            continue;
+        }
+
+        matches.clear();
+        match_rules(std::string_view(buf.data(), *len), matches);
+        if (matches.empty()) {
+            continue;
+        }
+
+        // Keep scanning from inside, so selected templates nested in
+        // arguments are found as well
+        extract(wikitext, name_end, text::trim(raw_name), matches, invocation++, out);
+    }
+}
+
+std::vector<SelectedArgument> TemplateSelector::select(std::string_view wikitext) const {
+    std::vector<SelectedArgument> out;
+    select(wikitext, out);
+    return out;
+}
+
+void TemplateSelector::select_all(std::span<const std::string_view> texts,
+                                  std::vector<std::vector<SelectedArgument>> &out, ThreadPool &pool) const {
+    out.resize(texts.size());
+    parallel_for(pool, 0, texts.size(), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            select(texts[i], out[i]);
+        }
+    });
+}
+
+void TemplateSelector::extract(std::string_view wikitext, size_t begin, std::string_view name,
+                               const std::vector<size_t> &rules, size_t invocation,
+                               std::vector<SelectedArgument> &out) const {
+    if (wikitext[begin] != '|') {
+        return; // {{Name}} without arguments
+    }
+
+    const size_t saved = out.size();
+    size_t positional = 0;
+
+    auto emit = [&](size_t arg_begin, size_t arg_end, size_t eq) {
+        SelectedArgument arg;
+        arg.invocation = invocation;
+        arg.template_name = name;
+        size_t position = 0;
+        if (eq != std::string_view::npos) {
+            arg.name = text::trim(wikitext.substr(arg_begin, eq - arg_begin));
+            arg.value = text::trim(wikitext.substr(eq + 1, arg_end - eq - 1));
+        } else {
+            position = ++positional;
+            arg.value = text::trim(wikitext.substr(arg_begin, arg_end - arg_begin));
+        }
+
+        for (size_t r: rules) {
+            arg.rule = r;
+            const auto &compiled = compiled_[r];
+            if (compiled.all) {
+                arg.parameter = 0;
+                out.push_back(arg);
+                continue;
+            }
+            const auto &params = rules_[r].parameters;
+            for (size_t k = 0; k < params.size(); ++k) {
+                bool hit = eq != std::string_view::npos ? arg.name == params[k]
+                                                        : compiled.positional[k] == position;
+                if (hit) {
+                    arg.parameter = k;
+                    out.push_back(arg);
+                }
+            }
+        }
+    };
+
+    // Open brace groups: 2 = template, 3 = parameter; bottom is this invocation
+    std::vector<uint8_t> braces{2};
+    int links = 0;
+    size_t arg_begin = begin + 1;
+    size_t eq = std::string_view::npos;
+    size_t i = begin + 1;
+
+    while (i < wikitext.size()) {
+        char c = wikitext[i];
+
+        if (c == '<' && wikitext.substr(i, 4) == "<!--") {
+            size_t close = wikitext.find("-->", i + 4);
+            i = close == std::string_view::npos ? wikitext.size() : close + 3;
+            continue;
+        }
+
+        if (c == '{' || c == '}') {
+            size_t run = 1;
+            while (i + run < wikitext.size() && wikitext[i + run] == c) {
+                ++run;
+            }
+
+            if (c == '{') {
+                for (size_t k = run; k >= 2;) {
+                    uint8_t group = k == 3 ? 3 : 2;
+                    braces.push_back(group);
+                    k -= group;
+                }
+                i += run;
+                continue;
+            }
+
+            size_t k = run;
+            while (k >= 2 && !braces.empty()) {
+                size_t group = std::min<size_t>(braces.back(), k);
+                braces.pop_back();
+                k -= group;
+                if (braces.empty()) {
+                    emit(arg_begin, i + (run - k) - group, eq);
+                    return;
+                }
+            }
+            i += run;
+            continue;
+        }
+
+        if (c == '[' && i + 1 < wikitext.size() && wikitext[i + 1] == '[') {
+            ++links;
+            i += 2;
+            continue;
+        }
+        if (c == ']' && i + 1 < wikitext.size() && wikitext[i + 1] == ']' && links > 0) {
+            --links;
+            i += 2;
+            continue;
+        }
+
+        if (braces.size() == 1 && links == 0) {
+            if (c == '|') {
+                emit(arg_begin, i, eq);
+                arg_begin = i + 1;
+                eq = std::string_view::npos;
+            } else if (c == '=' && eq == std::string_view::npos) {
+                eq = i;
+            }
+        }
+        ++i;
+    }
+
+    // Unterminated invocation: drop what was collected for it
+    out.resize(saved);
+}
+
+} // namespace wikilib::templates
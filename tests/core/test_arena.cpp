@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "wikilib/core/arena.h"
+#include "wikilib/dump/bz2_stream.h"
+
+using namespace wikilib;
+
+// ============================================================================
+// Arena tests
+// ============================================================================
+
+TEST(ArenaTest, AllocationsAreAlignedAndDistinct) {
+    Arena arena;
+    auto *a = static_cast<char *>(arena.allocate(3, 1));
+    auto *b = arena.allocate_array<uint64_t>(4);
+    auto *c = static_cast<char *>(arena.allocate(100, 64));
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(uint64_t), 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0u);
+    EXPECT_GE(reinterpret_cast<char *>(b), a + 3);
+    EXPECT_GE(c, reinterpret_cast<char *>(b + 4));
+
+    std::memset(c, 'x', 100);
+    EXPECT_EQ(arena.stats().bytes_used, 3u + 32u + 100u);
+    EXPECT_EQ(arena.stats().blocks, 1u);
+    EXPECT_GE(arena.stats().bytes_mapped, arena.config().block_size);
+}
+
+TEST(ArenaTest, ResetReusesBlocks) {
+    Arena arena(ArenaConfig{1 << 20, HugePages::Off, false});
+    void *first = arena.allocate(1000);
+    arena.reset();
+    void *again = arena.allocate(1000);
+
+    EXPECT_EQ(first, again);
+    EXPECT_EQ(arena.stats().resets, 1u);
+    EXPECT_EQ(arena.stats().bytes_used, 1000u);
+    EXPECT_EQ(arena.stats().blocks, 1u);
+    EXPECT_EQ(arena.stats().thp_bytes, 0u);
+}
+
+TEST(ArenaTest, LargeAllocationsGetTheirOwnBlock) {
+    Arena arena(ArenaConfig{2 << 20, HugePages::Transparent, true});
+    (void)arena.allocate(100);
+    auto *big = static_cast<char *>(arena.allocate(5 << 20));
+    big[(5 << 20) - 1] = 'z';
+
+    const ArenaStats &stats = arena.stats();
+    EXPECT_EQ(stats.blocks, 2u);
+    EXPECT_GE(stats.bytes_mapped, (2u << 20) + (5u << 20));
+    EXPECT_EQ(stats.peak_bytes_used, 100u + (5u << 20));
+    EXPECT_LE(stats.huge_page_fraction(), 1.0);
+
+    arena.release();
+    EXPECT_EQ(arena.stats().blocks, 0u);
+    EXPECT_EQ(arena.stats().bytes_mapped, 0u);
+}
+
+TEST(ArenaTest, ShrinkReturnsTail) {
+    Arena arena;
+    void *buffer = arena.allocate(4096, 1);
+    arena.shrink(buffer, 4096, 10);
+    EXPECT_EQ(arena.stats().bytes_used, 10u);
+
+    auto *next = static_cast<char *>(arena.allocate(1, 1));
+    EXPECT_EQ(next, static_cast<char *>(buffer) + 10);
+
+    // Not the latest allocation: ignored
+    arena.shrink(buffer, 10, 0);
+    EXPECT_EQ(arena.stats().bytes_used, 11u);
+}
+
+TEST(ArenaTest, CopyAndPmrContainers) {
+    Arena arena;
+    std::string_view text = arena.copy("Wikipedia");
+    EXPECT_EQ(text, "Wikipedia");
+
+    ArenaResource resource(arena);
+    std::pmr::vector<int> numbers(&resource);
+    for (int i = 0; i < 1000; ++i) {
+        numbers.push_back(i);
+    }
+    EXPECT_EQ(numbers[999], 999);
+    EXPECT_GT(arena.stats().bytes_used, 1000 * sizeof(int));
+}
+
+TEST(ArenaTest, DecompressIntoArena) {
+    std::string text;
+    for (int i = 0; i < 2000; ++i) {
+        text += "<page>" + std::to_string(i) + "</page>\n";
+    }
+    auto compressed = dump::compress_bz2(text);
+    ASSERT_TRUE(compressed.has_value());
+
+    Arena arena;
+    auto xml = dump::decompress_bz2(*compressed, arena);
+    ASSERT_TRUE(xml.has_value());
+    EXPECT_EQ(*xml, text);
+    EXPECT_EQ(arena.stats().bytes_used, text.size());
+
+    auto bad = dump::decompress_bz2("BZh9 not really", arena);
+    EXPECT_FALSE(bad.has_value());
+    EXPECT_EQ(arena.stats().bytes_used, text.size());
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "wikilib/core/bloom_filter.h"
+
+using namespace wikilib;
+
+static std::vector<std::string> titles(size_t count, const std::string &prefix) {
+    std::vector<std::string> result;
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(prefix + std::to_string(i));
+    }
+    return result;
+}
+
+// ============================================================================
+// BloomFilter tests
+// ============================================================================
+
+TEST(BloomFilterTest, NoFalseNegatives) {
+    auto present = titles(20000, "Strona ");
+    BloomFilter filter(present.size());
+    for (const auto &title: present) {
+        filter.insert(title);
+    }
+    for (const auto &title: present) {
+        EXPECT_TRUE(filter.may_contain(title)) << title;
+    }
+    EXPECT_EQ(filter.size_bytes(), 25024u); // 10 bits per key in 32-byte blocks
+}
+
+TEST(BloomFilterTest, FalsePositiveRate) {
+    auto present = titles(20000, "Kategoria:");
+    BloomFilter filter(present.size());
+    for (const auto &title: present) {
+        filter.insert(title);
+    }
+
+    size_t false_positives = 0;
+    auto absent = titles(100000, "Szablon:");
+    for (const auto &title: absent) {
+        false_positives += filter.may_contain(title);
+    }
+    EXPECT_LT(false_positives, absent.size() / 50); // ~1% expected
+}
+
+TEST(BloomFilterTest, EmptyFilterKnowsNothing) {
+    BloomFilter filter;
+    EXPECT_TRUE(filter.empty());
+    EXPECT_TRUE(filter.may_contain("anything"));
+    filter.insert("x");
+    EXPECT_EQ(filter.size_bytes(), 0u);
+}
+
+TEST(BloomFilterTest, SerializeRoundTrip) {
+    BloomFilter filter(100);
+    filter.insert("kot");
+    filter.insert("");
+
+    auto loaded = BloomFilter::deserialize(filter.serialize());
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->size_bytes(), filter.size_bytes());
+    EXPECT_TRUE(loaded->may_contain("kot"));
+    EXPECT_TRUE(loaded->may_contain(""));
+    EXPECT_FALSE(loaded->may_contain("pies"));
+
+    std::string data = filter.serialize();
+    EXPECT_FALSE(BloomFilter::deserialize(data.substr(0, data.size() - 1)).has_value());
+    EXPECT_FALSE(BloomFilter::deserialize("garbage").has_value());
+}
@@ -4,6 +4,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <cstring>
 #include "wikilib/core/line_reader.h"
@@ -311,3 +314,94 @@ TEST(BufferedLineReaderTest, LineEndingAtBufferBoundary) {
     ASSERT_TRUE(reader.read_line(line));
     EXPECT_EQ(line, "ABCDE");
 }
+
+// ============================================================================
+// MmapLineReader tests
+// ============================================================================
+
+static std::string write_temp_file(const std::string& name, const std::string& content) {
+    auto path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream(path, std::ios::binary) << content;
+    return path;
+}
+
+TEST(MmapLineReaderTest, ReadsFileInPlace) {
+    auto path = write_temp_file("wikilib_mmap_lines.txt", "Line 1\r\n\nLine 3\nLast");
+    MmapLineReader reader(path);
+    ASSERT_TRUE(reader.is_open()) << reader.error();
+
+    auto line = reader.read_line_view();
+    ASSERT_TRUE(line.has_value());
+    EXPECT_EQ(*line, "Line 1");
+    EXPECT_EQ(line->data(), reader.remaining().data() - 8); // A view into the mapping
+
+    std::string copy;
+    ASSERT_TRUE(reader.read_line(copy));
+    EXPECT_EQ(copy, "");
+    EXPECT_EQ(reader.read_line_view(), "Line 3");
+    EXPECT_EQ(reader.read_line_view(), "Last");
+    EXPECT_FALSE(reader.read_line_view().has_value());
+    EXPECT_TRUE(reader.eof());
+    std::remove(path.c_str());
+}
+
+TEST(MmapLineReaderTest, EmptyAndMissingFiles) {
+    auto path = write_temp_file("wikilib_mmap_empty.txt", "");
+    MmapLineReader empty(path);
+    EXPECT_TRUE(empty.is_open());
+    EXPECT_FALSE(empty.read_line_view().has_value());
+    std::remove(path.c_str());
+
+    MmapLineReader missing("/nonexistent/wikilib_lines.txt");
+    EXPECT_FALSE(missing.is_open());
+    EXPECT_FALSE(missing.error().empty());
+    EXPECT_TRUE(missing.eof());
+}
+
+TEST(MmapLineReaderTest, TrailingNewlineAddsNoLine) {
+    auto reader = MmapLineReader::from_string("a\nb\n");
+    EXPECT_EQ(reader.read_line_view(), "a");
+    EXPECT_EQ(reader.read_line_view(), "b");
+    EXPECT_FALSE(reader.read_line_view().has_value());
+}
+
+TEST(MmapLineReaderTest, SplitAtLineBoundaries) {
+    std::string content;
+    for (int i = 0; i < 1000; ++i) {
+        content += "line " + std::to_string(i) + std::string(static_cast<size_t>(i % 17), 'x') + "\n";
+    }
+    auto path = write_temp_file("wikilib_mmap_split.txt", content);
+
+    MmapLineReader reader(path);
+    ASSERT_TRUE(reader.is_open());
+    ASSERT_TRUE(reader.read_line_view()); // Splitting starts at the unread input
+    auto parts = reader.split(7);
+    EXPECT_EQ(parts.size(), 7u);
+    EXPECT_EQ(reader.read_line_view(), "line 1x");
+
+    std::vector<std::string_view> lines;
+    for (auto& part: parts) {
+        EXPECT_TRUE(part.remaining().ends_with('\n'));
+        while (auto line = part.read_line_view()) {
+            lines.push_back(*line);
+        }
+    }
+    ASSERT_EQ(lines.size(), 999u);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        EXPECT_TRUE(lines[i].starts_with("line " + std::to_string(i + 1))) << lines[i];
+    }
+
+    // Parts keep the mapping alive after the reader is gone
+    parts = reader.split(3);
+    reader = MmapLineReader::from_string("");
+    EXPECT_TRUE(parts.back().remaining().ends_with("line 999" + std::string(13, 'x') + "\n"));
+    std::remove(path.c_str());
+}
+
+TEST(MmapLineReaderTest, SplitSmallInput) {
+    auto reader = MmapLineReader::from_string("only line");
+    auto parts = reader.split(4);
+    ASSERT_EQ(parts.size(), 1u);
+    EXPECT_EQ(parts[0].read_line_view(), "only line");
+    EXPECT_TRUE(MmapLineReader::from_string("").split(4).empty());
+}
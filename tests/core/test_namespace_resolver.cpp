@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "wikilib/core/namespace_resolver.h"
+
+using namespace wikilib;
+
+namespace {
+
+std::vector<Namespace> polish_namespaces() {
+    std::vector<Namespace> namespaces;
+    auto add = [&namespaces](NamespaceId id, std::string name) {
+        Namespace ns;
+        ns.id = id;
+        ns.name = std::move(name);
+        namespaces.push_back(std::move(ns));
+    };
+    add(NS_MAIN, "");
+    add(NS_FILE, "Plik");
+    add(NS_TEMPLATE, "Szablon");
+    add(NS_CATEGORY, "Kategoria");
+    add(NS_CATEGORY + 1, "Dyskusja kategorii");
+    add(100, "Portal");
+    add(NS_MODULE, "Moduł");
+    return namespaces;
+}
+
+} // namespace
+
+// ============================================================================
+// Lookup tests
+// ============================================================================
+
+TEST(NamespaceResolverTest, CanonicalNames) {
+    NamespaceResolver resolver;
+    EXPECT_EQ(resolver.find("Category"), NS_CATEGORY);
+    EXPECT_EQ(resolver.find("Template"), NS_TEMPLATE);
+    EXPECT_EQ(resolver.find("Module talk"), NS_MODULE + 1);
+    EXPECT_EQ(resolver.find("Image"), NS_FILE);
+    EXPECT_FALSE(resolver.find("Kategoria").has_value());
+    EXPECT_FALSE(resolver.find("").has_value());
+    EXPECT_FALSE(resolver.find("Categor").has_value());
+    EXPECT_FALSE(resolver.find("Categoryy").has_value());
+}
+
+TEST(NamespaceResolverTest, CaseAndUnderscoresFold) {
+    NamespaceResolver resolver;
+    EXPECT_EQ(resolver.find("category"), NS_CATEGORY);
+    EXPECT_EQ(resolver.find("CATEGORY"), NS_CATEGORY);
+    EXPECT_EQ(resolver.find("User_talk"), NS_USER + 1);
+    EXPECT_EQ(resolver.find("  File "), NS_FILE);
+}
+
+TEST(NamespaceResolverTest, SiteNames) {
+    auto namespaces = polish_namespaces();
+    NamespaceResolver resolver(namespaces);
+
+    EXPECT_EQ(resolver.find("Kategoria"), NS_CATEGORY);
+    EXPECT_EQ(resolver.find("dyskusja_kategorii"), NS_CATEGORY + 1);
+    EXPECT_EQ(resolver.find("Portal"), 100);
+    EXPECT_EQ(resolver.find("Moduł"), NS_MODULE);
+    EXPECT_EQ(resolver.find("moduł"), NS_MODULE);
+
+    // Canonical names stay valid next to localized ones
+    EXPECT_EQ(resolver.find("Category"), NS_CATEGORY);
+    EXPECT_EQ(resolver.find("Plik"), NS_FILE);
+    EXPECT_EQ(resolver.find("File"), NS_FILE);
+}
+
+TEST(NamespaceResolverTest, Aliases) {
+    const NamespaceResolver::Alias aliases[] = {{"WP", NS_PROJECT}, {"Kat", NS_CATEGORY}};
+    NamespaceResolver resolver({}, aliases);
+    EXPECT_EQ(resolver.find("wp"), NS_PROJECT);
+    EXPECT_EQ(resolver.find("Kat"), NS_CATEGORY);
+}
+
+TEST(NamespaceResolverTest, EveryNameResolves) {
+    // Many names force several buckets to share displacement search
+    std::vector<Namespace> namespaces;
+    for (int i = 0; i < 500; ++i) {
+        Namespace ns;
+        ns.id = 1000 + i;
+        ns.name = "Namespace " + std::to_string(i);
+        namespaces.push_back(std::move(ns));
+    }
+    NamespaceResolver resolver(namespaces);
+    for (const auto &ns: namespaces) {
+        EXPECT_EQ(resolver.find(ns.name), ns.id) << ns.name;
+    }
+    EXPECT_FALSE(resolver.find("Namespace 500").has_value());
+}
+
+// ============================================================================
+// Title resolution tests
+// ============================================================================
+
+TEST(NamespaceResolverTest, ResolveTitle) {
+    const auto &resolver = NamespaceResolver::builtin();
+
+    auto title = resolver.resolve("Category: Physics");
+    EXPECT_EQ(title.namespace_id, NS_CATEGORY);
+    EXPECT_EQ(title.prefix, "Category");
+    EXPECT_EQ(title.local, "Physics");
+
+    title = resolver.resolve("kategoria:Fizyka");
+    EXPECT_EQ(title.namespace_id, NS_CATEGORY);
+    EXPECT_EQ(title.local, "Fizyka");
+
+    // Unknown prefix: the colon is part of a main namespace title
+    title = resolver.resolve("Star Wars: Episode IV");
+    EXPECT_EQ(title.namespace_id, NS_MAIN);
+    EXPECT_TRUE(title.prefix.empty());
+    EXPECT_EQ(title.local, "Star Wars: Episode IV");
+
+    EXPECT_EQ(resolver.namespace_of("Plain title"), NS_MAIN);
+    EXPECT_EQ(resolver.namespace_of(":Category:Physics"), NS_MAIN);
+}
+
+TEST(NamespaceResolverTest, CanonicalNameById) {
+    EXPECT_EQ(canonical_namespace_name(NS_TEMPLATE), "Template");
+    EXPECT_EQ(canonical_namespace_name(NS_CATEGORY + 1), "Category talk");
+    EXPECT_TRUE(canonical_namespace_name(NS_MAIN).empty());
+    EXPECT_TRUE(canonical_namespace_name(100).empty());
+}
+
+TEST(NamespaceResolverTest, PageInfoFullTitle) {
+    PageInfo page;
+    page.title = "Kot";
+    EXPECT_EQ(page.full_title(), "Kot");
+
+    page.namespace_id = NS_TEMPLATE;
+    EXPECT_EQ(page.full_title(), "Template:Kot");
+
+    page.title = "Template:Kot";
+    EXPECT_EQ(page.full_title(), "Template:Kot");
+
+    page.title = "Szablon:Kot"; // As read from a Polish dump
+    auto namespaces = polish_namespaces();
+    NamespaceResolver polish(namespaces);
+    EXPECT_EQ(page.full_title(polish), "Szablon:Kot");
+
+    // A colon in a bare title is not a namespace prefix
+    page.title = "Foo:Bar";
+    EXPECT_EQ(page.full_title(), "Template:Foo:Bar");
+    EXPECT_EQ(page.full_title(polish), "Template:Foo:Bar");
+    page.title = "Kategoria:Kot"; // Names another namespace
+    EXPECT_EQ(page.full_title(polish), "Template:Kategoria:Kot");
+
+    page.namespace_id = 100;
+    page.title = "Kot";
+    EXPECT_EQ(page.full_title(), "Kot");
+}
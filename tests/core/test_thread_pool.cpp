@@ -0,0 +1,218 @@
+/**
+ * @file test_thread_pool.cpp
+ * @brief Tests for thread pool, futures and channel
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "wikilib/core/channel.h"
+#include "wikilib/core/thread_pool.h"
+
+using namespace wikilib;
+
+// ============================================================================
+// ThreadPool tests
+// ============================================================================
+
+TEST(ThreadPoolTest, SubmitReturnsValue) {
+    ThreadPool pool(ThreadPoolConfig{4});
+    EXPECT_EQ(pool.size(), 4u);
+    EXPECT_EQ(pool.current_worker(), -1);
+
+    std::vector<Future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(futures[static_cast<size_t>(i)].get(), i * i);
+        EXPECT_FALSE(futures[static_cast<size_t>(i)].valid()); // get() consumes the result
+    }
+}
+
+TEST(ThreadPoolTest, VoidTasksAndPost) {
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool(ThreadPoolConfig{2});
+        pool.submit([&count] { count++; }).get();
+        for (int i = 0; i < 50; ++i) {
+            pool.post([&count] { count++; });
+        }
+        // Pool destruction runs every queued task
+    }
+    EXPECT_EQ(count.load(), 51);
+}
+
+TEST(ThreadPoolTest, ExceptionReachesGet) {
+    ThreadPool pool(ThreadPoolConfig{2});
+    auto future = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, ContinuationsChain) {
+    ThreadPool pool(ThreadPoolConfig{2});
+    auto text = pool.submit([] { return 20; })
+                        .then([](int n) { return n + 1; })
+                        .then([](int n) { return std::to_string(n * 2); });
+    EXPECT_EQ(text.get(), "42");
+
+    auto failed = pool.submit([]() -> int { throw std::runtime_error("first"); }).then([](int n) { return n; });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    std::atomic<bool> ran{false};
+    pool.submit([] {}).then([&ran] { ran = true; }).get();
+    EXPECT_TRUE(ran.load());
+}
+
+TEST(ThreadPoolTest, NestedWaitDoesNotDeadlock) {
+    // Every worker waits for tasks it queued itself
+    ThreadPool pool(ThreadPoolConfig{2});
+    std::vector<Future<int>> outer;
+    for (int i = 0; i < 8; ++i) {
+        outer.push_back(pool.submit([&pool, i] {
+            EXPECT_GE(pool.current_worker(), 0);
+            std::vector<Future<int>> inner;
+            for (int j = 0; j < 8; ++j) {
+                inner.push_back(pool.submit([i, j] { return i * j; }));
+            }
+            int sum = 0;
+            for (auto &future: inner) {
+                sum += future.get();
+            }
+            return sum;
+        }));
+    }
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(outer[static_cast<size_t>(i)].get(), i * 28);
+    }
+}
+
+TEST(ThreadPoolTest, PinnedWorkersRun) {
+    ThreadPool pool(ThreadPoolConfig{2, true});
+    EXPECT_EQ(pool.submit([] { return 7; }).get(), 7);
+}
+
+// ============================================================================
+// parallel_for tests
+// ============================================================================
+
+TEST(ParallelForTest, VisitsEveryIndexOnce) {
+    ThreadPool pool(ThreadPoolConfig{4});
+    std::vector<std::atomic<int>> hits(10007);
+    parallel_for(pool, 0, hits.size(), [&hits](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            hits[i]++;
+        }
+    });
+    for (const auto &hit: hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+}
+
+TEST(ParallelForTest, GrainAndOffsets) {
+    ThreadPool pool(ThreadPoolConfig{3});
+    std::atomic<size_t> sum{0};
+    std::atomic<size_t> calls{0};
+    parallel_for(pool, 10, 110, [&](size_t first, size_t last) {
+        EXPECT_LE(last - first, 25u);
+        calls++;
+        for (size_t i = first; i < last; ++i) {
+            sum += i;
+        }
+    }, 25);
+    EXPECT_EQ(calls.load(), 4u);
+    EXPECT_EQ(sum.load(), 5950u);
+
+    parallel_for(pool, 5, 5, [](size_t, size_t) { FAIL(); });
+}
+
+TEST(ParallelForTest, NestedInsideTask) {
+    ThreadPool pool(ThreadPoolConfig{2});
+    auto total = pool.submit([&pool] {
+        std::atomic<size_t> sum{0};
+        parallel_for(pool, 0, 1000, [&sum](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                sum += i;
+            }
+        });
+        return sum.load();
+    });
+    EXPECT_EQ(total.get(), 499500u);
+}
+
+TEST(ParallelForTest, ExceptionIsRethrown) {
+    ThreadPool pool(ThreadPoolConfig{2});
+    EXPECT_THROW(parallel_for(pool, 0, 100, [](size_t first, size_t) {
+        if (first == 0) {
+            throw std::runtime_error("chunk failed");
+        }
+    }, 10), std::runtime_error);
+}
+
+// ============================================================================
+// Channel tests
+// ============================================================================
+
+TEST(ChannelTest, BoundedPushAndClose) {
+    Channel<int> channel(2);
+    EXPECT_TRUE(channel.push(1));
+    const int item = 2;
+    EXPECT_TRUE(channel.try_push(item));
+    EXPECT_FALSE(channel.try_push(3)); // Full
+    EXPECT_EQ(channel.size(), 2u);
+
+    channel.close();
+    EXPECT_FALSE(channel.push(4));
+    EXPECT_EQ(channel.pop(), 1);
+    EXPECT_EQ(channel.try_pop(), 2);
+    EXPECT_FALSE(channel.pop().has_value());
+}
+
+TEST(ChannelTest, FailedTryPushKeepsItem) {
+    Channel<std::string> channel(1);
+    EXPECT_TRUE(channel.try_push(std::string("first")));
+    std::string item = "second";
+    EXPECT_FALSE(channel.try_push(std::move(item)));
+    EXPECT_EQ(item, "second");
+}
+
+TEST(ChannelTest, ManyProducersAndConsumers) {
+    Channel<size_t> channel(8);
+    constexpr size_t PER_PRODUCER = 1000;
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < 3; ++p) {
+        producers.emplace_back([&channel, p] {
+            for (size_t i = 0; i < PER_PRODUCER; ++i) {
+                channel.push(p * PER_PRODUCER + i);
+            }
+        });
+    }
+
+    std::atomic<size_t> sum{0};
+    std::atomic<size_t> count{0};
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < 3; ++c) {
+        consumers.emplace_back([&] {
+            while (auto item = channel.pop()) {
+                sum += *item;
+                count++;
+            }
+        });
+    }
+
+    for (auto &t: producers) {
+        t.join();
+    }
+    channel.close();
+    for (auto &t: consumers) {
+        t.join();
+    }
+
+    EXPECT_EQ(count.load(), 3 * PER_PRODUCER);
+    EXPECT_EQ(sum.load(), (3 * PER_PRODUCER) * (3 * PER_PRODUCER - 1) / 2);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * @file dump_test_fixture.h
+ * @brief Shared fixture for tests that write multistream dumps
+ */
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/multistream_writer.h"
+
+namespace wikilib::dump::testing {
+
+/**
+ * @brief One page for write_dump()
+ */
+struct TestPage {
+    PageId id = 0;
+    std::string title;
+    std::string xml;
+};
+
+/**
+ * @brief Fixture owning a temporary directory per test
+ *
+ * The directory is temp_directory_path()/"wikilib_<suite>_<test>" and is
+ * removed after the test.
+ */
+class DumpTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        const auto *info = ::testing::UnitTest::GetInstance()->current_test_info();
+        dir = std::filesystem::temp_directory_path() /
+              ("wikilib_" + std::string(info->test_suite_name()) + "_" + info->name());
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    /**
+     * @brief <page> element with one revision; extra goes after <id>
+     */
+    static std::string page_xml(PageId id, std::string_view title, std::string_view text,
+                                NamespaceId ns = NS_MAIN, std::string_view extra = {}) {
+        std::string xml = "<page><title>";
+        xml += title;
+        xml += "</title><ns>" + std::to_string(ns) + "</ns><id>" + std::to_string(id) + "</id>";
+        xml += extra;
+        xml += "<revision><text>";
+        xml += text;
+        xml += "</text></revision></page>";
+        return xml;
+    }
+
+    /**
+     * @brief Write a multistream dump and index of pages page(1) to page(count)
+     */
+    static void write_dump(const std::filesystem::path &dump, const std::filesystem::path &index,
+                           std::string_view header, int count, const MultistreamConfig &config,
+                           const std::function<TestPage(int)> &page) {
+        MultistreamWriter writer(dump.string(), index.string(), config);
+        ASSERT_TRUE(writer.is_open()) << writer.error();
+        writer.write_header(header);
+        for (int i = 1; i <= count; ++i) {
+            TestPage p = page(i);
+            writer.add_page(p.id, p.title, p.xml);
+        }
+        ASSERT_TRUE(writer.finish()) << writer.error();
+    }
+
+    static std::string read_file(const std::filesystem::path &path) {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    /**
+     * @brief Decompressed contents of a (multistream) BZ2 file
+     */
+    static std::string read_bz2(const std::filesystem::path &path) {
+        Bz2Stream stream(path.string());
+        return stream.read_all();
+    }
+};
+
+} // namespace wikilib::dump::testing
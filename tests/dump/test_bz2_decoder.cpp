@@ -0,0 +1,284 @@
+/**
+ * @file test_bz2_decoder.cpp
+ * @brief Tests for the in-tree bzip2 decoder
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include "wikilib/core/arena.h"
+#include "wikilib/core/thread_pool.h"
+#include "wikilib/dump/bz2_decoder.h"
+#include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/dump_reader.h"
+
+using namespace wikilib;
+using namespace wikilib::dump;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static std::string random_bytes(size_t size, uint32_t seed, int alphabet = 256) {
+    std::mt19937 rng(seed);
+    std::string data(size, '\0');
+    for (char &c: data) {
+        c = static_cast<char>(rng() % static_cast<uint32_t>(alphabet));
+    }
+    return data;
+}
+
+static std::string wikitext_like(size_t size) {
+    std::string data;
+    std::mt19937 rng(7);
+    const char *words[] = {"the ", "[[Link]] ", "{{cite|x=1}} ", "'''bold''' ", "\n== Heading ==\n", "zażółć ", "a "};
+    while (data.size() < size) {
+        data += words[rng() % 7];
+        if (rng() % 50 == 0) {
+            data.append(rng() % 300, static_cast<char>('a' + rng() % 3)); // Long runs
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief MSB-first bit writer for hand-made streams
+ */
+class BitWriter {
+public:
+    void put(uint64_t value, int bits) {
+        for (int i = bits - 1; i >= 0; --i) {
+            if (used_ == 0) {
+                data_.push_back('\0');
+            }
+            if ((value >> i) & 1) {
+                data_.back() = static_cast<char>(data_.back() | (0x80 >> used_));
+            }
+            used_ = (used_ + 1) % 8;
+        }
+    }
+
+    [[nodiscard]] const std::string &data() const noexcept {
+        return data_;
+    }
+private:
+    std::string data_;
+    int used_ = 0;
+};
+
+static void expect_round_trip(const std::string &data, int level, const Bz2DecodeConfig &config = {}) {
+    auto compressed = compress_bz2(data, level);
+    ASSERT_TRUE(compressed.has_value());
+    auto native = native_decompress_bz2(*compressed, config);
+    ASSERT_TRUE(native.has_value()) << native.error().message;
+    EXPECT_EQ(native->size(), data.size());
+    EXPECT_TRUE(*native == data);
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+TEST(Bz2DecoderTest, MatchesInput) {
+    expect_round_trip("a", 9);
+    expect_round_trip("Hello, World!\n", 9);
+    expect_round_trip(std::string(1000, 'x'), 9); // One RLE1 run after another
+    expect_round_trip(std::string(5, 'y') + std::string(255, 'z') + "q", 9);
+    expect_round_trip(random_bytes(50000, 1), 9); // Long Huffman codes
+    expect_round_trip(random_bytes(50000, 2, 3), 9);
+}
+
+TEST(Bz2DecoderTest, MultipleBlocks) {
+    expect_round_trip(wikitext_like(450000), 1);
+    expect_round_trip(random_bytes(250000, 3), 1);
+}
+
+TEST(Bz2DecoderTest, ConcatenatedStreams) {
+    auto first = compress_bz2("first stream\n");
+    auto second = compress_bz2(std::string(70000, 'b'));
+    ASSERT_TRUE(first && second);
+
+    auto native = native_decompress_bz2(*first + *second);
+    ASSERT_TRUE(native.has_value());
+    EXPECT_EQ(*native, "first stream\n" + std::string(70000, 'b'));
+}
+
+TEST(Bz2DecoderTest, ParallelBlocks) {
+    ThreadPool pool(ThreadPoolConfig{.threads = 4});
+    Bz2DecodeConfig config{.pool = &pool, .min_parallel_size = 0};
+    expect_round_trip(wikitext_like(900000), 1, config);
+    expect_round_trip(random_bytes(350000, 4), 1, config);
+    expect_round_trip("single block", 9, config);
+}
+
+TEST(Bz2DecoderTest, RejectsBadData) {
+    auto compressed = compress_bz2(wikitext_like(20000));
+    ASSERT_TRUE(compressed.has_value());
+
+    EXPECT_FALSE(native_decompress_bz2("").has_value());
+    EXPECT_FALSE(native_decompress_bz2("not bzip2 data").has_value());
+    EXPECT_FALSE(native_decompress_bz2(std::string_view(*compressed).substr(0, compressed->size() / 2)).has_value());
+
+    std::string corrupt = *compressed;
+    corrupt[corrupt.size() / 2] ^= 0x10;
+    EXPECT_FALSE(native_decompress_bz2(corrupt).has_value());
+}
+
+TEST(Bz2DecoderTest, RejectsOversubscribedCodeLengths) {
+    // One block whose 18 symbols all have 1-bit codes
+    BitWriter bits;
+    for (char c: std::string("BZh9")) {
+        bits.put(static_cast<uint8_t>(c), 8);
+    }
+    bits.put(0x314159265359ull, 48);
+    bits.put(0, 32); // CRC
+    bits.put(0, 1); // Not randomised
+    bits.put(0, 24); // BWT origin
+    bits.put(0x8000, 16); // Bytes 0-15 in use
+    bits.put(0xFFFF, 16);
+    bits.put(2, 3); // Huffman groups
+    bits.put(1, 15); // Selectors
+    bits.put(0, 1);
+    for (int table = 0; table < 2; ++table) {
+        bits.put(1, 5);
+        for (int symbol = 0; symbol < 18; ++symbol) {
+            bits.put(0, 1);
+        }
+    }
+    bits.put(0, 64);
+
+    EXPECT_FALSE(native_decompress_bz2(bits.data()).has_value());
+}
+
+TEST(Bz2DecoderTest, ParallelSurvivesGarbageCandidates) {
+    // Block magics inside random bits make the parallel scan decode garbage
+    std::string data = "BZh9" + random_bytes(200000, 5);
+    BitWriter magic;
+    magic.put(0x314159265359ull, 48);
+    for (size_t at = 1000; at + 6 < data.size(); at += 9973) {
+        data.replace(at, 6, magic.data());
+    }
+
+    ThreadPool pool(ThreadPoolConfig{.threads = 2});
+    EXPECT_FALSE(native_decompress_bz2(data, Bz2DecodeConfig{.pool = &pool, .min_parallel_size = 0}).has_value());
+}
+
+TEST(Bz2DecoderTest, DecodesIntoArena) {
+    std::string data = wikitext_like(450000);
+    auto compressed = compress_bz2(data, 1);
+    ASSERT_TRUE(compressed.has_value());
+
+    Arena arena;
+    auto decoded = native_decompress_bz2(*compressed, arena);
+    ASSERT_TRUE(decoded.has_value()) << decoded.error().message;
+    EXPECT_TRUE(*decoded == data);
+
+    // A failed decode gives its block back
+    uint64_t used = arena.stats().bytes_used;
+    EXPECT_FALSE(native_decompress_bz2("BZh9 garbage", arena).has_value());
+    EXPECT_EQ(arena.stats().bytes_used, used);
+}
+
+// ============================================================================
+// Backend selection
+// ============================================================================
+
+TEST(Bz2DecoderTest, BackendSelection) {
+    Bz2Backend previous = bz2_backend();
+    std::string data = wikitext_like(30000);
+    auto compressed = compress_bz2(data);
+    ASSERT_TRUE(compressed.has_value());
+
+    for (Bz2Backend backend: {Bz2Backend::Libbz2, Bz2Backend::Native}) {
+        set_bz2_backend(backend);
+        EXPECT_EQ(bz2_backend(), backend);
+        auto result = decompress_bz2(*compressed);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_TRUE(*result == data);
+        EXPECT_FALSE(decompress_bz2("BZh9 garbage").has_value());
+    }
+    set_bz2_backend(previous);
+}
+
+TEST(Bz2DecoderTest, NativeErrorsAreReported) {
+    Bz2Backend previous = bz2_backend();
+    auto compressed = compress_bz2(wikitext_like(30000));
+    ASSERT_TRUE(compressed.has_value());
+    std::string corrupt = *compressed;
+    corrupt[corrupt.size() / 2] ^= 0x10;
+
+    set_bz2_backend(Bz2Backend::Native);
+    auto result = decompress_bz2(corrupt);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_NE(result.error().message.find("CRC"), std::string::npos) << result.error().message;
+    set_bz2_backend(previous);
+}
+
+TEST(Bz2DecoderTest, BlocksFollowNativeBackend) {
+    Bz2Backend previous = bz2_backend();
+    std::string data = wikitext_like(450000);
+    auto compressed = compress_bz2(data, 1); // 100 kB blocks
+    ASSERT_TRUE(compressed.has_value());
+
+    set_bz2_backend(Bz2Backend::Native);
+    std::string all;
+    auto total = decompress_bz2_blocks(*compressed, [&all](std::string_view block) {
+        EXPECT_LE(block.size(), 4096u);
+        all.append(block);
+        return true;
+    }, 4096);
+    ASSERT_TRUE(total.has_value()) << total.error().message;
+    EXPECT_EQ(*total, data.size());
+    EXPECT_TRUE(all == data);
+
+    size_t calls = 0;
+    auto partial = decompress_bz2_blocks(*compressed, [&calls](std::string_view) { return ++calls < 3; }, 4096);
+    ASSERT_TRUE(partial.has_value());
+    EXPECT_EQ(*partial, 3u * 4096u);
+
+    std::string corrupt = *compressed;
+    corrupt[corrupt.size() / 2] ^= 0x10;
+    EXPECT_FALSE(decompress_bz2_blocks(corrupt, [](std::string_view) { return true; }).has_value());
+    EXPECT_FALSE(decompress_bz2_blocks("BZh9 broken", [](std::string_view) { return true; }).has_value());
+
+    // Single-page lookups decode through the selected backend too
+    std::string xml = "  <page>\n    <title>Kot</title>\n    <revision>\n      <text>miau</text>\n"
+                      "    </revision>\n  </page>\n";
+    auto chunk = compress_bz2(xml);
+    ASSERT_TRUE(chunk.has_value());
+    auto page = extract_page_from_bz2("Kot", *chunk);
+    ASSERT_TRUE(page.has_value()) << page.error().message;
+    EXPECT_EQ(*page, "miau");
+
+    set_bz2_backend(previous);
+}
+
+TEST(Bz2DecoderTest, StreamReadsWithNativeBackend) {
+    Bz2Backend previous = bz2_backend();
+    std::string first = wikitext_like(450000);
+    std::string second = "second stream\n";
+    auto a = compress_bz2(first, 1);
+    auto b = compress_bz2(second);
+    ASSERT_TRUE(a && b);
+
+    FILE *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    std::string contents = *a + *b;
+    std::fwrite(contents.data(), 1, contents.size(), file);
+
+    set_bz2_backend(Bz2Backend::Native);
+    std::rewind(file);
+    Bz2Stream stream(file, false);
+    EXPECT_TRUE(stream.is_open());
+    std::string all = stream.read_all();
+    EXPECT_TRUE(stream.error().empty()) << stream.error();
+    EXPECT_TRUE(all == first + second);
+
+    // Seeking restarts the native decoder at the second stream
+    ASSERT_TRUE(stream.seek_to_stream(a->size()));
+    EXPECT_EQ(stream.read_line(), "second stream");
+
+    set_bz2_backend(previous);
+    std::fclose(file);
+}
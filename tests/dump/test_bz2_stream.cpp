@@ -0,0 +1,180 @@
+/**
+ * @file test_bz2_stream.cpp
+ * @brief Tests for BZ2 stream reader
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/dump_reader.h"
+
+using namespace wikilib::dump;
+
+// ============================================================================
+// Helper to create stream over compressed content
+// ============================================================================
+
+static Bz2Stream make_stream(const std::string& content) {
+    auto compressed = compress_bz2(content);
+    EXPECT_TRUE(compressed.has_value());
+
+    FILE* file = std::tmpfile();
+    std::fwrite(compressed->data(), 1, compressed->size(), file);
+    std::rewind(file);
+    return Bz2Stream(file, true);
+}
+
+// ============================================================================
+// read_line_view tests
+// ============================================================================
+
+TEST(Bz2StreamTest, ReadLineView_MultipleLines) {
+    auto stream = make_stream("Line 1\nLine 2\nLine 3");
+
+    auto line = stream.read_line_view();
+    ASSERT_TRUE(line.has_value());
+    EXPECT_EQ(*line, "Line 1");
+
+    line = stream.read_line_view();
+    ASSERT_TRUE(line.has_value());
+    EXPECT_EQ(*line, "Line 2");
+
+    line = stream.read_line_view();
+    ASSERT_TRUE(line.has_value());
+    EXPECT_EQ(*line, "Line 3");
+
+    EXPECT_FALSE(stream.read_line_view().has_value());
+}
+
+TEST(Bz2StreamTest, ReadLineView_EmptyLinesAndCrLf) {
+    auto stream = make_stream("a\r\n\nb\n");
+
+    EXPECT_EQ(stream.read_line_view().value_or("<eof>"), "a");
+    EXPECT_EQ(stream.read_line_view().value_or("<eof>"), "");
+    EXPECT_EQ(stream.read_line_view().value_or("<eof>"), "b");
+    EXPECT_FALSE(stream.read_line_view().has_value());
+}
+
+TEST(Bz2StreamTest, ReadLineView_LinesSpanningRefill) {
+    // Lines longer than the 64KB decompression buffer must be carried over
+    std::string long_line(200 * 1024, 'x');
+    std::vector<std::string> expected;
+    std::string content;
+    for (int i = 0; i < 50; ++i) {
+        expected.push_back("short " + std::to_string(i));
+        expected.push_back(long_line.substr(0, 1000 * static_cast<size_t>(i) + 7));
+    }
+    expected.push_back(long_line);
+    for (const auto& l : expected) {
+        content += l;
+        content += '\n';
+    }
+
+    auto stream = make_stream(content);
+    size_t count = 0;
+    while (auto line = stream.read_line_view()) {
+        ASSERT_LT(count, expected.size());
+        EXPECT_EQ(*line, expected[count]);
+        ++count;
+    }
+    EXPECT_EQ(count, expected.size());
+}
+
+TEST(Bz2StreamTest, ReadLine_MatchesView) {
+    auto stream = make_stream("first\nsecond");
+
+    auto line = stream.read_line();
+    ASSERT_TRUE(line.has_value());
+    EXPECT_EQ(*line, "first");
+
+    line = stream.read_line();
+    ASSERT_TRUE(line.has_value());
+    EXPECT_EQ(*line, "second");
+
+    EXPECT_FALSE(stream.read_line().has_value());
+}
+
+TEST(Bz2StreamTest, ReadsConcatenatedStreams) {
+    FILE* file = std::tmpfile();
+    std::string expected;
+    for (int i = 0; i < 50; ++i) {
+        std::string part = "stream " + std::to_string(i) + "\n";
+        expected += part;
+        auto compressed = compress_bz2(part);
+        ASSERT_TRUE(compressed.has_value());
+        std::fwrite(compressed->data(), 1, compressed->size(), file);
+    }
+    std::rewind(file);
+
+    Bz2Stream stream(file, true);
+    EXPECT_EQ(stream.read_all(), expected);
+    EXPECT_TRUE(stream.error().empty());
+}
+
+// ============================================================================
+// Block-wise decompression and early page extraction
+// ============================================================================
+
+static std::string make_chunk(int pages) {
+    std::string xml;
+    for (int i = 0; i < pages; ++i) {
+        xml += "  <page>\n    <title>Page " + std::to_string(i) + "</title>\n    <id>" + std::to_string(i + 1) +
+               "</id>\n    <revision>\n      <text>Text of page " + std::to_string(i) + " " +
+               std::string(500, static_cast<char>('a' + i % 26)) + "</text>\n    </revision>\n  </page>\n";
+    }
+    return xml;
+}
+
+TEST(Bz2StreamTest, DecompressBlocksStopsEarly) {
+    std::string xml = make_chunk(200);
+    auto compressed = compress_bz2(xml);
+    ASSERT_TRUE(compressed.has_value());
+
+    std::string all;
+    auto total = decompress_bz2_blocks(*compressed, [&all](std::string_view block) {
+        EXPECT_LE(block.size(), 1024u);
+        all.append(block);
+        return true;
+    }, 1024);
+    ASSERT_TRUE(total.has_value());
+    EXPECT_EQ(*total, xml.size());
+    EXPECT_EQ(all, xml);
+
+    size_t calls = 0;
+    auto partial = decompress_bz2_blocks(*compressed, [&calls](std::string_view) { return ++calls < 3; }, 1024);
+    ASSERT_TRUE(partial.has_value());
+    EXPECT_EQ(*partial, 3u * 1024u);
+
+    EXPECT_FALSE(decompress_bz2_blocks("BZh9 broken", [](std::string_view) { return true; }).has_value());
+    EXPECT_FALSE(decompress_bz2_blocks(compressed->substr(0, compressed->size() / 2), [](std::string_view) {
+        return true;
+    }).has_value());
+}
+
+TEST(Bz2StreamTest, ExtractPageFromCompressedChunk) {
+    std::string xml = make_chunk(100) +
+                      "  <page>\n    <title>AT&amp;T &quot;x&quot;</title>\n    <revision>\n"
+                      "      <text>escaped</text>\n    </revision>\n  </page>\n";
+    auto compressed = compress_bz2(xml);
+    ASSERT_TRUE(compressed.has_value());
+
+    auto first = extract_page_from_bz2("Page 0", *compressed);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, "Text of page 0 " + std::string(500, 'a'));
+
+    auto middle = extract_page_from_bz2("Page 57", *compressed);
+    ASSERT_TRUE(middle.has_value());
+    EXPECT_TRUE(middle->starts_with("Text of page 57 "));
+
+    auto escaped = extract_page_from_bz2("AT&T \"x\"", *compressed);
+    ASSERT_TRUE(escaped.has_value());
+    EXPECT_EQ(*escaped, "escaped");
+
+    auto missing = extract_page_from_bz2("Page 5000", *compressed);
+    ASSERT_TRUE(missing.has_value());
+    EXPECT_TRUE(missing->empty());
+
+    EXPECT_FALSE(extract_page_from_bz2("Page 0", "not bz2").has_value());
+}
@@ -0,0 +1,89 @@
+/**
+ * @file test_dump_reader.cpp
+ * @brief Tests for indexed dump reading
+ */
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include "dump_test_fixture.h"
+#include "wikilib/dump/dump_reader.h"
+
+using namespace wikilib;
+using namespace wikilib::dump;
+using wikilib::dump::testing::DumpTest;
+using wikilib::dump::testing::TestPage;
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Test fixture with a small dump in dump-fetcher layout
+// ============================================================================
+
+class DumpReaderTest : public DumpTest {
+protected:
+    std::optional<DumpPath> path;
+
+    void SetUp() override {
+        DumpTest::SetUp();
+        path.emplace(dir);
+        path->set_project(WikiProject::Wiktionary).set_language("pl").set_date("20260101");
+        fs::create_directories(path->date_dir());
+
+        write_dump(path->dump_path(), path->index_path(), "<mediawiki>\n", 5, {.pages_per_stream = 2}, [](int i) {
+            auto id = static_cast<PageId>(i);
+            std::string title = i == 5 ? "Szablon:Box" : "Page " + std::to_string(i);
+            return TestPage{id, title, page_xml(id, title, "text " + std::to_string(i), i == 5 ? NS_TEMPLATE : NS_MAIN)};
+        });
+    }
+};
+
+// ============================================================================
+// Title lookups behind the Bloom filter
+// ============================================================================
+
+TEST_F(DumpReaderTest, LookupsAgreeWithTitleFilter) {
+    DumpReader reader(*path);
+    reader.load_index();
+    ASSERT_TRUE(reader.index_loaded());
+    EXPECT_EQ(reader.page_count(), 5u);
+
+    const BloomFilter &filter = reader.title_filter();
+    EXPECT_FALSE(filter.empty());
+
+    // Raw dump titles, namespace prefix included
+    EXPECT_TRUE(filter.may_contain("Szablon:Box"));
+    EXPECT_TRUE(reader.has_page("Szablon:Box"));
+    auto info = reader.get_page_info("Szablon:Box");
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->id, 5u);
+
+    for (int i = 1; i <= 4; ++i) {
+        std::string title = "Page " + std::to_string(i);
+        EXPECT_TRUE(filter.may_contain(title)) << title;
+        EXPECT_TRUE(reader.has_page(title)) << title;
+        ASSERT_TRUE(reader.get_page_info(title).has_value()) << title;
+        EXPECT_EQ(reader.get_page_info(title)->id, static_cast<PageId>(i));
+    }
+
+    for (const std::string title: {"Box", "Page 6", "page 1", ""}) {
+        EXPECT_FALSE(reader.has_page(title)) << title;
+        EXPECT_FALSE(reader.get_page_info(title).has_value()) << title;
+    }
+}
+
+TEST_F(DumpReaderTest, FilterIsEmptyBeforeIndexLoads) {
+    DumpReader reader(*path);
+    EXPECT_TRUE(reader.title_filter().empty());
+    EXPECT_FALSE(reader.has_page("Page 1"));
+    EXPECT_FALSE(reader.get_page_info("Page 1").has_value());
+}
+
+TEST_F(DumpReaderTest, ExtractsPageFoundThroughFilter) {
+    DumpReader reader(*path);
+    reader.load_index();
+    auto page = reader.extract_page("Page 3");
+    EXPECT_TRUE(page.found);
+    EXPECT_NE(page.content.find("text 3"), std::string::npos);
+    EXPECT_FALSE(reader.extract_page("Page 9").found);
+}
@@ -0,0 +1,134 @@
+/**
+ * @file test_dump_scheduler.cpp
+ * @brief Tests for multi-dump job scheduler
+ */
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include "dump_test_fixture.h"
+#include "wikilib/dump/dump_scheduler.h"
+
+using namespace wikilib::dump;
+using wikilib::dump::testing::DumpTest;
+using wikilib::dump::testing::TestPage;
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Test fixture with a small dump fetcher tree
+// ============================================================================
+
+class DumpSchedulerTest : public DumpTest {
+protected:
+    void SetUp() override {
+        DumpTest::SetUp();
+        fs::create_directories(dir / "wiktionary" / "20260101");
+
+        write_lang("aa", 3);
+        write_lang("bb", 40);
+        write_lang("cc", 7);
+
+        // Dump without index is not picked up by add_project
+        std::ofstream(dir / "wiktionary" / "20260101" / "ddwiktionary-20260101-pages-articles-multistream.xml.bz2")
+                << "x";
+    }
+
+    DumpPath project() const {
+        DumpPath path(dir);
+        path.set_project(WikiProject::Wiktionary).set_date("20260101");
+        return path;
+    }
+
+    void write_lang(const std::string &lang, int pages) {
+        DumpPath path = project();
+        path.set_language(lang);
+        write_dump(path.dump_path(), path.index_path(),
+                   "<mediawiki>\n<siteinfo><sitename>" + lang + "</sitename></siteinfo>\n", pages,
+                   {.pages_per_stream = 2, .compression_level = 1, .threads = 1}, [&lang](int i) {
+                       auto id = static_cast<wikilib::PageId>(i);
+                       std::string title = lang + " " + std::to_string(i);
+                       return TestPage{id, title, page_xml(id, title, "text of " + title)};
+                   });
+    }
+};
+
+// ============================================================================
+// Scheduling tests
+// ============================================================================
+
+TEST_F(DumpSchedulerTest, ProcessesAllLanguages) {
+    DumpScheduler scheduler({.threads = 3, .split_threshold = 400, .task_bytes = 300});
+    EXPECT_EQ(scheduler.add_project(project()), 3u);
+
+    fs::path out_dir = dir / "out";
+    fs::create_directories(out_dir);
+    scheduler.set_sink_factory(
+            [&](const DumpPath &dump) { return make_file_sink(out_dir / (dump.language() + ".txt")); });
+
+    std::mutex mutex;
+    std::set<std::string> finished;
+    scheduler.set_progress_callback([&](const DumpProgress &p) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (p.finished) {
+            finished.insert(p.name);
+        }
+    });
+
+    bool ok = scheduler.run([](const DumpPath &, const Page &page, std::string &out) {
+        out += page.info.title;
+        out += '\n';
+    });
+    ASSERT_TRUE(ok);
+
+    // bb is above the split threshold
+    EXPECT_GT(scheduler.task_count(), 3u);
+    EXPECT_EQ(finished.size(), 3u);
+
+    const auto &progress = scheduler.progress();
+    ASSERT_EQ(progress.size(), 3u);
+    uint64_t pages = 0;
+    for (const auto &p: progress) {
+        EXPECT_TRUE(p.finished);
+        EXPECT_TRUE(p.error.empty()) << p.error;
+        EXPECT_EQ(p.bytes_done, p.bytes_total);
+        pages += p.pages;
+    }
+    EXPECT_EQ(pages, 50u);
+
+    std::string bb = read_file(out_dir / "bb.txt");
+    std::set<std::string> titles;
+    size_t pos = 0;
+    while (pos < bb.size()) {
+        size_t nl = bb.find('\n', pos);
+        titles.insert(bb.substr(pos, nl - pos));
+        pos = nl + 1;
+    }
+    EXPECT_EQ(titles.size(), 40u);
+    EXPECT_TRUE(titles.contains("bb 1"));
+    EXPECT_TRUE(titles.contains("bb 40"));
+}
+
+TEST_F(DumpSchedulerTest, ReportsFailingDumpAndContinues) {
+    DumpPath bad = project();
+    bad.set_language("dd");
+
+    DumpPath good = project();
+    good.set_language("aa");
+
+    DumpScheduler scheduler({.threads = 2});
+    scheduler.add_dump(bad);
+    scheduler.add_dump(good);
+
+    uint64_t pages = 0;
+    std::mutex mutex;
+    EXPECT_FALSE(scheduler.run([&](const DumpPath &, const Page &, std::string &) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pages++;
+    }));
+
+    EXPECT_FALSE(scheduler.progress()[0].error.empty());
+    EXPECT_TRUE(scheduler.progress()[1].error.empty());
+    EXPECT_EQ(pages, 3u);
+}
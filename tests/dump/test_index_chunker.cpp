@@ -292,3 +292,25 @@ TEST(IndexChunkerTest, SkipMalformedLines) {
 
     EXPECT_FALSE(helper.get()->next_chunk(chunk));
 }
+
+TEST(IndexChunkerTest, MappedReaderLinesAsViews) {
+    std::string content =
+        "100:1:Page1\n"
+        "100:2:Page: two\n"
+        "bad\n"
+        "250:3:Page3\n";
+
+    IndexChunker chunker(std::make_unique<MmapLineReader>(MmapLineReader::from_string(content)), 400);
+
+    IndexChunk chunk;
+    ASSERT_TRUE(chunker.next_chunk(chunk));
+    EXPECT_EQ(chunk.start_offset, 100u);
+    EXPECT_EQ(chunk.end_offset, 250u);
+    ASSERT_EQ(chunk.size(), 2u);
+    EXPECT_EQ(chunk.entries[1].title, "Page: two");
+
+    ASSERT_TRUE(chunker.next_chunk(chunk));
+    EXPECT_EQ(chunk.entries[0].title, "Page3");
+    EXPECT_EQ(chunk.end_offset, 400u);
+    EXPECT_FALSE(chunker.next_chunk(chunk));
+}
@@ -0,0 +1,61 @@
+/**
+ * @file test_link_domains.cpp
+ * @brief Tests for parallel link domain counting over a multistream dump
+ */
+
+#include <gtest/gtest.h>
+#include "dump_test_fixture.h"
+#include "wikilib/dump/link_domains.h"
+
+using namespace wikilib::dump;
+using wikilib::dump::testing::DumpTest;
+using wikilib::dump::testing::TestPage;
+
+class LinkDomainsTest : public DumpTest {
+protected:
+    std::string dump;
+    std::string index;
+
+    void SetUp() override {
+        DumpTest::SetUp();
+        dump = (dir / "links-multistream.xml.bz2").string();
+        index = (dir / "links-multistream-index.txt.bz2").string();
+
+        write_dump(dump, index, "<mediawiki>\n<siteinfo><sitename>Test</sitename></siteinfo>\n", 10,
+                   {.pages_per_stream = 3, .threads = 2}, [](int i) {
+                       auto id = static_cast<wikilib::PageId>(i);
+                       std::string title = "Page " + std::to_string(i);
+                       std::string text = "[https://example.org/" + std::to_string(i) + " x] http://site" +
+                                          std::to_string(i % 2) + ".net &lt;ref&gt;";
+                       return TestPage{id, title, page_xml(id, title, text, i % 5 == 0 ? 1 : 0)};
+                   });
+    }
+};
+
+TEST_F(LinkDomainsTest, CountsAcrossWorkers) {
+    auto result = count_link_domains(dump, index, {.threads = 3});
+    ASSERT_TRUE(result.success) << result.error;
+
+    EXPECT_EQ(result.pages_scanned, 10u);
+    EXPECT_EQ(result.chunks_read, 4u);
+    EXPECT_EQ(result.domains.count("example.org"), 10u);
+    EXPECT_EQ(result.domains.count("site0.net"), 5u);
+    EXPECT_EQ(result.domains.count("site1.net"), 5u);
+}
+
+TEST_F(LinkDomainsTest, FiltersNamespaces) {
+    LinkDomainConfig config;
+    config.threads = 2;
+    config.namespaces = std::vector<wikilib::NamespaceId>{0};
+
+    auto result = count_link_domains(dump, index, config);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.pages_scanned, 8u);
+    EXPECT_EQ(result.domains.total(), 16u);
+}
+
+TEST_F(LinkDomainsTest, ReportsMissingDump) {
+    auto result = count_link_domains((dir / "missing.xml.bz2").string(), index);
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.error.empty());
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_multistream_writer.cpp
+ * @brief Tests for parallel multistream BZ2 writer
+ */
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <random>
+#include "dump_test_fixture.h"
+#include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/index_chunker.h"
+#include "wikilib/dump/multistream_writer.h"
+
+using namespace wikilib::dump;
+using wikilib::dump::testing::DumpTest;
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Test fixture with temporary output files
+// ============================================================================
+
+class MultistreamWriterTest : public DumpTest {
+protected:
+    std::string dump_file;
+    std::string index_file;
+
+    void SetUp() override {
+        DumpTest::SetUp();
+        dump_file = (dir / "test-multistream.xml.bz2").string();
+        index_file = (dir / "test-multistream-index.txt.bz2").string();
+    }
+
+    static std::string page_xml(int i) {
+        return DumpTest::page_xml(static_cast<wikilib::PageId>(i), "Page " + std::to_string(i),
+                                  "content " + std::to_string(i));
+    }
+};
+
+// ============================================================================
+// Round trip tests
+// ============================================================================
+
+TEST_F(MultistreamWriterTest, WritesReadableMultistreamDump) {
+    std::string expected = "<mediawiki>\n";
+    {
+        MultistreamWriter writer(dump_file, index_file, {.pages_per_stream = 10, .threads = 3});
+        ASSERT_TRUE(writer.is_open());
+
+        writer.write_header("<mediawiki>\n");
+        for (int i = 1; i <= 95; ++i) {
+            writer.add_page(static_cast<wikilib::PageId>(i), "Page " + std::to_string(i), page_xml(i));
+            expected += page_xml(i) + "\n";
+        }
+        ASSERT_TRUE(writer.finish());
+        expected += "</mediawiki>\n";
+
+        EXPECT_EQ(writer.stats().pages_written, 95u);
+        EXPECT_EQ(writer.stats().streams_written, 12u);  // header + 10 groups + footer
+    }
+
+    EXPECT_EQ(read_bz2(dump_file), expected);
+}
+
+TEST_F(MultistreamWriterTest, IndexOffsetsPointToStreams) {
+    {
+        MultistreamWriter writer(dump_file, index_file, {.pages_per_stream = 4, .threads = 2});
+        writer.write_header("<mediawiki>\n");
+        for (int i = 1; i <= 10; ++i) {
+            writer.add_page(static_cast<wikilib::PageId>(i), "Page " + std::to_string(i), page_xml(i));
+        }
+        ASSERT_TRUE(writer.finish());
+    }
+
+    std::string dump = read_file(dump_file);
+    auto chunks = load_index_chunks(index_file, dump.size());
+    ASSERT_EQ(chunks.size(), 3u);
+    EXPECT_EQ(chunks[0].size(), 4u);
+    EXPECT_EQ(chunks[1].size(), 4u);
+    EXPECT_EQ(chunks[2].size(), 2u);
+    EXPECT_EQ(chunks[2].entries[1].title, "Page 10");
+    EXPECT_EQ(chunks[2].entries[1].page_id, 10u);
+
+    // Each chunk decompresses independently to its pages
+    auto second = decompress_bz2(std::string_view(dump).substr(
+            chunks[1].start_offset, chunks[1].end_offset - chunks[1].start_offset));
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(*second, page_xml(5) + "\n" + page_xml(6) + "\n" + page_xml(7) + "\n" + page_xml(8) + "\n");
+}
+
+TEST_F(MultistreamWriterTest, FailsOnUnwritablePath) {
+    MultistreamWriter writer((dir / "missing" / "x.bz2").string(), index_file);
+    EXPECT_FALSE(writer.is_open());
+    EXPECT_FALSE(writer.error().empty());
+    EXPECT_FALSE(writer.finish());
+}
+
+TEST_F(MultistreamWriterTest, RunsOnCallerPool) {
+    // Writing from a task of a one-worker pool must not wait on itself
+    wikilib::ThreadPool pool(wikilib::ThreadPoolConfig{.threads = 1});
+    std::string expected = "<mediawiki>\n";
+    bool finished = pool.submit([&] {
+        MultistreamWriter writer(dump_file, index_file,
+                                 {.pages_per_stream = 3, .pool = &pool, .max_pending_streams = 2});
+        writer.write_header("<mediawiki>\n");
+        for (int i = 1; i <= 20; ++i) {
+            writer.add_page(static_cast<wikilib::PageId>(i), "Page " + std::to_string(i), page_xml(i));
+            expected += page_xml(i) + "\n";
+        }
+        return writer.finish();
+    }).get();
+    ASSERT_TRUE(finished);
+    expected += "</mediawiki>\n";
+
+    EXPECT_EQ(read_bz2(dump_file), expected);
+}
+
+TEST_F(MultistreamWriterTest, StopsAtFirstFailedStream) {
+    if (!fs::exists("/dev/full")) {
+        GTEST_SKIP() << "No /dev/full";
+    }
+
+    // Every stream is larger than the stdio buffer, so each write fails at once
+    std::mt19937 rng(7);
+    std::string noise(64 * 1024, ' ');
+    for (char &c: noise) {
+        c = static_cast<char>('a' + rng() % 26);
+    }
+
+    MultistreamWriter writer("/dev/full", index_file, {.pages_per_stream = 1, .threads = 2});
+    ASSERT_TRUE(writer.is_open());
+    for (int i = 1; i <= 5; ++i) {
+        writer.add_page(static_cast<wikilib::PageId>(i), "Page " + std::to_string(i), "<page>" + noise + "</page>");
+    }
+    EXPECT_FALSE(writer.finish());
+    EXPECT_EQ(writer.error(), "Failed to write dump stream");
+    EXPECT_EQ(writer.stats().streams_written, 0u);
+    EXPECT_EQ(writer.stats().pages_written, 0u);
+    EXPECT_TRUE(read_file(index_file).empty());
+}
@@ -0,0 +1,159 @@
+/**
+ * @file test_page_handler.cpp
+ * @brief Tests for page-level dump handling
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "wikilib/dump/page_handler.h"
+
+using namespace wikilib::dump;
+
+static const std::string kLongText(500, 'x');
+
+static const std::string kDumpXml =
+    "<mediawiki>"
+    "<siteinfo><sitename>Wiki</sitename></siteinfo>"
+    "<page><title>Main</title><ns>0</ns><id>1</id>"
+    "<revision><id>10</id><contributor><username>Anna</username></contributor><text>" + kLongText + "</text></revision>"
+    "<revision><id>11</id><parentid>10</parentid><comment>fix</comment><text>latest</text></revision>"
+    "</page>"
+    "<page><title>Szablon:Box</title><ns>10</ns><id>2</id><redirect title=\"Szablon:Ramka\" />"
+    "<revision><id>20</id><text>short</text></revision>"
+    "</page>"
+    "<page><title>Empty</title><id>3</id></page>"
+    "</mediawiki>";
+
+static PageHandler make_handler() {
+    return PageHandler(std::make_unique<XmlReader>(XmlReader::from_string(kDumpXml)));
+}
+
+// ============================================================================
+// Page recycling
+// ============================================================================
+
+TEST(PageHandlerTest, ReusedPageIsRefilled) {
+    auto handler = make_handler();
+    Page page;
+
+    ASSERT_TRUE(handler.next_page(page));
+    EXPECT_EQ(page.info.title, "Main");
+    ASSERT_EQ(page.revisions.size(), 2u);
+    EXPECT_EQ(page.revisions[0].contributor, "Anna");
+    EXPECT_EQ(page.revisions[1].parent_id, 10u);
+    EXPECT_EQ(page.content(), "latest");
+
+    const char *content_buffer = page.revisions[0].content.data();
+    ASSERT_TRUE(handler.next_page(page));
+    EXPECT_EQ(page.info.title, "Szablon:Box");
+    EXPECT_EQ(page.info.namespace_id, 10);
+    EXPECT_EQ(page.info.redirect_target, "Szablon:Ramka");
+    ASSERT_EQ(page.revisions.size(), 1u);
+    EXPECT_EQ(page.revisions[0].id, 20u);
+    EXPECT_EQ(page.revisions[0].content, "short");
+    EXPECT_EQ(page.revisions[0].content.data(), content_buffer); // Heap buffer reused
+    EXPECT_GE(page.revisions[0].content.capacity(), kLongText.size());
+    EXPECT_TRUE(page.revisions[0].contributor.empty());
+    EXPECT_EQ(page.revisions[0].parent_id, 0u);
+
+    ASSERT_TRUE(handler.next_page(page));
+    EXPECT_EQ(page.info.title, "Empty");
+    EXPECT_EQ(page.info.namespace_id, 0);
+    EXPECT_FALSE(page.info.is_redirect());
+    EXPECT_TRUE(page.revisions.empty());
+
+    EXPECT_FALSE(handler.next_page(page));
+    EXPECT_EQ(handler.stats().pages_read, 3u);
+}
+
+TEST(PageHandlerTest, FilteredReuseAndProcess) {
+    PageFilter filter;
+    filter.include_redirects = false;
+
+    auto handler = make_handler();
+    Page page;
+    ASSERT_TRUE(handler.next_page(page, filter));
+    EXPECT_EQ(page.info.title, "Main");
+    ASSERT_TRUE(handler.next_page(page, filter));
+    EXPECT_EQ(page.info.title, "Empty");
+    EXPECT_EQ(handler.stats().pages_skipped, 1u);
+
+    std::vector<std::string> titles;
+    auto processed = make_handler();
+    processed.process([&titles](const Page &p) {
+        titles.push_back(p.info.title);
+        return true;
+    });
+    EXPECT_EQ(titles, (std::vector<std::string>{"Main", "Szablon:Box", "Empty"}));
+    EXPECT_EQ(processed.stats().pages_processed, 3u);
+}
+
+TEST(PageHandlerTest, OnlyLatestRevisionKeepsLastRevision) {
+    PageFilter filter;
+    filter.only_latest_revision = true;
+
+    auto handler = make_handler();
+    Page page;
+    ASSERT_TRUE(handler.next_page(page, filter));
+    ASSERT_EQ(page.revisions.size(), 1u);
+    EXPECT_EQ(page.revisions[0].id, 11u);
+    EXPECT_EQ(page.content(), "latest");
+}
+
+TEST(PageHandlerTest, OptionalApiStillReturnsFreshPages) {
+    auto handler = make_handler();
+    auto first = handler.next_page();
+    auto second = handler.next_page();
+    ASSERT_TRUE(first && second);
+    EXPECT_EQ(first->info.title, "Main");
+    EXPECT_EQ(second->info.title, "Szablon:Box");
+    EXPECT_EQ(first->revisions.size(), 2u);
+}
+
+// ============================================================================
+// Page scanner
+// ============================================================================
+
+TEST(PageScannerTest, HandsOutPagesWithTheirXml) {
+    std::string page_a = "<page><title>A</title><ns>0</ns><id>1</id><revision><text>one</text></revision></page>";
+    std::string page_b = "<page><title>B</title><ns>10</ns><id>2</id><revision><text>two</text></revision></page>";
+    std::string xml = "  " + page_a + "\n  " + page_b + "\n";
+
+    PageScanner scanner;
+    std::vector<std::string> seen;
+    size_t consumed = scanner.scan(xml, true, [&](std::string_view page_xml, const Page &page) {
+        seen.push_back(page.info.title + "=" + std::string(page.content()) + ":" + std::string(page_xml));
+        return true;
+    });
+    EXPECT_EQ(consumed, xml.size());
+    EXPECT_EQ(seen, (std::vector<std::string>{"A=one:" + page_a, "B=two:" + page_b}));
+
+    seen.clear();
+    consumed = scanner.scan(xml, true, [&](std::string_view, const Page &page) {
+        seen.push_back(page.info.title);
+        return false;
+    });
+    EXPECT_EQ(seen, (std::vector<std::string>{"A"}));
+    EXPECT_EQ(consumed, 2 + page_a.size());
+}
+
+TEST(PageScannerTest, LeavesUnfinishedPageForNextCall) {
+    std::string page_a = "<page><title>A</title><id>1</id></page>";
+    std::string xml = page_a + "<page><title>B</ti";
+
+    PageScanner scanner;
+    size_t pages = 0;
+    auto count = [&](std::string_view, const Page &) {
+        ++pages;
+        return true;
+    };
+    EXPECT_EQ(scanner.scan(xml, false, count), page_a.size());
+    EXPECT_EQ(pages, 1u);
+
+    EXPECT_EQ(scanner.scan("<page><title>B</ti", false, count), 0u);
+    EXPECT_EQ(scanner.scan("</siteinfo>\n  <pa", false, count), 12u);
+    EXPECT_EQ(scanner.scan("</mediawiki>", true, count), 12u);
+    EXPECT_EQ(pages, 1u);
+}
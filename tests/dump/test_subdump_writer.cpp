@@ -0,0 +1,154 @@
+/**
+ * @file test_subdump_writer.cpp
+ * @brief Tests for filtered multistream sub-dump builder
+ */
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "dump_test_fixture.h"
+#include "wikilib/dump/bz2_stream.h"
+#include "wikilib/dump/index_chunker.h"
+#include "wikilib/dump/subdump_writer.h"
+
+using namespace wikilib::dump;
+using wikilib::dump::testing::DumpTest;
+using wikilib::dump::testing::TestPage;
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Test fixture with source dump
+// ============================================================================
+
+class SubdumpWriterTest : public DumpTest {
+protected:
+    std::string src_dump;
+    std::string src_index;
+    std::string out_dump;
+    std::string out_index;
+
+    static constexpr const char* kHeader =
+        "<mediawiki>\n<siteinfo><sitename>Test</sitename><namespaces>"
+        "<namespace key=\"0\" />"
+        "<namespace key=\"10\">Template</namespace>"
+        "</namespaces></siteinfo>\n";
+
+    void SetUp() override {
+        DumpTest::SetUp();
+        src_dump = (dir / "src-multistream.xml.bz2").string();
+        src_index = (dir / "src-multistream-index.txt.bz2").string();
+        out_dump = (dir / "out-multistream.xml.bz2").string();
+        out_index = (dir / "out-multistream-index.txt.bz2").string();
+
+        // Chunks 1-2 are articles, 3-4 templates, 5 mixed
+        write_dump(src_dump, src_index, kHeader, 20, {.pages_per_stream = 4, .threads = 2}, [](int i) {
+            bool tmpl = (i > 8 && i <= 16) || (i > 16 && i % 2 == 0);
+            auto id = static_cast<wikilib::PageId>(i);
+            std::string title = tmpl ? "Template:T" + std::to_string(i) : "Page " + std::to_string(i);
+            std::string xml = page_xml(id, title, "content " + std::to_string(i), tmpl ? 10 : 0,
+                                       i == 12 ? "<redirect title=\"X\" />" : "");
+            return TestPage{id, title, xml};
+        });
+    }
+};
+
+// ============================================================================
+// Filtering tests
+// ============================================================================
+
+TEST_F(SubdumpWriterTest, CopiesWholeChunksVerbatim) {
+    PageFilter filter;
+    filter.namespaces = std::vector<wikilib::NamespaceId>{10};
+
+    auto result = write_subdump(src_dump, src_index, out_dump, out_index, filter, {.threads = 1});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.pages_written, 10u);
+    EXPECT_EQ(result.chunks_copied, 2u);
+    EXPECT_EQ(result.chunks_reencoded, 1u);
+    EXPECT_EQ(result.chunks_skipped, 2u);
+
+    std::string xml = read_bz2(out_dump);
+    EXPECT_EQ(xml.rfind(kHeader, 0), 0u);
+    EXPECT_NE(xml.find("Template:T9"), std::string::npos);
+    EXPECT_NE(xml.find("Template:T20"), std::string::npos);
+    EXPECT_EQ(xml.find("Page "), std::string::npos);
+    EXPECT_TRUE(xml.ends_with("</mediawiki>\n"));
+
+    auto chunks = load_index_chunks(out_index, fs::file_size(out_dump));
+    ASSERT_EQ(chunks.size(), 3u);
+    EXPECT_EQ(chunks[0].entries[0].title, "Template:T9");
+    EXPECT_EQ(chunks[2].size(), 2u);
+    EXPECT_EQ(chunks[2].entries[1].page_id, 20u);
+}
+
+TEST_F(SubdumpWriterTest, RedirectFilterDecompressesChunks) {
+    PageFilter filter;
+    filter.namespaces = std::vector<wikilib::NamespaceId>{10};
+    filter.include_redirects = false;
+
+    auto result = write_subdump(src_dump, src_index, out_dump, out_index, filter, {.threads = 1});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.pages_written, 9u);
+    EXPECT_EQ(result.chunks_copied, 0u);
+    EXPECT_EQ(result.chunks_reencoded, 3u);
+
+    std::string xml = read_bz2(out_dump);
+    EXPECT_EQ(xml.find("Template:T12"), std::string::npos);
+    EXPECT_NE(xml.find("Template:T13"), std::string::npos);
+}
+
+TEST_F(SubdumpWriterTest, MaxPagesStopsEarly) {
+    PageFilter filter;
+    filter.max_pages = 6;
+
+    auto result = write_subdump(src_dump, src_index, out_dump, out_index, filter, {.threads = 1});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.pages_written, 6u);
+    EXPECT_EQ(result.chunks_copied, 1u);
+
+    auto chunks = load_index_chunks(out_index, fs::file_size(out_dump));
+    size_t pages = 0;
+    for (const auto& chunk : chunks) {
+        pages += chunk.size();
+    }
+    EXPECT_EQ(pages, 6u);
+}
+
+TEST_F(SubdumpWriterTest, OnlyLatestRevisionDropsOlderRevisions) {
+    // Page 2 has two revisions; chunks are pages 1-4, 5-8 and 9-12
+    std::string history_dump = (dir / "history-multistream.xml.bz2").string();
+    std::string history_index = (dir / "history-multistream-index.txt.bz2").string();
+    write_dump(history_dump, history_index, kHeader, 12, {.pages_per_stream = 4, .threads = 1}, [](int i) {
+        auto id = static_cast<wikilib::PageId>(i);
+        std::string title = "Page " + std::to_string(i);
+        std::string xml = page_xml(id, title, "text " + std::to_string(i));
+        if (i == 2) {
+            xml.insert(xml.find("<revision>"), "<revision><text>old text 2</text></revision>");
+        }
+        return TestPage{id, title, xml};
+    });
+
+    PageFilter latest;
+    latest.only_latest_revision = true;
+    auto result = write_subdump(history_dump, history_index, out_dump, out_index, latest, {.threads = 1});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.pages_written, 12u);
+    EXPECT_EQ(result.chunks_copied, 1u);
+    EXPECT_EQ(result.chunks_reencoded, 2u);
+
+    std::string xml = read_bz2(out_dump);
+    EXPECT_EQ(xml.find("old text 2"), std::string::npos);
+    EXPECT_NE(xml.find("<id>2</id><revision><text>text 2</text></revision></page>"), std::string::npos);
+
+    // By default kept chunks are copied with every revision
+    result = write_subdump(history_dump, history_index, out_dump, out_index, {}, {.threads = 1});
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.chunks_copied, 2u);
+    EXPECT_EQ(result.chunks_reencoded, 1u);
+    EXPECT_NE(read_bz2(out_dump).find("old text 2"), std::string::npos);
+}
+
+TEST_F(SubdumpWriterTest, MissingDumpFails) {
+    auto result = write_subdump((dir / "missing.bz2").string(), src_index, out_dump, out_index, {});
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.error.empty());
+}
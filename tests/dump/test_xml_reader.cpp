@@ -0,0 +1,104 @@
+/**
+ * @file test_xml_reader.cpp
+ * @brief Tests for streaming XML reader
+ */
+
+#include <gtest/gtest.h>
+#include "wikilib/dump/xml_reader.h"
+
+using namespace wikilib::dump;
+
+static const char* kDumpXml =
+    "<mediawiki>"
+    "<siteinfo><sitename>Wiki</sitename></siteinfo>"
+    "<page><title>A</title><revision><text>alpha</text></revision></page>"
+    "<page><title>B</title><revision><text>beta</text></revision></page>"
+    "</mediawiki>";
+
+// ============================================================================
+// Path tracking
+// ============================================================================
+
+TEST(XmlReaderTest, CurrentPathAndIds) {
+    auto reader = XmlReader::from_string(kDumpXml);
+
+    while (auto event = reader.next()) {
+        if (event->type == XmlEventType::StartElement && event->name == "title") {
+            break;
+        }
+    }
+
+    EXPECT_EQ(reader.current_path(), "mediawiki/page/title");
+    ASSERT_EQ(reader.path_ids().size(), 3u);
+    EXPECT_EQ(reader.path_ids()[0], reader.intern_name("mediawiki"));
+    EXPECT_EQ(reader.path_ids()[1], reader.intern_name("page"));
+    EXPECT_EQ(reader.path_ids()[2], reader.intern_name("title"));
+    EXPECT_EQ(reader.current_element_id(), reader.intern_name("title"));
+}
+
+TEST(XmlReaderTest, InternNameIsStable) {
+    auto reader = XmlReader::from_string("<a/>");
+
+    uint32_t id = reader.intern_name("page");
+    EXPECT_EQ(reader.intern_name("page"), id);
+    EXPECT_NE(reader.intern_name("revision"), id);
+}
+
+TEST(XmlReaderTest, SelfClosingElementEmitsEnd) {
+    auto reader = XmlReader::from_string("<ns><n key=\"0\" /><n key=\"10\">Template</n></ns>");
+
+    while (auto event = reader.next()) {
+        if (event->type == XmlEventType::StartElement && event->name == "n") {
+            break;
+        }
+    }
+
+    EXPECT_EQ(reader.read_text(), "");
+    EXPECT_EQ(reader.current_path(), "ns");
+
+    auto event = reader.next();
+    ASSERT_TRUE(event.has_value());
+    EXPECT_EQ(event->type, XmlEventType::StartElement);
+    EXPECT_EQ(event->get_attribute("key").value_or(""), "10");
+    EXPECT_EQ(reader.read_text(), "Template");
+}
+
+// ============================================================================
+// Element iterator
+// ============================================================================
+
+TEST(XmlElementIteratorTest, MatchesFullPath) {
+    auto reader = XmlReader::from_string(kDumpXml);
+    XmlElementIterator it(reader, "mediawiki/page/title");
+
+    auto first = it.next();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->text_content, "A");
+
+    auto second = it.next();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->text_content, "B");
+
+    EXPECT_FALSE(it.next().has_value());
+}
+
+TEST(XmlElementIteratorTest, MatchesSingleName) {
+    auto reader = XmlReader::from_string(kDumpXml);
+    XmlElementIterator it(reader, "text");
+
+    std::vector<std::string> texts;
+    for (const auto& elem : it) {
+        texts.push_back(elem.text_content);
+    }
+
+    ASSERT_EQ(texts.size(), 2u);
+    EXPECT_EQ(texts[0], "alpha");
+    EXPECT_EQ(texts[1], "beta");
+}
+
+TEST(XmlElementIteratorTest, PartialPathDoesNotMatch) {
+    auto reader = XmlReader::from_string(kDumpXml);
+    XmlElementIterator it(reader, "page/title");
+
+    EXPECT_FALSE(it.next().has_value());
+}
@@ -0,0 +1,112 @@
+/**
+ * @file test_external_links.cpp
+ * @brief Tests for external link scanning, URL normalization and domain counting
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "wikilib/markup/external_links.h"
+
+using namespace wikilib::markup;
+
+// ============================================================================
+// Scanner tests
+// ============================================================================
+
+TEST(ExternalLinksTest, FindsBracketedAndFreeLinks) {
+    std::string_view text =
+        "See [https://example.org/a label], also http://foo.com/x.\n"
+        "{{cite web|url=http://bar.net/p|title=T}} (ftp://files.example/f) '''https://bold.org'''";
+
+    std::vector<ExternalUrl> urls;
+    collect_external_urls(text, urls);
+
+    ASSERT_EQ(urls.size(), 5u);
+    EXPECT_EQ(urls[0].url, "https://example.org/a");
+    EXPECT_TRUE(urls[0].bracketed);
+    EXPECT_EQ(urls[1].url, "http://foo.com/x");
+    EXPECT_FALSE(urls[1].bracketed);
+    EXPECT_EQ(urls[2].url, "http://bar.net/p");
+    EXPECT_EQ(urls[3].url, "ftp://files.example/f");
+    EXPECT_EQ(urls[4].url, "https://bold.org");
+    EXPECT_EQ(text.substr(urls[1].offset, urls[1].url.size()), urls[1].url);
+}
+
+TEST(ExternalLinksTest, SkipsUnknownSchemesAndComments) {
+    std::string_view text =
+        "javascript://x xhttp://y <!-- http://hidden.org --> https:// "
+        "Wiki_(band) http://en.wikipedia.org/wiki/Foo_(bar)";
+
+    std::vector<ExternalUrl> urls;
+    collect_external_urls(text, urls);
+
+    ASSERT_EQ(urls.size(), 1u);
+    EXPECT_EQ(urls[0].url, "http://en.wikipedia.org/wiki/Foo_(bar)");
+}
+
+TEST(ExternalLinksTest, SchemeWhitelist) {
+    EXPECT_TRUE(is_url_scheme("http"));
+    EXPECT_TRUE(is_url_scheme("HTTPS"));
+    EXPECT_TRUE(is_url_scheme("worldwind"));
+    EXPECT_FALSE(is_url_scheme("file"));
+    EXPECT_FALSE(is_url_scheme(""));
+}
+
+// ============================================================================
+// Normalization tests
+// ============================================================================
+
+TEST(ExternalLinksTest, NormalizesUrl) {
+    std::string out;
+
+    ASSERT_TRUE(normalize_url("HTTP://User@Example.COM:80", out));
+    EXPECT_EQ(out, "http://example.com/");
+
+    ASSERT_TRUE(normalize_url("https://example.com:8443/%7euser/a%2fb?q=%41#frag", out));
+    EXPECT_EQ(out, "https://example.com:8443/~user/a%2Fb?q=A");
+
+    ASSERT_TRUE(normalize_url("https://www.Example.org/x#top", out, {.strip_fragment = false, .strip_www = true}));
+    EXPECT_EQ(out, "https://example.org/x#top");
+
+    EXPECT_FALSE(normalize_url("mailto:someone@example.org", out));
+    EXPECT_TRUE(out.empty());
+    EXPECT_FALSE(normalize_url("http:///path", out));
+}
+
+TEST(ExternalLinksTest, DecodesPunycode) {
+    std::string out;
+    ASSERT_TRUE(decode_punycode("mnchen-3ya", out));
+    EXPECT_EQ(out, "m\xC3\xBCnchen");
+
+    out.clear();
+    EXPECT_FALSE(decode_punycode("ab!", out));
+    EXPECT_TRUE(out.empty());
+
+    ASSERT_TRUE(normalize_url("http://XN--MNCHEN-3YA.de/", out, {.decode_idn = true}));
+    EXPECT_EQ(out, "http://m\xC3\xBCnchen.de/");
+
+    EXPECT_EQ(url_host("https://user@[::1]:8080/x"), "[::1]");
+}
+
+// ============================================================================
+// Domain counting tests
+// ============================================================================
+
+TEST(ExternalLinksTest, CountsAndMergesDomains) {
+    DomainCounter a({.strip_www = true});
+    a.add_text("[http://www.example.org/a A] http://example.org/b https://other.net");
+
+    DomainCounter b({.strip_www = true});
+    b.add_text("http://Other.NET:80/x");
+    b.add_url("not a url");
+
+    a.merge(b);
+    EXPECT_EQ(a.total(), 4u);
+    EXPECT_EQ(a.count("example.org"), 2u);
+    EXPECT_EQ(a.count("other.net"), 2u);
+
+    auto top = a.top(1);
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].first, "example.org");
+}
@@ -0,0 +1,111 @@
+/**
+ * @file test_html_tags.cpp
+ * @brief Tests for interned HTML tag/attribute ids and attribute splitting
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "wikilib/markup/ast.h"
+#include "wikilib/markup/html_tags.h"
+#include "wikilib/markup/parser.h"
+#include "wikilib/markup/tokenizer.h"
+
+using namespace wikilib::markup;
+
+// ============================================================================
+// Lookup tests
+// ============================================================================
+
+TEST(HtmlTagsTest, LookupTag) {
+    EXPECT_EQ(lookup_html_tag("br"), HtmlTagId::Br);
+    EXPECT_EQ(lookup_html_tag("blockquote"), HtmlTagId::Blockquote);
+    EXPECT_EQ(lookup_html_tag("wbr"), HtmlTagId::Wbr);
+    EXPECT_EQ(lookup_html_tag("script"), HtmlTagId::Unknown);
+    EXPECT_EQ(lookup_html_tag(""), HtmlTagId::Unknown);
+    EXPECT_EQ(html_tag_name(HtmlTagId::Span), "span");
+    EXPECT_EQ(html_tag_name(HtmlTagId::Unknown), "");
+}
+
+TEST(HtmlTagsTest, LookupAttributeIgnoresCase) {
+    EXPECT_EQ(lookup_html_attribute("class"), HtmlAttrId::Class);
+    EXPECT_EQ(lookup_html_attribute("COLSPAN"), HtmlAttrId::Colspan);
+    EXPECT_EQ(lookup_html_attribute("onclick"), HtmlAttrId::Unknown);
+}
+
+TEST(HtmlTagsTest, SplitAttributes) {
+    std::vector<HtmlAttribute> attrs;
+    size_t count = split_html_attributes(R"( class="a b"  id='main' width=50 hidden href=x/y)", attrs);
+
+    ASSERT_EQ(count, 5u);
+    EXPECT_EQ(attrs[0].name, "class");
+    EXPECT_EQ(attrs[0].value, "a b");
+    EXPECT_EQ(attrs[0].id, HtmlAttrId::Class);
+    EXPECT_EQ(attrs[1].value, "main");
+    EXPECT_EQ(attrs[2].value, "50");
+    EXPECT_EQ(attrs[3].name, "hidden");
+    EXPECT_TRUE(attrs[3].value.empty());
+    EXPECT_EQ(attrs[4].value, "x/y");
+    EXPECT_EQ(attrs[4].id, HtmlAttrId::Unknown);
+}
+
+// ============================================================================
+// Tokenizer and AST integration
+// ============================================================================
+
+TEST(HtmlTagsTest, TokenizerSplitsAttributes) {
+    Tokenizer tok(R"(<span class="x" style='color:red'>a</span><br clear=all/>)");
+
+    Token open = tok.next();
+    ASSERT_EQ(open.type, TokenType::HtmlTagOpen);
+    EXPECT_EQ(open.tag_id, HtmlTagId::Span);
+    auto attrs = tok.attributes(open);
+    ASSERT_EQ(attrs.size(), 2u);
+    EXPECT_EQ(attrs[1].name, "style");
+    EXPECT_EQ(attrs[1].value, "color:red");
+
+    (void)tok.next(); // a
+    Token close = tok.next();
+    EXPECT_EQ(close.type, TokenType::HtmlTagClose);
+    EXPECT_TRUE(tok.attributes(close).empty());
+
+    Token br = tok.next();
+    EXPECT_TRUE(br.self_closing());
+    ASSERT_EQ(tok.attributes(br).size(), 1u);
+    EXPECT_EQ(tok.attributes(br)[0].value, "all");
+}
+
+TEST(HtmlTagsTest, ParsedTagHasIndexedAttributes) {
+    Parser parser;
+    auto result = parser.parse(R"(<div class="box" ID="top">text</div>)");
+    ASSERT_TRUE(result.success());
+
+    const HtmlTagNode *tag = nullptr;
+    for (const auto &block: result.document->content) {
+        for (const auto &child: block->children()) {
+            if (child->type == NodeType::HtmlTag) {
+                tag = static_cast<const HtmlTagNode *>(child.get());
+            }
+        }
+        if (block->type == NodeType::HtmlTag) {
+            tag = static_cast<const HtmlTagNode *>(block.get());
+        }
+    }
+    ASSERT_NE(tag, nullptr);
+
+    EXPECT_EQ(tag->tag_id, HtmlTagId::Div);
+    EXPECT_EQ(tag->get_attribute(HtmlAttrId::Class), "box");
+    EXPECT_EQ(tag->get_attribute(HtmlAttrId::Id), "top");
+    EXPECT_EQ(tag->get_attribute("class"), "box");
+    EXPECT_FALSE(tag->get_attribute(HtmlAttrId::Style).has_value());
+}
+
+TEST(HtmlTagsTest, AddAttributeKeepsFirstOccurrence) {
+    HtmlTagNode node;
+    node.add_attribute("class", "first");
+    node.add_attribute("class", "second");
+    node.add_attribute("data-x", "1");
+
+    EXPECT_EQ(node.attributes.size(), 3u);
+    EXPECT_EQ(node.get_attribute(HtmlAttrId::Class), "first");
+    EXPECT_EQ(node.get_attribute("data-x"), "1");
+}
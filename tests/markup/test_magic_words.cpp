@@ -0,0 +1,68 @@
+/**
+ * @file test_magic_words.cpp
+ * @brief Tests for behavior switch lookup, tokenization and document flags
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "wikilib/markup/magic_words.h"
+#include "wikilib/markup/parser.h"
+#include "wikilib/markup/tokenizer.h"
+
+using namespace wikilib::markup;
+
+TEST(MagicWordsTest, LookupAllNames) {
+    for (size_t i = 0; i < BEHAVIOR_SWITCH_COUNT; ++i) {
+        auto id = static_cast<BehaviorSwitch>(i);
+        auto found = lookup_behavior_switch(behavior_switch_name(id));
+        ASSERT_TRUE(found.has_value()) << behavior_switch_name(id);
+        EXPECT_EQ(*found, id);
+    }
+
+    EXPECT_EQ(lookup_behavior_switch("NOCC"), BehaviorSwitch::NoContentConvert);
+    EXPECT_EQ(lookup_behavior_switch("NOTC"), BehaviorSwitch::NoTitleConvert);
+    EXPECT_FALSE(lookup_behavior_switch("NOTOCX").has_value());
+    EXPECT_FALSE(lookup_behavior_switch("notoc").has_value());
+    EXPECT_FALSE(lookup_behavior_switch("").has_value());
+}
+
+TEST(MagicWordsTest, UnderscoresStayInText) {
+    Tokenizer tok("foo_bar __init__ x");
+    auto tokens = tok.tokenize_all();
+
+    for (const auto &t: tokens) {
+        EXPECT_NE(t.type, TokenType::MagicWord);
+    }
+    ASSERT_FALSE(tokens.empty());
+    EXPECT_EQ(tok.text(tokens[0]), "foo_bar __init__ x");
+}
+
+TEST(MagicWordsTest, TokenizesKnownSwitches) {
+    Tokenizer tok("a__NOTOC__b __UNKNOWN__");
+    auto tokens = tok.tokenize_all();
+
+    std::vector<std::string_view> magic;
+    for (const auto &t: tokens) {
+        if (t.type == TokenType::MagicWord) {
+            magic.push_back(tok.text(t));
+        }
+    }
+    ASSERT_EQ(magic.size(), 1u);
+    EXPECT_EQ(magic[0], "__NOTOC__");
+}
+
+TEST(MagicWordsTest, DocumentRecordsSwitches) {
+    Parser parser;
+    auto result = parser.parse("Intro __NOTOC__\n\n== H ==\n''text __NOEDITSECTION__''\n__NOCC__");
+    ASSERT_TRUE(result.success());
+
+    const auto &doc = *result.document;
+    EXPECT_TRUE(doc.has_switch(BehaviorSwitch::NoToc));
+    EXPECT_TRUE(doc.has_switch(BehaviorSwitch::NoEditSection));
+    EXPECT_TRUE(doc.has_switch(BehaviorSwitch::NoContentConvert));
+    EXPECT_FALSE(doc.has_switch(BehaviorSwitch::ForceToc));
+    EXPECT_EQ(doc.behavior_switches.count(), 3u);
+
+    auto again = parser.parse("plain");
+    EXPECT_TRUE(again.document->behavior_switches.none());
+}
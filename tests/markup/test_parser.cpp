@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
+#include <functional>
 #include "wikilib/markup/parser.h"
+#include "wikilib/markup/wikitext_visitor.h"
 
+using namespace wikilib;
 using namespace wikilib::markup;
 
 // ============================================================================
@@ -140,6 +143,95 @@ TEST(ParserTest, ParseBoldItalic) {
     EXPECT_TRUE(found_formatting);
 }
 
+namespace {
+
+// Render formatting as <b>/<i>/<bi> tags, everything else as plain text
+std::string render_quotes(const NodeList &nodes) {
+    std::string out;
+    for (const auto &node: nodes) {
+        if (node->type == NodeType::Formatting) {
+            auto *fmt = static_cast<FormattingNode *>(node.get());
+            const char *tag = fmt->style == FormattingNode::Style::Bold     ? "b"
+                              : fmt->style == FormattingNode::Style::Italic ? "i"
+                                                                            : "bi";
+            out += std::string("<") + tag + ">" + render_quotes(fmt->content) + "</" + tag + ">";
+        } else if (node->type == NodeType::Paragraph) {
+            out += render_quotes(static_cast<ParagraphNode *>(node.get())->content);
+        } else if (node->type == NodeType::Link) {
+            out += "[" + render_quotes(static_cast<LinkNode *>(node.get())->display_content) + "]";
+        } else {
+            out += node->to_plain_text();
+        }
+    }
+    return out;
+}
+
+std::string render_quotes(std::string_view input) {
+    return render_quotes(parse(input).document->content);
+}
+
+} // namespace
+
+TEST(ParserTest, QuotesOverlapAreReopened) {
+    EXPECT_EQ(render_quotes("'''bold ''both''' italic''"), "<b>bold <i>both</i></b><i> italic</i>");
+    EXPECT_EQ(render_quotes("''italic '''both'' bold'''"), "<i>italic <b>both</b></i><b> bold</b>");
+}
+
+TEST(ParserTest, QuotesFiveRunNestingFollowsNextRun) {
+    EXPECT_EQ(render_quotes("'''''x''' y''"), "<i><b>x</b> y</i>");
+    EXPECT_EQ(render_quotes("'''''x'' y'''"), "<b><i>x</i> y</b>");
+    EXPECT_EQ(render_quotes("'''''x'''''"), "<bi>x</bi>");
+}
+
+TEST(ParserTest, QuotesOddBoldReadAsApostrophe) {
+    // Bold after a single-letter word wins over one after a space
+    EXPECT_EQ(render_quotes("a '''b l'''amour'' x'''"), "a <b>b l'<i>amour</i> x</b>");
+    EXPECT_EQ(render_quotes("l'''arbre''"), "l'<i>arbre</i>");
+}
+
+TEST(ParserTest, QuotesSurplusApostrophesAreText) {
+    EXPECT_EQ(render_quotes("''''bold'''"), "'<b>bold</b>");
+    EXPECT_EQ(render_quotes("''''''x'''''"), "'<bi>x</bi>");
+}
+
+TEST(ParserTest, QuotesClosedAtEndOfLine) {
+    EXPECT_EQ(render_quotes("''a\nb''c"), "<i>a</i>\nb<i>c</i>");
+}
+
+TEST(ParserTest, QuotesInsideLinkLabel) {
+    // Runs inside the label belong to the same line; the open bold spans the link
+    EXPECT_EQ(render_quotes("'''a [[L|''b'']] c"), "<b>a [<i>b</i>] c</b>");
+}
+
+TEST(ParserTest, QuotesClosedInsideLinkEndWithIt) {
+    // The italic opened before the link closes inside it; "d" is plain
+    EXPECT_EQ(render_quotes("''a[[b|c'']]d''"), "<i>a[c]</i>d<i></i>");
+    EXPECT_EQ(render_quotes("''a[[b|c'']]d''e''"), "<i>a[c]</i>d<i>e</i>");
+}
+
+TEST(ParserTest, QuotesOpenedInsideLinkContinueAfterIt) {
+    EXPECT_EQ(render_quotes("[[a|b''c]]d''e"), "[b<i>c</i>]<i>d</i>e");
+    EXPECT_EQ(render_quotes("[[a|b''c]]''d"), "[b<i>c</i>]d");
+    EXPECT_EQ(render_quotes("[[a|'''b''c]]d'''e''"), "[<b>b<i>c</i></b>]<b><i>d</i></b><i>e</i>");
+    EXPECT_EQ(render_quotes("[[a|b <span>''c</span> d]] e''"), "[b c<i> d</i>]<i> e</i>");
+}
+
+TEST(ParserTest, QuotesNeverLeaveEmptyText) {
+    auto result = parse("''a[[b|c'']]d''");
+    std::function<void(const NodeList &)> check = [&](const NodeList &nodes) {
+        for (const auto &node: nodes) {
+            if (node->type == NodeType::Text) {
+                EXPECT_FALSE(static_cast<TextNode *>(node.get())->text.empty());
+            } else if (node->type == NodeType::Formatting) {
+                check(static_cast<FormattingNode *>(node.get())->content);
+            } else if (node->type == NodeType::Link) {
+                check(static_cast<LinkNode *>(node.get())->display_content);
+            }
+        }
+    };
+    check(result.document->content);
+}
+
 // ============================================================================
 // Link tests
 // ============================================================================
@@ -450,6 +542,45 @@ TEST(ParserTest, ParseCategory) {
     EXPECT_TRUE(found_category);
 }
 
+TEST(ParserTest, ParseCategoryWithSiteNamespaces) {
+    Namespace category;
+    category.id = NS_CATEGORY;
+    category.name = "Категория";
+    std::vector<Namespace> namespaces{category};
+    NamespaceResolver resolver(namespaces);
+
+    ParserConfig config;
+    config.tokenizer.namespaces = &resolver;
+    Parser parser(config);
+    auto result = parser.parse("[[Категория:Физика]] [[category:Science]] [[:Category:Linked]]");
+    ASSERT_TRUE(result.success());
+
+    std::vector<std::string> categories;
+    for (const auto& node : result.document->content) {
+        if (node->type == NodeType::Category) {
+            categories.push_back(static_cast<CategoryNode*>(node.get())->category);
+        }
+    }
+    ASSERT_EQ(categories.size(), 2u);
+    EXPECT_EQ(categories[0], "Физика");
+    EXPECT_EQ(categories[1], "Science");
+}
+
+TEST(ParserTest, LinkExtractorClassifiesNamespaces) {
+    Parser parser;
+    auto result = parser.parse("[[Template:Infobox]] [[:Category:Physics]] [[File:X.png]] [[Star Wars: Episode IV]]");
+    ASSERT_TRUE(result.success());
+
+    LinkExtractor extractor;
+    extractor.visit(*result.document);
+    const auto& links = extractor.links();
+    ASSERT_EQ(links.size(), 4u);
+    EXPECT_EQ(links[0].namespace_id, NS_TEMPLATE);
+    EXPECT_EQ(links[1].namespace_id, NS_CATEGORY);
+    EXPECT_EQ(links[2].namespace_id, NS_FILE);
+    EXPECT_EQ(links[3].namespace_id, NS_MAIN);
+}
+
 // ============================================================================
 // Table tests
 // ============================================================================
@@ -559,6 +690,53 @@ TEST(ParserTest, ParserConfig_DisableTables) {
     EXPECT_FALSE(found_table);
 }
 
+// ============================================================================
+// Nesting tests
+// ============================================================================
+
+TEST(ParserTest, DeepNestingKeepsContent) {
+    std::string input;
+    for (int i = 0; i < 500; ++i) {
+        input += "{{T|";
+    }
+    input += "inner";
+    for (int i = 0; i < 500; ++i) {
+        input += "}}";
+    }
+
+    // Deeper than the default limit; the frame stack itself has no such bound
+    ParserConfig config;
+    config.max_depth = 1000;
+    Parser parser(config);
+    auto result = parser.parse(input);
+
+    EXPECT_EQ(result.error_counts.count(wikilib::ErrorCode::MaxDepthExceeded), 0u);
+    const Node *node = result.document->content.at(0).get();
+    int depth = 1;
+    while (node->type == NodeType::Template) {
+        const auto &params = static_cast<const TemplateNode *>(node)->parameters;
+        ASSERT_EQ(params.size(), 1u);
+        node = params[0].value.at(0).get();
+        depth++;
+    }
+    EXPECT_EQ(depth, 501);
+    EXPECT_EQ(node->to_plain_text(), "inner");
+}
+
+TEST(ParserTest, MaxDepthExceeded) {
+    ParserConfig config;
+    config.max_depth = 10;
+    Parser parser(config);
+    auto result = parser.parse("[[A|[[B|[[C|[[D|[[E|[[F|[[G|[[H|[[I|[[J|[[K|x]]]]]]]]]]]]]]]]]]]]]]");
+
+    EXPECT_GT(result.error_counts.count(wikilib::ErrorCode::MaxDepthExceeded), 0u);
+}
+
+TEST(ParserTest, StrayEndMarkersAreText) {
+    EXPECT_EQ(parse_to_text("a ] b"), "a ] b");
+    EXPECT_EQ(parse_to_text("x</span>y"), "x</span>y");
+}
+
 // ============================================================================
 // Error handling tests
 // ============================================================================
@@ -621,3 +799,61 @@ TEST(ParserTest, ParseInline) {
 
     EXPECT_TRUE(has_formatting || has_link); // At least one
 }
+
+// ============================================================================
+// Error reporting modes
+// ============================================================================
+
+TEST(ParserTest, UnclosedConstructsAreNotErrors) {
+    Parser parser;
+    EXPECT_FALSE(parser.parse("{{foo").has_errors());
+    EXPECT_FALSE(parser.parse("Text {{Unclosed|a\n\n[[Link <span>x").has_errors());
+}
+
+TEST(ParserTest, CompactErrorsFormatOnDemand) {
+    std::string_view input = "Text {{a|{{b|{{c}}}}}}";
+    ParserConfig config;
+    config.max_depth = 2;
+    Parser parser(config);
+    auto result = parser.parse(input);
+
+    ASSERT_TRUE(result.success());
+    ASSERT_TRUE(result.has_errors());
+    EXPECT_GT(result.error_counts.count(wikilib::ErrorCode::MaxDepthExceeded), 0u);
+    EXPECT_EQ(result.errors.size(), result.error_counts.total());
+
+    const auto &error = result.errors[0];
+    EXPECT_TRUE(error.message.empty());
+    EXPECT_EQ(error.code, wikilib::ErrorCode::MaxDepthExceeded);
+    EXPECT_NE(error.format().find(wikilib::error_code_message(error.code)), std::string::npos);
+    EXPECT_NE(error.format(input).find("Context:"), std::string::npos);
+}
+
+TEST(ParserTest, CounterOnlyErrors) {
+    ParserConfig config;
+    config.max_depth = 1;
+    config.error_reporting = wikilib::ErrorReporting::Counters;
+    Parser parser(config);
+    auto result = parser.parse("{{A|{{B}}}} [[C|{{D}}]]");
+
+    EXPECT_TRUE(result.errors.empty());
+    EXPECT_TRUE(result.has_errors());
+    EXPECT_GT(result.error_counts.count(wikilib::ErrorCode::MaxDepthExceeded), 0u);
+    EXPECT_EQ(result.error_counts.count(wikilib::ErrorSeverity::Error), result.error_counts.total());
+}
+
+TEST(ParserTest, ErrorsOff) {
+    ParserConfig config;
+    config.max_depth = 1;
+    config.error_reporting = wikilib::ErrorReporting::Off;
+    Parser parser(config);
+    auto result = parser.parse("{{A|{{B}}}}");
+
+    EXPECT_FALSE(result.has_errors());
+    EXPECT_EQ(result.error_counts.total(), 0u);
+}
+
+TEST(ParserTest, FreeFormErrorFormat) {
+    wikilib::ParseError error{"Custom problem", {}, wikilib::ErrorSeverity::Error, ""};
+    EXPECT_TRUE(error.format().starts_with("Error: Custom problem"));
+}
@@ -0,0 +1,95 @@
+/**
+ * @file test_ref_scanner.cpp
+ * @brief Tests for <ref> and <references> scanner
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "wikilib/markup/ref_scanner.h"
+
+using namespace wikilib::markup;
+
+// ============================================================================
+// Scanner tests
+// ============================================================================
+
+TEST(RefScannerTest, FindsRefKinds) {
+    std::string_view text =
+        "A<ref>plain</ref> B<ref name=\"x\" group='n'>named</ref> "
+        "C<ref name=x /> D<REF NAME = y/>\n"
+        "<references />";
+
+    RefScanner scanner(text);
+    RefSpan ref;
+
+    ASSERT_TRUE(scanner.next(ref));
+    EXPECT_EQ(ref.body, "plain");
+    EXPECT_TRUE(ref.name.empty());
+    EXPECT_EQ(text.substr(ref.location.begin.offset, ref.location.length()), "<ref>plain</ref>");
+
+    ASSERT_TRUE(scanner.next(ref));
+    EXPECT_EQ(ref.body, "named");
+    EXPECT_EQ(ref.name, "x");
+    EXPECT_EQ(ref.group, "n");
+
+    ASSERT_TRUE(scanner.next(ref));
+    EXPECT_TRUE(ref.self_closing);
+    EXPECT_EQ(ref.name, "x");
+    EXPECT_TRUE(ref.body.empty());
+
+    ASSERT_TRUE(scanner.next(ref));
+    EXPECT_TRUE(ref.self_closing);
+    EXPECT_EQ(ref.name, "y");
+
+    ASSERT_TRUE(scanner.next(ref));
+    EXPECT_TRUE(ref.is_references);
+    EXPECT_TRUE(ref.self_closing);
+
+    EXPECT_FALSE(scanner.next(ref));
+}
+
+TEST(RefScannerTest, SkipsCommentsNowikiAndLookalikes) {
+    std::string_view text =
+        "<!-- <ref>hidden</ref> --><nowiki><ref>raw</ref></nowiki>"
+        "<refx>no</refx><reference>no</reference><ref>yes</ref><ref>open";
+
+    RefScanner scanner(text);
+    RefSpan ref;
+    ASSERT_TRUE(scanner.next(ref));
+    EXPECT_EQ(ref.body, "yes");
+    EXPECT_FALSE(scanner.next(ref));
+}
+
+TEST(RefScannerTest, ListDefinedRefs) {
+    std::string_view text =
+        "Text<ref name=\"a\" />\n"
+        "<references>\n<ref name=\"a\">Defined later</ref>\n</references>";
+
+    std::vector<RefSpan> refs;
+    collect_refs(text, refs);
+    ASSERT_EQ(refs.size(), 1u);
+    EXPECT_EQ(refs[0].name, "a");
+    EXPECT_EQ(refs[0].body, "Defined later");
+    EXPECT_EQ(refs[0].uses, 2u);
+    EXPECT_FALSE(refs[0].self_closing);
+}
+
+// ============================================================================
+// Collection tests
+// ============================================================================
+
+TEST(RefScannerTest, CollectDedupesByGroupAndName) {
+    std::string_view text =
+        "<ref name=a>one</ref><ref name=a/><ref name=a group=g>two</ref>"
+        "<ref>anon</ref><ref>anon</ref>";
+
+    std::vector<RefSpan> refs;
+    collect_refs(text, refs);
+    ASSERT_EQ(refs.size(), 4u);
+    EXPECT_EQ(refs[0].body, "one");
+    EXPECT_EQ(refs[0].uses, 2u);
+    EXPECT_EQ(refs[1].group, "g");
+    EXPECT_EQ(refs[1].uses, 1u);
+    EXPECT_EQ(refs[2].body, "anon");
+    EXPECT_EQ(refs[3].body, "anon");
+}
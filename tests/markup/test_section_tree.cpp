@@ -18,13 +18,13 @@ TEST(SectionTreeTest, EmptyDocument) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
-    EXPECT_TRUE(tree->title.empty());
-    EXPECT_EQ(tree->level, 0);
-    EXPECT_TRUE(tree->is_root());
-    EXPECT_EQ(tree->content.size(), 0u);
-    EXPECT_EQ(tree->children.size(), 0u);
+    EXPECT_TRUE(root.title.empty());
+    EXPECT_EQ(root.level, 0);
+    EXPECT_TRUE(root.is_root());
+    EXPECT_EQ(root.content.size(), 0u);
+    EXPECT_EQ(tree.children(root).size(), 0u);
 }
 
 TEST(SectionTreeTest, SingleTextNode) {
@@ -32,12 +32,12 @@ TEST(SectionTreeTest, SingleTextNode) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
-    EXPECT_TRUE(tree->title.empty());
-    EXPECT_EQ(tree->level, 0);
-    EXPECT_EQ(tree->content.size(), 1u);
-    EXPECT_EQ(tree->children.size(), 0u);
+    EXPECT_TRUE(root.title.empty());
+    EXPECT_EQ(root.level, 0);
+    EXPECT_EQ(root.content.size(), 1u);
+    EXPECT_EQ(tree.children(root).size(), 0u);
 }
 
 TEST(SectionTreeTest, SingleSection) {
@@ -45,19 +45,19 @@ TEST(SectionTreeTest, SingleSection) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Root should have no content, one child
-    EXPECT_EQ(tree->content.size(), 0u);
-    EXPECT_EQ(tree->children.size(), 1u);
+    EXPECT_EQ(root.content.size(), 0u);
+    EXPECT_EQ(tree.children(root).size(), 1u);
 
     // Check first section
-    auto& section = tree->children[0];
-    EXPECT_EQ(section->title, "Introduction");
-    EXPECT_EQ(section->level, 2);
-    EXPECT_FALSE(section->is_root());
-    EXPECT_EQ(section->content.size(), 1u);  // "Some text here."
-    EXPECT_EQ(section->children.size(), 0u);
+    const Section& section = tree.children(root)[0];
+    EXPECT_EQ(section.title, "Introduction");
+    EXPECT_EQ(section.level, 2);
+    EXPECT_FALSE(section.is_root());
+    EXPECT_EQ(section.content.size(), 1u);  // "Some text here."
+    EXPECT_EQ(tree.children(section).size(), 0u);
 }
 
 TEST(SectionTreeTest, TwoSectionsAtSameLevel) {
@@ -70,18 +70,18 @@ Text 2
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Root should have 2 children at same level
-    EXPECT_EQ(tree->children.size(), 2u);
+    EXPECT_EQ(tree.children(root).size(), 2u);
 
-    EXPECT_EQ(tree->children[0]->title, "Section 1");
-    EXPECT_EQ(tree->children[0]->level, 2);
-    EXPECT_GT(tree->children[0]->content.size(), 0u);
+    EXPECT_EQ(tree.children(root)[0].title, "Section 1");
+    EXPECT_EQ(tree.children(root)[0].level, 2);
+    EXPECT_GT(tree.children(root)[0].content.size(), 0u);
 
-    EXPECT_EQ(tree->children[1]->title, "Section 2");
-    EXPECT_EQ(tree->children[1]->level, 2);
-    EXPECT_GT(tree->children[1]->content.size(), 0u);
+    EXPECT_EQ(tree.children(root)[1].title, "Section 2");
+    EXPECT_EQ(tree.children(root)[1].level, 2);
+    EXPECT_GT(tree.children(root)[1].content.size(), 0u);
 }
 
 // ============================================================================
@@ -100,29 +100,29 @@ Text 2
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Root should have 2 top-level sections
-    EXPECT_EQ(tree->children.size(), 2u);
+    EXPECT_EQ(tree.children(root).size(), 2u);
 
     // Section 1 should have a subsection
-    auto& sec1 = tree->children[0];
-    EXPECT_EQ(sec1->title, "Section 1");
-    EXPECT_EQ(sec1->level, 2);
-    EXPECT_EQ(sec1->children.size(), 1u);
+    const Section& sec1 = tree.children(root)[0];
+    EXPECT_EQ(sec1.title, "Section 1");
+    EXPECT_EQ(sec1.level, 2);
+    EXPECT_EQ(tree.children(sec1).size(), 1u);
 
     // Check subsection
-    auto& subsec = sec1->children[0];
-    EXPECT_EQ(subsec->title, "Subsection 1.1");
-    EXPECT_EQ(subsec->level, 3);
-    EXPECT_GT(subsec->content.size(), 0u);
-    EXPECT_EQ(subsec->children.size(), 0u);
+    const Section& subsec = tree.children(sec1)[0];
+    EXPECT_EQ(subsec.title, "Subsection 1.1");
+    EXPECT_EQ(subsec.level, 3);
+    EXPECT_GT(subsec.content.size(), 0u);
+    EXPECT_EQ(tree.children(subsec).size(), 0u);
 
     // Section 2 should have no subsections
-    auto& sec2 = tree->children[1];
-    EXPECT_EQ(sec2->title, "Section 2");
-    EXPECT_EQ(sec2->level, 2);
-    EXPECT_EQ(sec2->children.size(), 0u);
+    const Section& sec2 = tree.children(root)[1];
+    EXPECT_EQ(sec2.title, "Section 2");
+    EXPECT_EQ(sec2.level, 2);
+    EXPECT_EQ(tree.children(sec2).size(), 0u);
 }
 
 TEST(SectionTreeTest, DeepNesting) {
@@ -139,26 +139,26 @@ Text at level 5
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Check nesting depth
-    EXPECT_EQ(tree->children.size(), 1u);
+    EXPECT_EQ(tree.children(root).size(), 1u);
 
-    auto* current = tree->children[0].get();
+    const Section* current = &tree.children(root)[0];
     EXPECT_EQ(current->level, 2);
-    EXPECT_EQ(current->children.size(), 1u);
+    EXPECT_EQ(tree.children(*current).size(), 1u);
 
-    current = current->children[0].get();
+    current = &tree.children(*current)[0];
     EXPECT_EQ(current->level, 3);
-    EXPECT_EQ(current->children.size(), 1u);
+    EXPECT_EQ(tree.children(*current).size(), 1u);
 
-    current = current->children[0].get();
+    current = &tree.children(*current)[0];
     EXPECT_EQ(current->level, 4);
-    EXPECT_EQ(current->children.size(), 1u);
+    EXPECT_EQ(tree.children(*current).size(), 1u);
 
-    current = current->children[0].get();
+    current = &tree.children(*current)[0];
     EXPECT_EQ(current->level, 5);
-    EXPECT_EQ(current->children.size(), 0u);
+    EXPECT_EQ(tree.children(*current).size(), 0u);
 }
 
 TEST(SectionTreeTest, SkippedLevels) {
@@ -171,16 +171,16 @@ Skipped level 3
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Level 4 should still be child of level 2
-    EXPECT_EQ(tree->children.size(), 1u);
-    auto& sec2 = tree->children[0];
-    EXPECT_EQ(sec2->level, 2);
-    EXPECT_EQ(sec2->children.size(), 1u);
+    EXPECT_EQ(tree.children(root).size(), 1u);
+    const Section& sec2 = tree.children(root)[0];
+    EXPECT_EQ(sec2.level, 2);
+    EXPECT_EQ(tree.children(sec2).size(), 1u);
 
-    auto& sec4 = sec2->children[0];
-    EXPECT_EQ(sec4->level, 4);
+    const Section& sec4 = tree.children(sec2)[0];
+    EXPECT_EQ(sec4.level, 4);
 }
 
 TEST(SectionTreeTest, LevelReduction) {
@@ -197,18 +197,18 @@ Text 3 again
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
-    auto& sec2 = tree->children[0];
-    EXPECT_EQ(sec2->children.size(), 2u);  // Two level 3 sections
+    const Section& sec2 = tree.children(root)[0];
+    EXPECT_EQ(tree.children(sec2).size(), 2u);  // Two level 3 sections
 
-    auto& sec3_first = sec2->children[0];
-    EXPECT_EQ(sec3_first->level, 3);
-    EXPECT_EQ(sec3_first->children.size(), 1u);  // Has level 4 child
+    const Section& sec3_first = tree.children(sec2)[0];
+    EXPECT_EQ(sec3_first.level, 3);
+    EXPECT_EQ(tree.children(sec3_first).size(), 1u);  // Has level 4 child
 
-    auto& sec3_second = sec2->children[1];
-    EXPECT_EQ(sec3_second->level, 3);
-    EXPECT_EQ(sec3_second->children.size(), 0u);  // No children
+    const Section& sec3_second = tree.children(sec2)[1];
+    EXPECT_EQ(sec3_second.level, 3);
+    EXPECT_EQ(tree.children(sec3_second).size(), 0u);  // No children
 }
 
 // ============================================================================
@@ -225,14 +225,14 @@ Section text.
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Root should have preamble content
-    EXPECT_GT(tree->content.size(), 0u);
+    EXPECT_GT(root.content.size(), 0u);
 
     // And one child section
-    EXPECT_EQ(tree->children.size(), 1u);
-    EXPECT_EQ(tree->children[0]->title, "First Section");
+    EXPECT_EQ(tree.children(root).size(), 1u);
+    EXPECT_EQ(tree.children(root)[0].title, "First Section");
 }
 
 TEST(SectionTreeTest, ContentBetweenHeadings) {
@@ -246,13 +246,13 @@ Content of section 2.
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
-    EXPECT_EQ(tree->children.size(), 2u);
+    EXPECT_EQ(tree.children(root).size(), 2u);
 
     // Each section should have its own content
-    EXPECT_GT(tree->children[0]->content.size(), 0u);
-    EXPECT_GT(tree->children[1]->content.size(), 0u);
+    EXPECT_GT(tree.children(root)[0].content.size(), 0u);
+    EXPECT_GT(tree.children(root)[1].content.size(), 0u);
 }
 
 TEST(SectionTreeTest, EmptySections) {
@@ -264,15 +264,15 @@ Some content here.
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
-    EXPECT_EQ(tree->children.size(), 2u);
+    EXPECT_EQ(tree.children(root).size(), 2u);
 
     // Section 1 has no content
-    EXPECT_EQ(tree->children[0]->content.size(), 0u);
+    EXPECT_EQ(tree.children(root)[0].content.size(), 0u);
 
     // Section 2 has content
-    EXPECT_GT(tree->children[1]->content.size(), 0u);
+    EXPECT_GT(tree.children(root)[1].content.size(), 0u);
 }
 
 // ============================================================================
@@ -292,10 +292,10 @@ Text 2
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Total content count includes all content in tree
-    size_t total = tree->total_content_count();
+    size_t total = tree.total_content_count(root);
     EXPECT_GT(total, 0u);
 }
 
@@ -309,11 +309,11 @@ TEST(SectionTreeTest, TotalSectionCount) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Should count all sections and subsections
     // 2 at level 2, 1 at level 3, 1 at level 4 = 4 total
-    EXPECT_EQ(tree->total_section_count(), 4u);
+    EXPECT_EQ(tree.total_section_count(root), 4u);
 }
 
 TEST(SectionTreeTest, IsRootCheck) {
@@ -321,10 +321,10 @@ TEST(SectionTreeTest, IsRootCheck) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
-    EXPECT_TRUE(tree->is_root());
-    EXPECT_FALSE(tree->children[0]->is_root());
+    EXPECT_TRUE(root.is_root());
+    EXPECT_FALSE(tree.children(root)[0].is_root());
 }
 
 // ============================================================================
@@ -340,11 +340,9 @@ TEST(SectionTreeTest, TraverseSections) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
-
     // Count sections using traversal
     int count = 0;
-    traverse_sections(tree, [&count](const SectionNodePtr& node) {
+    traverse_sections(tree, [&count](const Section& node) {
         count++;
     });
 
@@ -363,13 +361,11 @@ TEST(SectionTreeTest, FindSectionByTitle) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
-
     // Find existing section
     auto methods = find_section(tree, "Methods");
     ASSERT_TRUE(methods != nullptr);
     EXPECT_EQ(methods->level, 2);
-    EXPECT_EQ(methods->children.size(), 2u);
+    EXPECT_EQ(tree.children(*methods).size(), 2u);
 
     // Find nested section
     auto setup = find_section(tree, "Setup");
@@ -395,8 +391,6 @@ More text
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
-
     std::string output = section_tree_to_string(tree);
 
     // Should contain ROOT and both sections
@@ -414,8 +408,6 @@ TEST(SectionTreeTest, PrintNestedTree) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
-
     std::string output = section_tree_to_string(tree);
 
     // Check tree structure indicators
@@ -430,12 +422,12 @@ TEST(SectionTreeTest, PrintNestedTree) {
 
 TEST(SectionTreeTest, NullDocument) {
     auto tree = build_section_tree(nullptr);
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
-    EXPECT_TRUE(tree->title.empty());
-    EXPECT_TRUE(tree->is_root());
-    EXPECT_EQ(tree->content.size(), 0u);
-    EXPECT_EQ(tree->children.size(), 0u);
+    EXPECT_TRUE(root.title.empty());
+    EXPECT_TRUE(root.is_root());
+    EXPECT_EQ(root.content.size(), 0u);
+    EXPECT_EQ(tree.children(root).size(), 0u);
 }
 
 TEST(SectionTreeTest, HeadingWithComplexContent) {
@@ -443,13 +435,40 @@ TEST(SectionTreeTest, HeadingWithComplexContent) {
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
-    EXPECT_EQ(tree->children.size(), 1u);
-    auto& section = tree->children[0];
+    EXPECT_EQ(tree.children(root).size(), 1u);
+    const Section& section = tree.children(root)[0];
 
     // Title should contain text from heading (may include markup)
-    EXPECT_FALSE(section->title.empty());
+    EXPECT_FALSE(section.title.empty());
+}
+
+TEST(SectionTreeTest, SectionsViewIntoDocument) {
+    auto doc = parse("Lead\n== A ==\nText A\n=== B ===\nText B\n== C ==\nText C");
+    ASSERT_TRUE(doc.success());
+
+    auto tree = build_section_tree(doc.document.get());
+    const auto& nodes = doc.document->content;
+    ASSERT_EQ(tree.size(), 4u);
+
+    // Subsections of a section follow it contiguously
+    const Section& a = tree[1];
+    EXPECT_EQ(a.title, "A");
+    EXPECT_EQ(a.end, 3u);
+    EXPECT_EQ(tree.parent(tree[2]), &a);
+    EXPECT_EQ(tree.parent(tree[3]), &tree.root());
+    EXPECT_EQ(tree.parent(tree.root()), nullptr);
+
+    // Content is a range of the document's own nodes
+    for (const Section& section : tree.sections()) {
+        for (const auto& node : section.content) {
+            EXPECT_GE(&node, nodes.data());
+            EXPECT_LT(&node, nodes.data() + nodes.size());
+            EXPECT_NE(node->type, NodeType::Heading);
+        }
+    }
+    EXPECT_EQ(tree.total_content_count(a), a.content.size() + tree[2].content.size());
 }
 
 TEST(SectionTreeTest, MultipleLevel1Headings) {
@@ -462,10 +481,10 @@ Content 2
     ASSERT_TRUE(doc.success());
 
     auto tree = build_section_tree(doc.document.get());
-    ASSERT_TRUE(tree != nullptr);
+    const Section& root = tree.root();
 
     // Both level 1 headings should be children of root
-    EXPECT_EQ(tree->children.size(), 2u);
-    EXPECT_EQ(tree->children[0]->level, 1);
-    EXPECT_EQ(tree->children[1]->level, 1);
+    EXPECT_EQ(tree.children(root).size(), 2u);
+    EXPECT_EQ(tree.children(root)[0].level, 1);
+    EXPECT_EQ(tree.children(root)[1].level, 1);
 }
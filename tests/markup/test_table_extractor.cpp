@@ -0,0 +1,224 @@
+/**
+ * @file test_table_extractor.cpp
+ * @brief Tests for streaming wikitable extraction
+ */
+
+#include <gtest/gtest.h>
+#include "wikilib/markup/table_extractor.h"
+
+using namespace wikilib::markup;
+
+// ============================================================================
+// Row extraction tests
+// ============================================================================
+
+TEST(TableExtractorTest, SkipsTextBeforeTable) {
+    TableExtractor tables("Intro with {| not a table\n== Heading ==\n{| class=\"wikitable\"\n|a\n|}\n");
+
+    ASSERT_TRUE(tables.next_table());
+    EXPECT_EQ(tables.table_attributes(), "class=\"wikitable\"");
+
+    std::vector<TableCell> row;
+    ASSERT_TRUE(tables.next_row(row));
+    ASSERT_EQ(row.size(), 1u);
+    EXPECT_EQ(row[0].text, "a");
+    EXPECT_FALSE(tables.next_row(row));
+    EXPECT_FALSE(tables.next_table());
+}
+
+TEST(TableExtractorTest, InlineCellsAndHeaders) {
+    TableExtractor tables(
+        "{|\n"
+        "|+ Results\n"
+        "! Team !! Points\n"
+        "|-\n"
+        "| [[Foo|Foo FC]] || {{num|3|x}}\n"
+        "|-\n"
+        "| style=\"color:red\" | Bar || 1\n"
+        "|}\n");
+
+    ASSERT_TRUE(tables.next_table());
+    std::vector<TableCell> row;
+
+    ASSERT_TRUE(tables.next_row(row));
+    EXPECT_EQ(tables.caption(), "Results");
+    ASSERT_EQ(row.size(), 2u);
+    EXPECT_TRUE(row[0].is_header);
+    EXPECT_EQ(row[0].text, "Team");
+    EXPECT_EQ(row[1].text, "Points");
+
+    ASSERT_TRUE(tables.next_row(row));
+    ASSERT_EQ(row.size(), 2u);
+    EXPECT_FALSE(row[0].is_header);
+    EXPECT_EQ(row[0].text, "[[Foo|Foo FC]]");
+    EXPECT_EQ(row[0].attributes, "");
+    EXPECT_EQ(row[1].text, "{{num|3|x}}");
+
+    ASSERT_TRUE(tables.next_row(row));
+    ASSERT_EQ(row.size(), 2u);
+    EXPECT_EQ(row[0].attributes, "style=\"color:red\"");
+    EXPECT_EQ(row[0].text, "Bar");
+    EXPECT_EQ(row[1].text, "1");
+
+    EXPECT_FALSE(tables.next_row(row));
+}
+
+TEST(TableExtractorTest, MultiLineCellAndNestedTable) {
+    TableExtractor tables(
+        "{|\n"
+        "| first line\n"
+        "second line\n"
+        "| outer\n"
+        "{|\n"
+        "| inner\n"
+        "|}\n"
+        "|}\n"
+        "{|\n"
+        "| next\n"
+        "|}\n");
+
+    ASSERT_TRUE(tables.next_table());
+    std::vector<TableCell> row;
+    ASSERT_TRUE(tables.next_row(row));
+    ASSERT_EQ(row.size(), 2u);
+    EXPECT_EQ(row[0].text, "first line\nsecond line");
+    EXPECT_EQ(row[1].text, "outer\n{|\n| inner\n|}");
+    EXPECT_FALSE(tables.next_row(row));
+
+    ASSERT_TRUE(tables.next_table());
+    ASSERT_TRUE(tables.next_row(row));
+    EXPECT_EQ(row[0].text, "next");
+    EXPECT_FALSE(tables.next_table());
+}
+
+TEST(TableExtractorTest, NextTableSkipsUnreadRows) {
+    TableExtractor tables("{|\n|a\n|-\n|b\n|}\n{|\n|c\n|}\n");
+
+    ASSERT_TRUE(tables.next_table());
+    ASSERT_TRUE(tables.next_table());
+    std::vector<TableCell> row;
+    ASSERT_TRUE(tables.next_row(row));
+    EXPECT_EQ(row[0].text, "c");
+}
+
+TEST(TableExtractorTest, UnclosedTemplateEndsAtTableMarkup) {
+    TableExtractor tables("{|\n| a {{broken\n|-\n| b\n|}\ntext\n{|\n| c\n|}\n");
+
+    ASSERT_TRUE(tables.next_table());
+    std::vector<TableCell> row;
+    ASSERT_TRUE(tables.next_row(row));
+    ASSERT_EQ(row.size(), 1u);
+    EXPECT_EQ(row[0].text, "a {{broken");
+    ASSERT_TRUE(tables.next_row(row));
+    ASSERT_EQ(row.size(), 1u);
+    EXPECT_EQ(row[0].text, "b");
+    EXPECT_FALSE(tables.next_row(row));
+
+    ASSERT_TRUE(tables.next_table());
+    ASSERT_TRUE(tables.next_row(row));
+    ASSERT_EQ(row.size(), 1u);
+    EXPECT_EQ(row[0].text, "c");
+    EXPECT_FALSE(tables.next_row(row));
+    EXPECT_FALSE(tables.next_table());
+}
+
+TEST(TableExtractorTest, MultiLineTemplateStaysInCell) {
+    TableExtractor tables("{|\n|-\n| {{flag\n | name = France\n | size = 20\n }}\n| Paris\n|}\n");
+
+    ASSERT_TRUE(tables.next_table());
+    std::vector<TableCell> row;
+    ASSERT_TRUE(tables.next_row(row));
+    ASSERT_EQ(row.size(), 2u);
+    EXPECT_EQ(row[0].text, "{{flag\n | name = France\n | size = 20\n }}");
+    EXPECT_EQ(row[1].text, "Paris");
+    EXPECT_FALSE(tables.next_row(row));
+}
+
+// ============================================================================
+// Grid tests
+// ============================================================================
+
+TEST(TableGridTest, ExpandsRowspanAndColspan) {
+    TableExtractor tables(
+        "{|\n"
+        "| rowspan=\"2\" | A || colspan=2 | B\n"
+        "|-\n"
+        "| C || D\n"
+        "|-\n"
+        "| E\n"
+        "|}\n");
+
+    TableGrid grid;
+    ASSERT_TRUE(tables.read_table(grid));
+    ASSERT_EQ(grid.rows(), 3u);
+    ASSERT_EQ(grid.columns(), 3u);
+
+    EXPECT_EQ(grid.at(0, 0).text, "A");
+    EXPECT_EQ(grid.at(0, 1).text, "B");
+    EXPECT_EQ(grid.at(0, 2).text, "B");
+    EXPECT_TRUE(grid.at(0, 2).is_span_copy);
+
+    EXPECT_EQ(grid.at(1, 0).text, "A");
+    EXPECT_TRUE(grid.at(1, 0).is_span_copy);
+    EXPECT_EQ(grid.at(1, 1).text, "C");
+    EXPECT_EQ(grid.at(1, 2).text, "D");
+
+    EXPECT_EQ(grid.at(2, 0).text, "E");
+    EXPECT_EQ(grid.at(2, 1).text, "");
+}
+
+TEST(TableGridTest, ColspanOverRowspanEndsIt) {
+    TableExtractor tables(
+        "{|\n"
+        "| A || rowspan=2 | B || C\n"
+        "|-\n"
+        "| colspan=2 | G || H\n"
+        "|-\n"
+        "| I || J || K\n"
+        "|}\n");
+
+    TableGrid grid;
+    ASSERT_TRUE(tables.read_table(grid));
+    ASSERT_EQ(grid.rows(), 3u);
+    ASSERT_EQ(grid.columns(), 3u);
+
+    EXPECT_EQ(grid.at(1, 0).text, "G");
+    EXPECT_EQ(grid.at(1, 1).text, "G");
+    EXPECT_EQ(grid.at(1, 2).text, "H");
+
+    // B's rowspan was taken by G, so it does not spill into the third row
+    EXPECT_EQ(grid.at(2, 0).text, "I");
+    EXPECT_EQ(grid.at(2, 1).text, "J");
+    EXPECT_EQ(grid.at(2, 2).text, "K");
+    EXPECT_FALSE(grid.at(2, 1).is_span_copy);
+}
+
+TEST(TableGridTest, WidensEarlierRows) {
+    TableGrid grid;
+    TableCell a{.text = "a"};
+    TableCell b{.text = "b"};
+    TableCell c{.text = "c"};
+
+    std::vector<TableCell> first{a};
+    std::vector<TableCell> second{a, b, c};
+    grid.add_row(first);
+    grid.add_row(second);
+
+    ASSERT_EQ(grid.columns(), 3u);
+    EXPECT_EQ(grid.at(0, 0).text, "a");
+    EXPECT_EQ(grid.at(0, 1).text, "");
+    EXPECT_EQ(grid.at(1, 2).text, "c");
+
+    grid.clear();
+    EXPECT_EQ(grid.rows(), 0u);
+    EXPECT_EQ(grid.columns(), 0u);
+}
+
+TEST(TableGridTest, ParseSpanAttribute) {
+    EXPECT_EQ(parse_span_attribute("rowspan=\"3\"", "rowspan"), 3u);
+    EXPECT_EQ(parse_span_attribute("style=\"x\" COLSPAN = '2'", "colspan"), 2u);
+    EXPECT_EQ(parse_span_attribute("data-colspan=4", "colspan"), 1u);
+    EXPECT_EQ(parse_span_attribute("colspan=0", "colspan"), 1u);
+    EXPECT_EQ(parse_span_attribute("colspan=99999", "colspan"), 1000u);
+    EXPECT_EQ(parse_span_attribute("", "rowspan"), 1u);
+}
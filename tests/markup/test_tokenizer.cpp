@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <stdexcept>
+#include <sys/mman.h>
 #include "wikilib/markup/tokenizer.h"
 
 using namespace wikilib;
@@ -7,20 +9,33 @@ using namespace wikilib::markup;
 class TokenizerTest : public ::testing::Test {
 protected:
     std::vector<Token> tokenize(std::string_view input) {
+        input_ = input;
         Tokenizer tok(input);
         return tok.tokenize_all();
     }
 
     Token first_token(std::string_view input) {
+        input_ = input;
         Tokenizer tok(input);
         return tok.next();
     }
+
+    // Views of tokens from the last tokenize() or first_token() input
+    std::string_view text(const Token &token) const {
+        return token.text(input_);
+    }
+
+    std::string_view tag_name(const Token &token) const {
+        return token.tag_name(input_);
+    }
+
+    std::string_view input_;
 };
 
 TEST_F(TokenizerTest, PlainText) {
     auto tok = first_token("Hello World");
     EXPECT_EQ(tok.type, TokenType::Text);
-    EXPECT_EQ(tok.text, "Hello World");
+    EXPECT_EQ(text(tok), "Hello World");
 }
 
 TEST_F(TokenizerTest, Bold) {
@@ -28,7 +43,7 @@ TEST_F(TokenizerTest, Bold) {
     ASSERT_GE(tokens.size(), 3u);
     EXPECT_EQ(tokens[0].type, TokenType::Bold);
     EXPECT_EQ(tokens[1].type, TokenType::Text);
-    EXPECT_EQ(tokens[1].text, "bold");
+    EXPECT_EQ(text(tokens[1]), "bold");
     EXPECT_EQ(tokens[2].type, TokenType::Bold);
 }
 
@@ -36,7 +51,7 @@ TEST_F(TokenizerTest, Italic) {
     auto tokens = tokenize("''italic''");
     ASSERT_GE(tokens.size(), 3u);
     EXPECT_EQ(tokens[0].type, TokenType::Italic);
-    EXPECT_EQ(tokens[1].text, "italic");
+    EXPECT_EQ(text(tokens[1]), "italic");
     EXPECT_EQ(tokens[2].type, TokenType::Italic);
 }
 
@@ -45,7 +60,7 @@ TEST_F(TokenizerTest, InternalLink) {
     ASSERT_GE(tokens.size(), 3u);
     EXPECT_EQ(tokens[0].type, TokenType::LinkOpen);
     EXPECT_EQ(tokens[1].type, TokenType::Text);
-    EXPECT_EQ(tokens[1].text, "Page name");
+    EXPECT_EQ(text(tokens[1]), "Page name");
     EXPECT_EQ(tokens[2].type, TokenType::LinkClose);
 }
 
@@ -53,9 +68,9 @@ TEST_F(TokenizerTest, PipedLink) {
     auto tokens = tokenize("[[Page|Display text]]");
     ASSERT_GE(tokens.size(), 5u);
     EXPECT_EQ(tokens[0].type, TokenType::LinkOpen);
-    EXPECT_EQ(tokens[1].text, "Page");
+    EXPECT_EQ(text(tokens[1]), "Page");
     EXPECT_EQ(tokens[2].type, TokenType::LinkSeparator);
-    EXPECT_EQ(tokens[3].text, "Display text");
+    EXPECT_EQ(text(tokens[3]), "Display text");
     EXPECT_EQ(tokens[4].type, TokenType::LinkClose);
 }
 
@@ -63,7 +78,7 @@ TEST_F(TokenizerTest, Template) {
     auto tokens = tokenize("{{Template}}");
     ASSERT_GE(tokens.size(), 3u);
     EXPECT_EQ(tokens[0].type, TokenType::TemplateOpen);
-    EXPECT_EQ(tokens[1].text, "Template");
+    EXPECT_EQ(text(tokens[1]), "Template");
     EXPECT_EQ(tokens[2].type, TokenType::TemplateClose);
 }
 
@@ -95,7 +110,7 @@ TEST_F(TokenizerTest, Parameter) {
     auto tokens = tokenize("{{{param}}}");
     ASSERT_GE(tokens.size(), 3u);
     EXPECT_EQ(tokens[0].type, TokenType::ParameterOpen);
-    EXPECT_EQ(tokens[1].text, "param");
+    EXPECT_EQ(text(tokens[1]), "param");
     EXPECT_EQ(tokens[2].type, TokenType::ParameterClose);
 }
 
@@ -164,7 +179,7 @@ TEST_F(TokenizerTest, NoWiki) {
     for (const auto &t: tokens) {
         if (t.type == TokenType::NoWiki) {
             found_nowiki = true;
-            EXPECT_EQ(t.text, "'''not bold'''");
+            EXPECT_EQ(text(t), "'''not bold'''");
             break;
         }
     }
@@ -203,8 +218,40 @@ TEST_F(TokenizerTest, MixedContent) {
 TEST_F(TokenizerTest, SourceLocation) {
     Tokenizer tok("Hello\nWorld");
     auto t1 = tok.next();
-    EXPECT_EQ(t1.location.begin.line, 1u);
-    EXPECT_EQ(t1.location.begin.column, 1u);
+    EXPECT_EQ(tok.location(t1).begin.line, 1u);
+    EXPECT_EQ(tok.location(t1).begin.column, 1u);
+}
+
+TEST_F(TokenizerTest, PackedTokenLocations) {
+    EXPECT_EQ(sizeof(Token), 16u);
+
+    Tokenizer tok("== A ==\nx <b>y</b>\n\n<nowiki>z</nowiki>");
+    auto tokens = tok.tokenize_all();
+    ASSERT_EQ(tokens[0].type, TokenType::Heading);
+    EXPECT_EQ(tokens[0].level, 2);
+    EXPECT_EQ(tok.text(tokens[0]), "==");
+
+    const Token *bold = nullptr;
+    const Token *nowiki = nullptr;
+    for (const auto &t: tokens) {
+        if (t.type == TokenType::HtmlTagClose) {
+            bold = &t;
+        } else if (t.type == TokenType::NoWiki) {
+            nowiki = &t;
+        }
+    }
+    ASSERT_NE(bold, nullptr);
+    EXPECT_EQ(tok.tag_name(*bold), "b");
+    SourceRange range = tok.location(*bold);
+    EXPECT_EQ(range.begin.line, 2u);
+    EXPECT_EQ(range.begin.column, 7u);
+    EXPECT_EQ(range.end.column, 11u);
+    EXPECT_EQ(range.length(), 4u);
+
+    ASSERT_NE(nowiki, nullptr);
+    EXPECT_EQ(tok.text(*nowiki), "z");
+    EXPECT_EQ(tok.location(*nowiki).begin.line, 4u);
+    EXPECT_EQ(tok.location(*nowiki).length(), 18u);
 }
 
 TEST_F(TokenizerTest, LooksLikeWikitext) {
@@ -280,7 +327,7 @@ TEST_F(TokenizerTest, NoWiki_NotClosed) {
         if (t.type == TokenType::NoWiki) {
             found_nowiki = true;
             // Content should include everything until EOF (no closing tag found)
-            EXPECT_EQ(t.text, "<!-- comment--><nowiki>");
+            EXPECT_EQ(text(t), "<!-- comment--><nowiki>");
         }
     }
     EXPECT_TRUE(found_nowiki);
@@ -321,7 +368,7 @@ TEST_F(TokenizerTest, NoWiki_Templates) {
         if (t.type == TokenType::TemplateOpen) found_template = true;
         if (t.type == TokenType::NoWiki) {
             found_nowiki = true;
-            nowiki_content = std::string(t.text);
+            nowiki_content = std::string(text(t));
         }
     }
 
@@ -348,7 +395,7 @@ TEST_F(TokenizerTest, Comment_PreserveMode) {
     for (const auto& t : tokens) {
         if (t.type == TokenType::HtmlComment) {
             found_comment = true;
-            comment_text = std::string(t.text);
+            comment_text = std::string(tok.text(t));
         }
     }
 
@@ -386,7 +433,7 @@ TEST_F(TokenizerTest, Tag_ValidSpan) {
     for (const auto& t : tokens) {
         if (t.type == TokenType::HtmlTagOpen) {
             found_tag = true;
-            EXPECT_EQ(t.tag_name, "span");
+            EXPECT_EQ(tag_name(t), "span");
         }
     }
     EXPECT_TRUE(found_tag);
@@ -400,7 +447,7 @@ TEST_F(TokenizerTest, Tag_ValidSub) {
     for (const auto& t : tokens) {
         if (t.type == TokenType::HtmlTagOpen) {
             found_tag = true;
-            EXPECT_EQ(t.tag_name, "sub");
+            EXPECT_EQ(tag_name(t), "sub");
         }
     }
     EXPECT_TRUE(found_tag);
@@ -414,7 +461,7 @@ TEST_F(TokenizerTest, Tag_ValidClosing) {
     for (const auto& t : tokens) {
         if (t.type == TokenType::HtmlTagClose) {
             found_tag = true;
-            EXPECT_EQ(t.tag_name, "sub");
+            EXPECT_EQ(tag_name(t), "sub");
         }
     }
     EXPECT_TRUE(found_tag);
@@ -428,8 +475,8 @@ TEST_F(TokenizerTest, Tag_ValidSelfClosing) {
     for (const auto& t : tokens) {
         if (t.type == TokenType::HtmlTagOpen) {
             found_tag = true;
-            EXPECT_EQ(t.tag_name, "br");
-            EXPECT_TRUE(t.self_closing);
+            EXPECT_EQ(tag_name(t), "br");
+            EXPECT_TRUE(t.self_closing());
         }
     }
     EXPECT_TRUE(found_tag);
@@ -476,10 +523,10 @@ TEST_F(TokenizerTest, Tag_ValidInText) {
     bool found_closing = false;
 
     for (const auto& t : tokens) {
-        if (t.type == TokenType::HtmlTagOpen && t.tag_name == "span") {
+        if (t.type == TokenType::HtmlTagOpen && tag_name(t) == "span") {
             found_opening = true;
         }
-        if (t.type == TokenType::HtmlTagClose && t.tag_name == "span") {
+        if (t.type == TokenType::HtmlTagClose && tag_name(t) == "span") {
             found_closing = true;
         }
     }
@@ -516,7 +563,7 @@ TEST_F(TokenizerTest, Tag_AllValidTags) {
 
         bool found = false;
         for (const auto& t : tokens) {
-            if (t.type == TokenType::HtmlTagOpen && t.tag_name == tag) {
+            if (t.type == TokenType::HtmlTagOpen && tag_name(t) == tag) {
                 found = true;
                 break;
             }
@@ -535,9 +582,9 @@ TEST_F(TokenizerTest, Tag_MixedValidInvalid) {
 
     for (const auto& t : tokens) {
         if (t.type == TokenType::HtmlTagOpen || t.type == TokenType::HtmlTagClose) {
-            if (t.tag_name == "span") {
+            if (tag_name(t) == "span") {
                 valid_tags++;
-            } else if (t.tag_name == "xyz") {
+            } else if (tag_name(t) == "xyz") {
                 invalid_tags++;
             }
         }
@@ -546,3 +593,16 @@ TEST_F(TokenizerTest, Tag_MixedValidInvalid) {
     EXPECT_EQ(valid_tags, 2);  // <span> and </span>
     EXPECT_EQ(invalid_tags, 0); // xyz should not be recognized as tag
 }
+
+TEST_F(TokenizerTest, RejectsInputBeyondTokenOffsets) {
+    // Reserve address space only; the pages are never touched
+    size_t size = Tokenizer::MAX_INPUT_SIZE + size_t{1};
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) {
+        GTEST_SKIP() << "Cannot reserve 4 GiB of address space";
+    }
+    std::string_view huge(static_cast<const char *>(data), size);
+    EXPECT_THROW(Tokenizer{huge}, std::length_error);
+    EXPECT_NO_THROW(Tokenizer{huge.substr(0, Tokenizer::MAX_INPUT_SIZE)});
+    munmap(data, size);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "wikilib/markup/parser.h"
+#include "wikilib/output/json_buffer.h"
+#include "wikilib/output/json_writer.h"
+
+using namespace wikilib;
+using namespace wikilib::output;
+
+// ============================================================================
+// JsonBuffer tests
+// ============================================================================
+
+TEST(JsonBufferTest, EscapesInPlace) {
+    JsonBuffer out;
+    out.string("a\"b\\c\nd\te\x01");
+    out.put(' ');
+    out.number(-42);
+    out.put(' ');
+    out.number(uint64_t{18446744073709551615ull});
+    out.put(' ');
+    out.boolean(true);
+    out.put(' ');
+    out.null();
+    EXPECT_EQ(out.take(), R"("a\"b\\c\nd\te\u0001" -42 18446744073709551615 true null)");
+    EXPECT_EQ(out.size(), 0u);
+}
+
+TEST(JsonBufferTest, UnicodeEscapes) {
+    JsonBuffer out;
+    out.string("zażółć", false);
+    out.string("ż😀", true);
+    out.string("\xC5", true); // Truncated sequence passes through
+    EXPECT_EQ(out.take(), "\"zażółć\"\"\\u017c\\ud83d\\ude00\"\"\xC5\"");
+}
+
+TEST(JsonBufferTest, PiecewiseString) {
+    JsonBuffer out;
+    out.put('"');
+    out.escaped("one \"");
+    out.escaped("two");
+    out.put('"');
+    EXPECT_EQ(out.view(), R"("one \"two")");
+}
+
+TEST(JsonBufferTest, FlushesToFdInChunks) {
+    FILE *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+
+    std::string expected;
+    {
+        JsonBuffer out(fileno(file), 256);
+        for (int i = 0; i < 100; ++i) {
+            out.string("value " + std::to_string(i));
+            expected += "\"value " + std::to_string(i) + '"';
+        }
+        EXPECT_GT(out.bytes_flushed(), 0u);
+        EXPECT_LT(out.size(), 256u + 16u);
+        EXPECT_TRUE(out.flush());
+        EXPECT_EQ(out.bytes_flushed(), expected.size());
+    }
+
+    std::string written(expected.size(), '\0');
+    std::rewind(file);
+    EXPECT_EQ(std::fread(written.data(), 1, written.size(), file), expected.size());
+    EXPECT_EQ(written, expected);
+    std::fclose(file);
+}
+
+TEST(JsonBufferTest, StreamSink) {
+    std::ostringstream stream;
+    {
+        JsonBuffer out(stream, 4);
+        out.string("first");
+        EXPECT_EQ(stream.str(), "\"first\"");
+        out.raw("[]");
+    }
+    EXPECT_EQ(stream.str(), "\"first\"[]");
+}
+
+// ============================================================================
+// JsonWriter tests
+// ============================================================================
+
+TEST(JsonWriterTest, CompactNodeOutput) {
+    auto result = markup::parse("== A ==\n'''b''' [[T|x]]");
+    ASSERT_TRUE(result.document);
+
+    JsonWriter writer(JsonConfig{.pretty_print = false});
+    std::string json = writer.write(*result.document);
+    EXPECT_TRUE(json.starts_with(R"({"type": "Document","content": [{"type": "Heading","level": 2,)")) << json;
+    EXPECT_NE(json.find(R"({"type": "Formatting","style": "bold","content": [{"type": "Text","text": "b"}]})"),
+              std::string::npos)
+            << json;
+    EXPECT_NE(json.find(R"("target": "T")"), std::string::npos);
+    EXPECT_EQ(json.find('\n'), std::string::npos);
+}
+
+TEST(JsonWriterTest, PrettyOutput) {
+    markup::DocumentNode doc;
+    doc.content.push_back(std::make_unique<markup::TextNode>("x"));
+
+    JsonWriter writer;
+    EXPECT_EQ(writer.write(doc), "{\n"
+                                 "  \"type\": \"Document\",\n"
+                                 "  \"content\": [\n"
+                                 "    {\n"
+                                 "      \"type\": \"Text\",\n"
+                                 "      \"text\": \"x\"\n"
+                                 "    }\n"
+                                 "  ]\n"
+                                 "}");
+}
+
+TEST(JsonWriterTest, MergesAdjacentTextNodes) {
+    markup::DocumentNode doc;
+    auto first = std::make_unique<markup::TextNode>("a\"");
+    first->location.begin.offset = 3;
+    auto second = std::make_unique<markup::TextNode>("b");
+    second->location.end.offset = 9;
+    doc.content.push_back(std::move(first));
+    doc.content.push_back(std::move(second));
+    doc.content.push_back(std::make_unique<markup::HorizontalRuleNode>());
+
+    // Off by default: one object per node
+    JsonConfig config{.pretty_print = false, .include_source_locations = true};
+    JsonWriter writer(config);
+    std::string json = writer.write(doc);
+    EXPECT_NE(json.find(R"("text": "a\"")"), std::string::npos) << json;
+    EXPECT_NE(json.find(R"("text": "b")"), std::string::npos);
+
+    writer.config().compact_text_nodes = true;
+    json = writer.write(doc);
+    EXPECT_NE(json.find(R"({"type": "Text","location": {"start": 3,"end": 9},"text": "a\"b"})"), std::string::npos)
+            << json;
+}
+
+TEST(JsonWriterTest, StreamAndFdMatchString) {
+    auto result = markup::parse("Some {{cite|title=x}} text\n* item");
+    ASSERT_TRUE(result.document);
+    JsonWriter writer;
+    std::string json = writer.write(*result.document);
+
+    std::ostringstream stream;
+    writer.write_to(*result.document, stream);
+    EXPECT_EQ(stream.str(), json);
+
+    FILE *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    EXPECT_TRUE(writer.write_to_fd(*result.document, fileno(file)));
+    std::string written(json.size(), '\0');
+    std::rewind(file);
+    EXPECT_EQ(std::fread(written.data(), 1, written.size(), file), json.size());
+    EXPECT_EQ(written, json);
+    std::fclose(file);
+}
+
+TEST(JsonWriterTest, PageWithoutSha1IsValid) {
+    dump::Page page;
+    page.info.id = 7;
+    page.info.title = "Zażółć";
+    page.revisions.emplace_back();
+    page.revisions.back().id = 11;
+
+    JsonWriter writer(JsonConfig{.pretty_print = false});
+    EXPECT_EQ(writer.write(page), R"({"id": 7,"title": "Zażółć","namespace": 0,"redirect": null,"revisions": [)"
+                                  R"({"id": 11,"timestamp": "","contributor": "","model": "","format": ""}]})");
+}
+
+TEST(JsonWriterTest, JsonLinesOnePagePerLine) {
+    std::ostringstream stream;
+    {
+        JsonLinesWriter lines(stream);
+        dump::Page page;
+        for (int i = 1; i <= 3; ++i) {
+            page.info.id = static_cast<PageId>(i);
+            lines.write(page);
+        }
+        EXPECT_EQ(lines.count(), 3u);
+    }
+    std::string text = stream.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 3);
+    EXPECT_TRUE(text.starts_with(R"({"id": 1,)"));
+}
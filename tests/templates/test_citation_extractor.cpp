@@ -0,0 +1,53 @@
+/**
+ * @file test_citation_extractor.cpp
+ * @brief Tests for citation extraction from <ref> bodies
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "wikilib/templates/citation_extractor.h"
+
+using namespace wikilib::templates;
+
+TEST(CitationExtractorTest, ExtractsSelectedFields) {
+    std::string_view text =
+        "Claim.<ref name=\"w\">{{cite web |url=http://a.example |title=A |access-date=2020}}</ref> "
+        "Again.<ref name=\"w\"/> "
+        "Book.<ref>{{Citation|title=B|author=X}} and {{cite journal|title=C|doi=10.1/x}}</ref>"
+        "<ref>no template</ref>";
+
+    CitationExtractor extractor({"title", "url", "doi"});
+    std::vector<wikilib::markup::RefSpan> refs;
+    std::vector<Citation> citations;
+    extractor.extract(text, refs, citations);
+
+    ASSERT_EQ(refs.size(), 3u);
+    EXPECT_EQ(refs[0].uses, 2u);
+
+    ASSERT_EQ(citations.size(), 3u);
+    EXPECT_EQ(citations[0].ref, 0u);
+    EXPECT_EQ(citations[0].template_name, "cite web");
+    ASSERT_EQ(citations[0].fields.size(), 2u);
+    EXPECT_EQ(citations[0].fields[0].first, "url");
+    EXPECT_EQ(citations[0].fields[0].second, "http://a.example");
+    EXPECT_EQ(citations[0].fields[1].second, "A");
+
+    EXPECT_EQ(citations[1].ref, 1u);
+    ASSERT_EQ(citations[1].fields.size(), 1u);
+    EXPECT_EQ(citations[1].fields[0].second, "B");
+
+    EXPECT_EQ(citations[2].template_name, "cite journal");
+    ASSERT_EQ(citations[2].fields.size(), 2u);
+    EXPECT_EQ(citations[2].fields[1].first, "doi");
+}
+
+TEST(CitationExtractorTest, AllFieldsByDefault) {
+    CitationExtractor extractor;
+    std::vector<wikilib::markup::RefSpan> refs;
+    std::vector<Citation> citations;
+    extractor.extract("<ref>{{cite news|title=T|work=W|pos}}</ref>", refs, citations);
+
+    ASSERT_EQ(citations.size(), 1u);
+    ASSERT_EQ(citations[0].fields.size(), 2u);
+    EXPECT_EQ(citations[0].fields[1].first, "work");
+}
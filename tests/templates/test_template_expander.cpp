@@ -0,0 +1,140 @@
+/**
+ * @file test_template_expander.cpp
+ * @brief Tests for template expansion
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include "wikilib/templates/template_expander.h"
+
+using namespace wikilib;
+using namespace wikilib::templates;
+
+// Provider that counts existence checks
+class CountingProvider : public MemoryTemplateProvider {
+public:
+    int exists_calls = 0;
+
+    bool template_exists(std::string_view name) override {
+        ++exists_calls;
+        return MemoryTemplateProvider::template_exists(name);
+    }
+};
+
+// ============================================================================
+// #ifexist with a title filter
+// ============================================================================
+
+TEST(TemplateExpanderTest, IfexistAsksProviderWithoutFilter) {
+    auto provider = std::make_shared<CountingProvider>();
+    provider->add_template("Template:Box", "box");
+    TemplateExpander expander(provider);
+
+    auto yes = expander.evaluate_parser_function(ParserFunction::Ifexist, {"Template:Box", "yes", "no"}, {});
+    auto no = expander.evaluate_parser_function(ParserFunction::Ifexist, {"Template:Missing", "yes", "no"}, {});
+    ASSERT_TRUE(yes && no);
+    EXPECT_EQ(*yes, "yes");
+    EXPECT_EQ(*no, "no");
+    EXPECT_EQ(provider->exists_calls, 2);
+}
+
+TEST(TemplateExpanderTest, IfexistSkipsProviderForFilteredTitles) {
+    auto provider = std::make_shared<CountingProvider>();
+    provider->add_template("Template:Box", "box");
+    provider->add_template("Template:Unlisted", "x");
+
+    auto filter = std::make_shared<BloomFilter>(100);
+    filter->insert("Template:Box");
+    filter->insert("Template:Gone"); // In the filter but not in the provider
+    ExpanderConfig config;
+    config.existing_titles = filter;
+    TemplateExpander expander(provider, config);
+
+    auto ifexist = [&](const std::string &title) {
+        auto result = expander.evaluate_parser_function(ParserFunction::Ifexist, {title, "yes", "no"}, {});
+        return result ? *result : "error";
+    };
+
+    EXPECT_EQ(ifexist("Template:Box"), "yes");
+    EXPECT_EQ(provider->exists_calls, 1);
+
+    // A filter hit still needs the provider's answer
+    EXPECT_EQ(ifexist("Template:Gone"), "no");
+    EXPECT_EQ(provider->exists_calls, 2);
+
+    // A filter miss never reaches the provider, so the filter must cover it
+    EXPECT_EQ(ifexist("Template:Missing"), "no");
+    EXPECT_EQ(ifexist("Template:Unlisted"), "no");
+    EXPECT_EQ(provider->exists_calls, 2);
+}
+
+TEST(TemplateExpanderTest, IfexistNormalizesTitleBeforeFilter) {
+    auto provider = std::make_shared<CountingProvider>();
+    auto filter = std::make_shared<BloomFilter>(100);
+    for (const char *title: {"Foo bar", "Template:Foo bar"}) {
+        provider->add_template(title, "x");
+        filter->insert(title);
+    }
+    ExpanderConfig config;
+    config.existing_titles = filter;
+    config.capital_links = true;
+    TemplateExpander expander(provider, config);
+
+    // Variants of a filtered title reach the provider; it decides on its own spelling
+    for (const char *title: {"foo_bar", " Foo bar ", "Foo__bar", "Template:foo_bar", "Template: foo bar"}) {
+        int before = provider->exists_calls;
+        (void) expander.evaluate_parser_function(ParserFunction::Ifexist, {title, "yes", "no"}, {});
+        EXPECT_EQ(provider->exists_calls, before + 1) << title;
+    }
+
+    EXPECT_EQ(*expander.evaluate_parser_function(ParserFunction::Ifexist, {"Foo bar", "yes", "no"}, {}), "yes");
+    int before = provider->exists_calls;
+    EXPECT_EQ(*expander.evaluate_parser_function(ParserFunction::Ifexist, {"Other_page", "yes", "no"}, {}), "no");
+    EXPECT_EQ(provider->exists_calls, before);
+}
+
+TEST(TemplateExpanderTest, IfexistKeepsLowerCaseFirstLetter) {
+    auto provider = std::make_shared<CountingProvider>();
+    auto filter = std::make_shared<BloomFilter>(100);
+    provider->add_template("kot", "x");
+    filter->insert("kot");
+    ExpanderConfig config;
+    config.existing_titles = filter;
+    TemplateExpander expander(provider, config);
+
+    // Without capital links the dump keeps "kot"; the filter must not turn that into a no
+    EXPECT_EQ(*expander.evaluate_parser_function(ParserFunction::Ifexist, {"kot", "yes", "no"}, {}), "yes");
+    EXPECT_EQ(provider->exists_calls, 1);
+
+    int before = provider->exists_calls;
+    (void) expander.evaluate_parser_function(ParserFunction::Ifexist, {" kot_", "yes", "no"}, {});
+    EXPECT_EQ(provider->exists_calls, before + 1);
+}
+
+TEST(TemplateExpanderTest, IfexistMapsCanonicalPrefixToLocalName) {
+    auto provider = std::make_shared<CountingProvider>();
+    auto filter = std::make_shared<BloomFilter>(100);
+    provider->add_template("Template:X", "x");
+    filter->insert("Szablon:X");
+
+    ExpanderConfig config;
+    config.existing_titles = filter;
+    config.namespaces = {{.id = NS_MAIN, .name = "", .canonical_name = ""},
+                         {.id = NS_TEMPLATE, .name = "Szablon", .canonical_name = "Template"}};
+    config.capital_links = true;
+    TemplateExpander expander(provider, config);
+
+    EXPECT_EQ(*expander.evaluate_parser_function(ParserFunction::Ifexist, {"Template:X", "yes", "no"}, {}), "yes");
+    EXPECT_EQ(provider->exists_calls, 1);
+
+    // Local and lower-case spellings reach the same dump title
+    for (const char *title: {"Szablon:X", "template:x", "szablon: x"}) {
+        int before = provider->exists_calls;
+        (void) expander.evaluate_parser_function(ParserFunction::Ifexist, {title, "yes", "no"}, {});
+        EXPECT_EQ(provider->exists_calls, before + 1) << title;
+    }
+
+    int before = provider->exists_calls;
+    EXPECT_EQ(*expander.evaluate_parser_function(ParserFunction::Ifexist, {"Template:Y", "yes", "no"}, {}), "no");
+    EXPECT_EQ(provider->exists_calls, before);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file test_template_selector.cpp
+ * @brief Tests for compiled template argument selectors
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "wikilib/templates/template_selector.h"
+
+using namespace wikilib::templates;
+
+// ============================================================================
+// Name normalization
+// ============================================================================
+
+TEST(TemplateSelectorTest, NormalizeTemplateName) {
+    EXPECT_EQ(normalize_template_name("infobox_country"), "Infobox country");
+    EXPECT_EQ(normalize_template_name("  Template:Infobox   country \n"), "Infobox country");
+    EXPECT_EQ(normalize_template_name("template: cite web"), "Cite web");
+    EXPECT_EQ(normalize_template_name(""), "");
+}
+
+// ============================================================================
+// Selection
+// ============================================================================
+
+TEST(TemplateSelectorTest, SelectsNamedArguments) {
+    TemplateSelector selector(std::vector<SelectorRule>{{"Infobox country", {"capital", "population"}}});
+
+    std::string text =
+        "Intro {{lang|fr|x}}\n"
+        "{{infobox_country\n"
+        "| name = France\n"
+        "| capital = [[Paris|Paris, France]]\n"
+        "| population = {{formatnum:67000000}} <!-- 2023 | est -->\n"
+        "}}\n";
+
+    auto args = selector.select(text);
+    ASSERT_EQ(args.size(), 2u);
+    EXPECT_EQ(args[0].name, "capital");
+    EXPECT_EQ(args[0].value, "[[Paris|Paris, France]]");
+    EXPECT_EQ(args[0].parameter, 0u);
+    EXPECT_EQ(args[0].template_name, "infobox_country");
+    EXPECT_EQ(args[1].name, "population");
+    EXPECT_EQ(args[1].value, "{{formatnum:67000000}} <!-- 2023 | est -->");
+    EXPECT_EQ(args[1].parameter, 1u);
+}
+
+TEST(TemplateSelectorTest, PositionalAndParameterArguments) {
+    TemplateSelector selector(std::vector<SelectorRule>{{"Cite", {"2", "url"}}});
+
+    auto args = selector.select("{{cite|{{{1}}}|second|url=http://x}}");
+    ASSERT_EQ(args.size(), 2u);
+    EXPECT_EQ(args[0].value, "second");
+    EXPECT_TRUE(args[0].name.empty());
+    EXPECT_EQ(args[1].value, "http://x");
+}
+
+TEST(TemplateSelectorTest, PrefixPatternAndNestedInvocations) {
+    TemplateSelector selector(std::vector<SelectorRule>{
+        {"Infobox*", {"name"}},
+        {"Coord", {}},
+    });
+
+    std::string text =
+        "{{Infobox settlement|name=A|coordinates={{coord|1|2}}}}"
+        "{{Infobox person|name=B}}"
+        "{{Infoboxes|name=C}}";
+
+    auto args = selector.select(text);
+    ASSERT_EQ(args.size(), 5u);
+    EXPECT_EQ(args[0].value, "A");
+    EXPECT_EQ(args[0].invocation, 0u);
+    EXPECT_EQ(args[1].rule, 1u);
+    EXPECT_EQ(args[1].value, "1");
+    EXPECT_EQ(args[2].value, "2");
+    EXPECT_EQ(args[2].invocation, 1u);
+    EXPECT_EQ(args[3].value, "B");
+    EXPECT_EQ(args[4].value, "C");
+}
+
+TEST(TemplateSelectorTest, SpacedPrefixPattern) {
+    TemplateSelector selector(std::vector<SelectorRule>{{"Infobox *", {"name"}}});
+
+    auto args = selector.select("{{Infoboxes|name=C}}{{Infobox_person|name=B}}");
+    ASSERT_EQ(args.size(), 1u);
+    EXPECT_EQ(args[0].value, "B");
+}
+
+TEST(TemplateSelectorTest, IgnoresUnterminatedInvocation) {
+    TemplateSelector selector(std::vector<SelectorRule>{{"Box", {"a"}}});
+
+    EXPECT_TRUE(selector.select("{{Box|a=1|b={{x}}").empty());
+    EXPECT_TRUE(selector.select("{{Box}}").empty());
+}
+
+TEST(TemplateSelectorTest, SelectAllMatchesSequentialSelect) {
+    TemplateSelector selector(std::vector<SelectorRule>{{"Infobox*", {"capital"}}, {"Box", {"1"}}});
+
+    std::vector<std::string> pages;
+    for (int i = 0; i < 500; ++i) {
+        std::string n = std::to_string(i);
+        pages.push_back(i % 3 == 0 ? "{{Infobox country|capital=C" + n + "}} {{Box|b" + n + "}}"
+                                   : "text " + n + " {{Box|x" + n + "}}");
+    }
+    std::vector<std::string_view> texts(pages.begin(), pages.end());
+
+    wikilib::ThreadPool pool(wikilib::ThreadPoolConfig{.threads = 3});
+    std::vector<std::vector<SelectedArgument>> out(7);
+    selector.select_all(texts, out, pool);
+    ASSERT_EQ(out.size(), texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        auto expected = selector.select(texts[i]);
+        ASSERT_EQ(out[i].size(), expected.size()) << i;
+        for (size_t j = 0; j < expected.size(); ++j) {
+            EXPECT_EQ(out[i][j].value, expected[j].value);
+            EXPECT_EQ(out[i][j].rule, expected[j].rule);
+            EXPECT_EQ(out[i][j].value.data(), expected[j].value.data()); // Views into the page
+        }
+    }
+    EXPECT_EQ(out[3].at(0).value, "C3");
+    EXPECT_EQ(out[4].at(0).value, "x4");
+}